@@ -32,6 +32,15 @@ typedef uint16_t _Py_CODEUNIT;
 #define _Py_SET_OPCODE(word, opcode) \
     do { ((unsigned char *)&(word))[0] = (opcode); } while (0)
 
+// The JIT state only exists in builds configured with the JIT:
+#ifdef _Py_JIT
+#  define _PyCode_JIT_FIELDS                                                   \
+    int _co_jit_warmup;           /* Warmup counter for the JIT, or -1 */      \
+    void *_co_jit;                /* JIT-compiled code, or NULL */
+#else
+#  define _PyCode_JIT_FIELDS
+#endif
+
 // To avoid repeating ourselves in deepfreeze.py, all PyCodeObject members are
 // defined in this macro:
 #define _PyCode_DEF(SIZE) {                                                    \
@@ -93,6 +102,7 @@ typedef uint16_t _Py_CODEUNIT;
     PyObject *_co_code;           /* cached co_code object/attribute */        \
     int _co_firsttraceable;       /* index of first traceable instruction */   \
     char *_co_linearray;          /* array of line offsets */                  \
+    _PyCode_JIT_FIELDS                                                         \
     /* Scratch space for extra data relating to the code object.               \
        Type is a void* to keep the format private in codeobject.c to force     \
        people to go through the proper APIs. */                                \
@@ -40,6 +40,8 @@ typedef enum {
 #ifdef WITH_PYMALLOC
     PYMEM_ALLOCATOR_PYMALLOC = 5,
     PYMEM_ALLOCATOR_PYMALLOC_DEBUG = 6,
+    PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE = 7,
+    PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE_DEBUG = 8,
 #endif
 } PyMemAllocatorName;
 
@@ -8,6 +8,14 @@ PyAPI_FUNC(void) _PyInterpreterState_RequireIDRef(PyInterpreterState *, int);
 
 PyAPI_FUNC(PyObject *) _PyInterpreterState_GetMainModule(PyInterpreterState *);
 
+#if !defined(WITH_PYMALLOC_THREAD_CACHE)
+/* Keep a few free blocks of the smallest pymalloc size classes in each
+ * thread state.  Off by default: the pool free lists are about as fast.
+ * Can be enabled using -DWITH_PYMALLOC_THREAD_CACHE=1, which changes the
+ * layout of PyThreadState. */
+#define WITH_PYMALLOC_THREAD_CACHE 0
+#endif
+
 /* State unique per thread */
 
 /* Py_tracefunc return -1 when raising an exception, or 0 for success. */
@@ -182,6 +190,16 @@ struct _ts {
     _PyStackChunk *datastack_chunk;
     PyObject **datastack_top;
     PyObject **datastack_limit;
+
+#if WITH_PYMALLOC_THREAD_CACHE
+    /* Free blocks of the smallest pymalloc size classes, kept for the next
+       allocations of the thread.  See "Thread caches" in
+       Objects/obmalloc.c. */
+    struct {
+        void *freeblock[8];
+        unsigned char count[8];
+    } obmalloc_cache;
+#endif
     /* XXX signal handlers should also be here */
 
     /* The following fields are here to avoid allocation during init.
@@ -103,6 +103,11 @@ _PyEval_Vector(PyThreadState *tstate,
             PyObject* const* args, size_t argcount,
             PyObject *kwnames);
 
+extern PyObject*
+_PyEval_Vector_Ex(PyThreadState *tstate,
+            PyFunctionObject *func, PyObject *locals,
+            PyObject *callargs, PyObject *kwargs);
+
 extern int _PyEval_ThreadsInitialized(struct pyruntimestate *runtime);
 extern PyStatus _PyEval_InitGIL(PyThreadState *tstate);
 extern void _PyEval_FiniGIL(PyInterpreterState *interp);
@@ -44,6 +44,16 @@ typedef struct {
 
 #define INLINE_CACHE_ENTRIES_COMPARE_OP CACHE_ENTRIES(_PyCompareOpCache)
 
+/* Set in the oparg of COMPARE_OP when both operands were pushed by
+ * LOAD_FAST_BORROW or LOAD_CONST_BORROW, so it must not decref them. */
+#define COMPARE_BORROWED 16
+
+typedef struct {
+    _Py_CODEUNIT counter;
+} _PyContainsOpCache;
+
+#define INLINE_CACHE_ENTRIES_CONTAINS_OP CACHE_ENTRIES(_PyContainsOpCache)
+
 typedef struct {
     _Py_CODEUNIT counter;
     _Py_CODEUNIT type_version[2];
@@ -79,8 +89,24 @@ typedef struct {
 
 #define INLINE_CACHE_ENTRIES_CALL CACHE_ENTRIES(_PyCallCache)
 
+/* CALL_PY_WITH_KWARGS stores the parameter index of each keyword argument
+ * in min_args instead, CALL_KW_INDEX_BITS bits per keyword. The top bit
+ * records whether the call was a method call, which shifts the positional
+ * arguments by one. */
+#define CALL_KW_INDEX_BITS 5
+#define CALL_KW_MAX_KWARGS 3
+#define CALL_KW_MAX_INDEX ((1 << CALL_KW_INDEX_BITS) - 1)
+#define CALL_KW_IS_METH (1 << 15)
+
+static inline int
+_PyCallCache_KwIndex(uint16_t layout, int i)
+{
+    return (layout >> (CALL_KW_INDEX_BITS * i)) & CALL_KW_MAX_INDEX;
+}
+
 typedef struct {
     _Py_CODEUNIT counter;
+    _Py_CODEUNIT type_version[2];
 } _PyStoreSubscrCache;
 
 #define INLINE_CACHE_ENTRIES_STORE_SUBSCR CACHE_ENTRIES(_PyStoreSubscrCache)
@@ -239,6 +265,12 @@ extern int _Py_Specialize_LoadAttr(PyObject *owner, _Py_CODEUNIT *instr,
                                    PyObject *name);
 extern int _Py_Specialize_StoreAttr(PyObject *owner, _Py_CODEUNIT *instr,
                                     PyObject *name);
+extern int _Py_Specialize_LoadAttrPoly(PyObject *owner, _Py_CODEUNIT *instr,
+                                       PyObject *name);
+extern int _Py_Specialize_StoreAttrPoly(PyObject *owner, _Py_CODEUNIT *instr,
+                                        PyObject *name);
+extern struct mega_attr_cache_entry *_PyMegaAttrCache_Fill(PyTypeObject *type,
+                                                           PyObject *name);
 extern int _Py_Specialize_LoadGlobal(PyObject *globals, PyObject *builtins, _Py_CODEUNIT *instr, PyObject *name);
 extern int _Py_Specialize_BinarySubscr(PyObject *sub, PyObject *container, _Py_CODEUNIT *instr);
 extern int _Py_Specialize_StoreSubscr(PyObject *container, PyObject *sub, _Py_CODEUNIT *instr);
@@ -248,6 +280,8 @@ extern void _Py_Specialize_BinaryOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *
                                     int oparg, PyObject **locals);
 extern void _Py_Specialize_CompareOp(PyObject *lhs, PyObject *rhs,
                                      _Py_CODEUNIT *instr, int oparg);
+extern void _Py_Specialize_ContainsOp(PyObject *value, PyObject *container,
+                                      _Py_CODEUNIT *instr);
 extern void _Py_Specialize_UnpackSequence(PyObject *seq, _Py_CODEUNIT *instr,
                                           int oparg);
 extern void _Py_Specialize_ForIter(PyObject *iter, _Py_CODEUNIT *instr);
@@ -263,6 +297,8 @@ extern int _PyStaticCode_InternStrings(PyCodeObject *co);
 #define STAT_INC(opname, name) do { if (_py_stats) _py_stats->opcode_stats[opname].specialization.name++; } while (0)
 #define STAT_DEC(opname, name) do { if (_py_stats) _py_stats->opcode_stats[opname].specialization.name--; } while (0)
 #define OPCODE_EXE_INC(opname) do { if (_py_stats) _py_stats->opcode_stats[opname].execution_count++; } while (0)
+#define OPCODE_TRIPLE_INC(first, second, third) \
+    do { if (_py_stats) _Py_OpcodeTripleInc(first, second, third); } while (0)
 #define CALL_STAT_INC(name) do { if (_py_stats) _py_stats->call_stats.name++; } while (0)
 #define OBJECT_STAT_INC(name) do { if (_py_stats) _py_stats->object_stats.name++; } while (0)
 #define OBJECT_STAT_INC_COND(name, cond) \
@@ -270,19 +306,26 @@ extern int _PyStaticCode_InternStrings(PyCodeObject *co);
 #define EVAL_CALL_STAT_INC(name) do { if (_py_stats) _py_stats->call_stats.eval_calls[name]++; } while (0)
 #define EVAL_CALL_STAT_INC_IF_FUNCTION(name, callable) \
     do { if (_py_stats && PyFunction_Check(callable)) _py_stats->call_stats.eval_calls[name]++; } while (0)
+#define ATTR_SITE_STAT(old_opcode, new_opcode) \
+    do { if (_py_stats) _Py_AttrSiteStat(old_opcode, new_opcode); } while (0)
 
 // Used by the _opcode extension which is built as a shared library
 PyAPI_FUNC(PyObject*) _Py_GetSpecializationStats(void);
 
+extern void _Py_OpcodeTripleInc(int first, int second, int third);
+extern void _Py_AttrSiteStat(int old_opcode, int new_opcode);
+
 #else
 #define STAT_INC(opname, name) ((void)0)
 #define STAT_DEC(opname, name) ((void)0)
 #define OPCODE_EXE_INC(opname) ((void)0)
+#define OPCODE_TRIPLE_INC(first, second, third) ((void)0)
 #define CALL_STAT_INC(name) ((void)0)
 #define OBJECT_STAT_INC(name) ((void)0)
 #define OBJECT_STAT_INC_COND(name, cond) ((void)0)
 #define EVAL_CALL_STAT_INC(name) ((void)0)
 #define EVAL_CALL_STAT_INC_IF_FUNCTION(name, callable) ((void)0)
+#define ATTR_SITE_STAT(old_opcode, new_opcode) ((void)0)
 #endif  // !Py_STATS
 
 // Cache values are only valid in memory, so use native endianness.
@@ -481,6 +524,22 @@ adaptive_counter_backoff(uint16_t counter) {
     return adaptive_counter_bits(value, backoff);
 }
 
+/* The miss counter of a specialized instruction counts down in its low
+ * MISS_COUNTER_BITS bits. LOAD_ATTR and STORE_ATTR keep the backoff of
+ * their adaptive counter in the bits above, so that a site deoptimized
+ * again and again backs off like one which keeps failing to specialize
+ * (and, for loads, eventually becomes LOAD_ATTR_MEGAMORPHIC). */
+#define MISS_COUNTER_BITS 12
+
+static inline uint16_t
+miss_counter_deopt(uint16_t counter) {
+    unsigned int backoff = counter >> MISS_COUNTER_BITS;
+    if (backoff == 0) {
+        return adaptive_counter_start();
+    }
+    return adaptive_counter_backoff(backoff);
+}
+
 
 /* Line array cache for tracing */
 
@@ -72,6 +72,10 @@ extern int _PyObjectDict_SetItem(PyTypeObject *tp, PyObject **dictptr, PyObject
 
 extern PyObject *_PyDict_Pop_KnownHash(PyObject *, PyObject *, Py_hash_t, PyObject *);
 
+/* Advance a forward dict key, value or item iterator. Stores borrowed
+ * references and returns 1, or returns 0 when exhausted or on error. */
+extern int _PyDictIter_NextEntry(PyObject *iter, PyObject **pkey, PyObject **pvalue);
+
 #define DKIX_EMPTY (-1)
 #define DKIX_DUMMY (-2)  /* Used internally */
 #define DKIX_ERROR (-3)
@@ -120,6 +124,9 @@ struct _dictkeysobject {
        Dynamically sized, SIZEOF_VOID_P is minimum. */
     char dk_indices[];  /* char is required to avoid strict aliasing. */
 
+    /* "uint8_t dk_ctrl[DK_SIZE(dk)];" array follows: one control byte per
+       slot of the hash table, see dictobject.c */
+
     /* "PyDictKeyEntry or PyDictUnicodeEntry dk_entries[USABLE_FRACTION(DK_SIZE(dk))];" array follows:
        see the DK_ENTRIES() macro */
 };
@@ -144,12 +151,14 @@ struct _dictvalues {
 #else
 #define DK_SIZE(dk)      (1<<DK_LOG_SIZE(dk))
 #endif
+#define DK_CTRL(dk) \
+    ((uint8_t*)(&((int8_t*)((dk)->dk_indices))[(size_t)1 << (dk)->dk_log2_index_bytes]))
 #define DK_ENTRIES(dk) \
     (assert((dk)->dk_kind == DICT_KEYS_GENERAL), \
-     (PyDictKeyEntry*)(&((int8_t*)((dk)->dk_indices))[(size_t)1 << (dk)->dk_log2_index_bytes]))
+     (PyDictKeyEntry*)(DK_CTRL(dk) + DK_SIZE(dk)))
 #define DK_UNICODE_ENTRIES(dk) \
     (assert((dk)->dk_kind != DICT_KEYS_GENERAL), \
-     (PyDictUnicodeEntry*)(&((int8_t*)((dk)->dk_indices))[(size_t)1 << (dk)->dk_log2_index_bytes]))
+     (PyDictUnicodeEntry*)(DK_CTRL(dk) + DK_SIZE(dk)))
 #define DK_IS_UNICODE(dk) ((dk)->dk_kind != DICT_KEYS_GENERAL)
 
 extern uint64_t _pydict_global_version;
@@ -53,14 +53,22 @@ static inline int _PyObject_GC_MAY_BE_TRACKED(PyObject *obj) {
 #define _PyGC_PREV_SHIFT           (2)
 #define _PyGC_PREV_MASK            (((uintptr_t) -1) << _PyGC_PREV_SHIFT)
 
+/* Bit flags for _gc_next */
+/* Bit 1 is set when the object of the oldest generation is queued for an
+   increment of the incremental collection. */
+#define _PyGC_NEXT_MASK_QUEUED     (2)
+
 // Lowest bit of _gc_next is used for flags only in GC.
 // But it is always 0 for normal code.
+// _PyGC_NEXT_MASK_QUEUED belongs to the object, not to the link: it is kept
+// when the next object changes.
 static inline PyGC_Head* _PyGCHead_NEXT(PyGC_Head *gc) {
-    uintptr_t next = gc->_gc_next;
+    uintptr_t next = gc->_gc_next & ~_PyGC_NEXT_MASK_QUEUED;
     return _Py_CAST(PyGC_Head*, next);
 }
 static inline void _PyGCHead_SET_NEXT(PyGC_Head *gc, PyGC_Head *next) {
-    gc->_gc_next = _Py_CAST(uintptr_t, next);
+    uintptr_t unext = _Py_CAST(uintptr_t, next);
+    gc->_gc_next = (gc->_gc_next & _PyGC_NEXT_MASK_QUEUED) | unext;
 }
 
 // Lowest two bits of _gc_prev is used for _PyGC_PREV_MASK_* flags.
@@ -142,8 +150,14 @@ struct gc_generation {
     int threshold; /* collection threshold */
     int count; /* count of allocations or collections of younger
                   generations */
+    int threshold_shift; /* log2 of the factor applied to threshold by the
+                            adaptive policy */
 };
 
+/* Pause times are counted in buckets of [0, 10 us), [10 us, 100 us), ...,
+   [100 ms, 1 s) and [1 s, +inf) */
+#define NUM_PAUSE_BUCKETS 7
+
 /* Running stats per generation */
 struct gc_generation_stats {
     /* total number of collections */
@@ -152,6 +166,8 @@ struct gc_generation_stats {
     Py_ssize_t collected;
     /* total number of uncollectable objects (put into gc.garbage) */
     Py_ssize_t uncollectable;
+    /* histogram of the pause times of the collections */
+    Py_ssize_t pauses[NUM_PAUSE_BUCKETS];
 };
 
 struct _gc_runtime_state {
@@ -187,6 +203,27 @@ struct _gc_runtime_state {
        collections, and are awaiting to undergo a full collection for
        the first time. */
     Py_ssize_t long_lived_pending;
+
+    /* Incremental collection of the oldest generation (see gcmodule.c).
+       Target pause time of an increment in seconds, 0.0 to disable. */
+    double pause_budget;
+    /* Objects of the oldest generation the current pass hasn't reached */
+    PyGC_Head old_unscanned;
+    /* Objects queued for the next increments of the current pass */
+    PyGC_Head old_queued;
+    /* Maximum number of objects in an increment */
+    Py_ssize_t increment_size;
+    /* Number of objects that survived the increments of the current pass */
+    Py_ssize_t pass_survivors;
+
+    /* Adaptive thresholds (see gcmodule.c): true if enabled */
+    int adaptive;
+    /* End of the last collection of each generation */
+    _PyTime_t last_collection[NUM_GENERATIONS];
+
+    /* Number of threads marking the objects of full collections (see
+       gcmodule.c), 1 to mark them in the calling thread only */
+    int mark_threads;
 };
 
 
@@ -202,6 +239,7 @@ extern void _PyList_ClearFreeList(PyInterpreterState *interp);
 extern void _PyDict_ClearFreeList(PyInterpreterState *interp);
 extern void _PyAsyncGen_ClearFreeLists(PyInterpreterState *interp);
 extern void _PyContext_ClearFreeList(PyInterpreterState *interp);
+extern void _PyType_ClearObjectCaches(PyInterpreterState *interp);
 
 #ifdef __cplusplus
 }
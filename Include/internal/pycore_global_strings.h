@@ -394,6 +394,7 @@ struct _Py_global_strings {
         STRUCT_FOR_ID(id)
         STRUCT_FOR_ID(ignore)
         STRUCT_FOR_ID(imag)
+        STRUCT_FOR_ID(immortalize)
         STRUCT_FOR_ID(importlib)
         STRUCT_FOR_ID(in_fd)
         STRUCT_FOR_ID(incoming)
@@ -612,6 +613,7 @@ struct _Py_global_strings {
         STRUCT_FOR_ID(term)
         STRUCT_FOR_ID(text)
         STRUCT_FOR_ID(threading)
+        STRUCT_FOR_ID(threads)
         STRUCT_FOR_ID(throw)
         STRUCT_FOR_ID(timeout)
         STRUCT_FOR_ID(times)
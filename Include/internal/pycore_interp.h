@@ -114,6 +114,9 @@ struct _is {
 
     struct _ceval_state ceval;
     struct _gc_runtime_state gc;
+    /* pymalloc state, NULL to share the main interpreter's.
+       See Objects/obmalloc.c. */
+    struct _obmalloc_state *obmalloc;
 
     // sys.modules dictionary
     PyObject *modules;
@@ -0,0 +1,29 @@
+#ifndef Py_INTERNAL_ITERATORS_H
+#define Py_INTERNAL_ITERATORS_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t tuplesize;
+    PyObject *ittuple;     /* tuple of iterators */
+    PyObject *result;
+    int strict;
+} _PyZipObject;
+
+/* Fetch the next pair from a builtin iterator without building the result
+ * tuple, for the specialized FOR_ITER instructions in Python/ceval.c.
+ * See the implementations for the exact return conventions. */
+
+extern int _PyEnum_NextPair(PyObject *en, PyObject **pindex, PyObject **pitem);
+extern int _PyZip_NextPair(PyObject *zip, PyObject **pfirst, PyObject **psecond);
+
+#ifdef __cplusplus
+}
+#endif
+#endif   /* !Py_INTERNAL_ITERATORS_H */
@@ -0,0 +1,63 @@
+#ifndef Py_INTERNAL_JIT_H
+#define Py_INTERNAL_JIT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#ifdef _Py_JIT
+
+/* The copy-and-patch JIT compiler in Python/jit.c.
+ *
+ * A code object is compiled once its RESUME and JUMP_BACKWARD instructions
+ * have run _PyJIT_WARMUP times, by which point it has been quickened and
+ * specialized.  Every instruction becomes a copy of the stencil for its
+ * opcode, built by Tools/jit/build.py from Tools/jit/template.c.  The
+ * stencils chain into each other with tail calls and return to the
+ * interpreter loop, which resumes at frame->prev_instr + 1, whenever they
+ * hit an instruction they don't implement or a guard fails.  They return
+ * -1 with an exception set on errors.
+ *
+ * _co_jit_warmup is -1 for code that can't be compiled, or whose compiled
+ * code mustn't be entered any more because the bytecode changed under it.
+ * The compiled code is only freed with the code object, since frames may
+ * still be running it. */
+
+#define _PyJIT_WARMUP 1024
+
+struct _PyInterpreterFrame;
+
+typedef int (*_PyJITFunction)(struct _PyInterpreterFrame *frame,
+                              PyObject **stack_pointer,
+                              PyThreadState *tstate);
+
+typedef struct {
+    void *memory;
+    size_t size;
+    /* One for every code unit: where to enter the compiled code to run
+       the instruction there, or NULL if it would exit straight away. */
+    _PyJITFunction entries[1];
+} _PyJITCode;
+
+/* Compile code, which must be quickened.  Return -1 if it can't be
+   compiled, without setting an exception. */
+extern int _PyJIT_Compile(PyCodeObject *code);
+extern void _PyJIT_Free(PyCodeObject *code);
+
+static inline _PyJITFunction
+_PyJIT_Entry(PyCodeObject *code, int offset)
+{
+    assert(code->_co_jit != NULL);
+    assert(0 <= offset && offset < Py_SIZE(code));
+    return ((_PyJITCode *)code->_co_jit)->entries[offset];
+}
+
+#endif  /* _Py_JIT */
+
+#ifdef __cplusplus
+}
+#endif
+#endif   /* !Py_INTERNAL_JIT_H */
@@ -78,6 +78,39 @@ static inline PyObject* _PyLong_FromUnsignedChar(unsigned char i)
     return Py_NewRef((PyObject *)&_PyLong_SMALL_INTS[_PY_NSMALLNEGINTS+i]);
 }
 
+/* Is this int of size 1, 0 or -1? */
+static inline int
+_PyLong_IsMedium(PyLongObject *op)
+{
+    return ((size_t)Py_SIZE(op)) + 1U < 3U;
+}
+
+static inline stwodigits
+_PyLong_MediumValue(PyLongObject *op)
+{
+    assert(_PyLong_IsMedium(op));
+    return ((stwodigits)Py_SIZE(op)) * op->ob_digit[0];
+}
+
+/* Store "value" in "op", an int of size 1, 0 or -1 that nothing else
+   references.  Return 0 and leave "op" alone if "value" needs more than
+   one digit or must be one of the cached small ints. */
+static inline int
+_PyLong_ReuseMedium(PyLongObject *op, stwodigits value)
+{
+    assert(PyLong_CheckExact(op));
+    assert(_PyLong_IsMedium(op));
+    if (-_PY_NSMALLNEGINTS <= value && value < _PY_NSMALLPOSINTS) {
+        return 0;
+    }
+    if (value <= -(stwodigits)PyLong_BASE || value >= (stwodigits)PyLong_BASE) {
+        return 0;
+    }
+    op->ob_digit[0] = (digit)(value < 0 ? -value : value);
+    Py_SET_SIZE(op, value < 0 ? -1 : 1);
+    return 1;
+}
+
 PyObject *_PyLong_Add(PyLongObject *left, PyLongObject *right);
 PyObject *_PyLong_Multiply(PyLongObject *left, PyLongObject *right);
 PyObject *_PyLong_Subtract(PyLongObject *left, PyLongObject *right);
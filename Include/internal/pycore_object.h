@@ -40,6 +40,9 @@ PyAPI_FUNC(void) _Py_NO_RETURN _Py_FatalRefcountErrorFunc(
 // Increment reference count by n
 static inline void _Py_RefcntAdd(PyObject* op, Py_ssize_t n)
 {
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
 #ifdef Py_REF_DEBUG
     _Py_RefTotal += n;
 #endif
@@ -50,6 +53,9 @@ static inline void _Py_RefcntAdd(PyObject* op, Py_ssize_t n)
 static inline void
 _Py_DECREF_SPECIALIZED(PyObject *op, const destructor destruct)
 {
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
     _Py_DECREF_STAT_INC();
 #ifdef Py_REF_DEBUG
     _Py_RefTotal--;
@@ -68,6 +74,9 @@ _Py_DECREF_SPECIALIZED(PyObject *op, const destructor destruct)
 static inline void
 _Py_DECREF_NO_DEALLOC(PyObject *op)
 {
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
     _Py_DECREF_STAT_INC();
 #ifdef Py_REF_DEBUG
     _Py_RefTotal--;
@@ -80,6 +89,27 @@ _Py_DECREF_NO_DEALLOC(PyObject *op)
 #endif
 }
 
+// Make op immortal: its reference count is saturated and it is never
+// deallocated.
+static inline void _Py_SetImmortal(PyObject *op)
+{
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
+#ifdef Py_REF_DEBUG
+    // The references counted so far are never released.  Statically
+    // allocated objects start at _PyObject_IMMORTAL_REFCNT, which isn't
+    // counted.
+    Py_ssize_t refcnt = op->ob_refcnt;
+    if (refcnt >= _PyObject_IMMORTAL_REFCNT) {
+        refcnt -= _PyObject_IMMORTAL_REFCNT;
+    }
+    _Py_RefTotal -= refcnt;
+#endif
+    op->ob_refcnt = _Py_SATURATED_REFCNT;
+}
+#define _Py_SetImmortal(op) _Py_SetImmortal(_PyObject_CAST(op))
+
 PyAPI_FUNC(int) _PyType_CheckConsistency(PyTypeObject *type);
 PyAPI_FUNC(int) _PyDict_CheckConsistency(PyObject *mp, int check_content);
 
@@ -23,7 +23,7 @@ static const uint32_t _PyOpcode_RelativeJump[9] = {
     536870912U,
     135118848U,
     4163U,
-    0U,
+    491520U,
     0U,
     0U,
     48U,
@@ -34,7 +34,7 @@ static const uint32_t _PyOpcode_Jump[9] = {
     536870912U,
     135118848U,
     4163U,
-    0U,
+    491520U,
     0U,
     0U,
     48U,
@@ -42,13 +42,14 @@ static const uint32_t _PyOpcode_Jump[9] = {
 
 const uint8_t _PyOpcode_Caches[256] = {
     [BINARY_SUBSCR] = 4,
-    [STORE_SUBSCR] = 1,
+    [STORE_SUBSCR] = 3,
     [UNPACK_SEQUENCE] = 1,
     [FOR_ITER] = 1,
     [STORE_ATTR] = 4,
     [LOAD_ATTR] = 9,
     [COMPARE_OP] = 2,
     [LOAD_GLOBAL] = 5,
+    [CONTAINS_OP] = 1,
     [BINARY_OP] = 1,
     [CALL] = 4,
 };
@@ -70,9 +71,12 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [BINARY_SLICE] = BINARY_SLICE,
     [BINARY_SUBSCR] = BINARY_SUBSCR,
     [BINARY_SUBSCR_ADAPTIVE] = BINARY_SUBSCR,
+    [BINARY_SUBSCR_ARRAY_INT] = BINARY_SUBSCR,
+    [BINARY_SUBSCR_BYTEARRAY_INT] = BINARY_SUBSCR,
     [BINARY_SUBSCR_DICT] = BINARY_SUBSCR,
     [BINARY_SUBSCR_GETITEM] = BINARY_SUBSCR,
     [BINARY_SUBSCR_LIST_INT] = BINARY_SUBSCR,
+    [BINARY_SUBSCR_MEMORYVIEW_INT] = BINARY_SUBSCR,
     [BINARY_SUBSCR_TUPLE_INT] = BINARY_SUBSCR,
     [BUILD_CONST_KEY_MAP] = BUILD_CONST_KEY_MAP,
     [BUILD_LIST] = BUILD_LIST,
@@ -102,6 +106,7 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [CALL_NO_KW_TYPE_1] = CALL,
     [CALL_PY_EXACT_ARGS] = CALL,
     [CALL_PY_WITH_DEFAULTS] = CALL,
+    [CALL_PY_WITH_KWARGS] = CALL,
     [CHECK_EG_MATCH] = CHECK_EG_MATCH,
     [CHECK_EXC_MATCH] = CHECK_EXC_MATCH,
     [CLEANUP_THROW] = CLEANUP_THROW,
@@ -111,6 +116,10 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [COMPARE_OP_INT_JUMP] = COMPARE_OP,
     [COMPARE_OP_STR_JUMP] = COMPARE_OP,
     [CONTAINS_OP] = CONTAINS_OP,
+    [CONTAINS_OP_ADAPTIVE] = CONTAINS_OP,
+    [CONTAINS_OP_DICT] = CONTAINS_OP,
+    [CONTAINS_OP_SET] = CONTAINS_OP,
+    [CONTAINS_OP_STR] = CONTAINS_OP,
     [COPY] = COPY,
     [COPY_FREE_VARS] = COPY_FREE_VARS,
     [DELETE_ATTR] = DELETE_ATTR,
@@ -127,8 +136,15 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [FORMAT_VALUE] = FORMAT_VALUE,
     [FOR_ITER] = FOR_ITER,
     [FOR_ITER_ADAPTIVE] = FOR_ITER,
+    [FOR_ITER_DICT_ITEMS] = FOR_ITER,
+    [FOR_ITER_DICT_KEYS] = FOR_ITER,
+    [FOR_ITER_DICT_VALUES] = FOR_ITER,
+    [FOR_ITER_ENUMERATE] = FOR_ITER,
     [FOR_ITER_LIST] = FOR_ITER,
     [FOR_ITER_RANGE] = FOR_ITER,
+    [FOR_ITER_STR] = FOR_ITER,
+    [FOR_ITER_TUPLE] = FOR_ITER,
+    [FOR_ITER_ZIP] = FOR_ITER,
     [GET_AITER] = GET_AITER,
     [GET_ANEXT] = GET_ANEXT,
     [GET_AWAITABLE] = GET_AWAITABLE,
@@ -155,6 +171,7 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [LOAD_ATTR_CLASS] = LOAD_ATTR,
     [LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN] = LOAD_ATTR,
     [LOAD_ATTR_INSTANCE_VALUE] = LOAD_ATTR,
+    [LOAD_ATTR_MEGAMORPHIC] = LOAD_ATTR,
     [LOAD_ATTR_METHOD_LAZY_DICT] = LOAD_ATTR,
     [LOAD_ATTR_METHOD_NO_DICT] = LOAD_ATTR,
     [LOAD_ATTR_METHOD_WITH_DICT] = LOAD_ATTR,
@@ -162,14 +179,19 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [LOAD_ATTR_MODULE] = LOAD_ATTR,
     [LOAD_ATTR_PROPERTY] = LOAD_ATTR,
     [LOAD_ATTR_SLOT] = LOAD_ATTR,
+    [LOAD_ATTR_SLOT_POLY] = LOAD_ATTR,
     [LOAD_ATTR_WITH_HINT] = LOAD_ATTR,
     [LOAD_BUILD_CLASS] = LOAD_BUILD_CLASS,
     [LOAD_CLASSDEREF] = LOAD_CLASSDEREF,
     [LOAD_CLOSURE] = LOAD_CLOSURE,
     [LOAD_CONST] = LOAD_CONST,
+    [LOAD_CONST_BORROW] = LOAD_CONST_BORROW,
     [LOAD_CONST__LOAD_FAST] = LOAD_CONST,
     [LOAD_DEREF] = LOAD_DEREF,
     [LOAD_FAST] = LOAD_FAST,
+    [LOAD_FAST_BORROW] = LOAD_FAST_BORROW,
+    [LOAD_FAST_BORROW__LOAD_CONST_BORROW] = LOAD_FAST_BORROW,
+    [LOAD_FAST_BORROW__LOAD_FAST_BORROW] = LOAD_FAST_BORROW,
     [LOAD_FAST_CHECK] = LOAD_FAST_CHECK,
     [LOAD_FAST__LOAD_CONST] = LOAD_FAST,
     [LOAD_FAST__LOAD_FAST] = LOAD_FAST,
@@ -188,9 +210,13 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [NOP] = NOP,
     [POP_EXCEPT] = POP_EXCEPT,
     [POP_JUMP_IF_FALSE] = POP_JUMP_IF_FALSE,
+    [POP_JUMP_IF_FALSE_BORROW] = POP_JUMP_IF_FALSE_BORROW,
     [POP_JUMP_IF_NONE] = POP_JUMP_IF_NONE,
+    [POP_JUMP_IF_NONE_BORROW] = POP_JUMP_IF_NONE_BORROW,
+    [POP_JUMP_IF_NOTNONE_BORROW] = POP_JUMP_IF_NOTNONE_BORROW,
     [POP_JUMP_IF_NOT_NONE] = POP_JUMP_IF_NOT_NONE,
     [POP_JUMP_IF_TRUE] = POP_JUMP_IF_TRUE,
+    [POP_JUMP_IF_TRUE_BORROW] = POP_JUMP_IF_TRUE_BORROW,
     [POP_TOP] = POP_TOP,
     [PREP_RERAISE_STAR] = PREP_RERAISE_STAR,
     [PRINT_EXPR] = PRINT_EXPR,
@@ -210,6 +236,7 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [STORE_ATTR_ADAPTIVE] = STORE_ATTR,
     [STORE_ATTR_INSTANCE_VALUE] = STORE_ATTR,
     [STORE_ATTR_SLOT] = STORE_ATTR,
+    [STORE_ATTR_SLOT_POLY] = STORE_ATTR,
     [STORE_ATTR_WITH_HINT] = STORE_ATTR,
     [STORE_DEREF] = STORE_DEREF,
     [STORE_FAST] = STORE_FAST,
@@ -220,8 +247,11 @@ const uint8_t _PyOpcode_Deopt[256] = {
     [STORE_SLICE] = STORE_SLICE,
     [STORE_SUBSCR] = STORE_SUBSCR,
     [STORE_SUBSCR_ADAPTIVE] = STORE_SUBSCR,
+    [STORE_SUBSCR_ARRAY_INT] = STORE_SUBSCR,
+    [STORE_SUBSCR_BYTEARRAY_INT] = STORE_SUBSCR,
     [STORE_SUBSCR_DICT] = STORE_SUBSCR,
     [STORE_SUBSCR_LIST_INT] = STORE_SUBSCR,
+    [STORE_SUBSCR_MEMORYVIEW_INT] = STORE_SUBSCR,
     [SWAP] = SWAP,
     [UNARY_INVERT] = UNARY_INVERT,
     [UNARY_NEGATIVE] = UNARY_NEGATIVE,
@@ -258,26 +288,30 @@ static const char *const _PyOpcode_OpName[263] = {
     [UNARY_INVERT] = "UNARY_INVERT",
     [BINARY_OP_SUBTRACT_INT] = "BINARY_OP_SUBTRACT_INT",
     [BINARY_SUBSCR_ADAPTIVE] = "BINARY_SUBSCR_ADAPTIVE",
+    [BINARY_SUBSCR_ARRAY_INT] = "BINARY_SUBSCR_ARRAY_INT",
+    [BINARY_SUBSCR_BYTEARRAY_INT] = "BINARY_SUBSCR_BYTEARRAY_INT",
     [BINARY_SUBSCR_DICT] = "BINARY_SUBSCR_DICT",
     [BINARY_SUBSCR_GETITEM] = "BINARY_SUBSCR_GETITEM",
     [BINARY_SUBSCR_LIST_INT] = "BINARY_SUBSCR_LIST_INT",
+    [BINARY_SUBSCR_MEMORYVIEW_INT] = "BINARY_SUBSCR_MEMORYVIEW_INT",
     [BINARY_SUBSCR_TUPLE_INT] = "BINARY_SUBSCR_TUPLE_INT",
-    [CALL_ADAPTIVE] = "CALL_ADAPTIVE",
-    [CALL_PY_EXACT_ARGS] = "CALL_PY_EXACT_ARGS",
-    [CALL_PY_WITH_DEFAULTS] = "CALL_PY_WITH_DEFAULTS",
     [BINARY_SUBSCR] = "BINARY_SUBSCR",
     [BINARY_SLICE] = "BINARY_SLICE",
     [STORE_SLICE] = "STORE_SLICE",
-    [CALL_BOUND_METHOD_EXACT_ARGS] = "CALL_BOUND_METHOD_EXACT_ARGS",
-    [CALL_BUILTIN_CLASS] = "CALL_BUILTIN_CLASS",
+    [CALL_ADAPTIVE] = "CALL_ADAPTIVE",
+    [CALL_PY_EXACT_ARGS] = "CALL_PY_EXACT_ARGS",
     [GET_LEN] = "GET_LEN",
     [MATCH_MAPPING] = "MATCH_MAPPING",
     [MATCH_SEQUENCE] = "MATCH_SEQUENCE",
     [MATCH_KEYS] = "MATCH_KEYS",
-    [CALL_BUILTIN_FAST_WITH_KEYWORDS] = "CALL_BUILTIN_FAST_WITH_KEYWORDS",
+    [CALL_PY_WITH_DEFAULTS] = "CALL_PY_WITH_DEFAULTS",
     [PUSH_EXC_INFO] = "PUSH_EXC_INFO",
     [CHECK_EXC_MATCH] = "CHECK_EXC_MATCH",
     [CHECK_EG_MATCH] = "CHECK_EG_MATCH",
+    [CALL_PY_WITH_KWARGS] = "CALL_PY_WITH_KWARGS",
+    [CALL_BOUND_METHOD_EXACT_ARGS] = "CALL_BOUND_METHOD_EXACT_ARGS",
+    [CALL_BUILTIN_CLASS] = "CALL_BUILTIN_CLASS",
+    [CALL_BUILTIN_FAST_WITH_KEYWORDS] = "CALL_BUILTIN_FAST_WITH_KEYWORDS",
     [CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS] = "CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS",
     [CALL_NO_KW_BUILTIN_FAST] = "CALL_NO_KW_BUILTIN_FAST",
     [CALL_NO_KW_BUILTIN_O] = "CALL_NO_KW_BUILTIN_O",
@@ -285,10 +319,6 @@ static const char *const _PyOpcode_OpName[263] = {
     [CALL_NO_KW_LEN] = "CALL_NO_KW_LEN",
     [CALL_NO_KW_LIST_APPEND] = "CALL_NO_KW_LIST_APPEND",
     [CALL_NO_KW_METHOD_DESCRIPTOR_FAST] = "CALL_NO_KW_METHOD_DESCRIPTOR_FAST",
-    [CALL_NO_KW_METHOD_DESCRIPTOR_NOARGS] = "CALL_NO_KW_METHOD_DESCRIPTOR_NOARGS",
-    [CALL_NO_KW_METHOD_DESCRIPTOR_O] = "CALL_NO_KW_METHOD_DESCRIPTOR_O",
-    [CALL_NO_KW_STR_1] = "CALL_NO_KW_STR_1",
-    [CALL_NO_KW_TUPLE_1] = "CALL_NO_KW_TUPLE_1",
     [WITH_EXCEPT_START] = "WITH_EXCEPT_START",
     [GET_AITER] = "GET_AITER",
     [GET_ANEXT] = "GET_ANEXT",
@@ -296,37 +326,37 @@ static const char *const _PyOpcode_OpName[263] = {
     [BEFORE_WITH] = "BEFORE_WITH",
     [END_ASYNC_FOR] = "END_ASYNC_FOR",
     [CLEANUP_THROW] = "CLEANUP_THROW",
+    [CALL_NO_KW_METHOD_DESCRIPTOR_NOARGS] = "CALL_NO_KW_METHOD_DESCRIPTOR_NOARGS",
+    [CALL_NO_KW_METHOD_DESCRIPTOR_O] = "CALL_NO_KW_METHOD_DESCRIPTOR_O",
+    [CALL_NO_KW_STR_1] = "CALL_NO_KW_STR_1",
+    [CALL_NO_KW_TUPLE_1] = "CALL_NO_KW_TUPLE_1",
+    [STORE_SUBSCR] = "STORE_SUBSCR",
+    [DELETE_SUBSCR] = "DELETE_SUBSCR",
     [CALL_NO_KW_TYPE_1] = "CALL_NO_KW_TYPE_1",
     [COMPARE_OP_ADAPTIVE] = "COMPARE_OP_ADAPTIVE",
     [COMPARE_OP_FLOAT_JUMP] = "COMPARE_OP_FLOAT_JUMP",
     [COMPARE_OP_INT_JUMP] = "COMPARE_OP_INT_JUMP",
-    [STORE_SUBSCR] = "STORE_SUBSCR",
-    [DELETE_SUBSCR] = "DELETE_SUBSCR",
     [COMPARE_OP_STR_JUMP] = "COMPARE_OP_STR_JUMP",
-    [EXTENDED_ARG_QUICK] = "EXTENDED_ARG_QUICK",
-    [FOR_ITER_ADAPTIVE] = "FOR_ITER_ADAPTIVE",
-    [FOR_ITER_LIST] = "FOR_ITER_LIST",
-    [FOR_ITER_RANGE] = "FOR_ITER_RANGE",
-    [JUMP_BACKWARD_QUICK] = "JUMP_BACKWARD_QUICK",
+    [CONTAINS_OP_ADAPTIVE] = "CONTAINS_OP_ADAPTIVE",
     [GET_ITER] = "GET_ITER",
     [GET_YIELD_FROM_ITER] = "GET_YIELD_FROM_ITER",
     [PRINT_EXPR] = "PRINT_EXPR",
     [LOAD_BUILD_CLASS] = "LOAD_BUILD_CLASS",
-    [LOAD_ATTR_ADAPTIVE] = "LOAD_ATTR_ADAPTIVE",
-    [LOAD_ATTR_CLASS] = "LOAD_ATTR_CLASS",
+    [CONTAINS_OP_DICT] = "CONTAINS_OP_DICT",
+    [CONTAINS_OP_SET] = "CONTAINS_OP_SET",
     [LOAD_ASSERTION_ERROR] = "LOAD_ASSERTION_ERROR",
     [RETURN_GENERATOR] = "RETURN_GENERATOR",
-    [LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN] = "LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN",
-    [LOAD_ATTR_INSTANCE_VALUE] = "LOAD_ATTR_INSTANCE_VALUE",
-    [LOAD_ATTR_MODULE] = "LOAD_ATTR_MODULE",
-    [LOAD_ATTR_PROPERTY] = "LOAD_ATTR_PROPERTY",
-    [LOAD_ATTR_SLOT] = "LOAD_ATTR_SLOT",
-    [LOAD_ATTR_WITH_HINT] = "LOAD_ATTR_WITH_HINT",
+    [CONTAINS_OP_STR] = "CONTAINS_OP_STR",
+    [EXTENDED_ARG_QUICK] = "EXTENDED_ARG_QUICK",
+    [FOR_ITER_ADAPTIVE] = "FOR_ITER_ADAPTIVE",
+    [FOR_ITER_DICT_ITEMS] = "FOR_ITER_DICT_ITEMS",
+    [FOR_ITER_DICT_KEYS] = "FOR_ITER_DICT_KEYS",
+    [FOR_ITER_DICT_VALUES] = "FOR_ITER_DICT_VALUES",
     [LIST_TO_TUPLE] = "LIST_TO_TUPLE",
     [RETURN_VALUE] = "RETURN_VALUE",
     [IMPORT_STAR] = "IMPORT_STAR",
     [SETUP_ANNOTATIONS] = "SETUP_ANNOTATIONS",
-    [LOAD_ATTR_METHOD_LAZY_DICT] = "LOAD_ATTR_METHOD_LAZY_DICT",
+    [FOR_ITER_ENUMERATE] = "FOR_ITER_ENUMERATE",
     [ASYNC_GEN_WRAP] = "ASYNC_GEN_WRAP",
     [PREP_RERAISE_STAR] = "PREP_RERAISE_STAR",
     [POP_EXCEPT] = "POP_EXCEPT",
@@ -353,7 +383,7 @@ static const char *const _PyOpcode_OpName[263] = {
     [JUMP_FORWARD] = "JUMP_FORWARD",
     [JUMP_IF_FALSE_OR_POP] = "JUMP_IF_FALSE_OR_POP",
     [JUMP_IF_TRUE_OR_POP] = "JUMP_IF_TRUE_OR_POP",
-    [LOAD_ATTR_METHOD_NO_DICT] = "LOAD_ATTR_METHOD_NO_DICT",
+    [FOR_ITER_LIST] = "FOR_ITER_LIST",
     [POP_JUMP_IF_FALSE] = "POP_JUMP_IF_FALSE",
     [POP_JUMP_IF_TRUE] = "POP_JUMP_IF_TRUE",
     [LOAD_GLOBAL] = "LOAD_GLOBAL",
@@ -361,7 +391,7 @@ static const char *const _PyOpcode_OpName[263] = {
     [CONTAINS_OP] = "CONTAINS_OP",
     [RERAISE] = "RERAISE",
     [COPY] = "COPY",
-    [LOAD_ATTR_METHOD_WITH_DICT] = "LOAD_ATTR_METHOD_WITH_DICT",
+    [FOR_ITER_RANGE] = "FOR_ITER_RANGE",
     [BINARY_OP] = "BINARY_OP",
     [SEND] = "SEND",
     [LOAD_FAST] = "LOAD_FAST",
@@ -381,9 +411,9 @@ static const char *const _PyOpcode_OpName[263] = {
     [STORE_DEREF] = "STORE_DEREF",
     [DELETE_DEREF] = "DELETE_DEREF",
     [JUMP_BACKWARD] = "JUMP_BACKWARD",
-    [LOAD_ATTR_METHOD_WITH_VALUES] = "LOAD_ATTR_METHOD_WITH_VALUES",
+    [FOR_ITER_STR] = "FOR_ITER_STR",
     [CALL_FUNCTION_EX] = "CALL_FUNCTION_EX",
-    [LOAD_CONST__LOAD_FAST] = "LOAD_CONST__LOAD_FAST",
+    [FOR_ITER_TUPLE] = "FOR_ITER_TUPLE",
     [EXTENDED_ARG] = "EXTENDED_ARG",
     [LIST_APPEND] = "LIST_APPEND",
     [SET_ADD] = "SET_ADD",
@@ -393,63 +423,63 @@ static const char *const _PyOpcode_OpName[263] = {
     [YIELD_VALUE] = "YIELD_VALUE",
     [RESUME] = "RESUME",
     [MATCH_CLASS] = "MATCH_CLASS",
-    [LOAD_FAST__LOAD_CONST] = "LOAD_FAST__LOAD_CONST",
-    [LOAD_FAST__LOAD_FAST] = "LOAD_FAST__LOAD_FAST",
+    [FOR_ITER_ZIP] = "FOR_ITER_ZIP",
+    [JUMP_BACKWARD_QUICK] = "JUMP_BACKWARD_QUICK",
     [FORMAT_VALUE] = "FORMAT_VALUE",
     [BUILD_CONST_KEY_MAP] = "BUILD_CONST_KEY_MAP",
     [BUILD_STRING] = "BUILD_STRING",
-    [LOAD_GLOBAL_ADAPTIVE] = "LOAD_GLOBAL_ADAPTIVE",
-    [LOAD_GLOBAL_BUILTIN] = "LOAD_GLOBAL_BUILTIN",
-    [LOAD_GLOBAL_MODULE] = "LOAD_GLOBAL_MODULE",
-    [RESUME_QUICK] = "RESUME_QUICK",
+    [LOAD_ATTR_ADAPTIVE] = "LOAD_ATTR_ADAPTIVE",
+    [LOAD_ATTR_CLASS] = "LOAD_ATTR_CLASS",
+    [LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN] = "LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN",
+    [LOAD_ATTR_INSTANCE_VALUE] = "LOAD_ATTR_INSTANCE_VALUE",
     [LIST_EXTEND] = "LIST_EXTEND",
     [SET_UPDATE] = "SET_UPDATE",
     [DICT_MERGE] = "DICT_MERGE",
     [DICT_UPDATE] = "DICT_UPDATE",
+    [LOAD_ATTR_MEGAMORPHIC] = "LOAD_ATTR_MEGAMORPHIC",
+    [LOAD_ATTR_MODULE] = "LOAD_ATTR_MODULE",
+    [LOAD_ATTR_PROPERTY] = "LOAD_ATTR_PROPERTY",
+    [LOAD_ATTR_SLOT] = "LOAD_ATTR_SLOT",
+    [LOAD_ATTR_SLOT_POLY] = "LOAD_ATTR_SLOT_POLY",
+    [CALL] = "CALL",
+    [KW_NAMES] = "KW_NAMES",
+    [LOAD_FAST_BORROW] = "LOAD_FAST_BORROW",
+    [LOAD_CONST_BORROW] = "LOAD_CONST_BORROW",
+    [POP_JUMP_IF_FALSE_BORROW] = "POP_JUMP_IF_FALSE_BORROW",
+    [POP_JUMP_IF_TRUE_BORROW] = "POP_JUMP_IF_TRUE_BORROW",
+    [POP_JUMP_IF_NOTNONE_BORROW] = "POP_JUMP_IF_NOTNONE_BORROW",
+    [POP_JUMP_IF_NONE_BORROW] = "POP_JUMP_IF_NONE_BORROW",
+    [LOAD_ATTR_WITH_HINT] = "LOAD_ATTR_WITH_HINT",
+    [LOAD_ATTR_METHOD_LAZY_DICT] = "LOAD_ATTR_METHOD_LAZY_DICT",
+    [LOAD_ATTR_METHOD_NO_DICT] = "LOAD_ATTR_METHOD_NO_DICT",
+    [LOAD_ATTR_METHOD_WITH_DICT] = "LOAD_ATTR_METHOD_WITH_DICT",
+    [LOAD_ATTR_METHOD_WITH_VALUES] = "LOAD_ATTR_METHOD_WITH_VALUES",
+    [LOAD_CONST__LOAD_FAST] = "LOAD_CONST__LOAD_FAST",
+    [LOAD_FAST__LOAD_CONST] = "LOAD_FAST__LOAD_CONST",
+    [LOAD_FAST__LOAD_FAST] = "LOAD_FAST__LOAD_FAST",
+    [LOAD_FAST_BORROW__LOAD_CONST_BORROW] = "LOAD_FAST_BORROW__LOAD_CONST_BORROW",
+    [LOAD_FAST_BORROW__LOAD_FAST_BORROW] = "LOAD_FAST_BORROW__LOAD_FAST_BORROW",
+    [LOAD_GLOBAL_ADAPTIVE] = "LOAD_GLOBAL_ADAPTIVE",
+    [LOAD_GLOBAL_BUILTIN] = "LOAD_GLOBAL_BUILTIN",
+    [LOAD_GLOBAL_MODULE] = "LOAD_GLOBAL_MODULE",
+    [RESUME_QUICK] = "RESUME_QUICK",
     [STORE_ATTR_ADAPTIVE] = "STORE_ATTR_ADAPTIVE",
     [STORE_ATTR_INSTANCE_VALUE] = "STORE_ATTR_INSTANCE_VALUE",
     [STORE_ATTR_SLOT] = "STORE_ATTR_SLOT",
+    [STORE_ATTR_SLOT_POLY] = "STORE_ATTR_SLOT_POLY",
     [STORE_ATTR_WITH_HINT] = "STORE_ATTR_WITH_HINT",
     [STORE_FAST__LOAD_FAST] = "STORE_FAST__LOAD_FAST",
-    [CALL] = "CALL",
-    [KW_NAMES] = "KW_NAMES",
     [STORE_FAST__STORE_FAST] = "STORE_FAST__STORE_FAST",
     [STORE_SUBSCR_ADAPTIVE] = "STORE_SUBSCR_ADAPTIVE",
+    [STORE_SUBSCR_ARRAY_INT] = "STORE_SUBSCR_ARRAY_INT",
+    [STORE_SUBSCR_BYTEARRAY_INT] = "STORE_SUBSCR_BYTEARRAY_INT",
     [STORE_SUBSCR_DICT] = "STORE_SUBSCR_DICT",
     [STORE_SUBSCR_LIST_INT] = "STORE_SUBSCR_LIST_INT",
+    [STORE_SUBSCR_MEMORYVIEW_INT] = "STORE_SUBSCR_MEMORYVIEW_INT",
     [UNPACK_SEQUENCE_ADAPTIVE] = "UNPACK_SEQUENCE_ADAPTIVE",
     [UNPACK_SEQUENCE_LIST] = "UNPACK_SEQUENCE_LIST",
     [UNPACK_SEQUENCE_TUPLE] = "UNPACK_SEQUENCE_TUPLE",
     [UNPACK_SEQUENCE_TWO_TUPLE] = "UNPACK_SEQUENCE_TWO_TUPLE",
-    [181] = "<181>",
-    [182] = "<182>",
-    [183] = "<183>",
-    [184] = "<184>",
-    [185] = "<185>",
-    [186] = "<186>",
-    [187] = "<187>",
-    [188] = "<188>",
-    [189] = "<189>",
-    [190] = "<190>",
-    [191] = "<191>",
-    [192] = "<192>",
-    [193] = "<193>",
-    [194] = "<194>",
-    [195] = "<195>",
-    [196] = "<196>",
-    [197] = "<197>",
-    [198] = "<198>",
-    [199] = "<199>",
-    [200] = "<200>",
-    [201] = "<201>",
-    [202] = "<202>",
-    [203] = "<203>",
-    [204] = "<204>",
-    [205] = "<205>",
-    [206] = "<206>",
-    [207] = "<207>",
-    [208] = "<208>",
-    [209] = "<209>",
     [210] = "<210>",
     [211] = "<211>",
     [212] = "<212>",
@@ -507,35 +537,6 @@ static const char *const _PyOpcode_OpName[263] = {
 #endif
 
 #define EXTRA_CASES \
-    case 181: \
-    case 182: \
-    case 183: \
-    case 184: \
-    case 185: \
-    case 186: \
-    case 187: \
-    case 188: \
-    case 189: \
-    case 190: \
-    case 191: \
-    case 192: \
-    case 193: \
-    case 194: \
-    case 195: \
-    case 196: \
-    case 197: \
-    case 198: \
-    case 199: \
-    case 200: \
-    case 201: \
-    case 202: \
-    case 203: \
-    case 204: \
-    case 205: \
-    case 206: \
-    case 207: \
-    case 208: \
-    case 209: \
     case 210: \
     case 211: \
     case 212: \
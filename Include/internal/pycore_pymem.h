@@ -102,6 +102,16 @@ void _PyObject_VirtualFree(void *, size_t size);
 /* This function returns the number of allocated memory blocks, regardless of size */
 PyAPI_FUNC(Py_ssize_t) _Py_GetAllocatedBlocks(void);
 
+/* Give interp pymalloc pools and arenas of its own */
+extern int _PyObject_InitState(PyInterpreterState *interp);
+extern void _PyObject_FiniState(PyInterpreterState *interp);
+/* Return the blocks cached by tstate to pymalloc */
+extern void _PyObject_ClearThreadCache(PyThreadState *tstate);
+/* Return the free memory of the arenas of the current interpreter to the
+   system and steer the allocations away from the sparsest arenas.
+   Return the number of bytes given back. */
+extern size_t _PyObject_TrimArenas(void);
+
 /* Macros */
 #ifdef WITH_PYMALLOC
 // Export the symbol for the 3rd party guppy3 project
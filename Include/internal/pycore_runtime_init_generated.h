@@ -903,6 +903,7 @@ extern "C" {
                 INIT_ID(id), \
                 INIT_ID(ignore), \
                 INIT_ID(imag), \
+                INIT_ID(immortalize), \
                 INIT_ID(importlib), \
                 INIT_ID(in_fd), \
                 INIT_ID(incoming), \
@@ -1121,6 +1122,7 @@ extern "C" {
                 INIT_ID(term), \
                 INIT_ID(text), \
                 INIT_ID(threading), \
+                INIT_ID(threads), \
                 INIT_ID(throw), \
                 INIT_ID(timeout), \
                 INIT_ID(times), \
@@ -2112,6 +2114,8 @@ _PyUnicode_InitStaticStrings(void) {
     PyUnicode_InternInPlace(&string);
     string = &_Py_ID(imag);
     PyUnicode_InternInPlace(&string);
+    string = &_Py_ID(immortalize);
+    PyUnicode_InternInPlace(&string);
     string = &_Py_ID(importlib);
     PyUnicode_InternInPlace(&string);
     string = &_Py_ID(in_fd);
@@ -2548,6 +2552,8 @@ _PyUnicode_InitStaticStrings(void) {
     PyUnicode_InternInPlace(&string);
     string = &_Py_ID(threading);
     PyUnicode_InternInPlace(&string);
+    string = &_Py_ID(threads);
+    PyUnicode_InternInPlace(&string);
     string = &_Py_ID(throw);
     PyUnicode_InternInPlace(&string);
     string = &_Py_ID(timeout);
@@ -6151,6 +6157,10 @@ _PyStaticObjects_CheckRefcnt(void) {
         _PyObject_Dump((PyObject *)&_Py_ID(imag));
         Py_FatalError("immortal object has less refcnt than expected _PyObject_IMMORTAL_REFCNT");
     };
+    if (Py_REFCNT((PyObject *)&_Py_ID(immortalize)) < _PyObject_IMMORTAL_REFCNT) {
+        _PyObject_Dump((PyObject *)&_Py_ID(immortalize));
+        Py_FatalError("immortal object has less refcnt than expected _PyObject_IMMORTAL_REFCNT");
+    };
     if (Py_REFCNT((PyObject *)&_Py_ID(importlib)) < _PyObject_IMMORTAL_REFCNT) {
         _PyObject_Dump((PyObject *)&_Py_ID(importlib));
         Py_FatalError("immortal object has less refcnt than expected _PyObject_IMMORTAL_REFCNT");
@@ -7023,6 +7033,10 @@ _PyStaticObjects_CheckRefcnt(void) {
         _PyObject_Dump((PyObject *)&_Py_ID(threading));
         Py_FatalError("immortal object has less refcnt than expected _PyObject_IMMORTAL_REFCNT");
     };
+    if (Py_REFCNT((PyObject *)&_Py_ID(threads)) < _PyObject_IMMORTAL_REFCNT) {
+        _PyObject_Dump((PyObject *)&_Py_ID(threads));
+        Py_FatalError("immortal object has less refcnt than expected _PyObject_IMMORTAL_REFCNT");
+    };
     if (Py_REFCNT((PyObject *)&_Py_ID(throw)) < _PyObject_IMMORTAL_REFCNT) {
         _PyObject_Dump((PyObject *)&_Py_ID(throw));
         Py_FatalError("immortal object has less refcnt than expected _PyObject_IMMORTAL_REFCNT");
@@ -38,6 +38,65 @@ struct type_cache {
 #endif
 };
 
+// Megamorphic attribute cache: remembers how LOAD_ATTR can read an
+// attribute from instances of a type, for call sites that have seen too
+// many types, or keep failing to specialize or being deoptimized. Entries
+// are keyed by (tp_version_tag, name) and filled by _PyMegaAttrCache_Fill()
+// in Python/specialize.c.
+enum {
+    MEGA_ATTR_GENERIC = 0,    // use the generic lookup
+    MEGA_ATTR_SLOT,           // object slot at byte offset "index"
+    MEGA_ATTR_INSTANCE_VALUE, // managed dict value at "index"
+    MEGA_ATTR_METHOD,         // method "descr" on an instance without dict
+    MEGA_ATTR_METHOD_WITH_VALUES, // method "descr", not shadowed in the
+                                  // managed dict keys of "keys_version"
+};
+
+struct mega_attr_cache_entry {
+    unsigned int version;  // initialized from type->tp_version_tag
+    uint16_t kind;
+    uint16_t index;
+    uint32_t keys_version;
+    PyObject *name;        // reference to exactly a str or None
+    PyObject *descr;       // borrowed reference or NULL
+};
+
+#define MEGA_ATTR_CACHE_SIZE_EXP 10
+
+struct mega_attr_cache {
+    struct mega_attr_cache_entry hashtable[1 << MEGA_ATTR_CACHE_SIZE_EXP];
+};
+
+static inline struct mega_attr_cache_entry *
+_PyMegaAttrCache_Entry(struct mega_attr_cache *cache,
+                       unsigned int version, PyObject *name)
+{
+    unsigned int h = (version ^ (unsigned int)(((uintptr_t)name) >> 3))
+                     & ((1 << MEGA_ATTR_CACHE_SIZE_EXP) - 1);
+    return &cache->hashtable[h];
+}
+
+// Polymorphic slot caches: the (type version, slot offset) pairs seen by
+// a LOAD_ATTR_SLOT_POLY or STORE_ATTR_SLOT_POLY instruction. They are kept
+// out of the inline cache so that the other attribute sites don't pay for
+// them; the "index" of the inline cache holds the number of the entry.
+// Entries are handed out round-robin and remember the instruction that
+// owns them, so a site whose entry was taken over by another one misses.
+#define ATTR_POLY_CACHE_SIZE 4
+#define ATTR_POLY_CACHES_SIZE_EXP 10
+
+struct attr_poly_cache_entry {
+    _Py_CODEUNIT *site;    // the owning instruction, or NULL
+    uint32_t versions[ATTR_POLY_CACHE_SIZE];  // 0 if unused
+    uint16_t offsets[ATTR_POLY_CACHE_SIZE];
+};
+
+struct attr_poly_caches {
+    struct attr_poly_cache_entry entries[1 << ATTR_POLY_CACHES_SIZE_EXP];
+    unsigned int next;     // the entry to hand out next
+    size_t handed_out;     // number of entries handed out, for the tests
+};
+
 /* For now we hard-code this to a value for which we are confident
    all the static builtin types will fit (for all builds). */
 #define _Py_MAX_STATIC_BUILTIN_TYPES 200
@@ -59,10 +118,38 @@ _PyStaticType_GET_WEAKREFS_LISTPTR(static_builtin_state *state)
     return &state->tp_weaklist;
 }
 
+// Object caches: free lists of the instances of the types with the
+// Py_TPFLAGS_OBJECT_CACHE flag, see _PyType_SetObjectCacheSize().
+#ifndef WITH_FREELISTS
+// without freelists
+#  define _Py_OBJECT_CACHE_DEFAULT_SIZE 0
+#endif
+
+#ifndef _Py_OBJECT_CACHE_DEFAULT_SIZE
+#  define _Py_OBJECT_CACHE_DEFAULT_SIZE 100
+#endif
+
+#define _Py_MAX_OBJECT_CACHES 64
+
+struct _Py_object_cache {
+    PyTypeObject *type;    // borrowed reference
+    /* Memory blocks of freed instances, including their pre-header,
+       linked through their first word */
+    void *free_list;
+    Py_ssize_t numfree;
+    Py_ssize_t maxfree;
+    Py_ssize_t hits;
+    Py_ssize_t misses;
+};
+
 struct types_state {
     struct type_cache type_cache;
+    struct mega_attr_cache mega_attr_cache;
+    struct attr_poly_caches attr_poly_caches;
     size_t num_builtins_initialized;
     static_builtin_state builtins[_Py_MAX_STATIC_BUILTIN_TYPES];
+    int num_object_caches;
+    struct _Py_object_cache object_caches[_Py_MAX_OBJECT_CACHES];
 };
 
 
@@ -71,6 +158,8 @@ extern static_builtin_state * _PyStaticType_GetState(PyTypeObject *);
 extern void _PyStaticType_ClearWeakRefs(PyTypeObject *type);
 extern void _PyStaticType_Dealloc(PyTypeObject *type);
 
+extern PyObject * _PyType_GetObjectCacheStats(PyInterpreterState *interp);
+
 
 PyObject *_Py_slot_tp_getattro(PyObject *self, PyObject *name);
 PyObject *_Py_slot_tp_getattr_hook(PyObject *self, PyObject *name);
@@ -24,6 +24,12 @@ extern PyTypeObject _PyUnicodeASCIIIter_Type;
 
 /* other API */
 
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t it_index;
+    PyObject *it_seq;    /* Set to NULL when iterator is exhausted */
+} _PyUnicodeIterObject;
+
 struct _Py_unicode_runtime_ids {
     PyThread_type_lock lock;
     // next_index value must be preserved when Py_Initialize()/Py_Finalize()
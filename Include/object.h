@@ -360,6 +360,12 @@ given type object has a specified feature.
 /* Track types initialized using _PyStaticType_InitBuiltin(). */
 #define _Py_TPFLAGS_STATIC_BUILTIN (1 << 1)
 
+/* Instances are recycled through a per-interpreter free list: the type
+ * must be fixed-size and allocate its instances with the default tp_alloc
+ * and tp_free, which are replaced by PyType_Ready().
+ */
+#define Py_TPFLAGS_OBJECT_CACHE (1 << 2)
+
 /* Placement of weakref pointers are managed by the VM, not by the type.
  * The VM will automatically set tp_weaklistoffset.
  */
@@ -425,6 +431,10 @@ given type object has a specified feature.
 /* Type is abstract and cannot be instantiated */
 #define Py_TPFLAGS_IS_ABSTRACT (1UL << 20)
 
+// This undocumented flag marks array.array, whose items the specializing
+// interpreter accesses directly.  It is not inherited by subclasses.
+#define _Py_TPFLAGS_ARRAY (1UL << 21)
+
 // This undocumented flag gives certain built-ins their unique pattern-matching
 // behavior, which allows a single positional subpattern to match against the
 // subject itself (rather than a mapped attribute on it):
@@ -509,12 +519,32 @@ PyAPI_FUNC(void) Py_DecRef(PyObject *);
 PyAPI_FUNC(void) _Py_IncRef(PyObject *);
 PyAPI_FUNC(void) _Py_DecRef(PyObject *);
 
+/* Immortal objects have a saturated reference count: Py_INCREF() and
+   Py_DECREF() leave it unchanged, so that the memory of these objects is
+   never written to by reference counting (see gc.freeze()).  Any reference
+   count above _Py_SATURATED_REFCNT_MIN is saturated, which tolerates the
+   changes made by extensions built against older headers.  Immortal objects
+   are never deallocated. */
+#define _Py_SATURATED_REFCNT \
+    ((Py_ssize_t)3 << (8 * SIZEOF_SIZE_T - 6))
+#define _Py_SATURATED_REFCNT_MIN \
+    ((Py_ssize_t)1 << (8 * SIZEOF_SIZE_T - 5))
+
+static inline int _Py_IsImmortal(PyObject *op)
+{
+    return op->ob_refcnt >= _Py_SATURATED_REFCNT_MIN;
+}
+#define _Py_IsImmortal(op) _Py_IsImmortal(_PyObject_CAST(op))
+
 static inline void Py_INCREF(PyObject *op)
 {
 #if defined(Py_REF_DEBUG) && defined(Py_LIMITED_API) && Py_LIMITED_API+0 >= 0x030A0000
     // Stable ABI for Python 3.10 built in debug mode.
     _Py_IncRef(op);
 #else
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
     _Py_INCREF_STAT_INC();
     // Non-limited C API and limited C API for Python 3.9 and older access
     // directly PyObject.ob_refcnt.
@@ -538,6 +568,9 @@ static inline void Py_DECREF(PyObject *op) {
 #elif defined(Py_REF_DEBUG)
 static inline void Py_DECREF(const char *filename, int lineno, PyObject *op)
 {
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
     _Py_DECREF_STAT_INC();
     _Py_RefTotal--;
     if (--op->ob_refcnt != 0) {
@@ -554,6 +587,9 @@ static inline void Py_DECREF(const char *filename, int lineno, PyObject *op)
 #else
 static inline void Py_DECREF(PyObject *op)
 {
+    if (_Py_IsImmortal(op)) {
+        return;
+    }
     _Py_DECREF_STAT_INC();
     // Non-limited C API and limited C API for Python 3.9 and older access
     // directly PyObject.ob_refcnt.
@@ -117,6 +117,12 @@ extern "C" {
 #define DICT_UPDATE                            165
 #define CALL                                   171
 #define KW_NAMES                               172
+#define LOAD_FAST_BORROW                       173
+#define LOAD_CONST_BORROW                      174
+#define POP_JUMP_IF_FALSE_BORROW               175
+#define POP_JUMP_IF_TRUE_BORROW                176
+#define POP_JUMP_IF_NOTNONE_BORROW             177
+#define POP_JUMP_IF_NONE_BORROW                178
 #define MIN_PSEUDO_OPCODE                      256
 #define SETUP_FINALLY                          256
 #define SETUP_CLEANUP                          257
@@ -136,69 +142,92 @@ extern "C" {
 #define BINARY_OP_SUBTRACT_FLOAT                14
 #define BINARY_OP_SUBTRACT_INT                  16
 #define BINARY_SUBSCR_ADAPTIVE                  17
-#define BINARY_SUBSCR_DICT                      18
-#define BINARY_SUBSCR_GETITEM                   19
-#define BINARY_SUBSCR_LIST_INT                  20
-#define BINARY_SUBSCR_TUPLE_INT                 21
-#define CALL_ADAPTIVE                           22
-#define CALL_PY_EXACT_ARGS                      23
-#define CALL_PY_WITH_DEFAULTS                   24
-#define CALL_BOUND_METHOD_EXACT_ARGS            28
-#define CALL_BUILTIN_CLASS                      29
-#define CALL_BUILTIN_FAST_WITH_KEYWORDS         34
-#define CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS  38
-#define CALL_NO_KW_BUILTIN_FAST                 39
-#define CALL_NO_KW_BUILTIN_O                    40
-#define CALL_NO_KW_ISINSTANCE                   41
-#define CALL_NO_KW_LEN                          42
-#define CALL_NO_KW_LIST_APPEND                  43
-#define CALL_NO_KW_METHOD_DESCRIPTOR_FAST       44
-#define CALL_NO_KW_METHOD_DESCRIPTOR_NOARGS     45
-#define CALL_NO_KW_METHOD_DESCRIPTOR_O          46
-#define CALL_NO_KW_STR_1                        47
-#define CALL_NO_KW_TUPLE_1                      48
-#define CALL_NO_KW_TYPE_1                       56
-#define COMPARE_OP_ADAPTIVE                     57
-#define COMPARE_OP_FLOAT_JUMP                   58
-#define COMPARE_OP_INT_JUMP                     59
-#define COMPARE_OP_STR_JUMP                     62
-#define EXTENDED_ARG_QUICK                      63
-#define FOR_ITER_ADAPTIVE                       64
-#define FOR_ITER_LIST                           65
-#define FOR_ITER_RANGE                          66
-#define JUMP_BACKWARD_QUICK                     67
-#define LOAD_ATTR_ADAPTIVE                      72
-#define LOAD_ATTR_CLASS                         73
-#define LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN       76
-#define LOAD_ATTR_INSTANCE_VALUE                77
-#define LOAD_ATTR_MODULE                        78
-#define LOAD_ATTR_PROPERTY                      79
-#define LOAD_ATTR_SLOT                          80
-#define LOAD_ATTR_WITH_HINT                     81
-#define LOAD_ATTR_METHOD_LAZY_DICT              86
-#define LOAD_ATTR_METHOD_NO_DICT               113
-#define LOAD_ATTR_METHOD_WITH_DICT             121
-#define LOAD_ATTR_METHOD_WITH_VALUES           141
-#define LOAD_CONST__LOAD_FAST                  143
-#define LOAD_FAST__LOAD_CONST                  153
-#define LOAD_FAST__LOAD_FAST                   154
-#define LOAD_GLOBAL_ADAPTIVE                   158
-#define LOAD_GLOBAL_BUILTIN                    159
-#define LOAD_GLOBAL_MODULE                     160
-#define RESUME_QUICK                           161
-#define STORE_ATTR_ADAPTIVE                    166
-#define STORE_ATTR_INSTANCE_VALUE              167
-#define STORE_ATTR_SLOT                        168
-#define STORE_ATTR_WITH_HINT                   169
-#define STORE_FAST__LOAD_FAST                  170
-#define STORE_FAST__STORE_FAST                 173
-#define STORE_SUBSCR_ADAPTIVE                  174
-#define STORE_SUBSCR_DICT                      175
-#define STORE_SUBSCR_LIST_INT                  176
-#define UNPACK_SEQUENCE_ADAPTIVE               177
-#define UNPACK_SEQUENCE_LIST                   178
-#define UNPACK_SEQUENCE_TUPLE                  179
-#define UNPACK_SEQUENCE_TWO_TUPLE              180
+#define BINARY_SUBSCR_ARRAY_INT                 18
+#define BINARY_SUBSCR_BYTEARRAY_INT             19
+#define BINARY_SUBSCR_DICT                      20
+#define BINARY_SUBSCR_GETITEM                   21
+#define BINARY_SUBSCR_LIST_INT                  22
+#define BINARY_SUBSCR_MEMORYVIEW_INT            23
+#define BINARY_SUBSCR_TUPLE_INT                 24
+#define CALL_ADAPTIVE                           28
+#define CALL_PY_EXACT_ARGS                      29
+#define CALL_PY_WITH_DEFAULTS                   34
+#define CALL_PY_WITH_KWARGS                     38
+#define CALL_BOUND_METHOD_EXACT_ARGS            39
+#define CALL_BUILTIN_CLASS                      40
+#define CALL_BUILTIN_FAST_WITH_KEYWORDS         41
+#define CALL_METHOD_DESCRIPTOR_FAST_WITH_KEYWORDS  42
+#define CALL_NO_KW_BUILTIN_FAST                 43
+#define CALL_NO_KW_BUILTIN_O                    44
+#define CALL_NO_KW_ISINSTANCE                   45
+#define CALL_NO_KW_LEN                          46
+#define CALL_NO_KW_LIST_APPEND                  47
+#define CALL_NO_KW_METHOD_DESCRIPTOR_FAST       48
+#define CALL_NO_KW_METHOD_DESCRIPTOR_NOARGS     56
+#define CALL_NO_KW_METHOD_DESCRIPTOR_O          57
+#define CALL_NO_KW_STR_1                        58
+#define CALL_NO_KW_TUPLE_1                      59
+#define CALL_NO_KW_TYPE_1                       62
+#define COMPARE_OP_ADAPTIVE                     63
+#define COMPARE_OP_FLOAT_JUMP                   64
+#define COMPARE_OP_INT_JUMP                     65
+#define COMPARE_OP_STR_JUMP                     66
+#define CONTAINS_OP_ADAPTIVE                    67
+#define CONTAINS_OP_DICT                        72
+#define CONTAINS_OP_SET                         73
+#define CONTAINS_OP_STR                         76
+#define EXTENDED_ARG_QUICK                      77
+#define FOR_ITER_ADAPTIVE                       78
+#define FOR_ITER_DICT_ITEMS                     79
+#define FOR_ITER_DICT_KEYS                      80
+#define FOR_ITER_DICT_VALUES                    81
+#define FOR_ITER_ENUMERATE                      86
+#define FOR_ITER_LIST                          113
+#define FOR_ITER_RANGE                         121
+#define FOR_ITER_STR                           141
+#define FOR_ITER_TUPLE                         143
+#define FOR_ITER_ZIP                           153
+#define JUMP_BACKWARD_QUICK                    154
+#define LOAD_ATTR_ADAPTIVE                     158
+#define LOAD_ATTR_CLASS                        159
+#define LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN      160
+#define LOAD_ATTR_INSTANCE_VALUE               161
+#define LOAD_ATTR_MEGAMORPHIC                  166
+#define LOAD_ATTR_MODULE                       167
+#define LOAD_ATTR_PROPERTY                     168
+#define LOAD_ATTR_SLOT                         169
+#define LOAD_ATTR_SLOT_POLY                    170
+#define LOAD_ATTR_WITH_HINT                    179
+#define LOAD_ATTR_METHOD_LAZY_DICT             180
+#define LOAD_ATTR_METHOD_NO_DICT               181
+#define LOAD_ATTR_METHOD_WITH_DICT             182
+#define LOAD_ATTR_METHOD_WITH_VALUES           183
+#define LOAD_CONST__LOAD_FAST                  184
+#define LOAD_FAST__LOAD_CONST                  185
+#define LOAD_FAST__LOAD_FAST                   186
+#define LOAD_FAST_BORROW__LOAD_CONST_BORROW    187
+#define LOAD_FAST_BORROW__LOAD_FAST_BORROW     188
+#define LOAD_GLOBAL_ADAPTIVE                   189
+#define LOAD_GLOBAL_BUILTIN                    190
+#define LOAD_GLOBAL_MODULE                     191
+#define RESUME_QUICK                           192
+#define STORE_ATTR_ADAPTIVE                    193
+#define STORE_ATTR_INSTANCE_VALUE              194
+#define STORE_ATTR_SLOT                        195
+#define STORE_ATTR_SLOT_POLY                   196
+#define STORE_ATTR_WITH_HINT                   197
+#define STORE_FAST__LOAD_FAST                  198
+#define STORE_FAST__STORE_FAST                 199
+#define STORE_SUBSCR_ADAPTIVE                  200
+#define STORE_SUBSCR_ARRAY_INT                 201
+#define STORE_SUBSCR_BYTEARRAY_INT             202
+#define STORE_SUBSCR_DICT                      203
+#define STORE_SUBSCR_LIST_INT                  204
+#define STORE_SUBSCR_MEMORYVIEW_INT            205
+#define UNPACK_SEQUENCE_ADAPTIVE               206
+#define UNPACK_SEQUENCE_LIST                   207
+#define UNPACK_SEQUENCE_TUPLE                  208
+#define UNPACK_SEQUENCE_TWO_TUPLE              209
 #define DO_TRACING                             255
 
 #define HAS_ARG(op) ((((op) >= HAVE_ARGUMENT) && (!IS_PSEUDO_OPCODE(op)))\
@@ -210,6 +239,7 @@ extern "C" {
 #define HAS_CONST(op) (false\
     || ((op) == LOAD_CONST) \
     || ((op) == KW_NAMES) \
+    || ((op) == LOAD_CONST_BORROW) \
     )
 
 #define NB_ADD                                   0
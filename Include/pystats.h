@@ -31,6 +31,9 @@ typedef struct _specialization_stats {
     uint64_t deferred;
     uint64_t miss;
     uint64_t deopt;
+    uint64_t monomorphic;
+    uint64_t polymorphic;
+    uint64_t megamorphic;
     uint64_t failure_kinds[SPECIALIZATION_FAILURE_KINDS];
 } SpecializationStats;
 
@@ -40,6 +43,19 @@ typedef struct _opcode_stats {
     uint64_t pair_count[256];
 } OpcodeStats;
 
+/* Counts of executed opcode triples, kept in a small open-addressed table
+ * since a dense 256**3 array would be far too big.  A key is
+ * (first << 16 | second << 8 | third) + 1, so that 0 marks an empty slot.
+ * Triples that cannot find a slot are counted as dropped. */
+#define OPCODE_TRIPLE_TABLE_BITS 16
+#define OPCODE_TRIPLE_TABLE_SIZE (1 << OPCODE_TRIPLE_TABLE_BITS)
+
+typedef struct _opcode_triple_stats {
+    uint32_t key[OPCODE_TRIPLE_TABLE_SIZE];
+    uint64_t count[OPCODE_TRIPLE_TABLE_SIZE];
+    uint64_t dropped;
+} OpcodeTripleStats;
+
 typedef struct _call_stats {
     uint64_t inlined_py_calls;
     uint64_t pyeval_calls;
@@ -53,6 +69,8 @@ typedef struct _object_stats {
     uint64_t decrefs;
     uint64_t interpreter_increfs;
     uint64_t interpreter_decrefs;
+    uint64_t interpreter_increfs_avoided;
+    uint64_t interpreter_decrefs_avoided;
     uint64_t allocations;
     uint64_t allocations512;
     uint64_t allocations4k;
@@ -69,6 +87,7 @@ typedef struct _object_stats {
 
 typedef struct _stats {
     OpcodeStats opcode_stats[256];
+    OpcodeTripleStats triple_stats;
     CallStats call_stats;
     ObjectStats object_stats;
 } PyStats;
@@ -34,6 +34,7 @@
 MAKE_FUNCTION_FLAGS = ('defaults', 'kwdefaults', 'annotations', 'closure')
 
 LOAD_CONST = opmap['LOAD_CONST']
+LOAD_CONST_BORROW = opmap['LOAD_CONST_BORROW']
 LOAD_GLOBAL = opmap['LOAD_GLOBAL']
 BINARY_OP = opmap['BINARY_OP']
 JUMP_BACKWARD = opmap['JUMP_BACKWARD']
@@ -42,6 +43,9 @@
 
 CACHE = opmap["CACHE"]
 
+# Set in the argument of COMPARE_OP when both operands are borrowed
+COMPARE_BORROWED = 16
+
 _all_opname = list(opname)
 _all_opmap = dict(opmap)
 _empty_slot = [slot for slot, name in enumerate(_all_opname) if name.startswith("<")]
@@ -363,7 +367,7 @@ def _get_const_value(op, arg, co_consts):
     assert op in hasconst
 
     argval = UNKNOWN
-    if op == LOAD_CONST:
+    if op == LOAD_CONST or op == LOAD_CONST_BORROW:
         if co_consts is not None:
             argval = co_consts[arg]
     return argval
@@ -483,8 +487,10 @@ def _get_instructions_bytes(code, varname_from_oparg=None,
             elif deop in haslocal or deop in hasfree:
                 argval, argrepr = _get_name_info(arg, varname_from_oparg)
             elif deop in hascompare:
-                argval = cmp_op[arg]
+                argval = cmp_op[arg & ~COMPARE_BORROWED]
                 argrepr = argval
+                if arg & COMPARE_BORROWED:
+                    argrepr += ', borrowed'
             elif deop == FORMAT_VALUE:
                 argval, argrepr = FORMAT_VALUE_CONVERTERS[arg & 0x3]
                 argval = (argval, bool(arg & 0x4))
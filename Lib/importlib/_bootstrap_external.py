@@ -413,6 +413,12 @@ def _write_atomic(path, data, mode=0o666):
 #     Python 3.12a1 3507 (Set lineno of module's RESUME to 0)
 #     Python 3.12a1 3508 (Add CLEANUP_THROW)
 #     Python 3.12a1 3509 (Conditional jumps only jump forward)
+#     Python 3.12a1 3510 (Polymorphic inline caches for LOAD_ATTR/STORE_ATTR)
+#     Python 3.12a1 3511 (Add type version to STORE_SUBSCR cache)
+#     Python 3.12a1 3512 (Add LOAD_FAST_BORROW and the instructions borrowing loads)
+#     Python 3.12a1 3513 (Add inline cache to CONTAINS_OP)
+#     Python 3.12a1 3514 (Pass a single **mapping to CALL_FUNCTION_EX without copying it)
+#     Python 3.12a1 3515 (Move the polymorphic slot caches out of line)
 
 #     Python 3.13 will start with 3550
 
@@ -425,7 +431,7 @@ def _write_atomic(path, data, mode=0o666):
 # Whenever MAGIC_NUMBER is changed, the ranges in the magic_values array
 # in PC/launcher.c must also be updated.
 
-MAGIC_NUMBER = (3509).to_bytes(2, 'little') + b'\r\n'
+MAGIC_NUMBER = (3515).to_bytes(2, 'little') + b'\r\n'
 
 _RAW_MAGIC_NUMBER = int.from_bytes(MAGIC_NUMBER, 'little')  # For import.c
 
@@ -215,6 +215,16 @@ def pseudo_op(name, op, real_ops):
 def_op('CALL', 171)
 def_op('KW_NAMES', 172)
 hasconst.append(172)
+# Loads that don't take a new reference, and the instructions that consume
+# their values without releasing it; see borrow_local_loads() in compile.c
+def_op('LOAD_FAST_BORROW', 173)
+haslocal.append(173)
+def_op('LOAD_CONST_BORROW', 174)
+hasconst.append(174)
+jrel_op('POP_JUMP_IF_FALSE_BORROW', 175)
+jrel_op('POP_JUMP_IF_TRUE_BORROW', 176)
+jrel_op('POP_JUMP_IF_NOTNONE_BORROW', 177)
+jrel_op('POP_JUMP_IF_NONE_BORROW', 178)
 
 
 hasarg.extend([op for op in opmap.values() if op >= HAVE_ARGUMENT])
@@ -286,15 +296,19 @@ def pseudo_op(name, op, real_ops):
     ],
     "BINARY_SUBSCR": [
         "BINARY_SUBSCR_ADAPTIVE",
+        "BINARY_SUBSCR_ARRAY_INT",
+        "BINARY_SUBSCR_BYTEARRAY_INT",
         "BINARY_SUBSCR_DICT",
         "BINARY_SUBSCR_GETITEM",
         "BINARY_SUBSCR_LIST_INT",
+        "BINARY_SUBSCR_MEMORYVIEW_INT",
         "BINARY_SUBSCR_TUPLE_INT",
     ],
     "CALL": [
         "CALL_ADAPTIVE",
         "CALL_PY_EXACT_ARGS",
         "CALL_PY_WITH_DEFAULTS",
+        "CALL_PY_WITH_KWARGS",
         "CALL_BOUND_METHOD_EXACT_ARGS",
         "CALL_BUILTIN_CLASS",
         "CALL_BUILTIN_FAST_WITH_KEYWORDS",
@@ -317,13 +331,26 @@ def pseudo_op(name, op, real_ops):
         "COMPARE_OP_INT_JUMP",
         "COMPARE_OP_STR_JUMP",
     ],
+    "CONTAINS_OP": [
+        "CONTAINS_OP_ADAPTIVE",
+        "CONTAINS_OP_DICT",
+        "CONTAINS_OP_SET",
+        "CONTAINS_OP_STR",
+    ],
     "EXTENDED_ARG": [
         "EXTENDED_ARG_QUICK",
     ],
     "FOR_ITER": [
         "FOR_ITER_ADAPTIVE",
+        "FOR_ITER_DICT_ITEMS",
+        "FOR_ITER_DICT_KEYS",
+        "FOR_ITER_DICT_VALUES",
+        "FOR_ITER_ENUMERATE",
         "FOR_ITER_LIST",
         "FOR_ITER_RANGE",
+        "FOR_ITER_STR",
+        "FOR_ITER_TUPLE",
+        "FOR_ITER_ZIP",
     ],
     "JUMP_BACKWARD": [
         "JUMP_BACKWARD_QUICK",
@@ -334,9 +361,11 @@ def pseudo_op(name, op, real_ops):
         "LOAD_ATTR_CLASS",
         "LOAD_ATTR_GETATTRIBUTE_OVERRIDDEN",
         "LOAD_ATTR_INSTANCE_VALUE",
+        "LOAD_ATTR_MEGAMORPHIC",
         "LOAD_ATTR_MODULE",
         "LOAD_ATTR_PROPERTY",
         "LOAD_ATTR_SLOT",
+        "LOAD_ATTR_SLOT_POLY",
         "LOAD_ATTR_WITH_HINT",
         # These will always push [unbound method, self] onto the stack.
         "LOAD_ATTR_METHOD_LAZY_DICT",
@@ -351,6 +380,10 @@ def pseudo_op(name, op, real_ops):
         "LOAD_FAST__LOAD_CONST",
         "LOAD_FAST__LOAD_FAST",
     ],
+    "LOAD_FAST_BORROW": [
+        "LOAD_FAST_BORROW__LOAD_CONST_BORROW",
+        "LOAD_FAST_BORROW__LOAD_FAST_BORROW",
+    ],
     "LOAD_GLOBAL": [
         "LOAD_GLOBAL_ADAPTIVE",
         "LOAD_GLOBAL_BUILTIN",
@@ -363,6 +396,7 @@ def pseudo_op(name, op, real_ops):
         "STORE_ATTR_ADAPTIVE",
         "STORE_ATTR_INSTANCE_VALUE",
         "STORE_ATTR_SLOT",
+        "STORE_ATTR_SLOT_POLY",
         "STORE_ATTR_WITH_HINT",
     ],
     "STORE_FAST": [
@@ -371,8 +405,11 @@ def pseudo_op(name, op, real_ops):
     ],
     "STORE_SUBSCR": [
         "STORE_SUBSCR_ADAPTIVE",
+        "STORE_SUBSCR_ARRAY_INT",
+        "STORE_SUBSCR_BYTEARRAY_INT",
         "STORE_SUBSCR_DICT",
         "STORE_SUBSCR_LIST_INT",
+        "STORE_SUBSCR_MEMORYVIEW_INT",
     ],
     "UNPACK_SEQUENCE": [
         "UNPACK_SEQUENCE_ADAPTIVE",
@@ -381,6 +418,17 @@ def pseudo_op(name, op, real_ops):
         "UNPACK_SEQUENCE_TWO_TUPLE",
     ],
 }
+
+# Superinstructions chosen from an execution profile by
+# Tools/scripts/generate_superinstructions.py, which also writes their
+# implementations to Python/superinstructions.h.  Do not edit by hand.
+# BEGIN PROFILED SUPERINSTRUCTIONS
+_profiled_superinstructions = {
+}
+# END PROFILED SUPERINSTRUCTIONS
+for _family, _names in _profiled_superinstructions.items():
+    _specializations.setdefault(_family, []).extend(_names)
+
 _specialized_instructions = [
     opcode for family in _specializations.values() for opcode in family
 ]
@@ -391,6 +439,9 @@ def pseudo_op(name, op, real_ops):
     "deferred",
     "miss",
     "deopt",
+    "monomorphic",
+    "polymorphic",
+    "megamorphic",
 ]
 
 _cache_format = {
@@ -410,6 +461,9 @@ def pseudo_op(name, op, real_ops):
         "counter": 1,
         "mask": 1,
     },
+    "CONTAINS_OP": {
+        "counter": 1,
+    },
     "BINARY_SUBSCR": {
         "counter": 1,
         "type_version": 2,
@@ -436,6 +490,7 @@ def pseudo_op(name, op, real_ops):
     },
     "STORE_SUBSCR": {
         "counter": 1,
+        "type_version": 2,
     },
 }
 
@@ -359,6 +359,66 @@ def test_find_shift_table_overflow(self):
         self.checkequal(len(text2) - N*len("de") - len(pattern2),
                         text2, 'find', pattern2)
 
+    def test_find_count_short_needles(self):
+        """Cover the vectorized search of needles of up to 64 characters."""
+        def reference_find(p, s):
+            for i in range(len(s)):
+                if s.startswith(p, i):
+                    return i
+            return -1
+
+        def reference_count(p, s):
+            count = i = 0
+            while i <= len(s) - len(p):
+                if s.startswith(p, i):
+                    count += 1
+                    i += len(p)
+                else:
+                    i += 1
+            return count
+
+        rr = random.randrange
+        choices = random.choices
+        for _ in range(1000):
+            p = ''.join(choices('ab', k=rr(2, 66)))
+            text = ''.join(choices('ab', k=rr(100)))
+            if rr(2):
+                text += p + ''.join(choices('ab', k=rr(100)))
+            with self.subTest(p=p, text=text):
+                self.checkequal(reference_find(p, text), text, 'find', p)
+                self.checkequal(reference_count(p, text), text, 'count', p)
+        self.checkequal(100000, 'a' * 200000, 'count', 'aa')
+        self.checkequal(99999, 'a' * 199999, 'count', 'aa')
+        self.checkequal(1000, 'ab' * 1000, 'count', 'ab')
+
+    def test_count_replace_false_candidates(self):
+        # Many false candidates after a match make the vectorized search
+        # fall back to the scalar one, which must not count the match again.
+        def reference_replace(s, old, new):
+            parts = []
+            i = 0
+            while i < len(s):
+                if s.startswith(old, i):
+                    parts.append(new)
+                    i += len(old)
+                else:
+                    parts.append(s[i])
+                    i += 1
+            return ''.join(parts)
+
+        for text, needle, count in [
+            ('a' * 500 + 'aba' + 'a' * 200, 'aba', 1),
+            ('aba' + 'a' * 2000, 'aba', 1),
+            ('aba' * 20 + 'a' * 1000 + 'aba' * 20, 'aba', 40),
+            (('a' * 13 + 'aba') * 100, 'aba', 100),
+            ('b' * 510 + 'ab' + 'a' * 1500 + 'ab', 'ab', 2),
+        ]:
+            with self.subTest(text=text):
+                self.checkequal(count, text, 'count', needle)
+                for repl in '', 'Z', 'ZZZZ':
+                    self.checkequal(reference_replace(text, needle, repl),
+                                    text, 'replace', needle, repl)
+
     def test_lower(self):
         self.checkequal('hello', 'HeLLo', 'lower')
         self.checkequal('hello', 'hello', 'lower')
@@ -6,6 +6,7 @@
     _testcapi = None
 import struct
 import collections
+import functools
 import itertools
 import gc
 import contextlib
@@ -48,6 +49,83 @@ def f():
         # BOOM!
 
 
+    def test_forwarding_calls(self):
+        def target(*args, **kwargs):
+            return args, kwargs
+
+        def wrapper(*args, **kwargs):
+            return target(*args, **kwargs)
+
+        args = (1, 2)
+        kwargs = {'a': 3}
+        for func in (target, wrapper):
+            with self.subTest(func=func.__name__):
+                res_args, res_kwargs = func(*args, **kwargs)
+                self.assertEqual(res_args, args)
+                self.assertEqual(res_kwargs, kwargs)
+                # **kwargs is always a new dict
+                self.assertIsNot(res_kwargs, kwargs)
+                res_kwargs['b'] = 4
+                self.assertEqual(kwargs, {'a': 3})
+                self.assertEqual(func(*args), (args, {}))
+                self.assertEqual(func(**kwargs), ((), kwargs))
+                self.assertEqual(func(*[1], **collections.OrderedDict(a=3)),
+                                 ((1,), kwargs))
+                with self.assertRaisesRegex(TypeError,
+                                            "keywords must be strings"):
+                    func(**{1: 2})
+                with self.assertRaisesRegex(TypeError, "must be a mapping"):
+                    func(**1)
+
+    def test_forwarding_to_other_callables(self):
+        def named(a, b=2, *, c=3):
+            return a, b, c
+        def varargs(*args):
+            return args
+        kwargs = {'c': 5}
+        self.assertEqual(named(*(1,), **kwargs), (1, 2, 5))
+        self.assertEqual(varargs(*(1, 2), **{}), (1, 2))
+        with self.assertRaisesRegex(TypeError, "unexpected keyword"):
+            varargs(**kwargs)
+        # Callables without vectorcall get a copy of the mapping
+        class Callable:
+            def __call__(self, **kwargs):
+                kwargs['x'] = 1
+                return kwargs
+        self.assertEqual(Callable()(**kwargs), {'c': 5, 'x': 1})
+        self.assertEqual(dict(**kwargs), kwargs)
+        self.assertIsNot(dict(**kwargs), kwargs)
+        self.assertEqual(kwargs, {'c': 5})
+
+    @cpython_only
+    def test_forwarding_reuses_args(self):
+        def forward(*args, **kwargs):
+            return args
+        args = (1, 2, 3)
+        self.assertIs(forward(*args), args)
+        self.assertIs(forward(*args, **{'a': 1}), args)
+        # PyObject_Call() passes its tuple on as well
+        uncached = functools.lru_cache(maxsize=0)(forward)
+        self.assertIs(uncached(*args), args)
+
+    @cpython_only
+    def test_forwarding_empty_kwargs_refcount(self):
+        def forward(*args, **kwargs):
+            return args
+        args = (1, 2)
+        kwargs = {}
+        before = sys.getrefcount(kwargs)
+        for _ in range(100):
+            forward(*args, **kwargs)
+        self.assertEqual(sys.getrefcount(kwargs), before)
+        if hasattr(sys, 'gettotalrefcount'):
+            forward(*args, **{}, **{})
+            before = sys.gettotalrefcount()
+            for _ in range(100):
+                forward(*args, **{}, **{})
+            self.assertLess(sys.gettotalrefcount() - before, 50)
+
+
 @cpython_only
 class CFunctionCallsErrorMessages(unittest.TestCase):
 
@@ -3,6 +3,7 @@
 
 from collections import OrderedDict
 import _thread
+import gc
 import importlib.machinery
 import importlib.util
 import os
@@ -11,6 +12,7 @@
 import re
 import subprocess
 import sys
+import sysconfig
 import textwrap
 import threading
 import time
@@ -529,6 +531,62 @@ def __del__(self):
         # Test that subtype_dealloc decref the newly assigned __class__ only once
         self.assertEqual(new_type_refcnt, sys.getrefcount(A))
 
+    def test_object_cache(self):
+        for tp in (_testcapi.HeapCachedCType, _testcapi.HeapGcCachedCType):
+            with self.subTest(tp=tp):
+                self.assertTrue(tp.__flags__ & (1 << 2))
+                self.addCleanup(gc.set_object_cache_size, tp, 100)
+                gc.set_object_cache_size(tp, 5)
+                objs = [tp() for i in range(10)]
+                type_refcnt = sys.getrefcount(tp)
+                del objs
+                self.assertEqual(sys.getrefcount(tp), type_refcnt - 10)
+                stats = gc.get_object_cache_stats()[tp]
+                self.assertEqual(stats["size"], 5)
+                self.assertEqual(stats["max_size"], 5)
+                # Instances are reused and fully reinitialized
+                hits = stats["hits"]
+                objs = [tp() for i in range(3)]
+                self.assertEqual([obj.value for obj in objs], [10] * 3)
+                self.assertEqual(gc.is_tracked(objs[0]),
+                                 tp is _testcapi.HeapGcCachedCType)
+                stats = gc.get_object_cache_stats()[tp]
+                self.assertEqual(stats["hits"], hits + 3)
+                self.assertEqual(stats["size"], 2)
+                # Shrinking the cache frees the cached memory
+                gc.set_object_cache_size(tp, 1)
+                self.assertEqual(gc.get_object_cache_stats()[tp]["size"], 1)
+                gc.collect()
+                self.assertEqual(gc.get_object_cache_stats()[tp]["size"], 0)
+
+    def test_object_cache_subclass(self):
+        class Sub(_testcapi.HeapGcCachedCType):
+            pass
+        self.assertFalse(Sub.__flags__ & (1 << 2))
+        obj = Sub()
+        obj.cycle = obj
+        self.assertEqual(obj.value, 10)
+        del obj
+        gc.collect()
+        self.assertNotIn(Sub, gc.get_object_cache_stats())
+        with self.assertRaises(TypeError):
+            gc.set_object_cache_size(Sub, 10)
+        with self.assertRaises(TypeError):
+            gc.set_object_cache_size(_testcapi.HeapGcCType, 10)
+        with self.assertRaises(ValueError):
+            gc.set_object_cache_size(_testcapi.HeapGcCachedCType, -1)
+
+    def test_object_cache_gc_subclass(self):
+        # A C subclass adding GC to a cached type without GC gets
+        # PyObject_GC_Del() as its tp_free
+        tp = _testcapi.HeapCachedCTypeGcSubclass
+        self.assertFalse(tp.__flags__ & (1 << 2))
+        obj = tp()
+        self.assertTrue(gc.is_tracked(obj))
+        del obj
+        gc.collect()
+        self.assertNotIn(tp, gc.get_object_cache_stats())
+
     def test_heaptype_with_dict(self):
         inst = _testcapi.HeapCTypeWithDict()
         inst.foo = 42
@@ -1217,6 +1275,12 @@ class PyMemPymallocDebugTests(PyMemDebugTests):
     PYTHONMALLOC = 'pymalloc_debug'
 
 
+@unittest.skipUnless(support.with_pymalloc(), 'need pymalloc')
+@unittest.skipUnless(sysconfig.get_config_var('HAVE_MMAP'), 'need mmap()')
+class PyMemPymallocHugepageDebugTests(PyMemDebugTests):
+    PYTHONMALLOC = 'pymalloc_hugepage_debug'
+
+
 @unittest.skipUnless(support.Py_DEBUG, 'need Py_DEBUG')
 class PyMemDefaultTests(PyMemDebugTests):
     # test default allocator of Python compiled in debug mode
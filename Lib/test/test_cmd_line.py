@@ -5,6 +5,7 @@
 import os
 import subprocess
 import sys
+import sysconfig
 import tempfile
 import textwrap
 import unittest
@@ -820,6 +821,11 @@ def test_pythonmalloc(self):
                 ('pymalloc', 'pymalloc'),
                 ('pymalloc_debug', 'pymalloc_debug'),
             ))
+        if pymalloc and sysconfig.get_config_var('HAVE_MMAP'):
+            tests.extend((
+                ('pymalloc_hugepage', 'pymalloc_hugepage'),
+                ('pymalloc_hugepage_debug', 'pymalloc_hugepage_debug'),
+            ))
 
         for env_var, name in tests:
             with self.subTest(env_var=env_var, name=name):
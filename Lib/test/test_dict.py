@@ -1562,6 +1562,117 @@ def make_pairs():
                 self.assertGreaterEqual(eq_count, 1)
 
 
+class ProbeKey:
+    # A key with a chosen hash; keys with the same hash differ by value
+    def __init__(self, hash, value=0):
+        self.hash = hash
+        self.value = value
+    def __hash__(self):
+        return self.hash
+    def __eq__(self, other):
+        return (isinstance(other, ProbeKey) and self.hash == other.hash
+                and self.value == other.value)
+    def __repr__(self):
+        return f'ProbeKey({self.hash:#x}, {self.value})'
+
+
+class ProbingTest(unittest.TestCase):
+    # Tables of more than 16 slots are probed by several groups.  These keys
+    # all start in the first group, in tables of up to 2**24 slots.
+
+    def colliding_keys(self, n, start=0):
+        # Same first group, different hashes
+        return [ProbeKey(k << 24) for k in range(start, start + n)]
+
+    def equal_hash_keys(self, n, start=0):
+        return [ProbeKey(0, v) for v in range(start, start + n)]
+
+    def str_keys(self, n, start=0):
+        return [f'key{i}' for i in range(start, start + n)]
+
+    def check_dict(self, d, present, absent):
+        self.assertEqual(len(d), len(present))
+        for key in present:
+            self.assertIn(key, d)
+            self.assertEqual(d[key], key)
+        for key in absent:
+            self.assertNotIn(key, d)
+            self.assertIsNone(d.get(key))
+        self.assertEqual(list(d), present)
+
+    def test_multi_group_tables(self):
+        for make_keys in (self.colliding_keys, self.equal_hash_keys,
+                          self.str_keys):
+            for n in 5, 11, 20, 40, 200:
+                with self.subTest(keys=make_keys.__name__, n=n):
+                    keys = make_keys(n)
+                    absent = make_keys(5, n)
+                    d = {}
+                    for key in keys:
+                        d[key] = key
+                    self.check_dict(d, keys, absent)
+                    self.check_dict(dict(zip(keys, keys)), keys, absent)
+                    self.check_dict(d.copy(), keys, absent)
+                    self.check_dict(dict.fromkeys(keys) | d, keys, absent)
+
+    def test_delete_then_reinsert(self):
+        for make_keys in (self.colliding_keys, self.equal_hash_keys,
+                          self.str_keys):
+            with self.subTest(keys=make_keys.__name__):
+                keys = make_keys(40)
+                d = dict(zip(keys, keys))
+                # Lookups go on past the dummies left by the deletions
+                for key in keys[:20]:
+                    del d[key]
+                self.check_dict(d, keys[20:], keys[:20])
+                for key in keys[:20]:
+                    d[key] = key
+                self.check_dict(d, keys[20:] + keys[:20], [])
+                for key in keys[::2]:
+                    self.assertIs(d.pop(key), key)
+                self.check_dict(d, (keys[20:] + keys[:20])[1::2], keys[::2])
+                # Keep replacing keys, so that the table fills up with
+                # dummies and is resized
+                others = make_keys(1000, 40)
+                for key in others:
+                    d[key] = key
+                    del d[key]
+                    self.assertNotIn(key, d)
+                for key in keys[::2]:
+                    d[key] = key
+                self.check_dict(d, (keys[20:] + keys[:20])[1::2] + keys[::2],
+                                others[:10])
+                while d:
+                    key, value = d.popitem()
+                    self.assertIs(key, value)
+                    self.assertNotIn(key, d)
+
+    @support.cpython_only
+    def test_remove_dead_weakref(self):
+        # _PyDict_DelItemIf() must find the slot of the key from its hash
+        _weakref = import_helper.import_module('_weakref')
+        class Obj:
+            pass
+        for make_keys in (self.colliding_keys, self.equal_hash_keys,
+                          self.str_keys):
+            with self.subTest(keys=make_keys.__name__):
+                keys = make_keys(40)
+                alive = Obj()
+                d = {key: weakref.ref(alive) for key in keys}
+                dead = Obj()
+                d[keys[30]] = weakref.ref(dead)
+                del dead
+                support.gc_collect()
+                _weakref._remove_dead_weakref(d, keys[30])
+                self.assertNotIn(keys[30], d)
+                self.assertEqual(list(d), keys[:30] + keys[31:])
+                # Live references are kept
+                _weakref._remove_dead_weakref(d, keys[5])
+                self.assertIn(keys[5], d)
+                d[keys[30]] = None
+                self.assertEqual(len(d), 40)
+
+
 class CAPITest(unittest.TestCase):
 
     # Test _PyDict_GetItem_KnownHash()
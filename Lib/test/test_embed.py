@@ -437,6 +437,7 @@ class InitConfigTests(EmbeddingTestsMixin, unittest.TestCase):
         'faulthandler': 0,
         'tracemalloc': 0,
         'perf_profiling': 0,
+        'jit': 0,
         'import_time': 0,
         'code_debug_ranges': 1,
         'show_ref_count': 0,
@@ -522,6 +523,7 @@ class InitConfigTests(EmbeddingTestsMixin, unittest.TestCase):
         faulthandler=0,
         tracemalloc=0,
         perf_profiling=0,
+        jit=0,
         pathconfig_warnings=0,
     )
     if MS_WINDOWS:
@@ -831,6 +833,7 @@ def test_init_from_config(self):
             'hash_seed': 123,
             'tracemalloc': 2,
             'perf_profiling': 0,
+            'jit': 0,
             'import_time': 1,
             'code_debug_ranges': 0,
             'show_ref_count': 1,
@@ -894,6 +897,7 @@ def test_init_compat_env(self):
             'hash_seed': 42,
             'tracemalloc': 2,
             'perf_profiling': 0,
+            'jit': 0,
             'import_time': 1,
             'code_debug_ranges': 0,
             'malloc_stats': 1,
@@ -926,6 +930,7 @@ def test_init_python_env(self):
             'hash_seed': 42,
             'tracemalloc': 2,
             'perf_profiling': 0,
+            'jit': 0,
             'import_time': 1,
             'code_debug_ranges': 0,
             'malloc_stats': 1,
@@ -8,6 +8,7 @@
 from test.support import threading_helper
 
 import gc
+import os
 import sys
 import sysconfig
 import textwrap
@@ -830,10 +831,13 @@ def test_get_stats(self):
         for st in stats:
             self.assertIsInstance(st, dict)
             self.assertEqual(set(st),
-                             {"collected", "collections", "uncollectable"})
+                             {"collected", "collections", "uncollectable",
+                              "pauses"})
             self.assertGreaterEqual(st["collected"], 0)
             self.assertGreaterEqual(st["collections"], 0)
             self.assertGreaterEqual(st["uncollectable"], 0)
+            self.assertEqual(len(st["pauses"]), 7)
+            self.assertLessEqual(sum(st["pauses"]), st["collections"])
         # Check that collection counts are incremented correctly
         if gc.isenabled():
             self.addCleanup(gc.enable)
@@ -850,12 +854,218 @@ def test_get_stats(self):
         self.assertEqual(new[1]["collections"], old[1]["collections"])
         self.assertEqual(new[2]["collections"], old[2]["collections"] + 1)
 
+    def test_threshold_policy(self):
+        self.addCleanup(gc.set_threshold_policy, gc.get_threshold_policy())
+        gc.set_threshold_policy("adaptive")
+        self.assertEqual(gc.get_threshold_policy(), "adaptive")
+        gc.set_threshold_policy("fixed")
+        self.assertEqual(gc.get_threshold_policy(), "fixed")
+        self.assertRaises(ValueError, gc.set_threshold_policy, "other")
+        self.assertRaises(TypeError, gc.set_threshold_policy, 1)
+        self.assertEqual(gc.get_threshold_policy(), "fixed")
+
+    def test_adaptive_threshold(self):
+        thresholds = []
+        def callback(phase, info):
+            if phase == "stop" and info["generation"] == 0:
+                thresholds.append(info["threshold"])
+
+        gc.collect()
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        self.addCleanup(gc.set_threshold_policy, gc.get_threshold_policy())
+        self.addCleanup(gc.callbacks.remove, callback)
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        gc.callbacks.append(callback)
+        gc.set_threshold(100, 1000, 1000)
+        gc.set_threshold_policy("adaptive")
+        # No garbage: the threshold of generation 0 grows
+        keep = [[] for i in range(10_000)]
+        self.assertEqual(gc.get_threshold()[0], 100)
+        self.assertGreater(max(thresholds), 100)
+        self.assertLessEqual(max(thresholds), 100 * 64)
+        # Only garbage: it shrinks back
+        thresholds.clear()
+        for i in range(50_000):
+            l = []
+            l.append(l)
+        del l
+        self.assertEqual(thresholds[-1], 100)
+        # The fixed policy restores the configured threshold
+        gc.set_threshold_policy("fixed")
+        thresholds.clear()
+        keep = [[] for i in range(10_000)]
+        self.assertEqual(set(thresholds), {100})
+
+    def test_pause_budget(self):
+        self.addCleanup(gc.set_pause_budget, gc.get_pause_budget())
+        gc.set_pause_budget(0.001)
+        self.assertEqual(gc.get_pause_budget(), 0.001)
+        gc.set_pause_budget(0)
+        self.assertEqual(gc.get_pause_budget(), 0.0)
+        self.assertRaises(ValueError, gc.set_pause_budget, -1.0)
+        self.assertRaises(ValueError, gc.set_pause_budget, float('nan'))
+        self.assertRaises(TypeError, gc.set_pause_budget, "1")
+        self.assertEqual(gc.get_pause_budget(), 0.0)
+
+    def test_incremental_collection(self):
+        class A:
+            pass
+
+        gc.collect()
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        self.addCleanup(gc.set_pause_budget, gc.get_pause_budget())
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        # Garbage cycles in the oldest generation
+        cycles = []
+        for i in range(20):
+            a = A()
+            a.self = a
+            cycles.append(a)
+        gc.collect()
+        wr = [weakref.ref(a) for a in cycles]
+        del a, cycles
+        gc.set_threshold(100, 2, 1)
+        # A tiny budget makes each increment as small as possible
+        gc.set_pause_budget(1e-9)
+        old = gc.get_stats()[2]
+        # Enough long-lived objects to start a pass
+        keep = [[] for i in range(len(gc.get_objects()))]
+        for i in range(100_000):
+            b = A()
+            b.self = b
+        del b
+        new = gc.get_stats()[2]
+        self.assertGreater(new["collections"], old["collections"] + 1)
+        self.assertGreaterEqual(new["collected"], old["collected"] + 20)
+        self.assertTrue(all(r() is None for r in wr))
+
+    def test_get_objects_during_pass(self):
+        gc.collect()
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        self.addCleanup(gc.set_pause_budget, gc.get_pause_budget())
+        if not gc.isenabled():
+            self.addCleanup(gc.disable)
+            gc.enable()
+        l = []
+        l.append(l)
+        gc.collect()
+        self.assertTrue(any(l is x for x in gc.get_objects(generation=2)))
+        gc.set_threshold(100, 1, 1)
+        gc.set_pause_budget(1e-9)
+        for i in range(1000):
+            t = []
+            t.append(t)
+        del t
+        # Whether or not a pass is running, the oldest generation holds
+        # all the old objects
+        self.assertTrue(any(l is x for x in gc.get_objects(generation=2)))
+        self.assertIn(l, gc.get_referrers(l))
+
+    def test_mark_threads(self):
+        self.addCleanup(gc.set_mark_threads, gc.get_mark_threads())
+        gc.set_mark_threads(4)
+        self.assertEqual(gc.get_mark_threads(), 4)
+        gc.set_mark_threads(1)
+        self.assertEqual(gc.get_mark_threads(), 1)
+        self.assertRaises(ValueError, gc.set_mark_threads, 0)
+        self.assertRaises(ValueError, gc.set_mark_threads, 257)
+        self.assertRaises(TypeError, gc.set_mark_threads, 2.0)
+        self.assertEqual(gc.get_mark_threads(), 1)
+
+    def test_parallel_mark(self):
+        class A:
+            pass
+
+        gc.collect()
+        self.addCleanup(gc.set_mark_threads, gc.get_mark_threads())
+        # Enough objects for the collection to be parallel, reachable
+        # through chains crossing the ranges of the threads
+        live = [A() for i in range(150_000)]
+        for a, b in zip(live, live[1:]):
+            a.next = b
+        head = live[0]
+        del live, a, b
+        for threads in (2, 3, 8):
+            with self.subTest(threads=threads):
+                gc.set_mark_threads(threads)
+                wr = []
+                for i in range(1000):
+                    c = A()
+                    c.d = {'c': c, 'l': [c]}
+                    wr.append(weakref.ref(c))
+                del c
+                self.assertGreaterEqual(gc.collect(), 3000)
+                self.assertTrue(all(r() is None for r in wr))
+                n = 0
+                a = head
+                while a is not None:
+                    n += 1
+                    a = getattr(a, 'next', None)
+                self.assertEqual(n, 150_000)
+
     def test_freeze(self):
         gc.freeze()
         self.assertGreater(gc.get_freeze_count(), 0)
         gc.unfreeze()
         self.assertEqual(gc.get_freeze_count(), 0)
 
+    def test_freeze_immortalize(self):
+        # Immortal objects can't be made mortal again: use a subprocess
+        code = """if 1:
+            import gc, sys, weakref
+
+            class A:
+                def __del__(self):
+                    print("finalized")
+
+            a = A()
+            a.self = a
+            s = "immortal" * 10
+            l = [a, s, (s, 1)]
+            gc.freeze(immortalize=True)
+            assert not gc.is_tracked(l)
+            assert not gc.is_tracked(a)
+            assert gc.get_freeze_count() == 0
+            refcnt = sys.getrefcount(s)
+            refs = [s] * 1000
+            assert sys.getrefcount(s) == refcnt
+            del refs, a
+            gc.collect()
+
+            # Immortal objects still work, mortal ones are still collected
+            b = A()
+            b.self = b
+            l.append(b)
+            wr = weakref.ref(l[0])
+            c = A()
+            c.self = c
+            wc = weakref.ref(c)
+            del b, c, l
+            gc.collect()
+            assert wr() is not None
+            assert wc() is None
+            print("done")
+            """
+        rc, out, err = assert_python_ok("-c", code)
+        # Only the mortal c is finalized
+        self.assertEqual(out.split(), [b"finalized", b"done"])
+
+    def test_dump_heap(self):
+        self.addCleanup(unlink, TESTFN)
+        n = gc.dump_heap(TESTFN)
+        self.assertGreater(n, 0)
+        with open(TESTFN, "rb") as f:
+            data = f.read()
+        self.assertEqual(data[:8], b"PYHEAP\0\1")
+        self.assertIn(b"E", data[-10:])
+        with self.assertRaises(OSError):
+            gc.dump_heap(os.path.join(TESTFN, "nonexistent", "heap"))
+        self.assertRaises(TypeError, gc.dump_heap, 42)
+
     def test_get_objects(self):
         gc.collect()
         l = []
@@ -1186,6 +1396,7 @@ def test_collect(self):
             self.assertTrue("generation" in info)
             self.assertTrue("collected" in info)
             self.assertTrue("uncollectable" in info)
+            self.assertTrue("threshold" in info)
 
     def test_collect_generation(self):
         self.preclean()
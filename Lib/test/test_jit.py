@@ -0,0 +1,266 @@
+import textwrap
+import unittest
+from test import support
+from test.support import import_helper
+from test.support.script_helper import assert_python_ok, assert_python_failure
+
+_testinternalcapi = import_helper.import_module("_testinternalcapi")
+
+if not support.has_subprocess_support:
+    raise unittest.SkipTest("test module requires subprocess")
+
+
+# Only builds configured with --enable-experimental-jit have a JIT compiler
+JIT_ENABLED = hasattr(_testinternalcapi, "has_jit_code")
+
+
+class TestJITOption(unittest.TestCase):
+
+    def get_jit_config(self, *args, **env_vars):
+        code = "import _testinternalcapi; print(_testinternalcapi.get_config()['jit'])"
+        rc, out, err = assert_python_ok(*args, "-c", code, **env_vars)
+        return int(out)
+
+    def test_option(self):
+        # The option is accepted even if the JIT isn't built in
+        self.assertEqual(self.get_jit_config("-E"), 0)
+        self.assertEqual(self.get_jit_config("-X", "jit"), 1)
+        self.assertEqual(self.get_jit_config(PYTHONJIT="1"), 1)
+        self.assertEqual(self.get_jit_config("-E", PYTHONJIT="1"), 0)
+        self.assertEqual(self.get_jit_config("-X", "jit=on"), 1)
+        self.assertEqual(self.get_jit_config("-X", "jit=1"), 1)
+        self.assertEqual(self.get_jit_config("-X", "jit=off"), 0)
+        self.assertEqual(self.get_jit_config("-X", "jit=0"), 0)
+        self.assertEqual(self.get_jit_config(PYTHONJIT="0"), 0)
+        # The option takes precedence over the environment variable
+        self.assertEqual(self.get_jit_config("-X", "jit=off", PYTHONJIT="1"), 0)
+
+    def test_invalid_option(self):
+        for args, env in [(("-X", "jit=yes"), {}),
+                          (("-X", "jit=2"), {}),
+                          ((), {"PYTHONJIT": "yes"})]:
+            with self.subTest(args=args, env=env):
+                rc, out, err = assert_python_failure(*args, "-c", "pass", **env)
+                self.assertIn(b"jit", err.lower())
+
+
+@unittest.skipUnless(JIT_ENABLED, "requires --enable-experimental-jit")
+class TestJIT(unittest.TestCase):
+
+    def run_jit(self, source):
+        prologue = textwrap.dedent("""
+            import _testinternalcapi
+            def check_compiled(func):
+                assert _testinternalcapi.has_jit_code(func.__code__), func
+        """)
+        rc, out, err = assert_python_ok("-X", "jit", "-c",
+                                        prologue + textwrap.dedent(source))
+        return out.decode()
+
+    def test_int_and_float_loops(self):
+        out = self.run_jit("""
+            def ints(n):
+                total = 0
+                i = 0
+                while i < n:
+                    total = total + i * 3 - 1
+                    i += 1
+                return total
+            def floats(n):
+                x = 0.0
+                for i in range(n):
+                    x = x * 0.5 + 1.5 - 0.25
+                return x
+            print(ints(10_000), floats(10_000))
+            check_compiled(ints)
+            check_compiled(floats)
+        """)
+        expected_int = sum(i * 3 - 1 for i in range(10_000))
+        x = 0.0
+        for i in range(10_000):
+            x = x * 0.5 + 1.5 - 0.25
+        self.assertEqual(out.split(), [str(expected_int), repr(x)])
+
+    def test_branches_and_iteration(self):
+        out = self.run_jit("""
+            def f(items):
+                found = None
+                count = 0
+                for item in items:
+                    if item is None:
+                        continue
+                    if item is not None and item > 2.5:
+                        count += 1
+                    if not item:
+                        found = item
+                return count, found
+            data = [None, 0, 1, 2.0, 3, 4.5] * 1000
+            print(*f(data))
+            check_compiled(f)
+        """)
+        self.assertEqual(out.split(), ["2000", "0"])
+
+    def test_deoptimization(self):
+        # Specialized instructions keep working when the types change after
+        # the code has been compiled.
+        out = self.run_jit("""
+            def f(a, b):
+                total = a
+                for _ in range(2000):
+                    total = total + b
+                return total
+            f(0, 1)
+            check_compiled(f)
+            print(f(0, 1), f(0.5, 1.0), f("", "x") == "x" * 2000, f(1 << 70, 1))
+        """)
+        self.assertEqual(out.split(),
+                         ["2000", "2000.5", "True", str((1 << 70) + 2000)])
+
+    def test_exceptions(self):
+        out = self.run_jit("""
+            import traceback
+            class Bad:
+                def __bool__(self):
+                    raise ValueError("bad")
+            def f(items):
+                n = 0
+                for item in items:
+                    if item:
+                        n += 1
+                return n
+            f([1] * 2000)
+            check_compiled(f)
+            try:
+                f([1, 0, Bad()])
+            except ValueError as exc:
+                tb = traceback.extract_tb(exc.__traceback__)
+                print(tb[1].name, tb[1].lineno - f.__code__.co_firstlineno)
+        """)
+        # Reported at "if item:"
+        self.assertEqual(out.split(), ["f", "3"])
+
+    def test_extended_arg(self):
+        # Leaving the compiled code at an instruction with an EXTENDED_ARG
+        # prefix (here the JUMP_BACKWARD, when another thread asks for the
+        # GIL) resumes with the whole oparg.
+        body = "total += 1; " * 200
+        out = self.run_jit("""
+            import sys, threading
+            def f(n):
+                total = 0
+                for i in range(n):
+                    BODY
+                return total
+            f(2000)
+            check_compiled(f)
+            done = False
+            def spin():
+                while not done:
+                    pass
+            sys.setswitchinterval(1e-6)
+            t = threading.Thread(target=spin)
+            t.start()
+            try:
+                print(f(20000))
+            finally:
+                done = True
+                t.join()
+        """.replace("BODY", body))
+        self.assertEqual(out.strip(), str(20000 * 200))
+
+    def test_tracing(self):
+        # Compiled code is not used while tracing
+        out = self.run_jit("""
+            import sys
+            def f(n):
+                total = 0
+                for i in range(n):
+                    total += i
+                return total
+            f(2000)
+            check_compiled(f)
+            lines = []
+            def tracer(frame, event, arg):
+                if frame.f_code is f.__code__ and event == "line":
+                    lines.append(frame.f_lineno)
+                return tracer
+            sys.settrace(tracer)
+            f(3)
+            sys.settrace(None)
+            print(len(lines))
+        """)
+        # "total = 0", then "for" and "total += i" three times, the last
+        # "for" and "return"
+        self.assertEqual(out.strip(), "9")
+
+    def test_unbound_local(self):
+        # A trace function deleting a local stops the compiled code from
+        # being used, since it doesn't check for unbound locals.
+        out = self.run_jit("""
+            import sys
+            def tracer(frame, event, arg):
+                if event == "line" and "x" in frame.f_locals:
+                    del frame.f_locals["x"]
+                    sys.settrace(None)
+                    frame.f_trace = None
+                return tracer
+            def f(n, trace):
+                x = 1
+                total = 0
+                if trace:
+                    sys.settrace(tracer)
+                    sys._getframe().f_trace = tracer
+                for i in range(n):
+                    if i > 0:
+                        # Back in the compiled code after the deletion
+                        total += x
+                return total
+            f(2000, False)
+            check_compiled(f)
+            try:
+                f(20, True)
+            except UnboundLocalError:
+                print("unbound")
+        """)
+        self.assertEqual(out.strip(), "unbound")
+
+    def test_gc_in_generator(self):
+        # The garbage collector doesn't look at the locals and the stack of
+        # a running generator, even after the interpreter took over from
+        # the compiled code (here at BUILD_SET).
+        out = self.run_jit("""
+            import gc
+            def gen(n):
+                marker = object()
+                a = b = c = None
+                for i in range(n):
+                    t = (a, b, {c})
+                    del t
+                    if i == n - 1:
+                        yield marker in gc.get_referents(g)
+            g = gen(2000)
+            print(*g)
+            check_compiled(gen)
+        """)
+        self.assertEqual(out.strip(), "False")
+
+    def test_interrupt(self):
+        # Backward jumps in compiled code check the eval breaker
+        out = self.run_jit("""
+            import _thread, threading
+            def spin():
+                i = 0
+                while True:
+                    i += 1
+            threading.Timer(0.5, _thread.interrupt_main).start()
+            try:
+                spin()
+            except KeyboardInterrupt:
+                print("interrupted")
+            check_compiled(spin)
+        """)
+        self.assertEqual(out.strip(), "interrupted")
+
+
+if __name__ == "__main__":
+    unittest.main()
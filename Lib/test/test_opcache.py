@@ -1,4 +1,10 @@
+import array
+import collections
+import dis
+import sys
+import types
 import unittest
+from test.support import import_helper
 
 
 class TestLoadAttrCache(unittest.TestCase):
@@ -362,6 +368,587 @@ def f():
             self.assertFalse(f())
 
 
+class TestSlotAttrCache(unittest.TestCase):
+    def make_siblings(self, n):
+        class Base:
+            __slots__ = ("a",)
+        classes = []
+        for i in range(n):
+            # Give each sibling a different number of leading slots, so
+            # that "b" lives at a different offset in each of them.
+            names = tuple(f"pad{j}" for j in range(i)) + ("b",)
+            classes.append(type(f"C{i}", (Base,), {"__slots__": names}))
+        return classes
+
+    def test_polymorphic_load(self):
+        classes = self.make_siblings(4)
+        objs = []
+        for i, cls in enumerate(classes):
+            o = cls()
+            o.a = i
+            o.b = -i
+            objs.append(o)
+
+        def f(o):
+            return o.a, o.b
+
+        for _ in range(1025):
+            for i, o in enumerate(objs):
+                self.assertEqual(f(o), (i, -i))
+
+    def test_polymorphic_store(self):
+        classes = self.make_siblings(4)
+        objs = [cls() for cls in classes]
+
+        def f(o, v):
+            o.b = v
+
+        for n in range(1025):
+            for o in objs:
+                f(o, n)
+        for o in objs:
+            self.assertEqual(o.b, 1024)
+
+    def test_polymorphic_many_sites(self):
+        # More polymorphic sites than the interpreter has entries for:
+        # the sites take the entries over from each other.
+        classes = self.make_siblings(3)
+        objs = []
+        for i, cls in enumerate(classes):
+            o = cls()
+            o.b = i
+            objs.append(o)
+
+        funcs = []
+        for _ in range(1100):
+            ns = {}
+            exec("def f(o): return o.b", ns)
+            funcs.append(ns["f"])
+        for _ in range(2):
+            for f in funcs:
+                for _ in range(40):
+                    for i, o in enumerate(objs):
+                        self.assertEqual(f(o), i)
+
+    def test_polymorphic_many_sites_settle(self):
+        # Sites whose entry was taken over back off instead of taking
+        # another entry right away, so they stop evicting each other.
+        _testinternalcapi = import_helper.import_module("_testinternalcapi")
+        classes = self.make_siblings(3)
+        objs = []
+        for i, cls in enumerate(classes):
+            o = cls()
+            o.b = i
+            objs.append(o)
+
+        n = 1100
+        ns = {}
+        exec("def load(o): return (" + "o.b, " * n + ")", ns)
+        exec("def store(o, v):\n" + "    o.b = v\n" * n, ns)
+        load, store = ns["load"], ns["store"]
+
+        def run(rounds):
+            handed_out = _testinternalcapi.get_attr_poly_caches_handed_out()
+            for _ in range(rounds):
+                for i, o in enumerate(objs):
+                    self.assertEqual(load(o), (i,) * n)
+                    store(o, i)
+            return (_testinternalcapi.get_attr_poly_caches_handed_out()
+                    - handed_out)
+
+        run(100)
+        # Taking over entries on every miss would hand out one per site
+        # execution, more than 600000 here.
+        self.assertLess(run(100), n)
+
+    def test_megamorphic(self):
+        classes = self.make_siblings(8)
+        objs = []
+        for i, cls in enumerate(classes):
+            o = cls()
+            o.b = i
+            objs.append(o)
+
+        def f(o):
+            return o.b
+
+        for _ in range(1025):
+            for i, o in enumerate(objs):
+                self.assertEqual(f(o), i)
+
+    def test_megamorphic_mixed_kinds(self):
+        classes = self.make_siblings(6)
+        objs = []
+        for i, cls in enumerate(classes):
+            o = cls()
+            o.b = i
+            objs.append(o)
+
+        class Plain:
+            def __init__(self):
+                self.b = "plain"
+
+        class Method:
+            __slots__ = ()
+            def b(self):
+                return "method"
+
+        def f(o):
+            return o.b
+
+        def g(o):
+            return o.b()
+
+        for _ in range(1025):
+            for i, o in enumerate(objs):
+                self.assertEqual(f(o), i)
+            self.assertEqual(f(Plain()), "plain")
+            self.assertIsInstance(f(Method()), types.MethodType)
+        callables = []
+        for i, cls in enumerate(classes):
+            o = cls()
+            o.b = lambda i=i: i
+            callables.append(o)
+        for _ in range(1025):
+            for i, o in enumerate(callables):
+                self.assertEqual(g(o), i)
+            self.assertEqual(g(Method()), "method")
+
+        plain = Plain()
+        classes[2].b = property(lambda self: "property")
+        Plain.b = property(lambda self: "plain property")
+        sys._clear_type_cache()
+        self.assertEqual(f(objs[2]), "property")
+        self.assertEqual(f(objs[3]), 3)
+        self.assertEqual(f(plain), "plain property")
+
+    def test_megamorphic_instance_values(self):
+        # Sites which are not slot accesses become megamorphic once they
+        # have been deoptimized a few times.
+        classes = []
+        for i in range(8):
+            ns = {"__init__": lambda self, i=i: setattr(self, "x", i),
+                  "m": lambda self, i=i: -i}
+            classes.append(type(f"C{i}", (), ns))
+        objs = [cls() for cls in classes]
+
+        def f(o):
+            return o.x
+
+        def g(o):
+            return o.m()
+
+        for _ in range(1025):
+            for i, o in enumerate(objs):
+                self.assertEqual(f(o), i)
+                self.assertEqual(g(o), -i)
+        for func in f, g:
+            opnames = {instr.opname for instr in
+                       dis.get_instructions(func, adaptive=True)}
+            self.assertIn("LOAD_ATTR_MEGAMORPHIC", opnames)
+
+        # Shadow the method with an instance attribute
+        objs[3].m = lambda: "shadowed"
+        self.assertEqual(g(objs[3]), "shadowed")
+        self.assertEqual(g(classes[3]()), -3)
+        objs[4].__dict__["m"] = lambda: "dict"
+        self.assertEqual(g(objs[4]), "dict")
+        # Replace the class attributes
+        classes[5].m = lambda self: "new method"
+        self.assertEqual(g(objs[5]), "new method")
+        classes[6].x = property(lambda self: "property")
+        self.assertEqual(f(objs[6]), "property")
+        del objs[7].x
+        with self.assertRaises(AttributeError):
+            f(objs[7])
+        self.assertEqual([f(o) for o in objs[:3]], [0, 1, 2])
+
+    def test_unset_slot(self):
+        classes = self.make_siblings(3)
+        objs = [cls() for cls in classes]
+        for o in objs[:-1]:
+            o.b = 1
+
+        def f(o):
+            return o.b
+
+        for _ in range(1025):
+            for o in objs[:-1]:
+                self.assertEqual(f(o), 1)
+        with self.assertRaises(AttributeError):
+            f(objs[-1])
+
+    def test_descriptor_replaced_after_optimization(self):
+        classes = self.make_siblings(3)
+        objs = []
+        for cls in classes:
+            o = cls()
+            o.b = 1
+            objs.append(o)
+
+        def f(o):
+            return o.b
+
+        for _ in range(1025):
+            for o in objs:
+                self.assertEqual(f(o), 1)
+        classes[1].b = property(lambda self: 2)
+        self.assertEqual([f(o) for o in objs], [1, 2, 1])
+
+
+class TestBufferSubscr(unittest.TestCase):
+    def test_bytearray(self):
+        ba = bytearray(range(16))
+
+        def load(b, i):
+            return b[i]
+
+        def store(b, i, v):
+            b[i] = v
+
+        for n in range(1025):
+            i = n % 16
+            store(ba, i, (n * 7) & 0xff)
+            self.assertEqual(load(ba, i), (n * 7) & 0xff)
+        self.assertEqual(load(ba, -1), ba[15])
+        store(ba, -1, 1)
+        self.assertEqual(ba[15], 1)
+        with self.assertRaises(IndexError):
+            load(ba, 16)
+        with self.assertRaises(IndexError):
+            store(ba, 16, 0)
+        with self.assertRaises(ValueError):
+            store(ba, 0, 256)
+        with self.assertRaises(ValueError):
+            store(ba, 0, -1)
+        with self.assertRaises(TypeError):
+            store(ba, 0, 1.0)
+        self.assertEqual(load(bytearray(b"xyz"), 1), ord("y"))
+
+    def test_memoryview(self):
+        buf = bytearray(range(16))
+        mv = memoryview(buf)
+
+        def load(m, i):
+            return m[i]
+
+        def store(m, i, v):
+            m[i] = v
+
+        for n in range(1025):
+            i = n % 16
+            store(mv, i, (n * 3) & 0xff)
+            self.assertEqual(load(mv, i), (n * 3) & 0xff)
+        self.assertEqual(buf[5], mv[5])
+        with self.assertRaises(IndexError):
+            load(mv, 16)
+        with self.assertRaises(ValueError):
+            store(mv, 0, 256)
+        # Strided and reversed views
+        step = mv[::-3]
+        self.assertEqual([load(step, i) for i in range(len(step))],
+                         list(buf[::-3]))
+        store(step, 1, 42)
+        self.assertEqual(buf[-4], 42)
+        # Read-only, multi-byte and released views take the generic path
+        ro = memoryview(bytes(range(4)))
+        self.assertEqual(load(ro, 3), 3)
+        with self.assertRaises(TypeError):
+            store(ro, 0, 1)
+        wide = mv.cast("H")
+        self.assertEqual(load(wide, 0), int.from_bytes(buf[:2], sys.byteorder))
+        store(wide, 0, 0xffff)
+        self.assertEqual(buf[:2], b"\xff\xff")
+        other = memoryview(bytearray(4))
+        other.release()
+        with self.assertRaises(ValueError):
+            load(other, 0)
+        with self.assertRaises(ValueError):
+            store(other, 0, 0)
+
+    def test_array(self):
+        def load(a, i):
+            return a[i]
+
+        def store(a, i, v):
+            a[i] = v
+
+        def opnames(func):
+            return {instr.opname for instr in
+                    dis.get_instructions(func, adaptive=True)}
+
+        ints = array.array("i", range(16))
+        for n in range(1025):
+            i = n % 16
+            store(ints, i, -n)
+            self.assertEqual(load(ints, i), -n)
+        self.assertIn("BINARY_SUBSCR_ARRAY_INT", opnames(load))
+        self.assertIn("STORE_SUBSCR_ARRAY_INT", opnames(store))
+        with self.assertRaises(IndexError):
+            load(ints, 16)
+        with self.assertRaises(IndexError):
+            store(ints, 16, 0)
+        with self.assertRaises(TypeError):
+            store(ints, 0, "x")
+        self.assertEqual(load(ints, -1), ints[15])
+        doubles = array.array("d", [0.5] * 4)
+        store(doubles, 2, 1.5)
+        self.assertEqual(load(doubles, 2), 1.5)
+        with self.assertRaises(OverflowError):
+            store(array.array("b", [0]), 0, 128)
+
+        class Sub(array.array):
+            def __getitem__(self, i):
+                return "sub"
+        self.assertEqual(load(Sub("i", [1]), 0), "sub")
+
+        # Subclasses are not specialized, even without overrides
+        class Plain(array.array):
+            pass
+        def load_plain(a, i):
+            return a[i]
+        plain = Plain("i", [1])
+        for _ in range(1025):
+            self.assertEqual(load_plain(plain, 0), 1)
+        self.assertNotIn("BINARY_SUBSCR_ARRAY_INT", opnames(load_plain))
+
+
+class TestForIterSpecialization(unittest.TestCase):
+    def test_dict(self):
+        def items(d):
+            return [(k, v) for k, v in d.items()]
+
+        def keys(d):
+            return [k for k in d]
+
+        def values(d):
+            return [v for v in d.values()]
+
+        class C:
+            pass
+        for _ in range(1025):
+            d = {"a": 1, "b": 2, 3: "c"}
+            self.assertEqual(items(d), list(d.items()))
+            self.assertEqual(keys(d), list(d))
+            self.assertEqual(values(d), list(d.values()))
+            o = C()
+            o.x = 1
+            o.y = 2
+            self.assertEqual(items(o.__dict__), [("x", 1), ("y", 2)])
+
+        def mutate(d):
+            for k, v in d.items():
+                d[k + 1] = v
+        with self.assertRaises(RuntimeError):
+            mutate({1: 1})
+        self.assertEqual(items({}), [])
+
+    def test_enumerate(self):
+        def f(it, start=0):
+            return [(i, x) for i, x in enumerate(it, start)]
+
+        for _ in range(1025):
+            self.assertEqual(f("abc"), [(0, "a"), (1, "b"), (2, "c")])
+        self.assertEqual(f("ab", sys.maxsize),
+                         [(sys.maxsize, "a"), (sys.maxsize + 1, "b")])
+        self.assertEqual(f("ab", 2**100), [(2**100, "a"), (2**100 + 1, "b")])
+
+        def gen():
+            yield 1
+            raise ZeroDivisionError
+        with self.assertRaises(ZeroDivisionError):
+            f(gen())
+
+    def test_zip(self):
+        def f(*its, strict=False):
+            return [(a, b) for a, b in zip(*its, strict=strict)]
+
+        for _ in range(1025):
+            self.assertEqual(f("abc", [1, 2]), [("a", 1), ("b", 2)])
+        self.assertEqual(f([1, 2], [3, 4], strict=True), [(1, 3), (2, 4)])
+        with self.assertRaisesRegex(ValueError, "argument 2 is shorter"):
+            f([1, 2], [3], strict=True)
+        with self.assertRaisesRegex(ValueError, "argument 2 is longer"):
+            f([1], [3, 4], strict=True)
+        # A zip of any other arity reaching the same site still unpacks
+        with self.assertRaises(ValueError):
+            f("ab", "cd", "ef")
+        self.assertEqual(f("ab", "cd"), [("a", "c"), ("b", "d")])
+
+    def test_tuple_and_str(self):
+        def f(it):
+            return [x for x in it]
+
+        for _ in range(1025):
+            self.assertEqual(f((1, 2, 3)), [1, 2, 3])
+            self.assertEqual(f("xyz"), ["x", "y", "z"])
+        self.assertEqual(f("h\xe9\u20ac"), ["h", "\xe9", "\u20ac"])
+        self.assertEqual(f(()), [])
+        self.assertEqual(f(""), [])
+        it = iter("ab")
+        self.assertEqual(f(it), ["a", "b"])
+        self.assertEqual(f(it), [])
+
+
+class TestContainsOpSpecialization(unittest.TestCase):
+    def test_dict(self):
+        def f(k, d):
+            return k in d, k not in d
+
+        class D(dict):
+            def __contains__(self, key):
+                return True
+
+        for _ in range(1025):
+            self.assertEqual(f("a", {"a": 1}), (True, False))
+            self.assertEqual(f("b", {"a": 1}), (False, True))
+        self.assertEqual(f(1, {1.0: 1}), (True, False))
+        self.assertEqual(f("b", D()), (True, False))
+        with self.assertRaises(TypeError):
+            f([], {})
+
+    def test_set(self):
+        def f(k, s):
+            return k in s, k not in s
+
+        for _ in range(1025):
+            self.assertEqual(f("a", {"a", "b"}), (True, False))
+            self.assertEqual(f("c", frozenset("ab")), (False, True))
+        # Sets are looked up as frozensets
+        self.assertEqual(f({1}, {frozenset({1})}), (True, False))
+        self.assertEqual(f(set(), frozenset()), (False, True))
+        with self.assertRaises(TypeError):
+            f([], {1})
+
+    def test_str(self):
+        def f(sub, s):
+            return sub in s, sub not in s
+
+        for _ in range(1025):
+            self.assertEqual(f("ell", "hello"), (True, False))
+            self.assertEqual(f("€", "hello"), (False, True))
+        self.assertEqual(f("", ""), (True, False))
+        self.assertEqual(f("b", ["a", "b"]), (True, False))
+        with self.assertRaises(TypeError):
+            f(1, "abc")
+
+
+class TestCallSpecialization(unittest.TestCase):
+    def test_keyword_call(self):
+        def f(a, b=2, c=3):
+            return (a, b, c)
+
+        class C:
+            def m(self, a, b=2, *, k):
+                return (a, b, k)
+
+        def call():
+            return f(1, c=30), f(a=1, b=20), f(1, 2, c=3)
+
+        def call_method(o):
+            return o.m(1, k=3), o.m(a=1, b=2, k=3)
+
+        o = C()
+        for _ in range(1025):
+            self.assertEqual(call(), ((1, 2, 30), (1, 20, 3), (1, 2, 3)))
+            self.assertEqual(call_method(o), ((1, 2, 3), (1, 2, 3)))
+
+        f.__defaults__ = (200, 300)
+        self.assertEqual(call(), ((1, 200, 30), (1, 20, 300), (1, 2, 3)))
+
+    def test_keyword_call_errors(self):
+        def f(a, b=2):
+            return (a, b)
+
+        def call(**kwargs):
+            return f(1, b=kwargs.get("b", 2))
+
+        for _ in range(1025):
+            self.assertEqual(call(), (1, 2))
+        with self.assertRaises(TypeError):
+            f(1, c=2)
+        with self.assertRaises(TypeError):
+            f(1, a=2)
+
+    def test_call_function_ex(self):
+        def target(a, b=2, *args, c=3, **kwargs):
+            return (a, b, args, c, kwargs)
+
+        def wrapper(*args, **kwargs):
+            return target(*args, **kwargs)
+
+        def gen(*args):
+            yield from args
+
+        def call_gen(*args):
+            return list(gen(*args))
+
+        for _ in range(1025):
+            self.assertEqual(wrapper(1), (1, 2, (), 3, {}))
+            self.assertEqual(wrapper(1, 2, 3, c=4, d=5),
+                             (1, 2, (3,), 4, {"d": 5}))
+            self.assertEqual(call_gen(1, 2), [1, 2])
+        self.assertEqual(target(*(1,), **collections.UserDict(c=6)),
+                         (1, 2, (), 6, {}))
+        with self.assertRaisesRegex(TypeError, "keywords must be strings"):
+            target(1, **{1: 2})
+        with self.assertRaises(TypeError):
+            wrapper()
+
+        def recurse(n):
+            if n:
+                return wrapper_recurse(n - 1)
+            return 0
+
+        def wrapper_recurse(*args, **kwargs):
+            return recurse(*args, **kwargs)
+
+        with self.assertRaises(RecursionError):
+            recurse(sys.getrecursionlimit() * 2)
+
+
+class TestBinaryOpReuse(unittest.TestCase):
+    def test_float_chain(self):
+        def f(a, b, c):
+            t = 0.0
+            for _ in range(10):
+                t = t + a * b - c
+            return t
+
+        a, b, c = 1.5, 2.0, 0.25
+        for _ in range(1025):
+            self.assertEqual(f(a, b, c), 27.5)
+        self.assertEqual((a, b, c), (1.5, 2.0, 0.25))
+
+    def test_int_chain(self):
+        def f(a, n):
+            i = a
+            for _ in range(n):
+                i = i + 1
+                i = (i * 3 - a) - (i * 2 - a)
+            return i
+
+        big = 2**40
+        for _ in range(1025):
+            self.assertEqual(f(1000, 10), 1010)
+            self.assertEqual(f(-300, 10), -290)
+            self.assertEqual(f(big, 3), big + 3)
+            # Results in the small int range must be the cached objects
+            self.assertIs(f(250, 5), 255)
+
+    def test_aliased_local(self):
+        def f(x, y):
+            for _ in range(3):
+                x = x + 1.0
+                y = y + 1
+            return x, y
+
+        a = 1000.0
+        b = 10**6
+        for _ in range(1025):
+            self.assertEqual(f(a, b), (1003.0, 10**6 + 3))
+        self.assertEqual((a, b), (1000.0, 10**6))
+
 if __name__ == "__main__":
     import unittest
     unittest.main()
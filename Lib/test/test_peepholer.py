@@ -408,7 +408,8 @@ def f(a, b, c):
         self.check_lnotab(f)
         self.assertNotInBytecode(f, 'JUMP_IF_FALSE_OR_POP')
         self.assertInBytecode(f, 'JUMP_IF_TRUE_OR_POP')
-        self.assertInBytecode(f, 'POP_JUMP_IF_FALSE')
+        # The jump consumes "a" right after it is loaded
+        self.assertInBytecode(f, 'POP_JUMP_IF_FALSE_BORROW')
         # JUMP_IF_TRUE_OR_POP to JUMP_IF_FALSE_OR_POP --> POP_JUMP_IF_TRUE to non-jump
         def f(a, b, c):
             return ((a or b)
@@ -417,7 +418,7 @@ def f(a, b, c):
         self.check_lnotab(f)
         self.assertNotInBytecode(f, 'JUMP_IF_TRUE_OR_POP')
         self.assertInBytecode(f, 'JUMP_IF_FALSE_OR_POP')
-        self.assertInBytecode(f, 'POP_JUMP_IF_TRUE')
+        self.assertInBytecode(f, 'POP_JUMP_IF_TRUE_BORROW')
 
     def test_elim_jump_to_uncond_jump4(self):
         def f():
@@ -863,6 +864,74 @@ def trace(frame, event, arg):
         self.assertNotInBytecode(f, "LOAD_FAST_CHECK")
 
 
+class TestBorrowedLoads(BytecodeTestCase):
+
+    def setUp(self):
+        self.addCleanup(sys.settrace, sys.gettrace())
+        sys.settrace(None)
+
+    def test_compare_borrows_operands(self):
+        def f(x):
+            return x == 1
+        self.assertInBytecode(f, 'LOAD_FAST_BORROW', 'x')
+        self.assertInBytecode(f, 'LOAD_CONST_BORROW', 1)
+        self.assertInBytecode(f, 'COMPARE_OP', '==')
+        for instr in dis.get_instructions(f):
+            if instr.opname == 'COMPARE_OP':
+                self.assertTrue(instr.arg & dis.COMPARE_BORROWED)
+
+    def test_jump_borrows_condition(self):
+        def f(x):
+            if x is None:
+                return 1
+            if x:
+                return 2
+        self.assertInBytecode(f, 'POP_JUMP_IF_NOTNONE_BORROW')
+        self.assertInBytecode(f, 'POP_JUMP_IF_FALSE_BORROW')
+        self.assertNotInBytecode(f, 'LOAD_FAST')
+
+    def test_no_borrow_across_lines(self):
+        def f(x):
+            return (x
+                    == 1)
+        self.assertNotInBytecode(f, 'LOAD_FAST_BORROW')
+        self.assertNotInBytecode(f, 'LOAD_CONST_BORROW')
+
+    def test_no_borrow_for_binary_op(self):
+        def f(x):
+            return x + 1
+        self.assertNotInBytecode(f, 'LOAD_FAST_BORROW')
+        self.assertNotInBytecode(f, 'LOAD_CONST_BORROW')
+
+    def test_refcounts_unchanged(self):
+        def f(x, y):
+            n = 0
+            for _ in range(100):
+                if x == y:
+                    n += 1
+                if x:
+                    n += 1
+            return n
+        x = object()
+        before = sys.getrefcount(x)
+        self.assertEqual(f(x, x), 200)
+        self.assertEqual(sys.getrefcount(x), before)
+
+    def test_deleted_local_raises(self):
+        def f():
+            x = 1
+            return x == 1
+        def trace(frame, event, arg):
+            if event == 'line' and frame.f_lineno == f.__code__.co_firstlineno + 2:
+                del frame.f_locals["x"]
+                sys.settrace(None)
+                return None
+            return trace
+        sys.settrace(trace)
+        with self.assertRaises(UnboundLocalError):
+            f()
+
+
 class DirectiCfgOptimizerTests(CfgOptimizationTestCase):
 
     def cfg_optimization_test(self, insts, expected_insts,
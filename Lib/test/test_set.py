@@ -11,6 +11,7 @@
 import collections
 import collections.abc
 import itertools
+import sys
 
 class PassThru(Exception):
     pass
@@ -1315,6 +1316,151 @@ def test_update_unit_tuple_non_overlap(self):
 
 #==============================================================================
 
+class ProbeKey:
+    # A key with a chosen hash; keys with the same hash differ by value
+    def __init__(self, hash, value=0):
+        self.hash = hash
+        self.value = value
+    def __hash__(self):
+        return self.hash
+    def __eq__(self, other):
+        return (isinstance(other, ProbeKey) and self.hash == other.hash
+                and self.value == other.value)
+    def __repr__(self):
+        return f'ProbeKey({self.hash:#x}, {self.value})'
+
+class TestProbing(unittest.TestCase):
+    # The last slot is the first one probed for these hashes, in tables of
+    # up to 2**24 slots, so the first group probed wraps around the table.
+    LAST_SLOT = 2**24 - 1
+
+    def colliding_keys(self, n, start=0):
+        # Same first slot, different hashes
+        return [ProbeKey(k << 24 | self.LAST_SLOT)
+                for k in range(start, start + n)]
+
+    def equal_hash_keys(self, n, start=0):
+        return [ProbeKey(self.LAST_SLOT, v) for v in range(start, start + n)]
+
+    def check_set(self, s, present, absent):
+        self.assertEqual(len(s), len(present))
+        for key in present:
+            self.assertIn(key, s)
+        for key in absent:
+            self.assertNotIn(key, s)
+        self.assertEqual(set(iter(s)), set(present))
+
+    def test_wrap_around_groups(self):
+        for make_keys in self.colliding_keys, self.equal_hash_keys:
+            for n in 3, 10, 40, 200:
+                with self.subTest(keys=make_keys.__name__, n=n):
+                    keys = make_keys(n)
+                    absent = make_keys(5, n)
+                    s = set()
+                    for key in keys:
+                        s.add(key)
+                    self.check_set(s, keys, absent)
+                    self.check_set(set(keys), keys, absent)
+                    self.check_set(frozenset(keys), keys, absent)
+
+    def test_dummy_reuse(self):
+        for make_keys in self.colliding_keys, self.equal_hash_keys:
+            with self.subTest(keys=make_keys.__name__):
+                keys = make_keys(10)
+                s = set(keys)
+                # Searches go on past dummies
+                for key in keys[:5]:
+                    s.discard(key)
+                self.check_set(s, keys[5:], keys[:5])
+                s.update(keys[:5])
+                self.check_set(s, keys, [])
+                order = list(s)
+                s.discard(keys[3])
+                key = make_keys(1, 10)[0]
+                s.add(key)
+                if support.check_impl_detail(cpython=True):
+                    # The new key takes the place of the removed one
+                    order[order.index(keys[3])] = key
+                    self.assertEqual(list(s), order)
+                s.remove(key)
+                s.add(keys[3])
+                # Adding and removing keys reuses the dummy slots
+                size = sys.getsizeof(s)
+                others = make_keys(1000, 11)
+                for key in others:
+                    s.add(key)
+                    s.remove(key)
+                    self.assertNotIn(key, s)
+                self.check_set(s, keys, others[:10])
+                if support.check_impl_detail(cpython=True):
+                    self.assertEqual(sys.getsizeof(s), size)
+                s.pop()
+                self.assertEqual(len(s), len(keys) - 1)
+
+    def test_merge_copies_control_bytes(self):
+        # Copying a set without dummies to an empty set of the same size
+        # copies the whole table
+        for keys in (self.colliding_keys(10), self.equal_hash_keys(10),
+                     list(range(10)), [str(i) for i in range(10)]):
+            with self.subTest(keys=keys[:2]):
+                s = set(keys)
+                absent = self.colliding_keys(5, 10) + [-1, 'x']
+                for copy in s.copy(), set(s), frozenset(s):
+                    if support.check_impl_detail(cpython=True):
+                        self.assertEqual(sys.getsizeof(copy),
+                                         sys.getsizeof(s))
+                    self.check_set(copy, keys, absent)
+                copy = s.copy()
+                copy.discard(keys[0])
+                copy.add(absent[0])
+                self.check_set(copy, keys[1:] + absent[:1],
+                               keys[:1] + absent[1:])
+
+    def test_compact_tables(self):
+        # Tables of exact ints and strs don't store the hashes.  They are
+        # turned into general tables when other keys are added.
+        class Str(str):
+            pass
+        ints = list(range(-50, 50)) + [2**100, -2**70]
+        strs = [str(i) for i in range(100)]
+        for keys in ints, strs, ints + strs:
+            with self.subTest(keys=keys[:2]):
+                s = set(keys)
+                if support.check_impl_detail(cpython=True):
+                    size = sys.getsizeof(s)
+                    self.assertLess(size, sys.getsizeof({(k,) for k in keys}))
+                # Equal keys of other types are found, and not added
+                equal = [1.0, True] if 1 in s else [Str('1')]
+                for key in equal:
+                    self.assertIn(key, s)
+                    s.add(key)
+                self.check_set(s, keys, [0.5, (1,), 'x'])
+                if support.check_impl_detail(cpython=True):
+                    self.assertEqual(sys.getsizeof(s), size)
+                # Adding other keys converts the table
+                s.add(0.5)
+                s.add((1,))
+                self.check_set(s, keys + [0.5, (1,)], ['x'])
+                s.discard(0.5)
+                s.discard((1,))
+                self.check_set(s, keys, [0.5, (1,)])
+                self.assertEqual(frozenset(s), frozenset(keys))
+                self.assertEqual(hash(frozenset(s)), hash(frozenset(keys)))
+
+    def test_compact_hash(self):
+        # The hash of a frozenset doesn't depend on the layout of its table
+        for n in 3, 10, 100:
+            with self.subTest(n=n):
+                compact = frozenset([1] + list(range(2, n)))
+                general = frozenset([True] + list(range(2, n)))
+                self.assertEqual(compact, general)
+                self.assertEqual(hash(compact), hash(general))
+                strs = frozenset(map(str, range(n)))
+                mixed = frozenset(list(map(str, range(n))) + [1.5])
+                self.assertEqual(hash(strs | {1.5}), hash(mixed))
+
+#==============================================================================
+
 class TestSubsets:
 
     case2method = {"<=": "issubset",
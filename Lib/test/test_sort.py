@@ -384,6 +384,63 @@ def test_none_in_tuples(self):
         actual = sorted([(None, 2), (None, 1)])
         self.assertEqual(actual, expected)
 
+    def test_radix_sort(self):
+        # Large shuffled lists of bounded ints and of floats are radix sorted
+        random.seed(1)
+        n = 5000
+        ints = [random.randrange(-2**29, 2**29) for _ in range(n)]
+        check_against_PyObject_RichCompareBool(self, ints)
+        # Equal keys must keep their order
+        check_against_PyObject_RichCompareBool(
+            self, [(1 << 28) + random.randrange(10) for _ in range(n)])
+        floats = [random.uniform(-1e6, 1e6) for _ in range(n)]
+        floats += [0.0, -0.0] * 100 + [float('inf'), float('-inf')] * 10
+        check_against_PyObject_RichCompareBool(self, floats)
+        check_against_PyObject_RichCompareBool(self, floats + [float('nan')])
+
+        values = list(range(n))
+        random.shuffle(values)
+        keys = [random.randrange(100) for _ in range(n)]
+        for reverse in False, True:
+            expected = sorted(values, key=lambda i: (keys[i],), reverse=reverse)
+            actual = sorted(values, key=keys.__getitem__, reverse=reverse)
+            self.assertEqual(actual, expected)
+
+    def test_threads(self):
+        random.seed(2)
+        n = 100_000
+        strings = [str(random.randrange(n)) for _ in range(n)]
+        almost_sorted = list(range(n))
+        for _ in range(100):
+            i = random.randrange(n)
+            almost_sorted[i] = random.randrange(n)
+        floats = [float(x) for x in almost_sorted]
+        for L in strings, almost_sorted, floats:
+            for reverse in False, True:
+                expected = sorted(L, key=lambda x: (x,), reverse=reverse)
+                for threads in 2, 3, 8:
+                    actual = sorted(L, reverse=reverse, threads=threads)
+                    self.assertEqual(actual, expected)
+                    for (opt, ref) in zip(actual, expected):
+                        self.assertIs(opt, ref)
+            values = list(range(n))
+            expected = sorted(values, key=lambda i: (L[i],))
+            self.assertEqual(sorted(values, key=L.__getitem__, threads=4),
+                             expected)
+
+        # Other lists are sorted by the calling thread only
+        L = [(x,) for x in strings]
+        self.assertEqual(sorted(L, threads=4), sorted(L))
+
+    def test_threads_invalid(self):
+        L = [3, 1, 2]
+        self.assertRaises(ValueError, L.sort, threads=0)
+        self.assertRaises(ValueError, L.sort, threads=257)
+        self.assertRaises(TypeError, L.sort, threads=2.0)
+        self.assertEqual(L, [3, 1, 2])
+        L.sort(threads=256)
+        self.assertEqual(L, [1, 2, 3])
+
 #==============================================================================
 
 if __name__ == "__main__":
@@ -187,6 +187,42 @@ def test_vformat_recursion_limit(self):
             fmt._vformat("{i}", args, kwargs, set(), -1)
         self.assertIn("recursion", str(err.exception))
 
+    def test_replace_many(self):
+        from _string import replace_many
+        self.assertEqual(replace_many('', [('a', 'b')]), '')
+        self.assertEqual(replace_many('abc', []), 'abc')
+        self.assertEqual(replace_many('abc', [('x', 'y')]), 'abc')
+        self.assertEqual(replace_many('a<b>&c', [('&', '&amp;'), ('<', '&lt;'),
+                                                 ('>', '&gt;')]),
+                         'a&lt;b&gt;&amp;c')
+        # the replacements are not searched again
+        self.assertEqual(replace_many('ab', [('a', 'b'), ('b', 'a')]), 'ba')
+        # at the same position, the first matching pair wins
+        self.assertEqual(replace_many('abab', [('a', '1'), ('ab', '2')]),
+                         '1b1b')
+        self.assertEqual(replace_many('abab', [('ab', '2'), ('a', '1')]),
+                         '22')
+        self.assertEqual(replace_many('aaaaa', [('aa', 'b')]), 'bba')
+        self.assertEqual(replace_many('<>' * 1000, [('<', '['), ('>', ']')]),
+                         '[]' * 1000)
+        # mixed kinds
+        self.assertEqual(replace_many('a\u20acb', [('\u20ac', 'e')]), 'aeb')
+        self.assertEqual(replace_many('a\U0001f600b', [('a', '\u20ac'),
+                                                       ('\U0001f600', '')]),
+                         '\u20acb')
+        self.assertEqual(replace_many('ab', [('\u20ac', 'e')]), 'ab')
+        class S(str):
+            pass
+        self.assertIs(type(replace_many(S('abc'), [('x', 'y')])), str)
+        self.assertIs(type(replace_many(S('abc'), [('a', 'y')])), str)
+
+        self.assertRaises(TypeError, replace_many, 'abc')
+        self.assertRaises(TypeError, replace_many, b'abc', [])
+        self.assertRaises(TypeError, replace_many, 'abc', 42)
+        self.assertRaises(TypeError, replace_many, 'abc', [('a',)])
+        self.assertRaises(TypeError, replace_many, 'abc', [('a', b'b')])
+        self.assertRaises(ValueError, replace_many, 'abc', [('', 'b')])
+
 
 # Template tests (formerly housed in test_pep292.py)
 
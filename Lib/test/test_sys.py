@@ -4,6 +4,7 @@
 import locale
 import operator
 import os
+import re
 import struct
 import subprocess
 import sys
@@ -933,6 +934,73 @@ def test_debugmallocstats(self):
         # The function has no parameter
         self.assertRaises(TypeError, sys._debugmallocstats, True)
 
+    @unittest.skipUnless(support.with_pymalloc(), "need pymalloc")
+    def test_debugmallocstats_subinterpreter(self):
+        # Isolated subinterpreters allocate from pymalloc states of their own
+        import_helper.import_module('_xxsubinterpreters')
+        code = textwrap.dedent("""
+            import sys
+            import _xxsubinterpreters as interpreters
+            interp = interpreters.create()
+            interpreters.run_string(interp, "x = [str(i) for i in range(10000)]")
+            sys._debugmallocstats()
+            interpreters.destroy(interp)
+            sys._debugmallocstats()
+        """)
+        ret, out, err = assert_python_ok('-c', code, PYTHONMALLOC='')
+        nstates = re.findall(rb'# allocator states +=\s+(\d+)', err)
+        self.assertEqual(len(nstates), 2)
+        self.assertEqual(int(nstates[0]), 2)
+        self.assertLessEqual(int(nstates[1]), 2)
+
+    @unittest.skipUnless(support.with_pymalloc(), "need pymalloc")
+    @unittest.skipUnless(sysconfig.get_config_var('HAVE_MMAP'), "need mmap()")
+    def test_debugmallocstats_hugepage(self):
+        # Huge pages are returned to the system once all their arenas are free
+        code = textwrap.dedent("""
+            import sys
+            x = [str(i) for i in range(1_000_000)]
+            del x
+            sys._debugmallocstats()
+        """)
+        ret, out, err = assert_python_ok('-c', code,
+                                         PYTHONMALLOC='pymalloc_hugepage')
+        total = re.search(rb'# huge pages allocated total +=\s+(\d+)', err)
+        current = re.search(rb'# huge pages allocated current +=\s+(\d+)',
+                            err)
+        self.assertIsNotNone(total)
+        self.assertIsNotNone(current)
+        self.assertLess(int(current[1]), int(total[1]))
+
+    def test_trim_allocator(self):
+        # Keep a few blocks alive so that their arenas can't be freed
+        x = [str(i) for i in range(200_000)]
+        y = x[::10_000]
+        del x
+        trimmed = sys._trim_allocator()
+        self.assertIsInstance(trimmed, int)
+        try:
+            import _testcapi
+        except ImportError:
+            with_pymalloc = support.with_pymalloc()
+        else:
+            try:
+                alloc_name = _testcapi.pymem_getallocatorsname()
+            except RuntimeError:
+                # "cannot get allocators name" (ex: tracemalloc is used)
+                with_pymalloc = support.with_pymalloc()
+            else:
+                with_pymalloc = alloc_name.startswith('pymalloc')
+        if (with_pymalloc and sys.platform != 'win32'
+                and sysconfig.get_config_var('HAVE_MMAP')):
+            self.assertGreater(trimmed, 0)
+        else:
+            self.assertGreaterEqual(trimmed, 0)
+        # The trimmed pools can be used again
+        x = [str(i) for i in range(200_000)]
+        self.assertEqual(x[-1], '199999')
+        self.assertEqual(y[1], '10000')
+
     @unittest.skipUnless(hasattr(sys, "getallocatedblocks"),
                          "sys.getallocatedblocks unavailable on this build")
     def test_getallocatedblocks(self):
@@ -947,7 +1015,7 @@ def test_getallocatedblocks(self):
                 # "cannot get allocators name" (ex: tracemalloc is used)
                 with_pymalloc = True
             else:
-                with_pymalloc = (alloc_name in ('pymalloc', 'pymalloc_debug'))
+                with_pymalloc = alloc_name.startswith('pymalloc')
 
         # Some sanity checks
         a = sys.getallocatedblocks()
@@ -1372,13 +1440,13 @@ def inner():
         # empty dict
         check({}, size('nQ2P'))
         # dict (string key)
-        check({"a": 1}, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 8 + (8*2//3)*calcsize('2P'))
+        check({"a": 1}, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 8 + 8 + (8*2//3)*calcsize('2P'))
         longdict = {str(i): i for i in range(8)}
-        check(longdict, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 16 + (16*2//3)*calcsize('2P'))
+        check(longdict, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 16 + 16 + (16*2//3)*calcsize('2P'))
         # dict (non-string key)
-        check({1: 1}, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 8 + (8*2//3)*calcsize('n2P'))
+        check({1: 1}, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 8 + 8 + (8*2//3)*calcsize('n2P'))
         longdict = {1:1, 2:2, 3:3, 4:4, 5:5, 6:6, 7:7, 8:8}
-        check(longdict, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 16 + (16*2//3)*calcsize('n2P'))
+        check(longdict, size('nQ2P') + calcsize(DICT_KEY_STRUCT_FORMAT) + 16 + 16 + (16*2//3)*calcsize('n2P'))
         # dictionary-keyview
         check({}.keys(), size('P'))
         # dictionary-valueview
@@ -1493,7 +1561,8 @@ def delx(self): del self.__x
         # set
         # frozenset
         PySet_MINSIZE = 8
-        samples = [[], range(10), range(50)]
+        samples = [[], range(10), range(50),
+                   [float(i) for i in range(10)], [(i,) for i in range(50)]]
         s = size('3nP' + PySet_MINSIZE*'nP' + '2nP')
         for sample in samples:
             minused = len(sample)
@@ -1508,8 +1577,14 @@ def delx(self): del self.__x
                 check(set(sample), s)
                 check(frozenset(sample), s)
             else:
-                check(set(sample), s + newsize*calcsize('nP'))
-                check(frozenset(sample), s + newsize*calcsize('nP'))
+                # entries, control bytes, copy of the first group, kind.
+                # The entries of tables of ints and strs have no hash.
+                if all(type(x) in (int, str) for x in sample):
+                    tablesize = newsize*calcsize('P') + newsize + 16
+                else:
+                    tablesize = newsize*calcsize('nP') + newsize + 16
+                check(set(sample), s + tablesize)
+                check(frozenset(sample), s + tablesize)
         # setiterator
         check(iter(set()), size('P3n'))
         # slice
@@ -1536,14 +1611,14 @@ def delx(self): del self.__x
                   )
         class newstyleclass(object): pass
         # Separate block for PyDictKeysObject with 8 keys and 5 entries
-        check(newstyleclass, s + calcsize(DICT_KEY_STRUCT_FORMAT) + 64 + 42*calcsize("2P"))
+        check(newstyleclass, s + calcsize(DICT_KEY_STRUCT_FORMAT) + 64 + 64 + 42*calcsize("2P"))
         # dict with shared keys
         [newstyleclass() for _ in range(100)]
         check(newstyleclass().__dict__, size('nQ2P') + self.P)
         o = newstyleclass()
         o.a = o.b = o.c = o.d = o.e = o.f = o.g = o.h = 1
         # Separate block for PyDictKeysObject with 16 keys and 10 entries
-        check(newstyleclass, s + calcsize(DICT_KEY_STRUCT_FORMAT) + 64 + 42*calcsize("2P"))
+        check(newstyleclass, s + calcsize(DICT_KEY_STRUCT_FORMAT) + 64 + 64 + 42*calcsize("2P"))
         # dict with shared keys
         check(newstyleclass().__dict__, size('nQ2P') + self.P)
         # unicode
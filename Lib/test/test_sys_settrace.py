@@ -2800,6 +2800,82 @@ def foo(*args):
         del foo
         sys.settrace(sys.gettrace())
 
+    @support.cpython_only
+    def test_opcode_events_between_borrowed_loads(self):
+        # Loads consumed by the next instruction skip the reference count
+        # when not traced, but every instruction still gets an event.
+        import dis
+
+        def f(x, y):
+            if x:
+                pass
+            return x < y
+
+        for _ in range(20):
+            f(1, 2)
+        events = []
+        def trace(frame, event, arg):
+            frame.f_trace_opcodes = True
+            if event == 'opcode' and frame.f_code is f.__code__:
+                events.append(frame.f_lasti)
+            return trace
+        sys.settrace(trace)
+        f(1, 2)
+        sys.settrace(None)
+        offsets = [i.offset for i in dis.get_instructions(f)
+                   if i.opname != 'RESUME']
+        self.assertEqual(events, offsets)
+
+    def test_rebind_local_between_borrowed_loads(self):
+        class Operand:
+            def __lt__(self, other):
+                return True
+
+        def f(x, y):
+            return x < y
+
+        count = 0
+        def trace(frame, event, arg):
+            nonlocal count
+            frame.f_trace_opcodes = True
+            if event == 'opcode' and frame.f_code is f.__code__:
+                count += 1
+                if count == 2:
+                    # Drop the last reference to the first operand, after
+                    # it has been loaded
+                    frame.f_locals['x'] = None
+            return trace
+        sys.settrace(trace)
+        self.assertIs(f(Operand(), 1), True)
+        sys.settrace(None)
+
+    def test_settrace_none_between_borrowed_loads(self):
+        def f(x, y):
+            if x is y:
+                pass
+            return x == y
+
+        for _ in range(20):
+            f(1, 2)
+        for stop in range(1, 12):
+            with self.subTest(stop=stop):
+                count = 0
+                def trace(frame, event, arg):
+                    nonlocal count
+                    frame.f_trace_opcodes = True
+                    if event == 'opcode' and frame.f_code is f.__code__:
+                        count += 1
+                        if count == stop:
+                            sys.settrace(None)
+                    return trace
+                x, y = object(), object()
+                refs = sys.getrefcount(x), sys.getrefcount(y)
+                sys.settrace(trace)
+                f(x, y)
+                sys.settrace(None)
+                self.assertEqual((sys.getrefcount(x), sys.getrefcount(y)),
+                                 refs)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,130 @@
+"""Tests for the generate_superinstructions script in the Tools directory."""
+
+import os
+import shutil
+import sys
+import unittest
+from test import support
+from test.support import os_helper
+
+from test.test_tools import basepath, skip_if_missing, import_tool
+
+skip_if_missing()
+
+gen = import_tool('generate_superinstructions')
+
+
+class GenerateSuperinstructionsTests(unittest.TestCase):
+
+    def setUp(self):
+        self.opcode_py = os.path.join(basepath, 'Lib', 'opcode.py')
+        self.module = gen.load_opcode_module(self.opcode_py)
+        self.op = {name: i for i, name in
+                   enumerate(gen.instruction_names(self.module))}
+
+    def stats(self, executions, pairs=(), triples=()):
+        stats = {}
+        for name, count in executions.items():
+            stats[f"opcode[{self.op[name]}].execution_count"] = count
+        for (a, b), count in pairs:
+            stats[f"opcode[{self.op[a]}].pair_count[{self.op[b]}]"] = count
+        for (a, b, c), count in triples:
+            key = f"opcode[{self.op[a]}].triple_count[{self.op[b]}][{self.op[c]}]"
+            stats[key] = count
+        return stats
+
+    def test_sequence_counts(self):
+        stats = self.stats(
+            {"LOAD_FAST": 100, "STORE_FAST__LOAD_FAST": 50, "POP_TOP": 150},
+            pairs=[(("LOAD_FAST", "POP_TOP"), 100),
+                   (("STORE_FAST__LOAD_FAST", "POP_TOP"), 50)],
+            triples=[(("LOAD_CONST", "LOAD_FAST", "POP_TOP"), 30),
+                     (("STORE_FAST__LOAD_FAST", "LOAD_FAST", "POP_TOP"), 20),
+                     (("LOAD_FAST", "STORE_FAST__LOAD_FAST", "POP_TOP"), 40)])
+        counts, total = gen.sequence_counts(stats, self.module)
+        self.assertEqual(total, 300)
+        self.assertEqual(counts[("LOAD_FAST", "POP_TOP")], 150)
+        self.assertEqual(counts[("STORE_FAST", "LOAD_FAST")], 50)
+        self.assertEqual(counts[("STORE_FAST", "LOAD_FAST", "POP_TOP")], 50)
+        self.assertEqual(counts[("LOAD_CONST", "LOAD_FAST", "POP_TOP")], 30)
+        self.assertEqual(counts[("LOAD_FAST", "LOAD_FAST", "POP_TOP")], 20)
+        # A fused middle instruction leaves no triple that spans all three
+        self.assertNotIn(("LOAD_FAST", "STORE_FAST", "LOAD_FAST"), counts)
+
+    def test_choose(self):
+        counts = {
+            ("LOAD_FAST", "LOAD_FAST"): 1000,      # hand-written already
+            ("LOAD_FAST", "BINARY_OP"): 900,       # BINARY_OP has a cache
+            ("LOAD_FAST", "POP_TOP"): 100,
+            ("LOAD_CONST", "LOAD_FAST", "POP_TOP"): 60,
+            ("PUSH_NULL", "LOAD_FAST"): 1,
+        }
+        chosen = gen.choose(counts, 1000, self.module, 8, 0.005)
+        self.assertEqual(chosen, [("LOAD_CONST", "LOAD_FAST", "POP_TOP"),
+                                  ("LOAD_FAST", "POP_TOP")])
+        chosen = gen.choose(counts, 1000, self.module, 1, 0.0)
+        self.assertEqual(chosen, [("LOAD_CONST", "LOAD_FAST", "POP_TOP")])
+
+    def test_write(self):
+        chosen = [("LOAD_CONST", "LOAD_FAST", "POP_TOP"),
+                  ("LOAD_FAST", "POP_TOP")]
+        with os_helper.temp_dir() as tmp:
+            opcode_py = os.path.join(tmp, 'opcode.py')
+            header = os.path.join(tmp, 'superinstructions.h')
+            shutil.copy(self.opcode_py, opcode_py)
+            gen.write_opcode_py(opcode_py, chosen)
+            gen.write_header(header, chosen)
+            module = gen.load_opcode_module(opcode_py)
+            with open(header) as f:
+                source = f.read()
+
+        self.assertEqual(module["_profiled_superinstructions"],
+                         {"LOAD_CONST": ["LOAD_CONST__LOAD_FAST__POP_TOP"],
+                          "LOAD_FAST": ["LOAD_FAST__POP_TOP"]})
+        self.assertIn("LOAD_CONST__LOAD_FAST__POP_TOP",
+                      module["_specializations"]["LOAD_CONST"])
+        self.assertIn("LOAD_FAST__POP_TOP",
+                      module["_specialized_instructions"])
+        self.assertIn("TARGET(LOAD_CONST__LOAD_FAST__POP_TOP)", source)
+        self.assertEqual(source.count("NEXTOPARG();"), 3)
+        self.assertIn("case (LOAD_FAST << 16) | (POP_TOP << 8):", source)
+        self.assertIn("case (LOAD_CONST << 16) | (LOAD_FAST << 8) | POP_TOP:",
+                      source)
+
+    def test_main(self):
+        # The hottest pair has a hand-written superinstruction, which
+        # _PyCode_Quicken() would otherwise apply over the profiled one.
+        stats = self.stats(
+            {"LOAD_FAST": 1000, "STORE_FAST": 1000, "POP_TOP": 1000},
+            pairs=[(("LOAD_FAST", "LOAD_FAST"), 5000),
+                   (("STORE_FAST", "LOAD_FAST"), 900),
+                   (("LOAD_FAST", "POP_TOP"), 500)],
+            triples=[(("STORE_FAST", "LOAD_FAST", "POP_TOP"), 300)])
+        with os_helper.temp_dir() as tmp:
+            stats_dir = os.path.join(tmp, 'py_stats')
+            os.mkdir(stats_dir)
+            with open(os.path.join(stats_dir, 'stats.txt'), 'w') as f:
+                for key, value in stats.items():
+                    f.write(f"{key} : {value}\n")
+            opcode_py = os.path.join(tmp, 'opcode.py')
+            header = os.path.join(tmp, 'superinstructions.h')
+            shutil.copy(self.opcode_py, opcode_py)
+            args = [opcode_py, header, '--stats-dir', stats_dir]
+            with support.swap_attr(sys, 'argv', ['generate', *args]), \
+                 support.captured_stdout():
+                gen.main()
+            module = gen.load_opcode_module(opcode_py)
+            with open(header) as f:
+                source = f.read()
+
+        self.assertEqual(module["_profiled_superinstructions"],
+                         {"LOAD_FAST": ["LOAD_FAST__POP_TOP"],
+                          "STORE_FAST": ["STORE_FAST__LOAD_FAST__POP_TOP"]})
+        self.assertIn("TARGET(STORE_FAST__LOAD_FAST__POP_TOP)", source)
+        self.assertIn("TARGET(LOAD_FAST__POP_TOP)", source)
+        self.assertNotIn("TARGET(LOAD_FAST__LOAD_FAST)", source)
+        self.assertNotIn("TARGET(STORE_FAST__LOAD_FAST)", source)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,85 @@
+"""Tests for the heap_snapshot script in the Tools directory."""
+
+import gc
+import io
+import sys
+import unittest
+from test.support import os_helper
+
+from test.test_tools import skip_if_missing, import_tool
+
+skip_if_missing()
+
+heap_snapshot = import_tool('heap_snapshot')
+
+
+class Node:
+    pass
+
+
+class HeapSnapshotTests(unittest.TestCase):
+
+    def dump(self):
+        self.addCleanup(os_helper.unlink, os_helper.TESTFN)
+        gc.dump_heap(os_helper.TESTFN)
+        return heap_snapshot.read_snapshot(os_helper.TESTFN)
+
+    def test_read_snapshot(self):
+        a = Node()
+        b = Node()
+        a.b = b
+        a.name = "heap snapshot test"
+        snapshot = self.dump()
+        self.assertGreater(snapshot.nnodes, 0)
+        i = snapshot.index[id(a)]
+        self.assertEqual(snapshot.type_name(i), "Node")
+        self.assertEqual(snapshot.refcounts[i], sys.getrefcount(a) - 1)
+        # a refers to its type and to its attributes, either directly or
+        # through its __dict__
+        self.assertIn(id(Node), snapshot.edges[i])
+        referents = list(snapshot.edges[i])
+        for j in snapshot.successors(i):
+            referents.extend(snapshot.edges[j])
+        self.assertIn(id(b), referents)
+        self.assertIn(id(a.name), referents)
+        s = snapshot.index[id(a.name)]
+        self.assertEqual(snapshot.type_name(s), "str")
+        self.assertEqual(snapshot.edges[s], [])
+
+    def test_retained_size(self):
+        holder = Node()
+        holder.items = [bytes(10_000) for i in range(10)]
+        snapshot = self.dump()
+        roots = heap_snapshot.find_roots(snapshot)
+        idom, postorder = heap_snapshot.dominators(snapshot, roots)
+        retained = heap_snapshot.retained_sizes(snapshot, idom, postorder)
+        i = snapshot.index[id(holder)]
+        self.assertIn(i, roots)
+        self.assertGreaterEqual(retained[i], 100_000)
+        for item in holder.items:
+            j = snapshot.index[id(item)]
+            self.assertEqual(idom[j], snapshot.index[id(holder.items)])
+            self.assertEqual(retained[j], snapshot.sizes[j])
+
+    def test_summarize(self):
+        snapshot = self.dump()
+        out = io.StringIO()
+        heap_snapshot.summarize(snapshot, 5, out=out)
+        self.assertIn("tracked objects", out.getvalue())
+        self.assertIn("retained", out.getvalue())
+
+    def test_invalid(self):
+        self.addCleanup(os_helper.unlink, os_helper.TESTFN)
+        with open(os_helper.TESTFN, "wb") as f:
+            f.write(b"not a snapshot")
+        with self.assertRaises(heap_snapshot.SnapshotError):
+            heap_snapshot.read_snapshot(os_helper.TESTFN)
+        gc.dump_heap(os_helper.TESTFN)
+        with open(os_helper.TESTFN, "r+b") as f:
+            f.truncate(100)
+        with self.assertRaises(heap_snapshot.SnapshotError):
+            heap_snapshot.read_snapshot(os_helper.TESTFN)
+
+
+if __name__ == '__main__':
+    unittest.main()
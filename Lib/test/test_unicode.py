@@ -272,6 +272,15 @@ def test_find(self):
         self.checkequal(-1, 'a' * 100, 'find', 'a\u0102')
         self.checkequal(-1, 'a' * 100, 'find', 'a\U00100304')
         self.checkequal(-1, '\u0102' * 100, 'find', '\u0102\U00100304')
+        # test the vectorized search in the wide kinds
+        self.checkequal(200, '\u0161\u0162' * 100 + '\u0161\u0163', 'find',
+                        '\u0161\u0163')
+        self.checkequal(-1, '\u0161\u0162' * 100, 'find', '\u0161\u0163')
+        self.checkequal(100, '\u0161\u0162' * 100, 'count', '\u0161\u0162')
+        self.checkequal(200, '\U00010161a' * 100 + '\U00010161b', 'find',
+                        '\U00010161b')
+        self.checkequal(-1, '\U00010161a' * 100, 'find', '\U00010161b')
+        self.checkequal(100, '\U00010161a' * 100, 'count', '\U00010161a')
 
     def test_rfind(self):
         string_tests.CommonTest.test_rfind(self)
@@ -1835,6 +1844,43 @@ def test_utf8_decode_invalid_sequences(self):
             self.assertRaises(UnicodeDecodeError,
                               (b'\xF4'+cb+b'\xBF\xBF').decode, 'utf-8')
 
+    def test_utf8_decode_long_sequences(self):
+        # Long runs of multi-byte sequences are validated and decoded 16
+        # bytes at a time: check valid and invalid sequences at every
+        # offset in a block.
+        texts = [
+            '\xe9' * 100,                   # 2-byte, UCS1
+            '\u0436' * 100,                 # 2-byte, UCS2
+            '\u65e5\u672c' * 50,            # 3-byte
+            '\U0001f600' * 50,              # 4-byte
+            ('\xe9\u0436 \u65e5a\U0001f600\u07ff\uffff\U0010ffff'
+             '\x80\u0800\ud7ff\ue000\U00010000') * 10,
+        ]
+        invalid = [
+            b'\x80', b'\xbf', b'\xc0\x80', b'\xc1\xbf', b'\xe0\x9f\xbf',
+            b'\xed\xa0\x80', b'\xf0\x8f\xbf\xbf', b'\xf4\x90\x80\x80',
+            b'\xf5\x80\x80\x80', b'\xff', b'\xc3', b'\xe6\x97', b'\xf0\x9f\x98',
+        ]
+        for text in texts:
+            self.assertEqual(text.encode('utf-8').decode('utf-8'), text)
+            for i in range(40):
+                prefix, suffix = text[:i], text[i:]
+                head = prefix.encode('utf-8')
+                self.assertEqual(
+                    (head + suffix.encode('utf-8')).decode('utf-8'), text)
+                for seq in invalid:
+                    data = head + seq + suffix.encode('utf-8')
+                    with self.assertRaises(UnicodeDecodeError) as cm:
+                        data.decode('utf-8')
+                    self.assertEqual(cm.exception.start, len(head))
+                    self.assertEqual(
+                        data.decode('utf-8', 'replace'),
+                        prefix + seq.decode('utf-8', 'replace') + suffix)
+                    self.assertEqual(
+                        data.decode('utf-8', 'surrogateescape'),
+                        prefix + seq.decode('utf-8', 'surrogateescape') +
+                        suffix)
+
     def test_issue8271(self):
         # Issue #8271: during the decoding of an invalid UTF-8 byte sequence,
         # only the start byte and the continuation byte(s) are now considered
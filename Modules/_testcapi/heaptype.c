@@ -518,6 +518,83 @@ static PyType_Spec HeapCType_spec = {
     HeapCType_slots
 };
 
+PyDoc_STRVAR(heapcachedctype__doc__,
+"A heap type without GC, whose instances are cached.\n\n"
+"The 'value' attribute is set to 10 in __init__.");
+
+static void
+heapcachedctype_dealloc(HeapCTypeObject *self)
+{
+    PyTypeObject *tp = Py_TYPE(self);
+    tp->tp_free(self);
+    Py_DECREF(tp);
+}
+
+static PyType_Slot HeapCachedCType_slots[] = {
+    {Py_tp_init, heapctype_init},
+    {Py_tp_members, heapctype_members},
+    {Py_tp_dealloc, heapcachedctype_dealloc},
+    {Py_tp_doc, (char*)heapcachedctype__doc__},
+    {0, 0},
+};
+
+static PyType_Spec HeapCachedCType_spec = {
+    "_testcapi.HeapCachedCType",
+    sizeof(HeapCTypeObject),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_OBJECT_CACHE,
+    HeapCachedCType_slots
+};
+
+PyDoc_STRVAR(heapgccachedctype__doc__,
+"A heap type with GC, whose instances are cached.\n\n"
+"The 'value' attribute is set to 10 in __init__.");
+
+static void
+heapgccachedctype_dealloc(HeapCTypeObject *self)
+{
+    PyTypeObject *tp = Py_TYPE(self);
+    PyObject_GC_UnTrack(self);
+    tp->tp_free(self);
+    Py_DECREF(tp);
+}
+
+static PyType_Slot HeapGcCachedCType_slots[] = {
+    {Py_tp_init, heapctype_init},
+    {Py_tp_members, heapctype_members},
+    {Py_tp_dealloc, heapgccachedctype_dealloc},
+    {Py_tp_traverse, heapgcctype_traverse},
+    {Py_tp_doc, (char*)heapgccachedctype__doc__},
+    {0, 0},
+};
+
+static PyType_Spec HeapGcCachedCType_spec = {
+    "_testcapi.HeapGcCachedCType",
+    sizeof(HeapCTypeObject),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC
+        | Py_TPFLAGS_OBJECT_CACHE,
+    HeapGcCachedCType_slots
+};
+
+PyDoc_STRVAR(heapcachedctypegcsubclass__doc__,
+"Subclass of HeapCachedCType, with GC and without tp_free.");
+
+static PyType_Slot HeapCachedCTypeGcSubclass_slots[] = {
+    {Py_tp_dealloc, heapgccachedctype_dealloc},
+    {Py_tp_traverse, heapgcctype_traverse},
+    {Py_tp_doc, (char*)heapcachedctypegcsubclass__doc__},
+    {0, 0},
+};
+
+static PyType_Spec HeapCachedCTypeGcSubclass_spec = {
+    "_testcapi.HeapCachedCTypeGcSubclass",
+    sizeof(HeapCTypeObject),
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    HeapCachedCTypeGcSubclass_slots
+};
+
 PyDoc_STRVAR(heapctypesubclass__doc__,
 "Subclass of HeapCType, without GC.\n\n"
 "__init__ sets the 'value' attribute to 10 and 'value2' to 20.");
@@ -996,6 +1073,26 @@ _PyTestCapi_Init_Heaptype(PyObject *m) {
     }
     PyModule_AddObject(m, "HeapGcCType", HeapGcCType);
 
+    PyObject *HeapCachedCType = PyType_FromSpec(&HeapCachedCType_spec);
+    if (HeapCachedCType == NULL) {
+        return -1;
+    }
+    PyModule_AddObject(m, "HeapCachedCType", HeapCachedCType);
+
+    PyObject *HeapCachedCTypeGcSubclass = PyType_FromSpecWithBases(
+        &HeapCachedCTypeGcSubclass_spec, HeapCachedCType);
+    if (HeapCachedCTypeGcSubclass == NULL) {
+        return -1;
+    }
+    PyModule_AddObject(m, "HeapCachedCTypeGcSubclass",
+                       HeapCachedCTypeGcSubclass);
+
+    PyObject *HeapGcCachedCType = PyType_FromSpec(&HeapGcCachedCType_spec);
+    if (HeapGcCachedCType == NULL) {
+        return -1;
+    }
+    PyModule_AddObject(m, "HeapGcCachedCType", HeapGcCachedCType);
+
     PyObject *HeapCType = PyType_FromSpec(&HeapCType_spec);
     if (HeapCType == NULL) {
         return -1;
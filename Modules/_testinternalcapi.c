@@ -532,6 +532,26 @@ set_eval_frame_record(PyObject *self, PyObject *list)
     Py_RETURN_NONE;
 }
 
+static PyObject *
+get_attr_poly_caches_handed_out(PyObject *self, PyObject *Py_UNUSED(args))
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    return PyLong_FromSize_t(interp->types.attr_poly_caches.handed_out);
+}
+
+#ifdef _Py_JIT
+static PyObject *
+has_jit_code(PyObject *self, PyObject *code)
+{
+    if (!PyCode_Check(code)) {
+        PyErr_SetString(PyExc_TypeError, "argument must be a code object");
+        return NULL;
+    }
+    return PyBool_FromLong(((PyCodeObject *)code)->_co_jit != NULL);
+}
+#endif
+
+
 
 /*[clinic input]
 
@@ -570,6 +590,11 @@ static PyMethodDef TestMethods[] = {
     {"DecodeLocaleEx", decode_locale_ex, METH_VARARGS},
     {"set_eval_frame_default", set_eval_frame_default, METH_NOARGS, NULL},
     {"set_eval_frame_record", set_eval_frame_record, METH_O, NULL},
+    {"get_attr_poly_caches_handed_out", get_attr_poly_caches_handed_out,
+     METH_NOARGS, NULL},
+#ifdef _Py_JIT
+    {"has_jit_code", has_jit_code, METH_O, NULL},
+#endif
     _TESTINTERNALCAPI_OPTIMIZE_CFG_METHODDEF
     {NULL, NULL} /* sentinel */
 };
@@ -2854,7 +2854,7 @@ static PyType_Spec array_spec = {
     .basicsize = sizeof(arrayobject),
     .flags = (Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE |
               Py_TPFLAGS_IMMUTABLETYPE | Py_TPFLAGS_HAVE_GC |
-              Py_TPFLAGS_SEQUENCE),
+              Py_TPFLAGS_SEQUENCE | _Py_TPFLAGS_ARRAY),
     .slots = array_slots,
 };
 
@@ -249,6 +249,258 @@ gc_get_count(PyObject *module, PyObject *Py_UNUSED(ignored))
     return gc_get_count_impl(module);
 }
 
+PyDoc_STRVAR(gc_set_pause_budget__doc__,
+"set_pause_budget($module, budget, /)\n"
+"--\n"
+"\n"
+"Set the pause budget of automatic collections, in seconds.\n"
+"\n"
+"Automatic collections of the oldest generation are split into increments\n"
+"which each take about budget seconds.  0 disables incremental collection.");
+
+#define GC_SET_PAUSE_BUDGET_METHODDEF    \
+    {"set_pause_budget", (PyCFunction)gc_set_pause_budget, METH_O, gc_set_pause_budget__doc__},
+
+static PyObject *
+gc_set_pause_budget_impl(PyObject *module, double budget);
+
+static PyObject *
+gc_set_pause_budget(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    double budget;
+
+    if (PyFloat_CheckExact(arg)) {
+        budget = PyFloat_AS_DOUBLE(arg);
+    }
+    else
+    {
+        budget = PyFloat_AsDouble(arg);
+        if (budget == -1.0 && PyErr_Occurred()) {
+            goto exit;
+        }
+    }
+    return_value = gc_set_pause_budget_impl(module, budget);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_pause_budget__doc__,
+"get_pause_budget($module, /)\n"
+"--\n"
+"\n"
+"Return the pause budget of automatic collections, in seconds.");
+
+#define GC_GET_PAUSE_BUDGET_METHODDEF    \
+    {"get_pause_budget", (PyCFunction)gc_get_pause_budget, METH_NOARGS, gc_get_pause_budget__doc__},
+
+static double
+gc_get_pause_budget_impl(PyObject *module);
+
+static PyObject *
+gc_get_pause_budget(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    double _return_value;
+
+    _return_value = gc_get_pause_budget_impl(module);
+    if ((_return_value == -1.0) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyFloat_FromDouble(_return_value);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_set_threshold_policy__doc__,
+"set_threshold_policy($module, policy, /)\n"
+"--\n"
+"\n"
+"Set the policy deciding when automatic collections happen.\n"
+"\n"
+"\"fixed\" collects each generation when its count exceeds its threshold.\n"
+"\"adaptive\" scales the thresholds according to the share of garbage found\n"
+"by the recent collections and to the time spent collecting.");
+
+#define GC_SET_THRESHOLD_POLICY_METHODDEF    \
+    {"set_threshold_policy", (PyCFunction)gc_set_threshold_policy, METH_O, gc_set_threshold_policy__doc__},
+
+static PyObject *
+gc_set_threshold_policy_impl(PyObject *module, const char *policy);
+
+static PyObject *
+gc_set_threshold_policy(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    const char *policy;
+
+    if (!PyUnicode_Check(arg)) {
+        _PyArg_BadArgument("set_threshold_policy", "argument", "str", arg);
+        goto exit;
+    }
+    Py_ssize_t policy_length;
+    policy = PyUnicode_AsUTF8AndSize(arg, &policy_length);
+    if (policy == NULL) {
+        goto exit;
+    }
+    if (strlen(policy) != (size_t)policy_length) {
+        PyErr_SetString(PyExc_ValueError, "embedded null character");
+        goto exit;
+    }
+    return_value = gc_set_threshold_policy_impl(module, policy);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_threshold_policy__doc__,
+"get_threshold_policy($module, /)\n"
+"--\n"
+"\n"
+"Return the policy deciding when automatic collections happen.");
+
+#define GC_GET_THRESHOLD_POLICY_METHODDEF    \
+    {"get_threshold_policy", (PyCFunction)gc_get_threshold_policy, METH_NOARGS, gc_get_threshold_policy__doc__},
+
+static PyObject *
+gc_get_threshold_policy_impl(PyObject *module);
+
+static PyObject *
+gc_get_threshold_policy(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_threshold_policy_impl(module);
+}
+
+PyDoc_STRVAR(gc_set_object_cache_size__doc__,
+"set_object_cache_size($module, type, size, /)\n"
+"--\n"
+"\n"
+"Set the maximum number of freed instances of type kept for reuse.\n"
+"\n"
+"type must have the Py_TPFLAGS_OBJECT_CACHE flag.");
+
+#define GC_SET_OBJECT_CACHE_SIZE_METHODDEF    \
+    {"set_object_cache_size", _PyCFunction_CAST(gc_set_object_cache_size), METH_FASTCALL, gc_set_object_cache_size__doc__},
+
+static PyObject *
+gc_set_object_cache_size_impl(PyObject *module, PyTypeObject *type,
+                              Py_ssize_t size);
+
+static PyObject *
+gc_set_object_cache_size(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *return_value = NULL;
+    PyTypeObject *type;
+    Py_ssize_t size;
+
+    if (!_PyArg_CheckPositional("set_object_cache_size", nargs, 2, 2)) {
+        goto exit;
+    }
+    if (!PyObject_TypeCheck(args[0], &PyType_Type)) {
+        _PyArg_BadArgument("set_object_cache_size", "argument 1", (&PyType_Type)->tp_name, args[0]);
+        goto exit;
+    }
+    type = (PyTypeObject *)args[0];
+    {
+        Py_ssize_t ival = -1;
+        PyObject *iobj = _PyNumber_Index(args[1]);
+        if (iobj != NULL) {
+            ival = PyLong_AsSsize_t(iobj);
+            Py_DECREF(iobj);
+        }
+        if (ival == -1 && PyErr_Occurred()) {
+            goto exit;
+        }
+        size = ival;
+    }
+    return_value = gc_set_object_cache_size_impl(module, type, size);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_object_cache_stats__doc__,
+"get_object_cache_stats($module, /)\n"
+"--\n"
+"\n"
+"Return the statistics of the object caches.\n"
+"\n"
+"The result maps each type whose instances are cached to a dict with the\n"
+"current and maximum number of cached instances, and the numbers of\n"
+"allocations which did and didn\'t reuse a cached instance.");
+
+#define GC_GET_OBJECT_CACHE_STATS_METHODDEF    \
+    {"get_object_cache_stats", (PyCFunction)gc_get_object_cache_stats, METH_NOARGS, gc_get_object_cache_stats__doc__},
+
+static PyObject *
+gc_get_object_cache_stats_impl(PyObject *module);
+
+static PyObject *
+gc_get_object_cache_stats(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_object_cache_stats_impl(module);
+}
+
+PyDoc_STRVAR(gc_set_mark_threads__doc__,
+"set_mark_threads($module, threads, /)\n"
+"--\n"
+"\n"
+"Set the number of threads marking the objects of full collections.\n"
+"\n"
+"With 1 (the default), the objects are marked in the calling thread only.");
+
+#define GC_SET_MARK_THREADS_METHODDEF    \
+    {"set_mark_threads", (PyCFunction)gc_set_mark_threads, METH_O, gc_set_mark_threads__doc__},
+
+static PyObject *
+gc_set_mark_threads_impl(PyObject *module, int threads);
+
+static PyObject *
+gc_set_mark_threads(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    int threads;
+
+    threads = _PyLong_AsInt(arg);
+    if (threads == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = gc_set_mark_threads_impl(module, threads);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_mark_threads__doc__,
+"get_mark_threads($module, /)\n"
+"--\n"
+"\n"
+"Return the number of threads marking the objects of full collections.");
+
+#define GC_GET_MARK_THREADS_METHODDEF    \
+    {"get_mark_threads", (PyCFunction)gc_get_mark_threads, METH_NOARGS, gc_get_mark_threads__doc__},
+
+static int
+gc_get_mark_threads_impl(PyObject *module);
+
+static PyObject *
+gc_get_mark_threads(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    int _return_value;
+
+    _return_value = gc_get_mark_threads_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromLong((long)_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(gc_get_objects__doc__,
 "get_objects($module, /, generation=None)\n"
 "--\n"
@@ -356,25 +608,73 @@ PyDoc_STRVAR(gc_is_finalized__doc__,
     {"is_finalized", (PyCFunction)gc_is_finalized, METH_O, gc_is_finalized__doc__},
 
 PyDoc_STRVAR(gc_freeze__doc__,
-"freeze($module, /)\n"
+"freeze($module, /, *, immortalize=False)\n"
 "--\n"
 "\n"
 "Freeze all current tracked objects and ignore them for future collections.\n"
 "\n"
 "This can be used before a POSIX fork() call to make the gc copy-on-write friendly.\n"
 "Note: collection before a POSIX fork() call may free pages for future allocation\n"
-"which can cause copy-on-write.");
+"which can cause copy-on-write.\n"
+"\n"
+"If immortalize is true, the objects are made immortal instead: their\n"
+"reference counts are no longer updated and they are never deallocated.");
 
 #define GC_FREEZE_METHODDEF    \
-    {"freeze", (PyCFunction)gc_freeze, METH_NOARGS, gc_freeze__doc__},
+    {"freeze", _PyCFunction_CAST(gc_freeze), METH_FASTCALL|METH_KEYWORDS, gc_freeze__doc__},
 
 static PyObject *
-gc_freeze_impl(PyObject *module);
+gc_freeze_impl(PyObject *module, int immortalize);
 
 static PyObject *
-gc_freeze(PyObject *module, PyObject *Py_UNUSED(ignored))
+gc_freeze(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
 {
-    return gc_freeze_impl(module);
+    PyObject *return_value = NULL;
+    #if defined(Py_BUILD_CORE) && !defined(Py_BUILD_CORE_MODULE)
+
+    #define NUM_KEYWORDS 1
+    static struct {
+        PyGC_Head _this_is_not_used;
+        PyObject_VAR_HEAD
+        PyObject *ob_item[NUM_KEYWORDS];
+    } _kwtuple = {
+        .ob_base = PyVarObject_HEAD_INIT(&PyTuple_Type, NUM_KEYWORDS)
+        .ob_item = { &_Py_ID(immortalize), },
+    };
+    #undef NUM_KEYWORDS
+    #define KWTUPLE (&_kwtuple.ob_base.ob_base)
+
+    #else  // !Py_BUILD_CORE
+    #  define KWTUPLE NULL
+    #endif  // !Py_BUILD_CORE
+
+    static const char * const _keywords[] = {"immortalize", NULL};
+    static _PyArg_Parser _parser = {
+        .keywords = _keywords,
+        .fname = "freeze",
+        .kwtuple = KWTUPLE,
+    };
+    #undef KWTUPLE
+    PyObject *argsbuf[1];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
+    int immortalize = 0;
+
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 0, 0, argsbuf);
+    if (!args) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
+    immortalize = _PyLong_AsInt(args[0]);
+    if (immortalize == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+skip_optional_kwonly:
+    return_value = gc_freeze_impl(module, immortalize);
+
+exit:
+    return return_value;
 }
 
 PyDoc_STRVAR(gc_unfreeze__doc__,
@@ -424,4 +724,39 @@ gc_get_freeze_count(PyObject *module, PyObject *Py_UNUSED(ignored))
 exit:
     return return_value;
 }
-/*[clinic end generated code: output=66432ac0e17fd04f input=a9049054013a1b77]*/
+
+PyDoc_STRVAR(gc_dump_heap__doc__,
+"dump_heap($module, path, /)\n"
+"--\n"
+"\n"
+"Write a snapshot of all objects tracked by the collector to a file.\n"
+"\n"
+"The nodes of the snapshot are the tracked objects and their edges are the\n"
+"references between them.  Return the number of tracked objects written.");
+
+#define GC_DUMP_HEAP_METHODDEF    \
+    {"dump_heap", (PyCFunction)gc_dump_heap, METH_O, gc_dump_heap__doc__},
+
+static Py_ssize_t
+gc_dump_heap_impl(PyObject *module, PyObject *path);
+
+static PyObject *
+gc_dump_heap(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    PyObject *path;
+    Py_ssize_t _return_value;
+
+    if (!PyUnicode_FSDecoder(arg, &path)) {
+        goto exit;
+    }
+    _return_value = gc_dump_heap_impl(module, path);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromSsize_t(_return_value);
+
+exit:
+    return return_value;
+}
+/*[clinic end generated code: output=3036cf7e59e2991f input=a9049054013a1b77]*/
@@ -25,11 +25,13 @@
 
 #include "Python.h"
 #include "pycore_context.h"
+#include "pycore_hashtable.h"   // _Py_hashtable_t
 #include "pycore_initconfig.h"
 #include "pycore_interp.h"      // PyInterpreterState.gc
 #include "pycore_object.h"
 #include "pycore_pyerrors.h"
 #include "pycore_pystate.h"     // _PyThreadState_GET()
+#include "pycore_typeobject.h"  // _PyType_GetObjectCacheStats()
 #include "pydtrace.h"
 
 typedef struct _gc_runtime_state GCState;
@@ -127,6 +129,10 @@ gc_decref(PyGC_Head *g)
 
 #define GEN_HEAD(gcstate, n) (&(gcstate)->generations[n].head)
 
+/* Number of objects in an increment of the oldest generation */
+#define INITIAL_INCREMENT_SIZE  10000
+#define MIN_INCREMENT_SIZE      1000
+
 
 static GCState *
 get_gc_state(void)
@@ -139,11 +145,12 @@ get_gc_state(void)
 void
 _PyGC_InitState(GCState *gcstate)
 {
-#define INIT_HEAD(GEN) \
+#define INIT_LIST(LIST) \
     do { \
-        GEN.head._gc_next = (uintptr_t)&GEN.head; \
-        GEN.head._gc_prev = (uintptr_t)&GEN.head; \
+        LIST._gc_next = (uintptr_t)&LIST; \
+        LIST._gc_prev = (uintptr_t)&LIST; \
     } while (0)
+#define INIT_HEAD(GEN) INIT_LIST(GEN.head)
 
     for (int i = 0; i < NUM_GENERATIONS; i++) {
         assert(gcstate->generations[i].count == 0);
@@ -152,7 +159,13 @@ _PyGC_InitState(GCState *gcstate)
     gcstate->generation0 = GEN_HEAD(gcstate, 0);
     INIT_HEAD(gcstate->permanent_generation);
 
+    INIT_LIST(gcstate->old_unscanned);
+    INIT_LIST(gcstate->old_queued);
+    gcstate->increment_size = INITIAL_INCREMENT_SIZE;
+    gcstate->mark_threads = 1;
+
 #undef INIT_HEAD
+#undef INIT_LIST
 }
 
 
@@ -224,6 +237,10 @@ NEXT_MASK_UNREACHABLE
     The flag is unset and the object is moved back to "reachable" set.
 
     move_legacy_finalizers() will remove this flag from "unreachable" set.
+
+_PyGC_NEXT_MASK_QUEUED
+    Set on the objects of old_queued, see "Incremental collection of the
+    oldest generation" below.  Objects being collected never have it.
 */
 
 /*** list functions ***/
@@ -400,6 +417,7 @@ validate_list(PyGC_Head *head, enum flagstates flags)
         assert(trueprev == prev);
         assert((gc->_gc_prev & PREV_MASK_COLLECTING) == prev_value);
         assert((gc->_gc_next & NEXT_MASK_UNREACHABLE) == next_value);
+        assert((gc->_gc_next & _PyGC_NEXT_MASK_QUEUED) == 0);
         prev = gc;
         gc = truenext;
     }
@@ -1043,6 +1061,7 @@ clear_freelists(PyInterpreterState *interp)
     _PyDict_ClearFreeList(interp);
     _PyAsyncGen_ClearFreeLists(interp);
     _PyContext_ClearFreeList(interp);
+    _PyType_ClearObjectCaches(interp);
 }
 
 // Show stats for objects in each generations
@@ -1053,9 +1072,12 @@ show_stats_each_generations(GCState *gcstate)
     size_t pos = 0;
 
     for (int i = 0; i < NUM_GENERATIONS && pos < sizeof(buf); i++) {
-        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos,
-                             " %zd",
-                             gc_list_size(GEN_HEAD(gcstate, i)));
+        Py_ssize_t size = gc_list_size(GEN_HEAD(gcstate, i));
+        if (i == NUM_GENERATIONS - 1) {
+            size += gc_list_size(&gcstate->old_unscanned);
+            size += gc_list_size(&gcstate->old_queued);
+        }
+        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos, " %zd", size);
     }
 
     PySys_FormatStderr(
@@ -1143,264 +1165,980 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
     validate_list(unreachable, collecting_set_unreachable_set);
 }
 
-/* Handle objects that may have resurrected after a call to 'finalize_garbage', moving
-   them to 'old_generation' and placing the rest on 'still_unreachable'.
+/* Parallel marking.
 
-   Contracts:
-       * After this function 'unreachable' must not be used anymore and 'still_unreachable'
-         will contain the objects that did not resurrect.
+When the number of mark threads is greater than 1 (see gc.set_mark_threads()),
+full collections of large heaps compute the same result as
+deduce_unreachable() with helper threads.  The objects being collected are
+first copied to an array, which is split in one range per thread, then:
 
-       * The "still_unreachable" list must be uninitialized (this function calls
-         gc_list_init over 'still_unreachable').
+1. Each thread sets gc_refs = ob_refcnt for the objects of its range, like
+   update_refs().
 
-IMPORTANT: After a call to this function, the 'still_unreachable' set will have the
-PREV_MARK_COLLECTING set, but the objects in this set are going to be removed so
-we can skip the expense of clearing the flag to avoid extra iteration. */
-static inline void
-handle_resurrected_objects(PyGC_Head *unreachable, PyGC_Head* still_unreachable,
-                           PyGC_Head *old_generation)
-{
-    // Remove the PREV_MASK_COLLECTING from unreachable
-    // to prepare it for a new call to 'deduce_unreachable'
-    gc_list_clear_collecting(unreachable);
+2. Each thread subtracts the internal references of its range, like
+   subtract_refs().  Objects can be referred to from several ranges, so
+   gc_refs is decremented with atomic operations.
 
-    // After the call to deduce_unreachable, the 'still_unreachable' set will
-    // have the PREV_MARK_COLLECTING set, but the objects are going to be
-    // removed so we can skip the expense of clearing the flag.
-    PyGC_Head* resurrected = unreachable;
-    deduce_unreachable(resurrected, still_unreachable);
-    clear_unreachable_mask(still_unreachable);
+3. Each thread marks the objects of its range with gc_refs > 0, and the
+   objects reachable from them, as reachable: marking atomically clears
+   PREV_MASK_COLLECTING, so that exactly one thread traverses each reachable
+   object.  The objects left to traverse are pushed on the thread's deque;
+   a thread whose deque is empty steals half of the deque of another one.
 
-    // Move the resurrected objects to the old generation for future collection.
-    gc_list_merge(resurrected, old_generation);
-}
+4. The calling thread moves the objects still having PREV_MASK_COLLECTING
+   to 'unreachable', leaving the lists in the state move_unreachable()
+   leaves them in.
 
-/* This is the main function.  Read this to understand how the
- * collection process works. */
-static Py_ssize_t
-gc_collect_main(PyThreadState *tstate, int generation,
-                Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
-                int nofail)
-{
-    int i;
-    Py_ssize_t m = 0; /* # objects collected */
-    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
-    PyGC_Head *young; /* the generation we are examining */
-    PyGC_Head *old; /* next older generation */
-    PyGC_Head unreachable; /* non-problematic unreachable trash */
-    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
-    PyGC_Head *gc;
-    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
-    GCState *gcstate = &tstate->interp->gc;
+The threads only call tp_traverse, which must not call Python code: the
+calling thread holds the GIL and waits for them.  The helper threads are
+started for each collection, and have no thread state.
 
-    // gc_collect_main() must not be called before _PyGC_Init
-    // or after _PyGC_Fini()
-    assert(gcstate->garbage != NULL);
-    assert(!_PyErr_Occurred(tstate));
+If a deque can't grow, the marks are discarded and move_unreachable() runs
+instead: gc_refs is still valid after step 3.
+*/
 
-    if (gcstate->debug & DEBUG_STATS) {
-        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
-        show_stats_each_generations(gcstate);
-        t1 = _PyTime_GetPerfCounter();
-    }
+#define MAX_MARK_THREADS        256
 
-    if (PyDTrace_GC_START_ENABLED())
-        PyDTrace_GC_START(generation);
+#ifdef HAVE_BUILTIN_ATOMIC
+#  define GC_PARALLEL
+#endif
 
-    /* update collection and allocation counters */
-    if (generation+1 < NUM_GENERATIONS)
-        gcstate->generations[generation+1].count += 1;
-    for (i = 0; i <= generation; i++)
-        gcstate->generations[i].count = 0;
+#ifdef GC_PARALLEL
 
-    /* merge younger generations with one we are currently collecting */
-    for (i = 0; i < generation; i++) {
-        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
-    }
+#ifdef HAVE_SCHED_H
+#  include <sched.h>              // sched_yield()
+#endif
 
-    /* handy references */
-    young = GEN_HEAD(gcstate, generation);
-    if (generation < NUM_GENERATIONS-1)
-        old = GEN_HEAD(gcstate, generation+1);
-    else
-        old = young;
-    validate_list(old, collecting_clear_unreachable_clear);
+/* Smaller collections are faster without helper threads */
+#define PARALLEL_MIN_OBJECTS    100000
+#define PARALLEL_STEAL_MAX      64
 
-    deduce_unreachable(young, &unreachable);
+#define ATOMIC_LOAD(p)          __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(p, v)      __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ATOMIC_ADD(p, v)        __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
 
-    untrack_tuples(young);
-    /* Move reachable objects to next generation. */
-    if (young != old) {
-        if (generation == NUM_GENERATIONS - 2) {
-            gcstate->long_lived_pending += gc_list_size(young);
-        }
-        gc_list_merge(young, old);
-    }
-    else {
-        /* We only un-track dicts in full collections, to avoid quadratic
-           dict build-up. See issue #14775. */
-        untrack_dicts(young);
-        gcstate->long_lived_pending = 0;
-        gcstate->long_lived_total = gc_list_size(young);
-    }
+static inline void
+mark_yield(void)
+{
+#ifdef HAVE_SCHED_H
+    sched_yield();
+#endif
+}
 
-    /* All objects in unreachable are trash, but objects reachable from
-     * legacy finalizers (e.g. tp_del) can't safely be deleted.
-     */
-    gc_list_init(&finalizers);
-    // NEXT_MASK_UNREACHABLE is cleared here.
-    // After move_legacy_finalizers(), unreachable is normal list.
-    move_legacy_finalizers(&unreachable, &finalizers);
-    /* finalizers contains the unreachable objects with a legacy finalizer;
-     * unreachable objects reachable *from* those are also uncollectable,
-     * and we move those into the finalizers list too.
-     */
-    move_legacy_finalizer_reachable(&finalizers);
+/* A deque of the objects a thread has marked but not traversed yet.  The
+ * owner pushes and pops at the tail, thieves take from the head. */
+struct mark_deque {
+    PyGC_Head **items;
+    Py_ssize_t head;
+    Py_ssize_t tail;
+    Py_ssize_t capacity;
+    int lock;
+    /* Keep the deques of different threads in different cache lines */
+    char padding[64];
+};
 
-    validate_list(&finalizers, collecting_clear_unreachable_clear);
-    validate_list(&unreachable, collecting_set_unreachable_clear);
+struct mark_state {
+    PyGC_Head **objects;
+    Py_ssize_t nobjects;
+    int nthreads;
+    struct mark_deque *deques;
+    /* Barrier between the steps */
+    int barrier_count;
+    int barrier_generation;
+    /* Number of threads still marking the roots of their range */
+    int scanning;
+    /* Number of objects pushed and not yet traversed */
+    Py_ssize_t outstanding;
+    /* Set if a deque couldn't grow */
+    int failed;
+    /* Set when nthreads is final */
+    int started;
+    /* Number of helper threads still running */
+    int alive;
+};
 
-    /* Print debugging information. */
-    if (gcstate->debug & DEBUG_COLLECTABLE) {
-        for (gc = GC_NEXT(&unreachable); gc != &unreachable; gc = GC_NEXT(gc)) {
-            debug_cycle("collectable", FROM_GC(gc));
+struct mark_worker {
+    struct mark_state *state;
+    int index;
+};
+
+static void
+deque_lock(struct mark_deque *deque)
+{
+    while (__atomic_exchange_n(&deque->lock, 1, __ATOMIC_ACQUIRE)) {
+        while (ATOMIC_LOAD(&deque->lock)) {
+            /* spin */
         }
     }
+}
 
-    /* Clear weakrefs and invoke callbacks as necessary. */
-    m += handle_weakrefs(&unreachable, old);
-
-    validate_list(old, collecting_clear_unreachable_clear);
-    validate_list(&unreachable, collecting_set_unreachable_clear);
-
-    /* Call tp_finalize on objects which have one. */
-    finalize_garbage(tstate, &unreachable);
+static void
+deque_unlock(struct mark_deque *deque)
+{
+    ATOMIC_STORE(&deque->lock, 0);
+}
 
-    /* Handle any objects that may have resurrected after the call
-     * to 'finalize_garbage' and continue the collection with the
-     * objects that are still unreachable */
-    PyGC_Head final_unreachable;
-    handle_resurrected_objects(&unreachable, &final_unreachable, old);
+/* Return -1 if the deque couldn't grow. */
+static int
+deque_push(struct mark_deque *deque, PyGC_Head *gc)
+{
+    int res = 0;
+    deque_lock(deque);
+    if (deque->tail == deque->capacity) {
+        if (deque->head > 0) {
+            Py_ssize_t size = deque->tail - deque->head;
+            memmove(deque->items, deque->items + deque->head,
+                    size * sizeof(PyGC_Head *));
+            deque->head = 0;
+            deque->tail = size;
+        }
+        else {
+            Py_ssize_t capacity = deque->capacity ? deque->capacity * 2 : 1024;
+            PyGC_Head **items = PyMem_RawRealloc(
+                deque->items, capacity * sizeof(PyGC_Head *));
+            if (items == NULL) {
+                res = -1;
+                goto done;
+            }
+            deque->items = items;
+            deque->capacity = capacity;
+        }
+    }
+    deque->items[deque->tail++] = gc;
+done:
+    deque_unlock(deque);
+    return res;
+}
 
-    /* Call tp_clear on objects in the final_unreachable set.  This will cause
-    * the reference cycles to be broken.  It may also cause some objects
-    * in finalizers to be freed.
-    */
-    m += gc_list_size(&final_unreachable);
-    delete_garbage(tstate, gcstate, &final_unreachable, old);
+static PyGC_Head *
+deque_pop(struct mark_deque *deque)
+{
+    PyGC_Head *gc = NULL;
+    deque_lock(deque);
+    if (deque->tail > deque->head) {
+        gc = deque->items[--deque->tail];
+        if (deque->tail == deque->head) {
+            deque->head = deque->tail = 0;
+        }
+    }
+    deque_unlock(deque);
+    return gc;
+}
 
-    /* Collect statistics on uncollectable objects found and print
-     * debugging information. */
-    for (gc = GC_NEXT(&finalizers); gc != &finalizers; gc = GC_NEXT(gc)) {
-        n++;
-        if (gcstate->debug & DEBUG_UNCOLLECTABLE)
-            debug_cycle("uncollectable", FROM_GC(gc));
+/* Move up to half of the objects of victim to buf, and return their
+ * number. */
+static Py_ssize_t
+deque_steal(struct mark_deque *victim, PyGC_Head **buf)
+{
+    deque_lock(victim);
+    Py_ssize_t n = (victim->tail - victim->head + 1) / 2;
+    if (n > PARALLEL_STEAL_MAX) {
+        n = PARALLEL_STEAL_MAX;
     }
-    if (gcstate->debug & DEBUG_STATS) {
-        double d = _PyTime_AsSecondsDouble(_PyTime_GetPerfCounter() - t1);
-        PySys_WriteStderr(
-            "gc: done, %zd unreachable, %zd uncollectable, %.4fs elapsed\n",
-            n+m, n, d);
+    memcpy(buf, victim->items + victim->head, n * sizeof(PyGC_Head *));
+    victim->head += n;
+    if (victim->tail == victim->head) {
+        victim->head = victim->tail = 0;
     }
+    deque_unlock(victim);
+    return n;
+}
 
-    /* Append instances in the uncollectable set to a Python
-     * reachable list of garbage.  The programmer has to deal with
-     * this if they insist on creating this type of structure.
-     */
-    handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
-    validate_list(old, collecting_clear_unreachable_clear);
-
-    /* Clear free list only during the collection of the highest
-     * generation */
-    if (generation == NUM_GENERATIONS-1) {
-        clear_freelists(tstate->interp);
+static void
+mark_barrier(struct mark_state *state)
+{
+    int generation = ATOMIC_LOAD(&state->barrier_generation);
+    if (ATOMIC_ADD(&state->barrier_count, 1) == state->nthreads - 1) {
+        ATOMIC_STORE(&state->barrier_count, 0);
+        ATOMIC_ADD(&state->barrier_generation, 1);
     }
-
-    if (_PyErr_Occurred(tstate)) {
-        if (nofail) {
-            _PyErr_Clear(tstate);
+    else {
+        while (ATOMIC_LOAD(&state->barrier_generation) == generation) {
+            mark_yield();
         }
-        else {
-            _PyErr_WriteUnraisableMsg("in garbage collection", NULL);
+    }
+}
+
+/* A traversal callback for step 2. */
+static int
+visit_decref_atomic(PyObject *op, void *Py_UNUSED(arg))
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (__atomic_load_n(&gc->_gc_prev, __ATOMIC_RELAXED)
+            & PREV_MASK_COLLECTING)
+        {
+            __atomic_fetch_sub(&gc->_gc_prev, 1 << _PyGC_PREV_SHIFT,
+                               __ATOMIC_RELAXED);
         }
     }
+    return 0;
+}
 
-    /* Update stats */
-    if (n_collected) {
-        *n_collected = m;
+/* gc_get_refs() for step 3, where other threads clear the collecting flag
+   in the same word. */
+static inline Py_ssize_t
+gc_get_refs_atomic(PyGC_Head *gc)
+{
+    uintptr_t prev = __atomic_load_n(&gc->_gc_prev, __ATOMIC_RELAXED);
+    return (Py_ssize_t)(prev >> _PyGC_PREV_SHIFT);
+}
+
+/* Mark gc as reachable, and push it if this thread marked it. */
+static void
+mark_reachable(struct mark_worker *worker, PyGC_Head *gc)
+{
+    struct mark_state *state = worker->state;
+    if (!(ATOMIC_LOAD(&gc->_gc_prev) & PREV_MASK_COLLECTING)) {
+        return;
     }
-    if (n_uncollectable) {
-        *n_uncollectable = n;
+    uintptr_t prev = __atomic_fetch_and(&gc->_gc_prev, ~PREV_MASK_COLLECTING,
+                                        __ATOMIC_ACQ_REL);
+    if (!(prev & PREV_MASK_COLLECTING)) {
+        /* Another thread marked it */
+        return;
     }
+    ATOMIC_ADD(&state->outstanding, 1);
+    if (deque_push(&state->deques[worker->index], gc) < 0) {
+        ATOMIC_STORE(&state->failed, 1);
+        ATOMIC_ADD(&state->outstanding, -1);
+    }
+}
 
-    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
-    stats->collections++;
-    stats->collected += m;
-    stats->uncollectable += n;
-
-    if (PyDTrace_GC_DONE_ENABLED()) {
-        PyDTrace_GC_DONE(n + m);
+/* A traversal callback for step 3. */
+static int
+visit_mark(PyObject *op, struct mark_worker *worker)
+{
+    if (_PyObject_IS_GC(op)) {
+        mark_reachable(worker, AS_GC(op));
     }
+    return 0;
+}
 
-    assert(!_PyErr_Occurred(tstate));
-    return n + m;
+static void
+mark_traverse(struct mark_worker *worker, PyGC_Head *gc)
+{
+    PyObject *op = FROM_GC(gc);
+    traverseproc traverse = Py_TYPE(op)->tp_traverse;
+    (void) traverse(op, (visitproc)visit_mark, worker);
+    ATOMIC_ADD(&worker->state->outstanding, -1);
 }
 
-/* Invoke progress callbacks to notify clients that garbage collection
- * is starting or stopping
- */
 static void
-invoke_gc_callback(PyThreadState *tstate, const char *phase,
-                   int generation, Py_ssize_t collected,
-                   Py_ssize_t uncollectable)
+mark_drain(struct mark_worker *worker)
 {
-    assert(!_PyErr_Occurred(tstate));
+    struct mark_deque *deque = &worker->state->deques[worker->index];
+    PyGC_Head *gc;
+    while ((gc = deque_pop(deque)) != NULL) {
+        mark_traverse(worker, gc);
+    }
+}
 
-    /* we may get called very early */
-    GCState *gcstate = &tstate->interp->gc;
-    if (gcstate->callbacks == NULL) {
-        return;
+static void
+mark_worker_run(struct mark_worker *worker)
+{
+    struct mark_state *state = worker->state;
+    Py_ssize_t start = state->nobjects * worker->index / state->nthreads;
+    Py_ssize_t end = state->nobjects * (worker->index + 1) / state->nthreads;
+    Py_ssize_t i;
+
+    /* Step 1: update_refs() */
+    for (i = start; i < end; i++) {
+        PyGC_Head *gc = state->objects[i];
+        gc_reset_refs(gc, Py_REFCNT(FROM_GC(gc)));
     }
+    mark_barrier(state);
 
-    /* The local variable cannot be rebound, check it for sanity */
-    assert(PyList_CheckExact(gcstate->callbacks));
-    PyObject *info = NULL;
-    if (PyList_GET_SIZE(gcstate->callbacks) != 0) {
-        info = Py_BuildValue("{sisnsn}",
-            "generation", generation,
-            "collected", collected,
-            "uncollectable", uncollectable);
-        if (info == NULL) {
-            PyErr_WriteUnraisable(NULL);
-            return;
+    /* Step 2: subtract_refs() */
+    for (i = start; i < end; i++) {
+        PyObject *op = FROM_GC(state->objects[i]);
+        traverseproc traverse = Py_TYPE(op)->tp_traverse;
+        (void) traverse(op, visit_decref_atomic, NULL);
+    }
+    mark_barrier(state);
+
+    /* Step 3: mark the objects reachable from the roots of the range */
+    for (i = start; i < end && !ATOMIC_LOAD(&state->failed); i++) {
+        PyGC_Head *gc = state->objects[i];
+        if (gc_get_refs_atomic(gc) > 0) {
+            mark_reachable(worker, gc);
+            mark_drain(worker);
         }
     }
-    for (Py_ssize_t i=0; i<PyList_GET_SIZE(gcstate->callbacks); i++) {
-        PyObject *r, *cb = PyList_GET_ITEM(gcstate->callbacks, i);
-        Py_INCREF(cb); /* make sure cb doesn't go away */
-        r = PyObject_CallFunction(cb, "sO", phase, info);
-        if (r == NULL) {
-            PyErr_WriteUnraisable(cb);
+    ATOMIC_ADD(&state->scanning, -1);
+
+    /* Help the other threads until all reachable objects are marked */
+    PyGC_Head *stolen[PARALLEL_STEAL_MAX];
+    while (!ATOMIC_LOAD(&state->failed)) {
+        mark_drain(worker);
+        Py_ssize_t n = 0;
+        for (int j = 1; j < state->nthreads && n == 0; j++) {
+            int victim = (worker->index + j) % state->nthreads;
+            n = deque_steal(&state->deques[victim], stolen);
+        }
+        if (n > 0) {
+            for (i = 0; i < n; i++) {
+                mark_traverse(worker, stolen[i]);
+            }
+        }
+        else if (ATOMIC_LOAD(&state->scanning) == 0
+                 && ATOMIC_LOAD(&state->outstanding) == 0)
+        {
+            break;
         }
         else {
-            Py_DECREF(r);
+            mark_yield();
         }
-        Py_DECREF(cb);
     }
-    Py_XDECREF(info);
-    assert(!_PyErr_Occurred(tstate));
+}
+
+static void
+mark_helper_thread(void *arg)
+{
+    struct mark_worker *worker = (struct mark_worker *)arg;
+    struct mark_state *state = worker->state;
+    while (!ATOMIC_LOAD(&state->started)) {
+        mark_yield();
+    }
+    if (worker->index < state->nthreads) {
+        mark_worker_run(worker);
+    }
+    /* The state must not be used after this */
+    ATOMIC_ADD(&state->alive, -1);
+}
+
+/* Move the objects which weren't marked to unreachable, like
+ * move_unreachable(). */
+static void
+move_unmarked(PyGC_Head *young, PyGC_Head *unreachable)
+{
+    PyGC_Head *prev = young;
+    PyGC_Head *gc = GC_NEXT(young);
+    while (gc != young) {
+        PyGC_Head *next = (PyGC_Head *)gc->_gc_next;
+        if (!gc_is_collecting(gc)) {
+            prev->_gc_next = (uintptr_t)gc;
+            _PyGCHead_SET_PREV(gc, prev);
+            prev = gc;
+        }
+        else {
+            PyGC_Head *last = GC_PREV(unreachable);
+            last->_gc_next = (NEXT_MASK_UNREACHABLE | (uintptr_t)gc);
+            _PyGCHead_SET_PREV(gc, last);
+            gc->_gc_next = (NEXT_MASK_UNREACHABLE | (uintptr_t)unreachable);
+            unreachable->_gc_prev = (uintptr_t)gc;
+        }
+        gc = next;
+    }
+    prev->_gc_next = (uintptr_t)young;
+    young->_gc_prev = (uintptr_t)prev;
+    unreachable->_gc_next &= ~NEXT_MASK_UNREACHABLE;
+}
+
+/* Same as deduce_unreachable(), with up to nthreads threads. */
+static void
+deduce_unreachable_parallel(PyGC_Head *base, PyGC_Head *unreachable,
+                            int nthreads)
+{
+    Py_ssize_t n = gc_list_size(base);
+    if (n < PARALLEL_MIN_OBJECTS) {
+        deduce_unreachable(base, unreachable);
+        return;
+    }
+    validate_list(base, collecting_clear_unreachable_clear);
+
+    struct mark_state state = {0};
+    struct mark_worker *workers = NULL;
+    state.objects = PyMem_RawMalloc(n * sizeof(PyGC_Head *));
+    state.deques = PyMem_RawCalloc(nthreads, sizeof(struct mark_deque));
+    workers = PyMem_RawMalloc(nthreads * sizeof(struct mark_worker));
+    if (state.objects == NULL || state.deques == NULL || workers == NULL) {
+        PyMem_RawFree(state.objects);
+        PyMem_RawFree(state.deques);
+        PyMem_RawFree(workers);
+        deduce_unreachable(base, unreachable);
+        return;
+    }
+    Py_ssize_t i = 0;
+    for (PyGC_Head *gc = GC_NEXT(base); gc != base; gc = GC_NEXT(gc)) {
+        state.objects[i++] = gc;
+    }
+    state.nobjects = n;
+
+    /* Start the helpers; the calling thread is worker 0 */
+    int started = 1;
+    for (int t = 1; t < nthreads; t++) {
+        workers[t].state = &state;
+        workers[t].index = started;
+        ATOMIC_ADD(&state.alive, 1);
+        if (PyThread_start_new_thread(mark_helper_thread, &workers[t])
+            == PYTHREAD_INVALID_THREAD_ID)
+        {
+            ATOMIC_ADD(&state.alive, -1);
+            break;
+        }
+        started++;
+    }
+    state.nthreads = started;
+    state.scanning = started;
+    workers[0].state = &state;
+    workers[0].index = 0;
+    ATOMIC_STORE(&state.started, 1);
+
+    mark_worker_run(&workers[0]);
+    while (ATOMIC_LOAD(&state.alive) > 0) {
+        mark_yield();
+    }
+
+    gc_list_init(unreachable);
+    if (state.failed) {
+        /* gc_refs are valid: start again from step 3 sequentially */
+        for (i = 0; i < n; i++) {
+            state.objects[i]->_gc_prev |= PREV_MASK_COLLECTING;
+        }
+        move_unreachable(base, unreachable);
+    }
+    else {
+        move_unmarked(base, unreachable);
+    }
+
+    for (int t = 0; t < nthreads; t++) {
+        PyMem_RawFree(state.deques[t].items);
+    }
+    PyMem_RawFree(state.deques);
+    PyMem_RawFree(state.objects);
+    PyMem_RawFree(workers);
+    validate_list(base, collecting_clear_unreachable_clear);
+    validate_list(unreachable, collecting_set_unreachable_set);
+}
+
+#endif  /* GC_PARALLEL */
+
+/* Handle objects that may have resurrected after a call to 'finalize_garbage', moving
+   them to 'old_generation' and placing the rest on 'still_unreachable'.
+
+   Contracts:
+       * After this function 'unreachable' must not be used anymore and 'still_unreachable'
+         will contain the objects that did not resurrect.
+
+       * The "still_unreachable" list must be uninitialized (this function calls
+         gc_list_init over 'still_unreachable').
+
+IMPORTANT: After a call to this function, the 'still_unreachable' set will have the
+PREV_MARK_COLLECTING set, but the objects in this set are going to be removed so
+we can skip the expense of clearing the flag to avoid extra iteration. */
+static inline void
+handle_resurrected_objects(PyGC_Head *unreachable, PyGC_Head* still_unreachable,
+                           PyGC_Head *old_generation)
+{
+    // Remove the PREV_MASK_COLLECTING from unreachable
+    // to prepare it for a new call to 'deduce_unreachable'
+    gc_list_clear_collecting(unreachable);
+
+    // After the call to deduce_unreachable, the 'still_unreachable' set will
+    // have the PREV_MARK_COLLECTING set, but the objects are going to be
+    // removed so we can skip the expense of clearing the flag.
+    PyGC_Head* resurrected = unreachable;
+    deduce_unreachable(resurrected, still_unreachable);
+    clear_unreachable_mask(still_unreachable);
+
+    // Move the resurrected objects to the old generation for future collection.
+    gc_list_merge(resurrected, old_generation);
+}
+
+/* Incremental collection of the oldest generation.
+
+A full collection examines every object of the oldest generation at once, so
+its pause grows with the heap.  When a pause budget is set (see
+gc.set_pause_budget()), automatic collections of the oldest generation are
+instead spread over a "pass" of many increments, each run right after a
+collection of the young generations:
+
+- A pass starts by moving the whole oldest generation to old_unscanned.
+
+- Each increment first queues the next objects of old_unscanned on
+  old_queued, flagging them with _PyGC_NEXT_MASK_QUEUED.  It then takes
+  objects from the front of old_queued along with the queued objects they
+  refer to, transitively, so that a cycle of garbage usually lands in a
+  single increment.
+
+- The increment is collected like a generation.  deduce_unreachable() only
+  subtracts the references from inside the increment, so any object referred
+  to from outside of it (including from the rest of the oldest generation)
+  is found reachable: collecting any subset of the objects is safe.  Since
+  nothing is computed across increments, the program can mutate the heap
+  freely between them and no write barrier is needed.  The survivors go back
+  to the oldest generation, like objects promoted during the pass.
+
+- The pass ends when both lists are empty.
+
+A cycle of garbage which doesn't fit in an increment, or part of which was
+promoted during the pass, may survive a pass: a later pass or a full
+collection frees it.  Anything which needs the whole oldest generation in
+one list (full collections, gc.freeze(), gc.get_objects(), ...) cancels the
+pass first.
+
+The size of the increments is adjusted after each of them to the throughput
+observed, so that their pause stays close to the budget.
+*/
+
+static inline int
+gc_pass_running(GCState *gcstate)
+{
+    return (!gc_list_is_empty(&gcstate->old_unscanned)
+            || !gc_list_is_empty(&gcstate->old_queued));
+}
+
+static void
+gc_start_pass(GCState *gcstate)
+{
+    assert(!gc_pass_running(gcstate));
+    gc_list_merge(GEN_HEAD(gcstate, NUM_GENERATIONS-1),
+                  &gcstate->old_unscanned);
+    gcstate->generations[NUM_GENERATIONS-1].count = 0;
+    gcstate->long_lived_pending = 0;
+    gcstate->pass_survivors = 0;
+}
+
+/* Put the objects of the current pass back into the oldest generation. */
+static void
+gc_cancel_pass(GCState *gcstate)
+{
+    PyGC_Head *queued = &gcstate->old_queued;
+    for (PyGC_Head *gc = GC_NEXT(queued); gc != queued; gc = GC_NEXT(gc)) {
+        gc->_gc_next &= ~_PyGC_NEXT_MASK_QUEUED;
+    }
+    PyGC_Head *old = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    gc_list_merge(queued, old);
+    gc_list_merge(&gcstate->old_unscanned, old);
+}
+
+struct increment_state {
+    PyGC_Head *increment;
+    Py_ssize_t size;
+    Py_ssize_t limit;
+};
+
+/* A traversal callback for gc_fill_increment(). */
+static int
+visit_queued(PyObject *op, struct increment_state *state)
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if ((gc->_gc_next & _PyGC_NEXT_MASK_QUEUED)
+            && state->size < state->limit)
+        {
+            gc->_gc_next &= ~_PyGC_NEXT_MASK_QUEUED;
+            gc_list_move(gc, state->increment);
+            state->size++;
+        }
+    }
+    return 0;
+}
+
+/* Move the next increment of the current pass to 'increment' and return its
+ * size. */
+static Py_ssize_t
+gc_fill_increment(GCState *gcstate, PyGC_Head *increment)
+{
+    PyGC_Head *unscanned = &gcstate->old_unscanned;
+    PyGC_Head *queued = &gcstate->old_queued;
+    Py_ssize_t limit = gcstate->increment_size;
+
+    /* Queue objects ahead of the increments, so that they can be pulled in
+     * by the objects which refer to them. */
+    for (Py_ssize_t i = 0; i < limit && !gc_list_is_empty(unscanned); i++) {
+        PyGC_Head *gc = GC_NEXT(unscanned);
+        gc_list_move(gc, queued);
+        gc->_gc_next |= _PyGC_NEXT_MASK_QUEUED;
+    }
+
+    struct increment_state state = {increment, 0, limit};
+    gc_list_init(increment);
+    while (state.size < limit / 2 && !gc_list_is_empty(queued)) {
+        PyGC_Head *gc = GC_NEXT(queued);
+        gc->_gc_next &= ~_PyGC_NEXT_MASK_QUEUED;
+        gc_list_move(gc, increment);
+        state.size++;
+        /* The traversals append to increment: this visits the objects
+         * reachable from gc until the limit is reached. */
+        for (; gc != increment; gc = GC_NEXT(gc)) {
+            PyObject *op = FROM_GC(gc);
+            traverseproc traverse = Py_TYPE(op)->tp_traverse;
+            (void) traverse(op, (visitproc)visit_queued, &state);
+        }
+    }
+    return state.size;
+}
+
+/* Size the next increments so that collecting them takes pause_budget. */
+static void
+gc_adjust_increment_size(GCState *gcstate, Py_ssize_t size, _PyTime_t pause)
+{
+    double seconds = _PyTime_AsSecondsDouble(pause);
+    if (size == 0 || seconds <= 0.0) {
+        return;
+    }
+    /* Average with the previous size to smooth out the noise */
+    double target = (double)size * gcstate->pause_budget / seconds;
+    double new_size = (gcstate->increment_size + target) / 2;
+    if (new_size < MIN_INCREMENT_SIZE) {
+        new_size = MIN_INCREMENT_SIZE;
+    }
+    else if (new_size > (double)(PY_SSIZE_T_MAX / 2)) {
+        new_size = (double)(PY_SSIZE_T_MAX / 2);
+    }
+    gcstate->increment_size = (Py_ssize_t)new_size;
+}
+
+static int
+pause_bucket(_PyTime_t pause)
+{
+    _PyTime_t us = _PyTime_AsMicroseconds(pause, _PyTime_ROUND_FLOOR);
+    _PyTime_t bound = 10;
+    int i = 0;
+    while (i < NUM_PAUSE_BUCKETS - 1 && us >= bound) {
+        bound *= 10;
+        i++;
+    }
+    return i;
+}
+
+/* Adaptive thresholds.
+
+With the fixed policy, generation 0 is collected every threshold0 net
+allocations of containers, however little garbage the collections find.
+With the adaptive policy (see gc.set_threshold_policy()), the threshold of
+each generation is scaled by a power of two, from 1 to 64, adjusted after
+each of its collections:
+
+- if less than 1% of the objects examined were garbage, or if the collection
+  took more than 5% of the time since the previous one and less than 10%
+  were garbage, the factor doubles: the collections are mostly wasted;
+
+- if 10% or more were garbage, the factor halves, back towards the
+  configured threshold.
+
+The increments of the oldest generation don't adjust its threshold.
+*/
+
+#define ADAPTIVE_MAX_SHIFT 6
+
+/* Return the threshold of a generation, scaled by the adaptive policy. */
+static inline int
+gc_threshold(GCState *gcstate, int generation)
+{
+    struct gc_generation *gen = &gcstate->generations[generation];
+    if (gen->threshold > (INT_MAX >> gen->threshold_shift)) {
+        return INT_MAX;
+    }
+    return gen->threshold << gen->threshold_shift;
+}
+
+static void
+gc_adapt_threshold(GCState *gcstate, int generation, Py_ssize_t examined,
+                   Py_ssize_t garbage, _PyTime_t pause, _PyTime_t end)
+{
+    struct gc_generation *gen = &gcstate->generations[generation];
+    _PyTime_t last = gcstate->last_collection[generation];
+    gcstate->last_collection[generation] = end;
+    if (examined == 0) {
+        return;
+    }
+    double yield = (double)garbage / (double)examined;
+    double overhead = 0.0;
+    if (last != 0 && end > last) {
+        overhead = (double)pause / (double)(end - last);
+    }
+    if (yield < 0.01 || (overhead > 0.05 && yield < 0.10)) {
+        if (gen->threshold_shift < ADAPTIVE_MAX_SHIFT) {
+            gen->threshold_shift++;
+        }
+    }
+    else if (yield >= 0.10 && gen->threshold_shift > 0) {
+        gen->threshold_shift--;
+    }
+}
+
+/* This is the main function.  Read this to understand how the
+ * collection process works.  If incremental is true, collect the next
+ * increment of the oldest generation instead of a whole generation. */
+static Py_ssize_t
+gc_collect_main(PyThreadState *tstate, int generation,
+                Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable,
+                int nofail, int incremental)
+{
+    int i;
+    Py_ssize_t m = 0; /* # objects collected */
+    Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
+    PyGC_Head *young; /* the generation we are examining */
+    PyGC_Head *old; /* next older generation */
+    PyGC_Head increment; /* the objects of an increment */
+    Py_ssize_t increment_size = 0;
+    Py_ssize_t survivors = 0; /* # reachable objects, if adaptive */
+    PyGC_Head unreachable; /* non-problematic unreachable trash */
+    PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
+    PyGC_Head *gc;
+    _PyTime_t t1 = _PyTime_GetPerfCounter();
+    GCState *gcstate = &tstate->interp->gc;
+
+    // gc_collect_main() must not be called before _PyGC_Init
+    // or after _PyGC_Fini()
+    assert(gcstate->garbage != NULL);
+    assert(!_PyErr_Occurred(tstate));
+    assert(!incremental || generation == NUM_GENERATIONS - 1);
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting %sgeneration %d...\n",
+                          incremental ? "an increment of " : "", generation);
+        show_stats_each_generations(gcstate);
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(generation);
+
+    if (incremental) {
+        /* The young generations were just collected */
+        increment_size = gc_fill_increment(gcstate, &increment);
+        young = &increment;
+        old = GEN_HEAD(gcstate, generation);
+    }
+    else {
+        /* update collection and allocation counters */
+        if (generation+1 < NUM_GENERATIONS)
+            gcstate->generations[generation+1].count += 1;
+        for (i = 0; i <= generation; i++)
+            gcstate->generations[i].count = 0;
+
+        if (generation == NUM_GENERATIONS-1) {
+            gc_cancel_pass(gcstate);
+        }
+
+        /* merge younger generations with one we are currently collecting */
+        for (i = 0; i < generation; i++) {
+            gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
+        }
+
+        /* handy references */
+        young = GEN_HEAD(gcstate, generation);
+        if (generation < NUM_GENERATIONS-1)
+            old = GEN_HEAD(gcstate, generation+1);
+        else
+            old = young;
+    }
+    validate_list(old, collecting_clear_unreachable_clear);
+
+#ifdef GC_PARALLEL
+    if (generation == NUM_GENERATIONS - 1 && !incremental
+        && gcstate->mark_threads > 1)
+    {
+        deduce_unreachable_parallel(young, &unreachable,
+                                    gcstate->mark_threads);
+    }
+    else
+#endif
+    {
+        deduce_unreachable(young, &unreachable);
+    }
+
+    untrack_tuples(young);
+    if (gcstate->adaptive && !incremental) {
+        survivors = gc_list_size(young);
+    }
+    /* Move reachable objects to next generation. */
+    if (young != old) {
+        if (incremental) {
+            /* The pass amounts to a full collection */
+            untrack_dicts(young);
+            gcstate->pass_survivors += gc_list_size(young);
+        }
+        else if (generation == NUM_GENERATIONS - 2) {
+            gcstate->long_lived_pending += gc_list_size(young);
+        }
+        gc_list_merge(young, old);
+    }
+    else {
+        /* We only un-track dicts in full collections, to avoid quadratic
+           dict build-up. See issue #14775. */
+        untrack_dicts(young);
+        gcstate->long_lived_pending = 0;
+        gcstate->long_lived_total = gc_list_size(young);
+    }
+
+    /* All objects in unreachable are trash, but objects reachable from
+     * legacy finalizers (e.g. tp_del) can't safely be deleted.
+     */
+    gc_list_init(&finalizers);
+    // NEXT_MASK_UNREACHABLE is cleared here.
+    // After move_legacy_finalizers(), unreachable is normal list.
+    move_legacy_finalizers(&unreachable, &finalizers);
+    /* finalizers contains the unreachable objects with a legacy finalizer;
+     * unreachable objects reachable *from* those are also uncollectable,
+     * and we move those into the finalizers list too.
+     */
+    move_legacy_finalizer_reachable(&finalizers);
+
+    validate_list(&finalizers, collecting_clear_unreachable_clear);
+    validate_list(&unreachable, collecting_set_unreachable_clear);
+
+    /* Print debugging information. */
+    if (gcstate->debug & DEBUG_COLLECTABLE) {
+        for (gc = GC_NEXT(&unreachable); gc != &unreachable; gc = GC_NEXT(gc)) {
+            debug_cycle("collectable", FROM_GC(gc));
+        }
+    }
+
+    /* Clear weakrefs and invoke callbacks as necessary. */
+    m += handle_weakrefs(&unreachable, old);
+
+    validate_list(old, collecting_clear_unreachable_clear);
+    validate_list(&unreachable, collecting_set_unreachable_clear);
+
+    /* Call tp_finalize on objects which have one. */
+    finalize_garbage(tstate, &unreachable);
+
+    /* Handle any objects that may have resurrected after the call
+     * to 'finalize_garbage' and continue the collection with the
+     * objects that are still unreachable */
+    PyGC_Head final_unreachable;
+    handle_resurrected_objects(&unreachable, &final_unreachable, old);
+
+    /* Call tp_clear on objects in the final_unreachable set.  This will cause
+    * the reference cycles to be broken.  It may also cause some objects
+    * in finalizers to be freed.
+    */
+    m += gc_list_size(&final_unreachable);
+    delete_garbage(tstate, gcstate, &final_unreachable, old);
+
+    /* Collect statistics on uncollectable objects found and print
+     * debugging information. */
+    for (gc = GC_NEXT(&finalizers); gc != &finalizers; gc = GC_NEXT(gc)) {
+        n++;
+        if (gcstate->debug & DEBUG_UNCOLLECTABLE)
+            debug_cycle("uncollectable", FROM_GC(gc));
+    }
+    if (gcstate->debug & DEBUG_STATS) {
+        double d = _PyTime_AsSecondsDouble(_PyTime_GetPerfCounter() - t1);
+        PySys_WriteStderr(
+            "gc: done, %zd unreachable, %zd uncollectable, %.4fs elapsed\n",
+            n+m, n, d);
+    }
+
+    /* Append instances in the uncollectable set to a Python
+     * reachable list of garbage.  The programmer has to deal with
+     * this if they insist on creating this type of structure.
+     */
+    handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
+    validate_list(old, collecting_clear_unreachable_clear);
+
+    /* Clear free list only during the collection of the highest
+     * generation */
+    if (generation == NUM_GENERATIONS-1 && !gc_pass_running(gcstate)) {
+        if (incremental) {
+            /* This was the last increment of the pass */
+            gcstate->long_lived_total = gcstate->pass_survivors;
+        }
+        clear_freelists(tstate->interp);
+    }
+
+    if (_PyErr_Occurred(tstate)) {
+        if (nofail) {
+            _PyErr_Clear(tstate);
+        }
+        else {
+            _PyErr_WriteUnraisableMsg("in garbage collection", NULL);
+        }
+    }
+
+    /* Update stats */
+    if (n_collected) {
+        *n_collected = m;
+    }
+    if (n_uncollectable) {
+        *n_uncollectable = n;
+    }
+
+    _PyTime_t t2 = _PyTime_GetPerfCounter();
+    _PyTime_t pause = t2 - t1;
+    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
+    stats->collections++;
+    stats->collected += m;
+    stats->uncollectable += n;
+    stats->pauses[pause_bucket(pause)]++;
+    if (incremental) {
+        gc_adjust_increment_size(gcstate, increment_size, pause);
+    }
+    else if (gcstate->adaptive) {
+        gc_adapt_threshold(gcstate, generation, survivors + m + n, m + n,
+                           pause, t2);
+    }
+
+    if (PyDTrace_GC_DONE_ENABLED()) {
+        PyDTrace_GC_DONE(n + m);
+    }
+
+    assert(!_PyErr_Occurred(tstate));
+    return n + m;
+}
+
+/* Invoke progress callbacks to notify clients that garbage collection
+ * is starting or stopping
+ */
+static void
+invoke_gc_callback(PyThreadState *tstate, const char *phase,
+                   int generation, Py_ssize_t collected,
+                   Py_ssize_t uncollectable)
+{
+    assert(!_PyErr_Occurred(tstate));
+
+    /* we may get called very early */
+    GCState *gcstate = &tstate->interp->gc;
+    if (gcstate->callbacks == NULL) {
+        return;
+    }
+
+    /* The local variable cannot be rebound, check it for sanity */
+    assert(PyList_CheckExact(gcstate->callbacks));
+    PyObject *info = NULL;
+    if (PyList_GET_SIZE(gcstate->callbacks) != 0) {
+        info = Py_BuildValue("{sisnsnsi}",
+            "generation", generation,
+            "collected", collected,
+            "uncollectable", uncollectable,
+            "threshold", gc_threshold(gcstate, generation));
+        if (info == NULL) {
+            PyErr_WriteUnraisable(NULL);
+            return;
+        }
+    }
+    for (Py_ssize_t i=0; i<PyList_GET_SIZE(gcstate->callbacks); i++) {
+        PyObject *r, *cb = PyList_GET_ITEM(gcstate->callbacks, i);
+        Py_INCREF(cb); /* make sure cb doesn't go away */
+        r = PyObject_CallFunction(cb, "sO", phase, info);
+        if (r == NULL) {
+            PyErr_WriteUnraisable(cb);
+        }
+        else {
+            Py_DECREF(r);
+        }
+        Py_DECREF(cb);
+    }
+    Py_XDECREF(info);
+    assert(!_PyErr_Occurred(tstate));
 }
 
 /* Perform garbage collection of a generation and invoke
  * progress callbacks.
  */
 static Py_ssize_t
-gc_collect_with_callback(PyThreadState *tstate, int generation)
+gc_collect_with_callback(PyThreadState *tstate, int generation,
+                         int incremental)
 {
     assert(!_PyErr_Occurred(tstate));
     Py_ssize_t result, collected, uncollectable;
     invoke_gc_callback(tstate, "start", generation, 0, 0);
-    result = gc_collect_main(tstate, generation, &collected, &uncollectable, 0);
+    result = gc_collect_main(tstate, generation, &collected, &uncollectable, 0,
+                             incremental);
     invoke_gc_callback(tstate, "stop", generation, collected, uncollectable);
     assert(!_PyErr_Occurred(tstate));
     return result;
@@ -1415,7 +2153,7 @@ gc_collect_generations(PyThreadState *tstate)
      * generations younger than it will be collected. */
     Py_ssize_t n = 0;
     for (int i = NUM_GENERATIONS-1; i >= 0; i--) {
-        if (gcstate->generations[i].count > gcstate->generations[i].threshold) {
+        if (gcstate->generations[i].count > gc_threshold(gcstate, i)) {
             /* Avoid quadratic performance degradation in number
                of tracked objects (see also issue #4074):
 
@@ -1455,10 +2193,23 @@ gc_collect_generations(PyThreadState *tstate)
             if (i == NUM_GENERATIONS - 1
                 && gcstate->long_lived_pending < gcstate->long_lived_total / 4)
                 continue;
-            n = gc_collect_with_callback(tstate, i);
+            if (i == NUM_GENERATIONS - 1 && gcstate->pause_budget > 0.0) {
+                /* Start a pass over the oldest generation (if one isn't
+                 * running yet), and collect the young generations. */
+                n = gc_collect_with_callback(tstate, NUM_GENERATIONS - 2, 0);
+                if (!gc_pass_running(gcstate)) {
+                    gc_start_pass(gcstate);
+                }
+                break;
+            }
+            n = gc_collect_with_callback(tstate, i, 0);
             break;
         }
     }
+    /* A running pass makes progress on each automatic collection */
+    if (gc_pass_running(gcstate)) {
+        n += gc_collect_with_callback(tstate, NUM_GENERATIONS - 1, 1);
+    }
     return n;
 }
 
@@ -1538,7 +2289,7 @@ gc_collect_impl(PyObject *module, int generation)
     }
     else {
         gcstate->collecting = 1;
-        n = gc_collect_with_callback(tstate, generation);
+        n = gc_collect_with_callback(tstate, generation, 0);
         gcstate->collecting = 0;
     }
     return n;
@@ -1641,6 +2392,177 @@ gc_get_count_impl(PyObject *module)
                          gcstate->generations[2].count);
 }
 
+/*[clinic input]
+gc.set_pause_budget
+
+    budget: double
+    /
+
+Set the pause budget of automatic collections, in seconds.
+
+Automatic collections of the oldest generation are split into increments
+which each take about budget seconds.  0 disables incremental collection.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_pause_budget_impl(PyObject *module, double budget)
+/*[clinic end generated code: output=6f7f7b925973a47a input=53af607774e2f1d8]*/
+{
+    if (!(budget >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "pause budget must be a non-negative number");
+        return NULL;
+    }
+    GCState *gcstate = get_gc_state();
+    gcstate->pause_budget = budget;
+    if (budget == 0.0) {
+        gc_cancel_pass(gcstate);
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_pause_budget -> double
+
+Return the pause budget of automatic collections, in seconds.
+[clinic start generated code]*/
+
+static double
+gc_get_pause_budget_impl(PyObject *module)
+/*[clinic end generated code: output=0ac6600c52706fdb input=86618023c1e489fa]*/
+{
+    GCState *gcstate = get_gc_state();
+    return gcstate->pause_budget;
+}
+
+/*[clinic input]
+gc.set_threshold_policy
+
+    policy: str
+    /
+
+Set the policy deciding when automatic collections happen.
+
+"fixed" collects each generation when its count exceeds its threshold.
+"adaptive" scales the thresholds according to the share of garbage found
+by the recent collections and to the time spent collecting.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_threshold_policy_impl(PyObject *module, const char *policy)
+/*[clinic end generated code: output=751ab5532d8a790f input=f043e2485c594184]*/
+{
+    GCState *gcstate = get_gc_state();
+    if (strcmp(policy, "fixed") == 0) {
+        gcstate->adaptive = 0;
+        for (int i = 0; i < NUM_GENERATIONS; i++) {
+            gcstate->generations[i].threshold_shift = 0;
+        }
+    }
+    else if (strcmp(policy, "adaptive") == 0) {
+        gcstate->adaptive = 1;
+    }
+    else {
+        PyErr_Format(PyExc_ValueError,
+                     "policy must be 'fixed' or 'adaptive', not '%s'", policy);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_threshold_policy
+
+Return the policy deciding when automatic collections happen.
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_threshold_policy_impl(PyObject *module)
+/*[clinic end generated code: output=c25dcaf2307c9f43 input=3106cfc713d3b828]*/
+{
+    GCState *gcstate = get_gc_state();
+    return PyUnicode_FromString(gcstate->adaptive ? "adaptive" : "fixed");
+}
+
+/*[clinic input]
+gc.set_object_cache_size
+
+    type: object(subclass_of='&PyType_Type', type='PyTypeObject *')
+    size: Py_ssize_t
+    /
+
+Set the maximum number of freed instances of type kept for reuse.
+
+type must have the Py_TPFLAGS_OBJECT_CACHE flag.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_object_cache_size_impl(PyObject *module, PyTypeObject *type,
+                              Py_ssize_t size)
+/*[clinic end generated code: output=e610b67bdf684b1d input=c26b2a0cdca1ff16]*/
+{
+    if (_PyType_SetObjectCacheSize(type, size) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_object_cache_stats
+
+Return the statistics of the object caches.
+
+The result maps each type whose instances are cached to a dict with the
+current and maximum number of cached instances, and the numbers of
+allocations which did and didn't reuse a cached instance.
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_object_cache_stats_impl(PyObject *module)
+/*[clinic end generated code: output=c37c792fc6852ad4 input=a26c42d26bc448d1]*/
+{
+    return _PyType_GetObjectCacheStats(_PyInterpreterState_GET());
+}
+
+/*[clinic input]
+gc.set_mark_threads
+
+    threads: int
+    /
+
+Set the number of threads marking the objects of full collections.
+
+With 1 (the default), the objects are marked in the calling thread only.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_mark_threads_impl(PyObject *module, int threads)
+/*[clinic end generated code: output=1ef7fe9de3b51ba5 input=1adc612cfa0337f1]*/
+{
+    if (threads < 1 || threads > MAX_MARK_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+                     "threads must be between 1 and %d", MAX_MARK_THREADS);
+        return NULL;
+    }
+    GCState *gcstate = get_gc_state();
+    gcstate->mark_threads = threads;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_mark_threads -> int
+
+Return the number of threads marking the objects of full collections.
+[clinic start generated code]*/
+
+static int
+gc_get_mark_threads_impl(PyObject *module)
+/*[clinic end generated code: output=69def07a8661eb7c input=5d6a81139ca6b7b3]*/
+{
+    GCState *gcstate = get_gc_state();
+    return gcstate->mark_threads;
+}
+
 static int
 referrersvisit(PyObject* obj, PyObject *objs)
 {
@@ -1687,6 +2609,7 @@ gc_get_referrers(PyObject *self, PyObject *args)
     }
 
     GCState *gcstate = get_gc_state();
+    gc_cancel_pass(gcstate);
     for (int i = 0; i < NUM_GENERATIONS; i++) {
         if (!(gc_referrers_for(args, GEN_HEAD(gcstate, i), result))) {
             Py_DECREF(result);
@@ -1764,6 +2687,7 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
     if (result == NULL) {
         return NULL;
     }
+    gc_cancel_pass(gcstate);
 
     /* If generation is passed, we extract only that generation */
     if (generation != -1) {
@@ -1828,10 +2752,22 @@ gc_get_stats_impl(PyObject *module)
     for (i = 0; i < NUM_GENERATIONS; i++) {
         PyObject *dict;
         st = &stats[i];
-        dict = Py_BuildValue("{snsnsn}",
+        PyObject *pauses = PyList_New(NUM_PAUSE_BUCKETS);
+        if (pauses == NULL)
+            goto error;
+        for (int j = 0; j < NUM_PAUSE_BUCKETS; j++) {
+            PyObject *count = PyLong_FromSsize_t(st->pauses[j]);
+            if (count == NULL) {
+                Py_DECREF(pauses);
+                goto error;
+            }
+            PyList_SET_ITEM(pauses, j, count);
+        }
+        dict = Py_BuildValue("{snsnsnsN}",
                              "collections", st->collections,
                              "collected", st->collected,
-                             "uncollectable", st->uncollectable
+                             "uncollectable", st->uncollectable,
+                             "pauses", pauses
                             );
         if (dict == NULL)
             goto error;
@@ -1893,25 +2829,83 @@ gc_is_finalized(PyObject *module, PyObject *obj)
     Py_RETURN_FALSE;
 }
 
+/* A traversal callback for immortalize_list(). */
+static int
+visit_immortalize(PyObject *op, void *Py_UNUSED(arg))
+{
+    if (_Py_IsImmortal(op)) {
+        return 0;
+    }
+    if (_PyObject_IS_GC(op) && _PyObject_GC_IS_TRACKED(op)) {
+        /* It is in a list being immortalized */
+        return 0;
+    }
+    if (PyType_Check(op)
+        && !_PyType_HasFeature((PyTypeObject *)op, Py_TPFLAGS_HEAPTYPE))
+    {
+        /* Static types are finalized with the runtime */
+        return 0;
+    }
+    _Py_SetImmortal(op);
+    if (_PyObject_IS_GC(op)) {
+        /* An untracked container only refers to a few atomic objects */
+        traverseproc traverse = Py_TYPE(op)->tp_traverse;
+        (void) traverse(op, visit_immortalize, NULL);
+    }
+    return 0;
+}
+
+/* Make the objects of a list, and the untracked objects they refer to,
+ * immortal, and untrack them.
+ *
+ * Immortal objects are always alive, so references from them can be
+ * counted as external references by the collector whether or not they are
+ * tracked: they don't need to be in the lists, and not being in them spares
+ * the writes to their GC header when their neighbours are unlinked.
+ */
+static void
+immortalize_list(PyGC_Head *head)
+{
+    for (PyGC_Head *gc = GC_NEXT(head); gc != head; gc = GC_NEXT(gc)) {
+        PyObject *op = FROM_GC(gc);
+        _Py_SetImmortal(op);
+        traverseproc traverse = Py_TYPE(op)->tp_traverse;
+        (void) traverse(op, visit_immortalize, NULL);
+    }
+    while (!gc_list_is_empty(head)) {
+        _PyObject_GC_UNTRACK(FROM_GC(GC_NEXT(head)));
+    }
+}
+
 /*[clinic input]
 gc.freeze
 
+    *
+    immortalize: bool(accept={int}) = False
+
 Freeze all current tracked objects and ignore them for future collections.
 
 This can be used before a POSIX fork() call to make the gc copy-on-write friendly.
 Note: collection before a POSIX fork() call may free pages for future allocation
 which can cause copy-on-write.
+
+If immortalize is true, the objects are made immortal instead: their
+reference counts are no longer updated and they are never deallocated.
 [clinic start generated code]*/
 
 static PyObject *
-gc_freeze_impl(PyObject *module)
-/*[clinic end generated code: output=502159d9cdc4c139 input=b602b16ac5febbe5]*/
+gc_freeze_impl(PyObject *module, int immortalize)
+/*[clinic end generated code: output=db32b5465626796f input=4ca488dab56a46b3]*/
 {
     GCState *gcstate = get_gc_state();
+    gc_cancel_pass(gcstate);
     for (int i = 0; i < NUM_GENERATIONS; ++i) {
         gc_list_merge(GEN_HEAD(gcstate, i), &gcstate->permanent_generation.head);
         gcstate->generations[i].count = 0;
     }
+    if (immortalize) {
+        immortalize_list(&gcstate->permanent_generation.head);
+    }
     Py_RETURN_NONE;
 }
 
@@ -1947,6 +2941,254 @@ gc_get_freeze_count_impl(PyObject *module)
     return gc_list_size(&gcstate->permanent_generation.head);
 }
 
+/* Heap snapshots.
+
+gc.dump_heap() streams the object graph to a file without creating any
+Python object, so that it can be used on heaps too large for
+gc.get_objects().  The file starts with the 8 bytes b"PYHEAP\0\1", followed
+by records made of a one byte tag and unsigned LEB128 varints:
+
+    'T' type_address name_length name
+        Emitted before the first node of the type.  name is tp_name.
+    'N' address type_address size refcount nedges edge_address...
+        A node.  size is the shallow size of the object computed from its
+        type (including the GC header), and the edges are the referents
+        reported by tp_traverse.
+    'L' address type_address size refcount
+        A referent which is not tracked by the GC.  Leaves are emitted after
+        each node which refers to them, so a leaf may be repeated.
+    'E' nnodes
+        The end of the snapshot, followed by the number of 'N' records.
+
+The objects are only read: tp_traverse doesn't call Python code, so the
+graph doesn't change while it is written.  Memory use is bounded by the
+write buffer and the table of the types already written.  See
+Tools/scripts/heap_snapshot.py to analyze the snapshots.
+*/
+
+#define HEAP_SNAPSHOT_MAGIC "PYHEAP\0\1"
+#define HEAP_BUFFER_SIZE (64 * 1024)
+
+struct heap_writer {
+    FILE *fp;
+    char *buf;
+    size_t len;
+    /* errno of the first failed write, or 0 */
+    int error;
+    /* set of the types already written */
+    _Py_hashtable_t *types;
+    Py_ssize_t nnodes;
+};
+
+static void
+heap_flush(struct heap_writer *w)
+{
+    if (w->len && !w->error) {
+        if (fwrite(w->buf, 1, w->len, w->fp) != w->len) {
+            w->error = errno ? errno : EIO;
+        }
+    }
+    w->len = 0;
+}
+
+static void
+heap_write(struct heap_writer *w, const void *data, size_t size)
+{
+    if (w->len + size > HEAP_BUFFER_SIZE) {
+        heap_flush(w);
+        if (size > HEAP_BUFFER_SIZE) {
+            if (!w->error && fwrite(data, 1, size, w->fp) != size) {
+                w->error = errno ? errno : EIO;
+            }
+            return;
+        }
+    }
+    memcpy(w->buf + w->len, data, size);
+    w->len += size;
+}
+
+static void
+heap_write_varint(struct heap_writer *w, uint64_t value)
+{
+    unsigned char bytes[10];
+    size_t n = 0;
+    do {
+        bytes[n] = value & 0x7f;
+        value >>= 7;
+        if (value) {
+            bytes[n] |= 0x80;
+        }
+        n++;
+    } while (value);
+    heap_write(w, bytes, n);
+}
+
+static inline void
+heap_write_address(struct heap_writer *w, const void *ptr)
+{
+    heap_write_varint(w, (uint64_t)(uintptr_t)ptr);
+}
+
+static int
+heap_write_type(struct heap_writer *w, PyTypeObject *tp)
+{
+    if (_Py_hashtable_get_entry(w->types, tp) != NULL) {
+        return 0;
+    }
+    if (_Py_hashtable_set(w->types, tp, NULL) < 0) {
+        return -1;
+    }
+    size_t len = strlen(tp->tp_name);
+    heap_write(w, "T", 1);
+    heap_write_address(w, tp);
+    heap_write_varint(w, len);
+    heap_write(w, tp->tp_name, len);
+    return 0;
+}
+
+/* Write the part common to nodes and leaves. */
+static int
+heap_write_object(struct heap_writer *w, char tag, PyObject *op)
+{
+    PyTypeObject *tp = Py_TYPE(op);
+    if (heap_write_type(w, tp) < 0) {
+        return -1;
+    }
+    size_t size = (size_t)tp->tp_basicsize + _PyType_PreHeaderSize(tp);
+    if (tp->tp_itemsize) {
+        Py_ssize_t n = Py_SIZE(op);
+        size += (size_t)(n < 0 ? -n : n) * (size_t)tp->tp_itemsize;
+    }
+    heap_write(w, &tag, 1);
+    heap_write_address(w, op);
+    heap_write_address(w, tp);
+    heap_write_varint(w, size);
+    heap_write_varint(w, (uint64_t)Py_REFCNT(op));
+    return 0;
+}
+
+static int
+visit_count_edge(PyObject *op, uint64_t *nedges)
+{
+    (*nedges)++;
+    return 0;
+}
+
+static int
+visit_write_edge(PyObject *op, struct heap_writer *w)
+{
+    heap_write_address(w, op);
+    return 0;
+}
+
+static int
+visit_write_leaf(PyObject *op, struct heap_writer *w)
+{
+    if (_PyObject_IS_GC(op) && _PyObject_GC_IS_TRACKED(op)) {
+        return 0;
+    }
+    return heap_write_object(w, 'L', op);
+}
+
+static int
+heap_write_node(struct heap_writer *w, PyObject *op)
+{
+    traverseproc traverse = Py_TYPE(op)->tp_traverse;
+    uint64_t nedges = 0;
+    (void) traverse(op, (visitproc)visit_count_edge, &nedges);
+    if (heap_write_object(w, 'N', op) < 0) {
+        return -1;
+    }
+    heap_write_varint(w, nedges);
+    (void) traverse(op, (visitproc)visit_write_edge, w);
+    w->nnodes++;
+    return traverse(op, (visitproc)visit_write_leaf, w);
+}
+
+static int
+heap_write_list(struct heap_writer *w, PyGC_Head *head)
+{
+    for (PyGC_Head *gc = GC_NEXT(head); gc != head; gc = GC_NEXT(gc)) {
+        if (heap_write_node(w, FROM_GC(gc)) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*[clinic input]
+gc.dump_heap -> Py_ssize_t
+
+    path: object(converter="PyUnicode_FSDecoder")
+    /
+
+Write a snapshot of all objects tracked by the collector to a file.
+
+The nodes of the snapshot are the tracked objects and their edges are the
+references between them.  Return the number of tracked objects written.
+[clinic start generated code]*/
+
+static Py_ssize_t
+gc_dump_heap_impl(PyObject *module, PyObject *path)
+/*[clinic end generated code: output=9f35ae03cb1b1a48 input=bf5bebabe9c1b582]*/
+{
+    struct heap_writer w = {0};
+    Py_ssize_t result = -1;
+
+    if (PySys_Audit("gc.dump_heap", "O", path) < 0) {
+        goto done;
+    }
+    w.fp = _Py_fopen_obj(path, "wb");
+    if (w.fp == NULL) {
+        goto done;
+    }
+    w.buf = PyMem_RawMalloc(HEAP_BUFFER_SIZE);
+    w.types = _Py_hashtable_new(_Py_hashtable_hash_ptr,
+                                _Py_hashtable_compare_direct);
+    if (w.buf == NULL || w.types == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    GCState *gcstate = get_gc_state();
+    gc_cancel_pass(gcstate);
+    heap_write(&w, HEAP_SNAPSHOT_MAGIC, sizeof(HEAP_SNAPSHOT_MAGIC) - 1);
+    for (int i = 0; i < NUM_GENERATIONS; i++) {
+        if (heap_write_list(&w, GEN_HEAD(gcstate, i)) < 0) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+    if (heap_write_list(&w, &gcstate->permanent_generation.head) < 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    heap_write(&w, "E", 1);
+    heap_write_varint(&w, (uint64_t)w.nnodes);
+    heap_flush(&w);
+    if (w.error == 0 && fflush(w.fp) != 0) {
+        w.error = errno;
+    }
+    if (w.error) {
+        errno = w.error;
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        goto done;
+    }
+    result = w.nnodes;
+
+done:
+    if (w.fp != NULL && fclose(w.fp) != 0 && result >= 0) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, path);
+        result = -1;
+    }
+    if (w.types != NULL) {
+        _Py_hashtable_destroy(w.types);
+    }
+    PyMem_RawFree(w.buf);
+    Py_DECREF(path);
+    return result;
+}
+
 
 PyDoc_STRVAR(gc__doc__,
 "This module provides access to the garbage collector for reference cycles.\n"
@@ -1961,6 +3203,14 @@ PyDoc_STRVAR(gc__doc__,
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
 "get_threshold() -- Return the current the collection thresholds.\n"
+"set_threshold_policy() -- Set the policy of automatic collections.\n"
+"get_threshold_policy() -- Return the policy of automatic collections.\n"
+"set_pause_budget() -- Set the pause budget of automatic collections.\n"
+"get_pause_budget() -- Return the pause budget of automatic collections.\n"
+"set_mark_threads() -- Set the number of threads marking full collections.\n"
+"get_mark_threads() -- Return the number of threads marking full collections.\n"
+"set_object_cache_size() -- Set the size of the object cache of a type.\n"
+"get_object_cache_stats() -- Return the statistics of the object caches.\n"
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "is_finalized() -- Returns true if a given object has been already finalized.\n"
@@ -1968,7 +3218,8 @@ PyDoc_STRVAR(gc__doc__,
 "get_referents() -- Return the list of objects that an object refers to.\n"
 "freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
 "unfreeze() -- Unfreeze all objects in the permanent generation.\n"
-"get_freeze_count() -- Return the number of objects in the permanent generation.\n");
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n"
+"dump_heap() -- Write a snapshot of all tracked objects to a file.\n");
 
 static PyMethodDef GcMethods[] = {
     GC_ENABLE_METHODDEF
@@ -1979,6 +3230,14 @@ static PyMethodDef GcMethods[] = {
     GC_GET_COUNT_METHODDEF
     {"set_threshold",  gc_set_threshold, METH_VARARGS, gc_set_thresh__doc__},
     GC_GET_THRESHOLD_METHODDEF
+    GC_SET_THRESHOLD_POLICY_METHODDEF
+    GC_GET_THRESHOLD_POLICY_METHODDEF
+    GC_SET_PAUSE_BUDGET_METHODDEF
+    GC_GET_PAUSE_BUDGET_METHODDEF
+    GC_SET_MARK_THREADS_METHODDEF
+    GC_GET_MARK_THREADS_METHODDEF
+    GC_SET_OBJECT_CACHE_SIZE_METHODDEF
+    GC_GET_OBJECT_CACHE_STATS_METHODDEF
     GC_COLLECT_METHODDEF
     GC_GET_OBJECTS_METHODDEF
     GC_GET_STATS_METHODDEF
@@ -1991,6 +3250,7 @@ static PyMethodDef GcMethods[] = {
     GC_FREEZE_METHODDEF
     GC_UNFREEZE_METHODDEF
     GC_GET_FREEZE_COUNT_METHODDEF
+    GC_DUMP_HEAP_METHODDEF
     {NULL,      NULL}           /* Sentinel */
 };
 
@@ -2086,7 +3346,7 @@ PyGC_Collect(void)
         PyObject *exc, *value, *tb;
         gcstate->collecting = 1;
         _PyErr_Fetch(tstate, &exc, &value, &tb);
-        n = gc_collect_with_callback(tstate, NUM_GENERATIONS - 1);
+        n = gc_collect_with_callback(tstate, NUM_GENERATIONS - 1, 0);
         _PyErr_Restore(tstate, exc, value, tb);
         gcstate->collecting = 0;
     }
@@ -2110,7 +3370,7 @@ _PyGC_CollectNoFail(PyThreadState *tstate)
 
     Py_ssize_t n;
     gcstate->collecting = 1;
-    n = gc_collect_main(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1);
+    n = gc_collect_main(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1, 0);
     gcstate->collecting = 0;
     return n;
 }
@@ -2183,6 +3443,7 @@ _PyGC_Fini(PyInterpreterState *interp)
         // calling PyObject_GC_UnTrack() on the object crashs if the previous
         // or the next object of the PyGC_Head structure became a dangling
         // pointer.
+        gc_cancel_pass(gcstate);
         for (int i = 0; i < NUM_GENERATIONS; i++) {
             PyGC_Head *gen = GEN_HEAD(gcstate, i);
             gc_fini_untrack(gen);
@@ -2263,7 +3524,7 @@ _PyObject_GC_Link(PyObject *op)
     g->_gc_next = 0;
     g->_gc_prev = 0;
     gcstate->generations[0].count++; /* number of allocated GC objects */
-    if (gcstate->generations[0].count > gcstate->generations[0].threshold &&
+    if (gcstate->generations[0].count > gc_threshold(gcstate, 0) &&
         gcstate->enabled &&
         gcstate->generations[0].threshold &&
         !gcstate->collecting &&
@@ -1113,6 +1113,7 @@ bytearray_dealloc(PyByteArrayObject *self)
 #define STRINGLIB_FAST_MEMCHR memchr
 #define STRINGLIB_MUTABLE 1
 
+#include "stringlib/simd.h"
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
@@ -433,6 +433,7 @@ _Py_bytes_maketrans(Py_buffer *frm, Py_buffer *to)
 #define STRINGLIB_SIZEOF_CHAR 1
 #define STRINGLIB_FAST_MEMCHR memchr
 
+#include "stringlib/simd.h"
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
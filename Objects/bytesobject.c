@@ -1264,6 +1264,7 @@ PyBytes_AsStringAndSize(PyObject *obj,
 #include "stringlib/stringdefs.h"
 #define STRINGLIB_MUTABLE 0
 
+#include "stringlib/simd.h"
 #include "stringlib/fastsearch.h"
 #include "stringlib/count.h"
 #include "stringlib/find.h"
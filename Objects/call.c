@@ -7,16 +7,6 @@
 #include "pycore_tuple.h"         // _PyTuple_ITEMS()
 
 
-static PyObject *const *
-_PyStack_UnpackDict(PyThreadState *tstate,
-                    PyObject *const *args, Py_ssize_t nargs,
-                    PyObject *kwargs, PyObject **p_kwnames);
-
-static void
-_PyStack_UnpackDict_Free(PyObject *const *stack, Py_ssize_t nargs,
-                         PyObject *kwnames);
-
-
 static PyObject *
 null_error(PyThreadState *tstate)
 {
@@ -325,6 +315,18 @@ _PyObject_Call(PyThreadState *tstate, PyObject *callable,
     assert(kwargs == NULL || PyDict_Check(kwargs));
     EVAL_CALL_STAT_INC_IF_FUNCTION(EVAL_CALL_API, callable);
     vectorcallfunc vector_func = _PyVectorcall_Function(callable);
+    if (vector_func == _PyFunction_Vectorcall && PyTuple_CheckExact(args)
+        && (kwargs == NULL || PyDict_CheckExact(kwargs)))
+    {
+        /* Pass the tuple and dict on, for a function to use them as its
+           *args and **kwargs */
+        PyFunctionObject *f = (PyFunctionObject *)callable;
+        PyObject *locals = NULL;
+        if (!(((PyCodeObject *)f->func_code)->co_flags & CO_OPTIMIZED)) {
+            locals = f->func_globals;
+        }
+        return _PyEval_Vector_Ex(tstate, f, locals, args, kwargs);
+    }
     if (vector_func != NULL) {
         return _PyVectorcall_Call(tstate, vector_func, callable, args, kwargs);
     }
@@ -963,8 +965,10 @@ _PyStack_AsDict(PyObject *const *values, PyObject *kwnames)
 
    The newly allocated argument vector supports PY_VECTORCALL_ARGUMENTS_OFFSET.
 
-   When done, you must call _PyStack_UnpackDict_Free(stack, nargs, kwnames) */
-static PyObject *const *
+   When done, you must call _PyStack_UnpackDict_Free(stack, nargs, kwnames),
+   or _PyStack_UnpackDict_FreeNoDecRef() if the references to the arguments
+   were given away. */
+PyObject *const *
 _PyStack_UnpackDict(PyThreadState *tstate,
                     PyObject *const *args, Py_ssize_t nargs,
                     PyObject *kwargs, PyObject **p_kwnames)
@@ -1036,7 +1040,7 @@ _PyStack_UnpackDict(PyThreadState *tstate,
     return stack;
 }
 
-static void
+void
 _PyStack_UnpackDict_Free(PyObject *const *stack, Py_ssize_t nargs,
                          PyObject *kwnames)
 {
@@ -1044,6 +1048,12 @@ _PyStack_UnpackDict_Free(PyObject *const *stack, Py_ssize_t nargs,
     for (Py_ssize_t i = 0; i < n; i++) {
         Py_DECREF(stack[i]);
     }
+    _PyStack_UnpackDict_FreeNoDecRef(stack, kwnames);
+}
+
+void
+_PyStack_UnpackDict_FreeNoDecRef(PyObject *const *stack, PyObject *kwnames)
+{
     PyMem_Free((PyObject **)stack - 1);
     Py_DECREF(kwnames);
 }
@@ -6,6 +6,7 @@
 #include "pycore_code.h"          // _PyCodeConstructor
 #include "pycore_frame.h"         // FRAME_SPECIALS_SIZE
 #include "pycore_interp.h"        // PyInterpreterState.co_extra_freefuncs
+#include "pycore_jit.h"           // _PyJIT_Free()
 #include "pycore_opcode.h"        // _PyOpcode_Deopt
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
 #include "pycore_tuple.h"         // _PyTuple_ITEMS()
@@ -341,6 +342,10 @@ init_code(PyCodeObject *co, struct _PyCodeConstructor *con)
     co->co_warmup = QUICKENING_INITIAL_WARMUP_VALUE;
     co->_co_linearray_entry_size = 0;
     co->_co_linearray = NULL;
+#ifdef _Py_JIT
+    co->_co_jit_warmup = 0;
+    co->_co_jit = NULL;
+#endif
     memcpy(_PyCode_CODE(co), PyBytes_AS_STRING(con->code),
            PyBytes_GET_SIZE(con->code));
     int entry_point = 0;
@@ -1624,6 +1629,11 @@ code_dealloc(PyCodeObject *co)
     if (co->_co_linearray) {
         PyMem_Free(co->_co_linearray);
     }
+#ifdef _Py_JIT
+    if (co->_co_jit) {
+        _PyJIT_Free(co);
+    }
+#endif
     if (co->co_warmup == 0) {
         _Py_QuickenedCount--;
     }
@@ -2202,6 +2212,12 @@ _PyStaticCode_Dealloc(PyCodeObject *co)
         PyMem_Free(co->_co_linearray);
         co->_co_linearray = NULL;
     }
+#ifdef _Py_JIT
+    if (co->_co_jit) {
+        _PyJIT_Free(co);
+    }
+    co->_co_jit_warmup = 0;
+#endif
 }
 
 int
@@ -27,6 +27,9 @@ As of Python 3.6, this is compact and ordered. Basic idea is described here:
 | dk_indices[]        |
 |                     |
 +---------------------+
+| dk_ctrl[]           |
+|                     |
++---------------------+
 | dk_entries[]        |
 |                     |
 +---------------------+
@@ -40,6 +43,12 @@ Size of indices is dk_size.  Type of each index in indices is vary on dk_size:
 * int32 for 2**16 <= dk_size <= 2**31
 * int64 for 2**32 <= dk_size
 
+dk_ctrl holds one control byte per slot of dk_indices: DKC_EMPTY for
+DKIX_EMPTY, DKC_DUMMY for DKIX_DUMMY, or a 7-bit tag of the hash of the key
+for an index in entries.  The lookups compare the tag of the hash with the
+control bytes of a group of slots at once, and only read the indices and the
+entries of the slots whose tag matches.  See "Probing groups" below.
+
 dk_entries is array of PyDictKeyEntry when dk_kind == DICT_KEYS_GENERAL or
 PyDictUnicodeEntry otherwise. Its length is USABLE_FRACTION(dk_size).
 
@@ -122,6 +131,7 @@ As a consequence of this, split keys have a maximum size of 16.
 #include "pycore_pyerrors.h"      // _PyErr_Fetch()
 #include "pycore_pystate.h"       // _PyThreadState_GET()
 #include "stringlib/eq.h"         // unicode_eq()
+#include "stringlib/simd.h"       // STRINGLIB_SSE2, stringlib_ctz32()
 
 #include <stdbool.h>
 
@@ -230,6 +240,33 @@ masked); and the PyDictObject struct required a member to hold the table's
 polynomial.  In Tim's experiments the current scheme ran faster, produced
 equally good collision statistics, needed less code & used less memory.
 
+Probing groups
+
+The slots of the table are probed in groups of DK_GROUP_SIZE (16) slots, or
+of the whole table when it is smaller.  The recurrence above visits the
+groups rather than the slots: the first group is the hash modulo the number
+of groups, so keys with consecutive hashes are still spread over the table.
+
+Each slot has a control byte in dk_ctrl.  The control bytes of a group are
+compared with a byte at once with SSE2 or NEON instructions (one byte at a
+time on other platforms), which gives a bit mask of the matching slots:
+
+- The slots whose control byte is the tag of the hash are candidates.  Their
+  index and their entry are compared with the key.  The tag is made of 7
+  bits of the hash, mixed by a multiplication so that all the bits of the
+  hash are used: two different hashes have the same tag with a probability
+  of 1/128, so the entries of the other slots are rarely read, even in large
+  tables where each of them is a cache miss.
+
+- A new key is stored in the first Unused slot of the first group which has
+  one.  The groups before it in the probe sequence have no Unused slot, and
+  since Unused slots are only created by resizing the table, a lookup can
+  stop at the first group with an Unused slot: if the key is not in this
+  group, it is not in the table.  Most lookups of a missing key thus only
+  read the control bytes of one group.
+
+Dummy slots keep their own control byte, DKC_DUMMY: they are never
+candidates, and don't stop the lookups.
 */
 
 static int dictresize(PyDictObject *mp, uint8_t log_newsize, int unicode);
@@ -386,6 +423,119 @@ dictkeys_set_index(PyDictKeysObject *keys, Py_ssize_t i, Py_ssize_t ix)
     }
 }
 
+/* Control bytes of the slots, see "Probing groups" above.  The control byte
+   of a slot holding an index is the tag of the hash, in range(0x80). */
+#define DKC_EMPTY 0x80
+#define DKC_DUMMY 0xfe
+
+#define DK_LOG_GROUP_SIZE 4
+#define DK_GROUP_SIZE (1 << DK_LOG_GROUP_SIZE)
+
+/* A group mask has DK_GROUP_STRIDE bits per slot, the lowest of which is set
+   for the slots of the group which match. */
+#ifdef STRINGLIB_NEON
+typedef uint64_t dk_groupmask;
+#  define DK_GROUP_STRIDE 4
+#  define DK_GROUP_CTZ stringlib_ctz64
+#else
+typedef uint32_t dk_groupmask;
+#  define DK_GROUP_STRIDE 1
+#  define DK_GROUP_CTZ stringlib_ctz32
+#endif
+
+static inline uint8_t
+dictkeys_hash_tag(Py_hash_t hash)
+{
+#if SIZEOF_SIZE_T > 4
+    return (uint8_t)(((size_t)hash * 0x9e3779b97f4a7c15) >> 57);
+#else
+    return (uint8_t)(((size_t)hash * 0x9e3779b9) >> 25);
+#endif
+}
+
+/* log2 of the number of slots of a group: the group is the whole table
+   when it is smaller than DK_GROUP_SIZE. */
+static inline int
+dictkeys_log2_group_size(const PyDictKeysObject *keys)
+{
+    return Py_MIN(DK_LOG_SIZE(keys), DK_LOG_GROUP_SIZE);
+}
+
+/* Mask of the slots which are in a group of size 1 << log2_group_size.  The
+   control bytes are always read DK_GROUP_SIZE at a time: when the table is
+   smaller, the control bytes are followed by the entries. */
+static inline dk_groupmask
+dk_group_valid(int log2_group_size)
+{
+    return (~(dk_groupmask)0 >> (8 * sizeof(dk_groupmask)
+                                 - (DK_GROUP_STRIDE << log2_group_size)));
+}
+
+/* Mask of the slots of the group at ctrl whose control byte is c. */
+static inline dk_groupmask
+dk_group_match(const uint8_t *ctrl, uint8_t c)
+{
+#if defined(STRINGLIB_SSE2)
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    __m128i eq = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)c));
+    return (uint32_t)_mm_movemask_epi8(eq);
+#elif defined(STRINGLIB_NEON)
+    uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(c));
+    uint8x8_t bits = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return (vget_lane_u64(vreinterpret_u64_u8(bits), 0)
+            & 0x1111111111111111u);
+#else
+    dk_groupmask mask = 0;
+    for (int i = 0; i < DK_GROUP_SIZE; i++) {
+        mask |= (dk_groupmask)(ctrl[i] == c) << i;
+    }
+    return mask;
+#endif
+}
+
+/* Index in its group of the first slot of a non-empty group mask. */
+static inline size_t
+dk_group_first(dk_groupmask mask)
+{
+    return (size_t)DK_GROUP_CTZ(mask) / DK_GROUP_STRIDE;
+}
+
+/* Start loading the indices of the group at slot base while its control
+   bytes are compared: in large tables, both are usually cache misses. */
+static inline void
+dictkeys_prefetch_group(const PyDictKeysObject *keys, size_t base)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    int log2_index_size = keys->dk_log2_index_bytes - DK_LOG_SIZE(keys);
+    __builtin_prefetch((const char *)keys->dk_indices
+                       + (base << log2_index_size));
+#else
+    (void)keys;
+    (void)base;
+#endif
+}
+
+/* Store the index ix of an entry whose key has the given hash in the slot i
+   returned by find_empty_slot(). */
+static inline void
+dictkeys_add_index(PyDictKeysObject *keys, Py_ssize_t i, Py_ssize_t ix,
+                   Py_hash_t hash)
+{
+    assert(ix >= 0);
+    assert(DK_CTRL(keys)[i] == DKC_EMPTY);
+    dictkeys_set_index(keys, i, ix);
+    DK_CTRL(keys)[i] = dictkeys_hash_tag(hash);
+}
+
+/* Turn the slot i, which holds an index, into a dummy. */
+static inline void
+dictkeys_set_dummy(PyDictKeysObject *keys, Py_ssize_t i)
+{
+    assert(DK_CTRL(keys)[i] < DKC_EMPTY);
+    dictkeys_set_index(keys, i, DKIX_DUMMY);
+    DK_CTRL(keys)[i] = DKC_DUMMY;
+}
+
 
 /* USABLE_FRACTION is the maximum dictionary load.
  * Increasing this ratio makes dictionaries more dense resulting in more
@@ -458,8 +608,10 @@ static PyDictKeysObject empty_keys_struct = {
         1, /* dk_version */
         0, /* dk_usable (immutable) */
         0, /* dk_nentries */
-        {DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY,
-         DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY, DKIX_EMPTY}, /* dk_indices */
+        /* dk_indices, then the group of control bytes which is read */
+#define E ((char)DKC_EMPTY)
+        {DKIX_EMPTY, E, E, E, E, E, E, E, E, E, E, E, E, E, E, E, E},
+#undef E
 };
 
 #define Py_EMPTY_KEYS &empty_keys_struct
@@ -528,9 +680,26 @@ _PyDict_CheckConsistency(PyObject *op, int check_content)
     }
 
     if (check_content) {
+        uint8_t *ctrl = DK_CTRL(keys);
         for (Py_ssize_t i=0; i < DK_SIZE(keys); i++) {
             Py_ssize_t ix = dictkeys_get_index(keys, i);
             CHECK(DKIX_DUMMY <= ix && ix <= usable);
+            if (ix == DKIX_EMPTY) {
+                CHECK(ctrl[i] == DKC_EMPTY);
+            }
+            else if (ix == DKIX_DUMMY) {
+                CHECK(ctrl[i] == DKC_DUMMY);
+            }
+            else {
+                Py_hash_t hash;
+                if (DK_IS_UNICODE(keys)) {
+                    hash = unicode_get_hash(DK_UNICODE_ENTRIES(keys)[ix].me_key);
+                }
+                else {
+                    hash = DK_ENTRIES(keys)[ix].me_hash;
+                }
+                CHECK(ctrl[i] == dictkeys_hash_tag(hash));
+            }
         }
 
         if (keys->dk_kind == DICT_KEYS_GENERAL) {
@@ -631,6 +800,7 @@ new_keys_object(uint8_t log2_size, bool unicode)
     {
         dk = PyObject_Malloc(sizeof(PyDictKeysObject)
                              + ((size_t)1 << log2_bytes)
+                             + ((size_t)1 << log2_size)
                              + entry_size * usable);
         if (dk == NULL) {
             PyErr_NoMemory();
@@ -648,7 +818,8 @@ new_keys_object(uint8_t log2_size, bool unicode)
     dk->dk_usable = usable;
     dk->dk_version = 0;
     memset(&dk->dk_indices[0], 0xff, ((size_t)1 << log2_bytes));
-    memset(&dk->dk_indices[(size_t)1 << log2_bytes], 0, entry_size * usable);
+    memset(DK_CTRL(dk), DKC_EMPTY, ((size_t)1 << log2_size));
+    memset(DK_CTRL(dk) + ((size_t)1 << log2_size), 0, entry_size * usable);
     return dk;
 }
 
@@ -845,20 +1016,29 @@ PyDict_New(void)
 static Py_ssize_t
 lookdict_index(PyDictKeysObject *k, Py_hash_t hash, Py_ssize_t index)
 {
-    size_t mask = DK_MASK(k);
+    const uint8_t *ctrl = DK_CTRL(k);
+    const uint8_t tag = dictkeys_hash_tag(hash);
+    const int log2_group = dictkeys_log2_group_size(k);
+    const dk_groupmask valid = dk_group_valid(log2_group);
+    size_t mask = DK_MASK(k) >> log2_group;
     size_t perturb = (size_t)hash;
-    size_t i = (size_t)hash & mask;
+    size_t g = (size_t)hash & mask;
 
     for (;;) {
-        Py_ssize_t ix = dictkeys_get_index(k, i);
-        if (ix == index) {
-            return i;
+        size_t base = g << log2_group;
+        dk_groupmask match = dk_group_match(ctrl + base, tag) & valid;
+        while (match) {
+            size_t i = base + dk_group_first(match);
+            if (dictkeys_get_index(k, i) == index) {
+                return i;
+            }
+            match &= match - 1;
         }
-        if (ix == DKIX_EMPTY) {
+        if (dk_group_match(ctrl + base, DKC_EMPTY) & valid) {
             return DKIX_EMPTY;
         }
         perturb >>= PERTURB_SHIFT;
-        i = mask & (i*5 + perturb + 1);
+        g = mask & (g*5 + perturb + 1);
     }
     Py_UNREACHABLE();
 }
@@ -868,13 +1048,24 @@ static Py_ssize_t
 unicodekeys_lookup_generic(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
 {
     PyDictUnicodeEntry *ep0 = DK_UNICODE_ENTRIES(dk);
-    size_t mask = DK_MASK(dk);
+    const uint8_t *ctrl = DK_CTRL(dk);
+    const uint8_t tag = dictkeys_hash_tag(hash);
+    const int log2_group = dictkeys_log2_group_size(dk);
+    const dk_groupmask valid = dk_group_valid(log2_group);
+    size_t mask = DK_MASK(dk) >> log2_group;
     size_t perturb = hash;
-    size_t i = (size_t)hash & mask;
+    size_t g = (size_t)hash & mask;
     Py_ssize_t ix;
     for (;;) {
-        ix = dictkeys_get_index(dk, i);
-        if (ix >= 0) {
+        size_t base = g << log2_group;
+        dictkeys_prefetch_group(dk, base);
+        dk_groupmask match = dk_group_match(ctrl + base, tag) & valid;
+        for (; match; match &= match - 1) {
+            ix = dictkeys_get_index(dk, base + dk_group_first(match));
+            /* A comparison may have deleted the key of the slot */
+            if (ix < 0) {
+                continue;
+            }
             PyDictUnicodeEntry *ep = &ep0[ix];
             assert(ep->me_key != NULL);
             assert(PyUnicode_CheckExact(ep->me_key));
@@ -900,11 +1091,11 @@ unicodekeys_lookup_generic(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key
                 }
             }
         }
-        else if (ix == DKIX_EMPTY) {
+        if (dk_group_match(ctrl + base, DKC_EMPTY) & valid) {
             return DKIX_EMPTY;
         }
         perturb >>= PERTURB_SHIFT;
-        i = mask & (i*5 + perturb + 1);
+        g = mask & (g*5 + perturb + 1);
     }
     Py_UNREACHABLE();
 }
@@ -914,28 +1105,21 @@ static Py_ssize_t _Py_HOT_FUNCTION
 unicodekeys_lookup_unicode(PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
 {
     PyDictUnicodeEntry *ep0 = DK_UNICODE_ENTRIES(dk);
-    size_t mask = DK_MASK(dk);
+    const uint8_t *ctrl = DK_CTRL(dk);
+    const uint8_t tag = dictkeys_hash_tag(hash);
+    const int log2_group = dictkeys_log2_group_size(dk);
+    const dk_groupmask valid = dk_group_valid(log2_group);
+    size_t mask = DK_MASK(dk) >> log2_group;
     size_t perturb = hash;
-    size_t i = (size_t)hash & mask;
+    size_t g = (size_t)hash & mask;
     Py_ssize_t ix;
     for (;;) {
-        ix = dictkeys_get_index(dk, i);
-        if (ix >= 0) {
-            PyDictUnicodeEntry *ep = &ep0[ix];
-            assert(ep->me_key != NULL);
-            assert(PyUnicode_CheckExact(ep->me_key));
-            if (ep->me_key == key ||
-                    (unicode_get_hash(ep->me_key) == hash && unicode_eq(ep->me_key, key))) {
-                return ix;
-            }
-        }
-        else if (ix == DKIX_EMPTY) {
-            return DKIX_EMPTY;
-        }
-        perturb >>= PERTURB_SHIFT;
-        i = mask & (i*5 + perturb + 1);
-        ix = dictkeys_get_index(dk, i);
-        if (ix >= 0) {
+        size_t base = g << log2_group;
+        dictkeys_prefetch_group(dk, base);
+        dk_groupmask match = dk_group_match(ctrl + base, tag) & valid;
+        for (; match; match &= match - 1) {
+            ix = dictkeys_get_index(dk, base + dk_group_first(match));
+            assert(ix >= 0);
             PyDictUnicodeEntry *ep = &ep0[ix];
             assert(ep->me_key != NULL);
             assert(PyUnicode_CheckExact(ep->me_key));
@@ -944,11 +1128,11 @@ unicodekeys_lookup_unicode(PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
                 return ix;
             }
         }
-        else if (ix == DKIX_EMPTY) {
+        if (dk_group_match(ctrl + base, DKC_EMPTY) & valid) {
             return DKIX_EMPTY;
         }
         perturb >>= PERTURB_SHIFT;
-        i = mask & (i*5 + perturb + 1);
+        g = mask & (g*5 + perturb + 1);
     }
     Py_UNREACHABLE();
 }
@@ -958,13 +1142,24 @@ static Py_ssize_t
 dictkeys_generic_lookup(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key, Py_hash_t hash)
 {
     PyDictKeyEntry *ep0 = DK_ENTRIES(dk);
-    size_t mask = DK_MASK(dk);
+    const uint8_t *ctrl = DK_CTRL(dk);
+    const uint8_t tag = dictkeys_hash_tag(hash);
+    const int log2_group = dictkeys_log2_group_size(dk);
+    const dk_groupmask valid = dk_group_valid(log2_group);
+    size_t mask = DK_MASK(dk) >> log2_group;
     size_t perturb = hash;
-    size_t i = (size_t)hash & mask;
+    size_t g = (size_t)hash & mask;
     Py_ssize_t ix;
     for (;;) {
-        ix = dictkeys_get_index(dk, i);
-        if (ix >= 0) {
+        size_t base = g << log2_group;
+        dictkeys_prefetch_group(dk, base);
+        dk_groupmask match = dk_group_match(ctrl + base, tag) & valid;
+        for (; match; match &= match - 1) {
+            ix = dictkeys_get_index(dk, base + dk_group_first(match));
+            /* A comparison may have deleted the key of the slot */
+            if (ix < 0) {
+                continue;
+            }
             PyDictKeyEntry *ep = &ep0[ix];
             assert(ep->me_key != NULL);
             if (ep->me_key == key) {
@@ -989,11 +1184,11 @@ dictkeys_generic_lookup(PyDictObject *mp, PyDictKeysObject* dk, PyObject *key, P
                 }
             }
         }
-        else if (ix == DKIX_EMPTY) {
+        if (dk_group_match(ctrl + base, DKC_EMPTY) & valid) {
             return DKIX_EMPTY;
         }
         perturb >>= PERTURB_SHIFT;
-        i = mask & (i*5 + perturb + 1);
+        g = mask & (g*5 + perturb + 1);
     }
     Py_UNREACHABLE();
 }
@@ -1166,15 +1361,20 @@ find_empty_slot(PyDictKeysObject *keys, Py_hash_t hash)
 {
     assert(keys != NULL);
 
-    const size_t mask = DK_MASK(keys);
-    size_t i = hash & mask;
-    Py_ssize_t ix = dictkeys_get_index(keys, i);
-    for (size_t perturb = hash; ix >= 0;) {
+    const uint8_t *ctrl = DK_CTRL(keys);
+    const int log2_group = dictkeys_log2_group_size(keys);
+    const dk_groupmask valid = dk_group_valid(log2_group);
+    const size_t mask = DK_MASK(keys) >> log2_group;
+    size_t g = hash & mask;
+    for (size_t perturb = hash;;) {
+        size_t base = g << log2_group;
+        dk_groupmask empty = dk_group_match(ctrl + base, DKC_EMPTY) & valid;
+        if (empty) {
+            return base + dk_group_first(empty);
+        }
         perturb >>= PERTURB_SHIFT;
-        i = (i*5 + perturb + 1) & mask;
-        ix = dictkeys_get_index(keys, i);
+        g = (g*5 + perturb + 1) & mask;
     }
-    return i;
 }
 
 static int
@@ -1206,7 +1406,7 @@ insert_into_dictkeys(PyDictKeysObject *keys, PyObject *name)
         Py_ssize_t hashpos = find_empty_slot(keys, hash);
         ix = keys->dk_nentries;
         PyDictUnicodeEntry *ep = &DK_UNICODE_ENTRIES(keys)[ix];
-        dictkeys_set_index(keys, hashpos, ix);
+        dictkeys_add_index(keys, hashpos, ix, hash);
         assert(ep->me_key == NULL);
         ep->me_key = name;
         keys->dk_usable--;
@@ -1250,7 +1450,8 @@ insertdict(PyDictObject *mp, PyObject *key, Py_hash_t hash, PyObject *value)
         }
 
         Py_ssize_t hashpos = find_empty_slot(mp->ma_keys, hash);
-        dictkeys_set_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries);
+        dictkeys_add_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries,
+                           hash);
 
         if (DK_IS_UNICODE(mp->ma_keys)) {
             PyDictUnicodeEntry *ep;
@@ -1333,8 +1534,9 @@ insert_to_emptydict(PyDictObject *mp, PyObject *key, Py_hash_t hash,
 
     MAINTAIN_TRACKING(mp, key, value);
 
-    size_t hashpos = (size_t)hash & (PyDict_MINSIZE-1);
-    dictkeys_set_index(mp->ma_keys, hashpos, 0);
+    /* The table is a single group, whose first slot is empty */
+    Py_BUILD_ASSERT(PyDict_MINSIZE <= DK_GROUP_SIZE);
+    dictkeys_add_index(mp->ma_keys, 0, 0, hash);
     if (unicode) {
         PyDictUnicodeEntry *ep = DK_UNICODE_ENTRIES(mp->ma_keys);
         ep->me_key = key;
@@ -1359,31 +1561,19 @@ Internal routine used by dictresize() to build a hashtable of entries.
 static void
 build_indices_generic(PyDictKeysObject *keys, PyDictKeyEntry *ep, Py_ssize_t n)
 {
-    size_t mask = DK_MASK(keys);
     for (Py_ssize_t ix = 0; ix != n; ix++, ep++) {
         Py_hash_t hash = ep->me_hash;
-        size_t i = hash & mask;
-        for (size_t perturb = hash; dictkeys_get_index(keys, i) != DKIX_EMPTY;) {
-            perturb >>= PERTURB_SHIFT;
-            i = mask & (i*5 + perturb + 1);
-        }
-        dictkeys_set_index(keys, i, ix);
+        dictkeys_add_index(keys, find_empty_slot(keys, hash), ix, hash);
     }
 }
 
 static void
 build_indices_unicode(PyDictKeysObject *keys, PyDictUnicodeEntry *ep, Py_ssize_t n)
 {
-    size_t mask = DK_MASK(keys);
     for (Py_ssize_t ix = 0; ix != n; ix++, ep++) {
         Py_hash_t hash = unicode_get_hash(ep->me_key);
         assert(hash != -1);
-        size_t i = hash & mask;
-        for (size_t perturb = hash; dictkeys_get_index(keys, i) != DKIX_EMPTY;) {
-            perturb >>= PERTURB_SHIFT;
-            i = mask & (i*5 + perturb + 1);
-        }
-        dictkeys_set_index(keys, i, ix);
+        dictkeys_add_index(keys, find_empty_slot(keys, hash), ix, hash);
     }
 }
 
@@ -1929,7 +2119,7 @@ delitem_common(PyDictObject *mp, Py_hash_t hash, Py_ssize_t ix,
     }
     else {
         mp->ma_keys->dk_version = 0;
-        dictkeys_set_index(mp->ma_keys, hashpos, DKIX_DUMMY);
+        dictkeys_set_dummy(mp->ma_keys, hashpos);
         if (DK_IS_UNICODE(mp->ma_keys)) {
             PyDictUnicodeEntry *ep = &DK_UNICODE_ENTRIES(mp->ma_keys)[ix];
             old_key = ep->me_key;
@@ -1998,7 +2188,7 @@ int
 _PyDict_DelItemIf(PyObject *op, PyObject *key,
                   int (*predicate)(PyObject *value))
 {
-    Py_ssize_t hashpos, ix;
+    Py_ssize_t ix;
     PyDictObject *mp;
     Py_hash_t hash;
     PyObject *old_value;
@@ -2025,11 +2215,8 @@ _PyDict_DelItemIf(PyObject *op, PyObject *key,
     if (res == -1)
         return -1;
 
-    hashpos = lookdict_index(mp->ma_keys, hash, ix);
-    assert(hashpos >= 0);
-
     if (res > 0)
-        return delitem_common(mp, hashpos, ix, old_value);
+        return delitem_common(mp, hash, ix, old_value);
     else
         return 0;
 }
@@ -3302,7 +3489,8 @@ PyDict_SetDefault(PyObject *d, PyObject *key, PyObject *defaultobj)
             }
         }
         Py_ssize_t hashpos = find_empty_slot(mp->ma_keys, hash);
-        dictkeys_set_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries);
+        dictkeys_add_index(mp->ma_keys, hashpos, mp->ma_keys->dk_nentries,
+                           hash);
         if (DK_IS_UNICODE(mp->ma_keys)) {
             assert(PyUnicode_CheckExact(key));
             PyDictUnicodeEntry *ep = &DK_UNICODE_ENTRIES(mp->ma_keys)[mp->ma_keys->dk_nentries];
@@ -3478,7 +3666,7 @@ dict_popitem_impl(PyDictObject *self)
     j = lookdict_index(self->ma_keys, hash, i);
     assert(j >= 0);
     assert(dictkeys_get_index(self->ma_keys, j) == i);
-    dictkeys_set_index(self->ma_keys, j, DKIX_DUMMY);
+    dictkeys_set_dummy(self->ma_keys, j);
 
     PyTuple_SET_ITEM(res, 0, key);
     PyTuple_SET_ITEM(res, 1, value);
@@ -3555,6 +3743,7 @@ _PyDict_KeysSize(PyDictKeysObject *keys)
         ?  sizeof(PyDictKeyEntry) : sizeof(PyDictUnicodeEntry);
     return (sizeof(PyDictKeysObject)
             + ((size_t)1 << keys->dk_log2_index_bytes)
+            + DK_SIZE(keys)
             + USABLE_FRACTION(DK_SIZE(keys)) * es);
 }
 
@@ -4203,22 +4392,25 @@ PyTypeObject PyDictIterValue_Type = {
     0,
 };
 
-static PyObject *
-dictiter_iternextitem(dictiterobject *di)
+/* Advance a forward iterator and store borrowed references to the next key
+   and value. Return 1 on success, or 0 once the iterator is exhausted or
+   the dict was changed (with RuntimeError set). */
+static int
+dictiter_next_entry(dictiterobject *di, PyObject **pkey, PyObject **pvalue)
 {
-    PyObject *key, *value, *result;
+    PyObject *key, *value;
     Py_ssize_t i;
     PyDictObject *d = di->di_dict;
 
     if (d == NULL)
-        return NULL;
+        return 0;
     assert (PyDict_Check(d));
 
     if (di->di_used != d->ma_used) {
         PyErr_SetString(PyExc_RuntimeError,
                         "dictionary changed size during iteration");
         di->di_used = -1; /* Make this state sticky */
-        return NULL;
+        return 0;
     }
 
     i = di->di_pos;
@@ -4264,6 +4456,35 @@ dictiter_iternextitem(dictiterobject *di)
     }
     di->di_pos = i+1;
     di->len--;
+    *pkey = key;
+    *pvalue = value;
+    return 1;
+
+fail:
+    di->di_dict = NULL;
+    Py_DECREF(d);
+    return 0;
+}
+
+/* Used by the specialized FOR_ITER instructions, which push the key and
+   value directly instead of going through a result tuple. */
+int
+_PyDictIter_NextEntry(PyObject *self, PyObject **pkey, PyObject **pvalue)
+{
+    assert(Py_IS_TYPE(self, &PyDictIterKey_Type) ||
+           Py_IS_TYPE(self, &PyDictIterValue_Type) ||
+           Py_IS_TYPE(self, &PyDictIterItem_Type));
+    return dictiter_next_entry((dictiterobject *)self, pkey, pvalue);
+}
+
+static PyObject *
+dictiter_iternextitem(dictiterobject *di)
+{
+    PyObject *key, *value, *result;
+
+    if (!dictiter_next_entry(di, &key, &value)) {
+        return NULL;
+    }
     Py_INCREF(key);
     Py_INCREF(value);
     result = di->di_result;
@@ -4289,11 +4510,6 @@ dictiter_iternextitem(dictiterobject *di)
         PyTuple_SET_ITEM(result, 1, value);  /* steals reference */
     }
     return result;
-
-fail:
-    di->di_dict = NULL;
-    Py_DECREF(d);
-    return NULL;
 }
 
 PyTypeObject PyDictIterItem_Type = {
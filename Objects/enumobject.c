@@ -2,6 +2,7 @@
 
 #include "Python.h"
 #include "pycore_call.h"          // _PyObject_CallNoArgs()
+#include "pycore_iterators.h"     // _PyEnum_NextPair()
 #include "pycore_long.h"          // _PyLong_GetOne()
 #include "pycore_object.h"        // _PyObject_GC_TRACK()
 
@@ -167,19 +168,17 @@ enum_traverse(enumobject *en, visitproc visit, void *arg)
     return 0;
 }
 
+/* Return the current index of an enumeration that has reached
+   PY_SSIZE_T_MAX as a new reference, and advance past it. */
 static PyObject *
-enum_next_long(enumobject *en, PyObject* next_item)
+enum_long_index(enumobject *en)
 {
-    PyObject *result = en->en_result;
     PyObject *next_index;
     PyObject *stepped_up;
-    PyObject *old_index;
-    PyObject *old_item;
 
     if (en->en_longindex == NULL) {
         en->en_longindex = PyLong_FromSsize_t(PY_SSIZE_T_MAX);
         if (en->en_longindex == NULL) {
-            Py_DECREF(next_item);
             return NULL;
         }
     }
@@ -187,10 +186,25 @@ enum_next_long(enumobject *en, PyObject* next_item)
     assert(next_index != NULL);
     stepped_up = PyNumber_Add(next_index, en->one);
     if (stepped_up == NULL) {
-        Py_DECREF(next_item);
         return NULL;
     }
     en->en_longindex = stepped_up;
+    return next_index;
+}
+
+static PyObject *
+enum_next_long(enumobject *en, PyObject* next_item)
+{
+    PyObject *result = en->en_result;
+    PyObject *next_index;
+    PyObject *old_index;
+    PyObject *old_item;
+
+    next_index = enum_long_index(en);
+    if (next_index == NULL) {
+        Py_DECREF(next_item);
+        return NULL;
+    }
 
     if (Py_REFCNT(result) == 1) {
         Py_INCREF(result);
@@ -268,6 +282,41 @@ enum_next(enumobject *en)
     return result;
 }
 
+/* Used by the specialized FOR_ITER instruction, which pushes the index and
+   the item directly instead of going through the result tuple. Stores new
+   references and returns 1, or returns 0 when exhausted or on error, like
+   tp_iternext returning NULL. */
+int
+_PyEnum_NextPair(PyObject *self, PyObject **pindex, PyObject **pitem)
+{
+    enumobject *en = (enumobject *)self;
+    PyObject *it = en->en_sit;
+    PyObject *next_index;
+    PyObject *next_item;
+
+    assert(Py_IS_TYPE(self, &PyEnum_Type));
+    next_item = (*Py_TYPE(it)->tp_iternext)(it);
+    if (next_item == NULL) {
+        return 0;
+    }
+    if (en->en_index == PY_SSIZE_T_MAX) {
+        next_index = enum_long_index(en);
+    }
+    else {
+        next_index = PyLong_FromSsize_t(en->en_index);
+        if (next_index != NULL) {
+            en->en_index++;
+        }
+    }
+    if (next_index == NULL) {
+        Py_DECREF(next_item);
+        return 0;
+    }
+    *pindex = next_index;
+    *pitem = next_item;
+    return 1;
+}
+
 static PyObject *
 enum_reduce(enumobject *en, PyObject *Py_UNUSED(ignored))
 {
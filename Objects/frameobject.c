@@ -313,6 +313,8 @@ mark_stacks(PyCodeObject *code_obj, int len)
                 case JUMP_IF_TRUE_OR_POP:
                 case POP_JUMP_IF_FALSE:
                 case POP_JUMP_IF_TRUE:
+                case POP_JUMP_IF_FALSE_BORROW:
+                case POP_JUMP_IF_TRUE_BORROW:
                 {
                     int64_t target_stack;
                     int j = get_arg(code, i);
@@ -647,6 +649,10 @@ add_load_fast_null_checks(PyCodeObject *co)
     if (changed) {
         // invalidate cached co_code object
         Py_CLEAR(co->_co_code);
+#ifdef _Py_JIT
+        // the compiled code doesn't check for unbound locals
+        co->_co_jit_warmup = -1;
+#endif
     }
 }
 
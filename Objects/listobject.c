@@ -1215,6 +1215,11 @@ struct s_MergeState {
      * of tuples. It may be set to safe_object_compare, but the idea is that hopefully
      * we can assume more, and use one of the special-case compares. */
     int (*tuple_elem_compare)(PyObject *, PyObject *, MergeState *);
+
+    /* Nonzero in the helper threads of a parallel sort, which don't hold
+     * the GIL: key_compare doesn't call back into Python, the temp memory
+     * comes from the raw allocator and errors aren't set. */
+    int nogil;
 };
 
 /* binarysort is the best method for sorting small arrays: it does
@@ -1551,6 +1556,7 @@ merge_init(MergeState *ms, Py_ssize_t list_size, int has_keyfunc,
     ms->min_gallop = MIN_GALLOP;
     ms->listlen = list_size;
     ms->basekeys = lo->keys;
+    ms->nogil = 0;
 }
 
 /* Free all the temp memory owned by the MergeState.  This must be called
@@ -1562,7 +1568,10 @@ merge_freemem(MergeState *ms)
 {
     assert(ms != NULL);
     if (ms->a.keys != ms->temparray) {
-        PyMem_Free(ms->a.keys);
+        if (ms->nogil)
+            PyMem_RawFree(ms->a.keys);
+        else
+            PyMem_Free(ms->a.keys);
         ms->a.keys = NULL;
     }
 }
@@ -1574,6 +1583,7 @@ static int
 merge_getmem(MergeState *ms, Py_ssize_t need)
 {
     int multiplier;
+    size_t size;
 
     assert(ms != NULL);
     if (need <= ms->alloced)
@@ -1586,18 +1596,20 @@ merge_getmem(MergeState *ms, Py_ssize_t need)
      */
     merge_freemem(ms);
     if ((size_t)need > PY_SSIZE_T_MAX / sizeof(PyObject *) / multiplier) {
-        PyErr_NoMemory();
-        return -1;
+        goto nomemory;
     }
-    ms->a.keys = (PyObject **)PyMem_Malloc(multiplier * need
-                                          * sizeof(PyObject *));
+    size = multiplier * need * sizeof(PyObject *);
+    ms->a.keys = (PyObject **)(ms->nogil ? PyMem_RawMalloc(size)
+                                         : PyMem_Malloc(size));
     if (ms->a.keys != NULL) {
         ms->alloced = need;
         if (ms->a.values != NULL)
             ms->a.values = &ms->a.keys[need];
         return 0;
     }
-    PyErr_NoMemory();
+  nomemory:
+    if (!ms->nogil)
+        PyErr_NoMemory();
     return -1;
 }
 #define MERGE_GETMEM(MS, NEED) ((NEED) <= (MS)->alloced ? 0 :   \
@@ -2059,6 +2071,59 @@ reverse_sortslice(sortslice *s, Py_ssize_t n)
         reverse_slice(s->values, &s->values[n]);
 }
 
+/* Sort the n keys at lo, and their values, with ms, which merge_init() set
+ * up for them: march over the keys once, left to right, finding natural
+ * runs, extending short natural runs to minrun elements, and merging them.
+ * Returns 0 on success, -1 on error.
+ */
+static int
+natural_mergesort(MergeState *ms, sortslice lo, Py_ssize_t nkeys)
+{
+    Py_ssize_t nremaining = nkeys;
+    Py_ssize_t minrun = merge_compute_minrun(nkeys);
+
+    assert(ms->n == 0);
+    assert(nkeys > 1);
+    do {
+        int descending;
+        Py_ssize_t n;
+
+        /* Identify next run. */
+        n = count_run(ms, lo.keys, lo.keys + nremaining, &descending);
+        if (n < 0)
+            return -1;
+        if (descending)
+            reverse_sortslice(&lo, n);
+        /* If short, extend to min(minrun, nremaining). */
+        if (n < minrun) {
+            const Py_ssize_t force = nremaining <= minrun ?
+                              nremaining : minrun;
+            if (binarysort(ms, lo, lo.keys + force, lo.keys + n) < 0)
+                return -1;
+            n = force;
+        }
+        /* Maybe merge pending runs. */
+        assert(ms->n == 0 || ms->pending[ms->n -1].base.keys +
+                             ms->pending[ms->n-1].len == lo.keys);
+        if (found_new_run(ms, n) < 0)
+            return -1;
+        /* Push new run on stack. */
+        assert(ms->n < MAX_MERGE_PENDING);
+        ms->pending[ms->n].base = lo;
+        ms->pending[ms->n].len = n;
+        ++ms->n;
+        /* Advance to find next run. */
+        sortslice_advance(&lo, n);
+        nremaining -= n;
+    } while (nremaining);
+
+    if (merge_force_collapse(ms) < 0)
+        return -1;
+    assert(ms->n == 1);
+    assert(ms->pending[0].len == nkeys);
+    return 0;
+}
+
 /* Here we define custom comparison functions to optimize for the cases one commonly
  * encounters in practice: homogeneous lists, often of one of the basic types. */
 
@@ -2135,7 +2200,7 @@ unsafe_latin_compare(PyObject *v, PyObject *w, MergeState *ms)
            res < 0 :
            PyUnicode_GET_LENGTH(v) < PyUnicode_GET_LENGTH(w));
 
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));;
+    assert(ms->nogil || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2163,7 +2228,7 @@ unsafe_long_compare(PyObject *v, PyObject *w, MergeState *ms)
         w0 = -w0;
 
     res = v0 < w0;
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));
+    assert(ms->nogil || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2178,7 +2243,7 @@ unsafe_float_compare(PyObject *v, PyObject *w, MergeState *ms)
     assert(Py_IS_TYPE(w, &PyFloat_Type));
 
     res = PyFloat_AS_DOUBLE(v) < PyFloat_AS_DOUBLE(w);
-    assert(res == PyObject_RichCompareBool(v, w, Py_LT));
+    assert(ms->nogil || res == PyObject_RichCompareBool(v, w, Py_LT));
     return res;
 }
 
@@ -2224,6 +2289,251 @@ unsafe_tuple_compare(PyObject *v, PyObject *w, MergeState *ms)
         return PyObject_RichCompareBool(vt->ob_item[i], wt->ob_item[i], Py_LT);
 }
 
+/* Radix sort: large lists of bounded ints or of floats are sorted by a
+ * stable LSD radix sort of unsigned integer images of the keys, unless they
+ * are mostly sorted already, which the mergesort handles better.  The images
+ * order like the keys; -0.0 has the image of 0.0, which it is equal to.
+ * NaNs don't compare consistently with other floats, so lists containing one
+ * are left to the mergesort.
+ */
+
+#define RADIX_MIN_SIZE 1024
+#define RADIX_SAMPLES 256
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+typedef struct {
+    uint64_t key;       /* image of the key */
+    Py_ssize_t index;   /* index of the key in the slice */
+} radix_item;
+
+static inline uint64_t
+radix_long_image(PyObject *v)
+{
+    PyLongObject *vl = (PyLongObject *)v;
+    sdigit v0 = Py_SIZE(vl) == 0 ? 0 : (sdigit)vl->ob_digit[0];
+
+    assert(Py_IS_TYPE(v, &PyLong_Type));
+    assert(Py_ABS(Py_SIZE(v)) <= 1);
+    if (Py_SIZE(vl) < 0)
+        v0 = -v0;
+    return (uint32_t)(int32_t)v0 ^ 0x80000000u;
+}
+
+/* Return -1 for a NaN. */
+static inline int
+radix_float_image(PyObject *v, uint64_t *image)
+{
+    double d = PyFloat_AS_DOUBLE(v);
+    uint64_t bits;
+
+    assert(Py_IS_TYPE(v, &PyFloat_Type));
+    if (Py_IS_NAN(d))
+        return -1;
+    if (d == 0.0)
+        d = 0.0;
+    memcpy(&bits, &d, sizeof(bits));
+    *image = (bits >> 63) ? ~bits : bits | ((uint64_t)1 << 63);
+    return 0;
+}
+
+/* Sort the n keys at lo, and their values, which are bounded ints or floats
+ * as ms->key_compare says.  Returns 1 if they were sorted, 0 if the mergesort
+ * must be used instead: for NaNs, mostly sorted keys or if memory is short.
+ */
+static int
+radix_sort(MergeState *ms, sortslice lo, Py_ssize_t n)
+{
+    const int is_float = ms->key_compare == unsafe_float_compare;
+    const int ndigits = (is_float ? 64 : 32) / RADIX_BITS;
+    Py_ssize_t (*counts)[RADIX_BUCKETS] = NULL;
+    radix_item *items, *src, *dst;
+    Py_ssize_t i;
+    int descents = 0;
+    int result = 0;
+
+    if (n < RADIX_MIN_SIZE
+        || (size_t)n > PY_SSIZE_T_MAX / (2 * sizeof(radix_item))) {
+        return 0;
+    }
+    /* Estimate how sorted the keys are from a sample of adjacent pairs:
+       about half of them are descents in random data. */
+    for (i = 0; i < RADIX_SAMPLES; i++) {
+        Py_ssize_t j = (n - 1) / RADIX_SAMPLES * i;
+        descents += ms->key_compare(lo.keys[j + 1], lo.keys[j], ms);
+    }
+    if (descents < RADIX_SAMPLES / 8)
+        return 0;
+
+    items = PyMem_Malloc(2 * n * sizeof(radix_item));
+    if (items == NULL)
+        return 0;
+    counts = PyMem_Calloc(ndigits, sizeof(*counts));
+    if (counts == NULL)
+        goto done;
+
+    /* Compute the images and the histograms of all their digits. */
+    src = items;
+    dst = items + n;
+    for (i = 0; i < n; i++) {
+        uint64_t image;
+        if (!is_float)
+            image = radix_long_image(lo.keys[i]);
+        else if (radix_float_image(lo.keys[i], &image) < 0)
+            goto done;
+        src[i].key = image;
+        src[i].index = i;
+        for (int d = 0; d < ndigits; d++)
+            counts[d][(image >> (d * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    /* One stable counting sort per digit, from the least significant.  The
+       digits which are the same in all the keys are skipped. */
+    for (int d = 0; d < ndigits; d++) {
+        Py_ssize_t *count = counts[d];
+        int shift = d * RADIX_BITS;
+        if (count[(src[0].key >> shift) & (RADIX_BUCKETS - 1)] == n)
+            continue;
+        Py_ssize_t pos = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            Py_ssize_t c = count[b];
+            count[b] = pos;
+            pos += c;
+        }
+        for (i = 0; i < n; i++) {
+            dst[count[(src[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+        radix_item *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    /* Apply the permutation, using the other half of items as temp space. */
+    PyObject **tmp = (PyObject **)dst;
+    for (i = 0; i < n; i++)
+        tmp[i] = lo.keys[src[i].index];
+    memcpy(lo.keys, tmp, n * sizeof(PyObject *));
+    if (lo.values != NULL) {
+        for (i = 0; i < n; i++)
+            tmp[i] = lo.values[src[i].index];
+        memcpy(lo.values, tmp, n * sizeof(PyObject *));
+    }
+    result = 1;
+
+done:
+    PyMem_Free(counts);
+    PyMem_Free(items);
+    return result;
+}
+
+/* Parallel sort: when list.sort() is called with threads > 1 and
+ * key_compare doesn't call back into Python, a large list is split into one
+ * slice per thread.  Helper threads without a thread state sort the slices
+ * while the calling thread, which released the GIL, sorts the first one.
+ * The sorted slices are then merged like natural runs, which keeps the sort
+ * stable.
+ */
+
+#define MAX_SORT_THREADS 256
+#define PARALLEL_SORT_MIN_SLICE (1 << 14)
+
+struct sort_worker {
+    MergeState ms;
+    sortslice lo;
+    Py_ssize_t n;
+    int result;
+    PyThread_type_lock done;    /* released when the slice is sorted */
+};
+
+static void
+sort_helper_thread(void *arg)
+{
+    struct sort_worker *worker = (struct sort_worker *)arg;
+    worker->result = natural_mergesort(&worker->ms, worker->lo, worker->n);
+    PyThread_release_lock(worker->done);
+}
+
+/* Same as natural_mergesort(), with up to nthreads threads. */
+static int
+parallel_mergesort(MergeState *ms, sortslice lo, Py_ssize_t n, int nthreads)
+{
+    struct sort_worker *workers;
+    int t, started, failed = 0;
+
+    assert(ms->key_compare == unsafe_latin_compare
+           || ms->key_compare == unsafe_long_compare
+           || ms->key_compare == unsafe_float_compare);
+    nthreads = (int)Py_MIN(nthreads, n / PARALLEL_SORT_MIN_SLICE);
+    if (nthreads < 2)
+        return natural_mergesort(ms, lo, n);
+    workers = PyMem_RawCalloc(nthreads, sizeof(struct sort_worker));
+    if (workers == NULL)
+        return natural_mergesort(ms, lo, n);
+
+    for (t = 0; t < nthreads; t++) {
+        struct sort_worker *worker = &workers[t];
+        Py_ssize_t start = n * t / nthreads;
+        worker->lo = lo;
+        sortslice_advance(&worker->lo, start);
+        worker->n = n * (t + 1) / nthreads - start;
+        merge_init(&worker->ms, worker->n, lo.values != NULL, &worker->lo);
+        worker->ms.key_compare = ms->key_compare;
+        worker->ms.nogil = 1;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    /* The calling thread sorts the slices no helper could be started for */
+    for (started = 1; started < nthreads; started++) {
+        struct sort_worker *worker = &workers[started];
+        worker->done = PyThread_allocate_lock();
+        if (worker->done == NULL)
+            break;
+        PyThread_acquire_lock(worker->done, WAIT_LOCK);
+        if (PyThread_start_new_thread(sort_helper_thread, worker)
+            == PYTHREAD_INVALID_THREAD_ID)
+        {
+            PyThread_free_lock(worker->done);
+            break;
+        }
+    }
+    workers[0].result = natural_mergesort(&workers[0].ms, workers[0].lo,
+                                          workers[0].n);
+    for (t = started; t < nthreads; t++) {
+        workers[t].result = natural_mergesort(&workers[t].ms, workers[t].lo,
+                                              workers[t].n);
+    }
+    for (t = 1; t < started; t++) {
+        PyThread_acquire_lock(workers[t].done, WAIT_LOCK);
+        PyThread_free_lock(workers[t].done);
+    }
+    for (t = 0; t < nthreads; t++) {
+        failed |= workers[t].result < 0;
+        merge_freemem(&workers[t].ms);
+    }
+    Py_END_ALLOW_THREADS
+
+    if (failed) {
+        /* Out of memory in a helper: the keys are still a permutation */
+        PyMem_RawFree(workers);
+        return natural_mergesort(ms, lo, n);
+    }
+    for (t = 0; t < nthreads; t++) {
+        if (found_new_run(ms, workers[t].n) < 0) {
+            PyMem_RawFree(workers);
+            return -1;
+        }
+        assert(ms->n < MAX_MERGE_PENDING);
+        ms->pending[ms->n].base = workers[t].lo;
+        ms->pending[ms->n].len = workers[t].n;
+        ++ms->n;
+    }
+    PyMem_RawFree(workers);
+    if (merge_force_collapse(ms) < 0)
+        return -1;
+    assert(ms->n == 1);
+    return 0;
+}
+
 /* An adaptive, stable, natural mergesort.  See listsort.txt.
  * Returns Py_None on success, NULL on error.  Even in case of error, the
  * list will be some permutation of its input state (nothing is lost or
@@ -2235,6 +2545,7 @@ list.sort
     *
     key as keyfunc: object = None
     reverse: bool(accept={int}) = False
+    threads: int = 1
 
 Sort the list in ascending order and return None.
 
@@ -2245,15 +2556,18 @@ If a key function is given, apply it once to each list item and sort them,
 ascending or descending, according to their function values.
 
 The reverse flag can be set to sort in descending order.
+
+Large lists of strings, ints or floats can be sorted by up to the given
+number of threads.
 [clinic start generated code]*/
 
 static PyObject *
-list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
-/*[clinic end generated code: output=57b9f9c5e23fbe42 input=cb56cd179a713060]*/
+list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse,
+               int threads)
+/*[clinic end generated code: output=33a48ab7c5cd98f1 input=9fc7a978c05c98ce]*/
 {
     MergeState ms;
     Py_ssize_t nremaining;
-    Py_ssize_t minrun;
     sortslice lo;
     Py_ssize_t saved_ob_size, saved_allocated;
     PyObject **saved_ob_item;
@@ -2264,6 +2578,11 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
 
     assert(self != NULL);
     assert(PyList_Check(self));
+    if (threads < 1 || threads > MAX_SORT_THREADS) {
+        PyErr_Format(PyExc_ValueError,
+                     "threads must be between 1 and %d", MAX_SORT_THREADS);
+        return NULL;
+    }
     if (keyfunc == Py_None)
         keyfunc = NULL;
 
@@ -2423,46 +2742,24 @@ list_sort_impl(PyListObject *self, PyObject *keyfunc, int reverse)
         reverse_slice(&saved_ob_item[0], &saved_ob_item[saved_ob_size]);
     }
 
-    /* March over the array once, left to right, finding natural runs,
-     * and extending short natural runs to minrun elements.
-     */
-    minrun = merge_compute_minrun(nremaining);
-    do {
-        int descending;
-        Py_ssize_t n;
-
-        /* Identify next run. */
-        n = count_run(&ms, lo.keys, lo.keys + nremaining, &descending);
-        if (n < 0)
-            goto fail;
-        if (descending)
-            reverse_sortslice(&lo, n);
-        /* If short, extend to min(minrun, nremaining). */
-        if (n < minrun) {
-            const Py_ssize_t force = nremaining <= minrun ?
-                              nremaining : minrun;
-            if (binarysort(&ms, lo, lo.keys + force, lo.keys + n) < 0)
-                goto fail;
-            n = force;
+    /* The compares which don't call back into Python allow a radix sort
+     * or helper threads. */
+    if (ms.key_compare == unsafe_long_compare
+        || ms.key_compare == unsafe_float_compare) {
+        if (radix_sort(&ms, lo, nremaining)) {
+            goto succeed;
         }
-        /* Maybe merge pending runs. */
-        assert(ms.n == 0 || ms.pending[ms.n -1].base.keys +
-                            ms.pending[ms.n-1].len == lo.keys);
-        if (found_new_run(&ms, n) < 0)
-            goto fail;
-        /* Push new run on stack. */
-        assert(ms.n < MAX_MERGE_PENDING);
-        ms.pending[ms.n].base = lo;
-        ms.pending[ms.n].len = n;
-        ++ms.n;
-        /* Advance to find next run. */
-        sortslice_advance(&lo, n);
-        nremaining -= n;
-    } while (nremaining);
+    }
 
-    if (merge_force_collapse(&ms) < 0)
+    if (threads > 1 && (ms.key_compare == unsafe_latin_compare
+                        || ms.key_compare == unsafe_long_compare
+                        || ms.key_compare == unsafe_float_compare)) {
+        if (parallel_mergesort(&ms, lo, nremaining, threads) < 0)
+            goto fail;
+    }
+    else if (natural_mergesort(&ms, lo, nremaining) < 0) {
         goto fail;
-    assert(ms.n == 1);
+    }
     assert(keys == NULL
            ? ms.pending[0].base.keys == saved_ob_item
            : ms.pending[0].base.keys == &keys[0]);
@@ -2519,7 +2816,7 @@ PyList_Sort(PyObject *v)
         PyErr_BadInternalCall();
         return -1;
     }
-    v = list_sort_impl((PyListObject *)v, NULL, 0);
+    v = list_sort_impl((PyListObject *)v, NULL, 0, 1);
     if (v == NULL)
         return -1;
     Py_DECREF(v);
@@ -1,6 +1,7 @@
 #include "Python.h"
 #include "pycore_pymem.h"         // _PyTraceMalloc_Config
 #include "pycore_code.h"         // stats
+#include "pycore_pystate.h"       // _PyThreadState_GET()
 
 #include <stdbool.h>
 #include <stdlib.h>               // malloc()
@@ -80,6 +81,11 @@ static void* _PyObject_Malloc(void *ctx, size_t size);
 static void* _PyObject_Calloc(void *ctx, size_t nelem, size_t elsize);
 static void _PyObject_Free(void *ctx, void *p);
 static void* _PyObject_Realloc(void *ctx, void *ptr, size_t size);
+#ifdef ARENAS_USE_MMAP
+static void* _PyObject_ArenaHugeAlloc(void *ctx, size_t size);
+static void _PyObject_ArenaHugeFree(void *ctx, void *ptr, size_t size);
+#endif
+static int huge_arenas_enabled(void);
 #endif
 
 
@@ -291,6 +297,14 @@ _PyMem_GetAllocatorName(const char *name, PyMemAllocatorName *allocator)
     else if (strcmp(name, "pymalloc_debug") == 0) {
         *allocator = PYMEM_ALLOCATOR_PYMALLOC_DEBUG;
     }
+#ifdef ARENAS_USE_MMAP
+    else if (strcmp(name, "pymalloc_hugepage") == 0) {
+        *allocator = PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE;
+    }
+    else if (strcmp(name, "pymalloc_hugepage_debug") == 0) {
+        *allocator = PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE_DEBUG;
+    }
+#endif
 #endif
     else if (strcmp(name, "malloc") == 0) {
         *allocator = PYMEM_ALLOCATOR_MALLOC;
@@ -329,6 +343,8 @@ _PyMem_SetupAllocators(PyMemAllocatorName allocator)
 #ifdef WITH_PYMALLOC
     case PYMEM_ALLOCATOR_PYMALLOC:
     case PYMEM_ALLOCATOR_PYMALLOC_DEBUG:
+    case PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE:
+    case PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE_DEBUG:
     {
         PyMemAllocatorEx malloc_alloc = MALLOC_ALLOC;
         PyMem_SetAllocator(PYMEM_DOMAIN_RAW, &malloc_alloc);
@@ -337,7 +353,17 @@ _PyMem_SetupAllocators(PyMemAllocatorName allocator)
         PyMem_SetAllocator(PYMEM_DOMAIN_MEM, &pymalloc);
         PyMem_SetAllocator(PYMEM_DOMAIN_OBJ, &pymalloc);
 
-        if (allocator == PYMEM_ALLOCATOR_PYMALLOC_DEBUG) {
+#ifdef ARENAS_USE_MMAP
+        if (allocator == PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE ||
+            allocator == PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE_DEBUG) {
+            PyObjectArenaAllocator arena = {NULL, _PyObject_ArenaHugeAlloc,
+                                            _PyObject_ArenaHugeFree};
+            PyObject_SetArenaAllocator(&arena);
+        }
+#endif
+
+        if (allocator == PYMEM_ALLOCATOR_PYMALLOC_DEBUG ||
+            allocator == PYMEM_ALLOCATOR_PYMALLOC_HUGEPAGE_DEBUG) {
             PyMem_SetupDebugHooks();
         }
         break;
@@ -392,7 +418,7 @@ _PyMem_GetCurrentAllocatorName(void)
         pymemallocator_eq(&_PyMem, &pymalloc) &&
         pymemallocator_eq(&_PyObject, &pymalloc))
     {
-        return "pymalloc";
+        return huge_arenas_enabled() ? "pymalloc_hugepage" : "pymalloc";
     }
 #endif
 
@@ -416,7 +442,8 @@ _PyMem_GetCurrentAllocatorName(void)
             pymemallocator_eq(&_PyMem_Debug.mem.alloc, &pymalloc) &&
             pymemallocator_eq(&_PyMem_Debug.obj.alloc, &pymalloc))
         {
-            return "pymalloc_debug";
+            return (huge_arenas_enabled() ? "pymalloc_hugepage_debug"
+                                          : "pymalloc_debug");
         }
 #endif
     }
@@ -444,6 +471,18 @@ static PyObjectArenaAllocator _PyObject_Arena = {NULL,
 #endif
     };
 
+#ifdef WITH_PYMALLOC
+static int
+huge_arenas_enabled(void)
+{
+#ifdef ARENAS_USE_MMAP
+    return _PyObject_Arena.alloc == _PyObject_ArenaHugeAlloc;
+#else
+    return 0;
+#endif
+}
+#endif
+
 #ifdef WITH_PYMALLOC
 static int
 _PyMem_DebugEnabled(void)
@@ -1162,10 +1201,55 @@ on that C doesn't insert any padding anywhere in a pool_header at or before
 the prevpool member.
 **************************************************************************** */
 
-#define PTA(x)  ((poolp )((uint8_t *)&(usedpools[2*(x)]) - 2*sizeof(block *)))
-#define PT(x)   PTA(x), PTA(x)
+#define PTA(state, x) \
+    ((poolp )((uint8_t *)&((state)->usedpools[2*(x)]) - 2*sizeof(block *)))
+
+/*==========================================================================
+Allocator state.
+
+Each interpreter allocates from the pools and arenas of its own
+_obmalloc_state, interp->obmalloc.  Most interpreters share the state of the
+main interpreter; isolated subinterpreters (see _Py_NewInterpreter()) get one
+of their own, so that they don't contend for the pools of other interpreters.
+
+A block may still be freed by another interpreter than the one that
+allocated it: pymalloc_free() finds the state owning the pool with
+get_pool_state().  All states are kept in a list headed by the main state for
+that.  The state of a deleted interpreter that still has blocks in use stays
+on the list ("orphaned") and is released once its last arena is freed.  Only
+the radix tree can tell whether a pointer belongs to any of the states, so
+without it every interpreter uses the main state.
+*/
+
+struct _obmalloc_state {
+    /* See "Pool table" above. */
+    poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8];
+
+    /* See "Arena management" below. */
+    struct arena_object* arenas;
+    uint maxarenas;
+    struct arena_object* unused_arena_objects;
+    struct arena_object* usable_arenas;
+    struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1];
+
+    /* Number of arenas allocated that haven't been free()'d. */
+    size_t narenas_currently_allocated;
+    /* Total number of times malloc() called to allocate an arena. */
+    size_t ntimes_arena_allocated;
+    /* High water mark (max value ever seen) for narenas_currently_allocated. */
+    size_t narenas_highwater;
+
+    /* Number of blocks of this state sitting in thread caches. */
+    Py_ssize_t ncached;
+
+    struct _obmalloc_state *next;
+    int orphaned;
+};
+
+#define PT(x)   PTA(&obmalloc_main_state, x), PTA(&obmalloc_main_state, x)
 
-static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
+static struct _obmalloc_state obmalloc_main_state = {
+  .usedpools = {
     PT(0), PT(1), PT(2), PT(3), PT(4), PT(5), PT(6), PT(7)
 #if NB_SMALL_SIZE_CLASSES > 8
     , PT(8), PT(9), PT(10), PT(11), PT(12), PT(13), PT(14), PT(15)
@@ -1191,8 +1275,11 @@ static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
 #endif /* NB_SMALL_SIZE_CLASSES > 24 */
 #endif /* NB_SMALL_SIZE_CLASSES > 16 */
 #endif /* NB_SMALL_SIZE_CLASSES >  8 */
+  },
 };
 
+#undef PT
+
 /*==========================================================================
 Arena management.
 
@@ -1240,23 +1327,25 @@ with nfp free pools.  This is NULL if and only if there is no arena with
 nfp free pools in usable_arenas.
 */
 
-/* Array of objects used to track chunks of memory (arenas). */
-static struct arena_object* arenas = NULL;
-/* Number of slots currently allocated in the `arenas` vector. */
-static uint maxarenas = 0;
+/* The members of _obmalloc_state:
 
-/* The head of the singly-linked, NULL-terminated list of available
- * arena_objects.
- */
-static struct arena_object* unused_arena_objects = NULL;
+arenas
+    Array of objects used to track chunks of memory (arenas).
 
-/* The head of the doubly-linked, NULL-terminated at each end, list of
- * arena_objects associated with arenas that have pools available.
- */
-static struct arena_object* usable_arenas = NULL;
+maxarenas
+    Number of slots currently allocated in the `arenas` vector.
 
-/* nfp2lasta[nfp] is the last arena in usable_arenas with nfp free pools */
-static struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1] = { NULL };
+unused_arena_objects
+    The head of the singly-linked, NULL-terminated list of available
+    arena_objects.
+
+usable_arenas
+    The head of the doubly-linked, NULL-terminated at each end, list of
+    arena_objects associated with arenas that have pools available.
+
+nfp2lasta
+    nfp2lasta[nfp] is the last arena in usable_arenas with nfp free pools.
+*/
 
 /* How many arena_objects do we initially allocate?
  * 16 = can allocate 16 arenas = 16 * ARENA_SIZE = 4MB before growing the
@@ -1264,32 +1353,133 @@ static struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1] = { NULL };
  */
 #define INITIAL_ARENA_OBJECTS 16
 
-/* Number of arenas allocated that haven't been free()'d. */
-static size_t narenas_currently_allocated = 0;
+/* Blocks that pymalloc handed over to PyMem_RawMalloc(), for all states */
+static Py_ssize_t raw_allocated_blocks;
 
-/* Total number of times malloc() called to allocate an arena. */
-static size_t ntimes_arena_allocated = 0;
-/* High water mark (max value ever seen) for narenas_currently_allocated. */
-static size_t narenas_highwater = 0;
+static inline struct _obmalloc_state *
+get_state(PyThreadState *tstate)
+{
+    if (tstate == NULL || tstate->interp->obmalloc == NULL) {
+        return &obmalloc_main_state;
+    }
+    return tstate->interp->obmalloc;
+}
 
-static Py_ssize_t raw_allocated_blocks;
+/* Return the state of the interpreter of the current thread. */
+static inline struct _obmalloc_state *
+get_current_state(void)
+{
+    if (LIKELY(obmalloc_main_state.next == NULL)) {
+        /* There are no other states */
+        return &obmalloc_main_state;
+    }
+    return get_state(_PyThreadState_GET());
+}
 
-Py_ssize_t
-_Py_GetAllocatedBlocks(void)
+/* Return true if pool was carved off an arena of state. */
+static inline int
+pool_in_state(struct _obmalloc_state *state, poolp pool)
 {
-    Py_ssize_t n = raw_allocated_blocks;
+    uint arenaindex = pool->arenaindex;
+    return arenaindex < state->maxarenas &&
+        (uintptr_t)pool - state->arenas[arenaindex].address < ARENA_SIZE &&
+        state->arenas[arenaindex].address != 0;
+}
+
+/* Return the state owning pool, a pool of a pymalloc arena.  That's most
+ * likely the state of the current interpreter. */
+static inline struct _obmalloc_state *
+get_pool_state(struct _obmalloc_state *state, poolp pool)
+{
+    if (LIKELY(obmalloc_main_state.next == NULL ||
+               pool_in_state(state, pool))) {
+        return state;
+    }
+    for (state = &obmalloc_main_state; state != NULL; state = state->next) {
+        if (pool_in_state(state, pool)) {
+            return state;
+        }
+    }
+    Py_UNREACHABLE();
+}
+
+/*==========================================================================
+Thread caches.
+
+A thread keeps up to THREAD_CACHE_LIMIT freed blocks of each of the
+THREAD_CACHE_CLASSES smallest size classes in tstate->obmalloc_cache, and
+hands them out again, most recently freed first, before going to the pools.
+Only blocks of the state of the thread's interpreter are cached.  A cached
+block is still allocated as far as its pool is concerned; state->ncached
+counts them so that _Py_GetAllocatedBlocks() doesn't.
+PyThreadState_Clear() returns the blocks to their pools.
+
+The caches are only built with WITH_PYMALLOC_THREAD_CACHE, which also adds
+obmalloc_cache to PyThreadState (see Include/cpython/pystate.h).
+*/
+
+#if WITH_PYMALLOC_THREAD_CACHE
+#define THREAD_CACHE_CLASSES \
+    Py_ARRAY_LENGTH(((PyThreadState *)NULL)->obmalloc_cache.freeblock)
+#define THREAD_CACHE_LIMIT 16
+
+/* Return a block of size class size from the cache of the current thread,
+ * or NULL if it has none. */
+static inline block *
+thread_cache_pop(uint size)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    if (tstate == NULL) {
+        return NULL;
+    }
+    block *bp = tstate->obmalloc_cache.freeblock[size];
+    if (bp != NULL) {
+        tstate->obmalloc_cache.freeblock[size] = *(block **)bp;
+        tstate->obmalloc_cache.count[size]--;
+        get_state(tstate)->ncached--;
+    }
+    return bp;
+}
+
+/* Keep block p of pool in the cache of the current thread, whose
+ * interpreter allocates from state.  Return 0 if p can't be cached. */
+static inline int
+thread_cache_push(struct _obmalloc_state *state, poolp pool, void *p)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    uint size = pool->szidx;
+    if (tstate == NULL ||
+        tstate->obmalloc_cache.count[size] >= THREAD_CACHE_LIMIT ||
+        !(LIKELY(obmalloc_main_state.next == NULL) ||
+          pool_in_state(state, pool)))
+    {
+        return 0;
+    }
+    *(block **)p = tstate->obmalloc_cache.freeblock[size];
+    tstate->obmalloc_cache.freeblock[size] = (block *)p;
+    tstate->obmalloc_cache.count[size]++;
+    state->ncached++;
+    return 1;
+}
+#endif
+
+static Py_ssize_t
+get_allocated_blocks(struct _obmalloc_state *state)
+{
+    Py_ssize_t n = 0;
     /* add up allocated blocks for used pools */
-    for (uint i = 0; i < maxarenas; ++i) {
+    for (uint i = 0; i < state->maxarenas; ++i) {
+        struct arena_object *ao = &state->arenas[i];
         /* Skip arenas which are not allocated. */
-        if (arenas[i].address == 0) {
+        if (ao->address == 0) {
             continue;
         }
 
-        uintptr_t base = (uintptr_t)_Py_ALIGN_UP(arenas[i].address, POOL_SIZE);
+        uintptr_t base = (uintptr_t)_Py_ALIGN_UP(ao->address, POOL_SIZE);
 
         /* visit every pool in the arena */
-        assert(base <= (uintptr_t) arenas[i].pool_address);
-        for (; base < (uintptr_t) arenas[i].pool_address; base += POOL_SIZE) {
+        assert(base <= (uintptr_t) ao->pool_address);
+        for (; base < (uintptr_t) ao->pool_address; base += POOL_SIZE) {
             poolp p = (poolp)base;
             n += p->ref.count;
         }
@@ -1297,6 +1487,19 @@ _Py_GetAllocatedBlocks(void)
     return n;
 }
 
+Py_ssize_t
+_Py_GetAllocatedBlocks(void)
+{
+    Py_ssize_t n = raw_allocated_blocks;
+    for (struct _obmalloc_state *state = &obmalloc_main_state;
+         state != NULL; state = state->next)
+    {
+        /* Blocks in thread caches count as free. */
+        n += get_allocated_blocks(state) - state->ncached;
+    }
+    return n;
+}
+
 #if WITH_PYMALLOC_RADIX_TREE
 /*==========================================================================*/
 /* radix tree for tracking arena usage.  If enabled, used to implement
@@ -1571,13 +1774,281 @@ arena_map_is_used(block *p)
 #endif /* WITH_PYMALLOC_RADIX_TREE */
 
 
+#ifdef ARENAS_USE_MMAP
+/*==========================================================================
+Huge page arenas.
+
+With PYTHONMALLOC=pymalloc_hugepage, arenas are carved out of regions of
+HUGE_REGION_SIZE bytes aligned to HUGE_REGION_SIZE, so that the kernel can
+back each region with a single huge page: traversing a large object graph
+then takes far fewer TLB misses.  Regions come from MAP_HUGETLB if huge pages
+were reserved (vm.nr_hugepages), else from regular mappings with the
+MADV_HUGEPAGE hint for transparent huge pages.
+
+A region is filled before a new one is mapped, and is unmapped once all of
+its arenas are free.  Freed arenas of a region still in use are not returned
+to the system, since that would split the huge page, unless the allocator is
+explicitly trimmed (see _PyObject_TrimArenas()).
+
+huge_regions maps the address of a region to its huge_region, with linear
+probing.  Its size is a power of 2, at least twice the number of regions.
+*/
+
+/* The size of a huge page on x86-64 and on arm64 with 4 KiB pages */
+#define HUGE_REGION_BITS        21                    /* 2 MiB */
+#define HUGE_REGION_SIZE        ((size_t)1 << HUGE_REGION_BITS)
+#define HUGE_REGION_MASK        (HUGE_REGION_SIZE - 1)
+#define ARENAS_PER_REGION       (HUGE_REGION_SIZE / ARENA_SIZE)
+#define REGION_FULL             ((uint32_t)((1ULL << ARENAS_PER_REGION) - 1))
+
+#if ARENA_BITS > HUGE_REGION_BITS || HUGE_REGION_BITS - ARENA_BITS > 5
+#   error "a huge page must hold 1 to 32 arenas"
+#endif
+
+struct huge_region {
+    uintptr_t address;
+    /* Bit i is set if the i-th arena of the region is in use */
+    uint32_t used;
+    /* Bit i is set if the free i-th arena was returned to the system */
+    uint32_t trimmed;
+    /* The list of regions with free arenas */
+    struct huge_region *nextregion;
+    struct huge_region *prevregion;
+};
+
+static struct huge_region **huge_regions;
+static size_t huge_regions_size;
+static size_t nhuge_regions;
+static size_t ntimes_huge_region_allocated;
+static struct huge_region *partial_huge_regions;
+/* -1: not tried yet, 0: MAP_HUGETLB failed, 1: MAP_HUGETLB works */
+static int use_hugetlb = -1;
+
+static inline size_t
+huge_region_slot(uintptr_t address)
+{
+    return (address >> HUGE_REGION_BITS) & (huge_regions_size - 1);
+}
+
+static struct huge_region *
+huge_region_lookup(uintptr_t address)
+{
+    if (huge_regions == NULL) {
+        return NULL;
+    }
+    for (size_t i = huge_region_slot(address); huge_regions[i] != NULL;
+         i = (i + 1) & (huge_regions_size - 1))
+    {
+        if (huge_regions[i]->address == address) {
+            return huge_regions[i];
+        }
+    }
+    return NULL;
+}
+
+static int
+huge_region_insert(struct huge_region *region)
+{
+    if (2 * (nhuge_regions + 1) > huge_regions_size) {
+        size_t oldsize = huge_regions_size;
+        struct huge_region **old = huge_regions;
+        size_t newsize = oldsize ? 2 * oldsize : 64;
+        struct huge_region **new = PyMem_RawCalloc(newsize, sizeof(*new));
+        if (new == NULL) {
+            return -1;
+        }
+        huge_regions = new;
+        huge_regions_size = newsize;
+        nhuge_regions = 0;
+        for (size_t i = 0; i < oldsize; i++) {
+            if (old[i] != NULL) {
+                (void)huge_region_insert(old[i]);
+            }
+        }
+        PyMem_RawFree(old);
+    }
+    size_t i = huge_region_slot(region->address);
+    while (huge_regions[i] != NULL) {
+        i = (i + 1) & (huge_regions_size - 1);
+    }
+    huge_regions[i] = region;
+    nhuge_regions++;
+    return 0;
+}
+
+static void
+huge_region_remove(struct huge_region *region)
+{
+    size_t mask = huge_regions_size - 1;
+    size_t i = huge_region_slot(region->address);
+    while (huge_regions[i] != region) {
+        i = (i + 1) & mask;
+    }
+    huge_regions[i] = NULL;
+    nhuge_regions--;
+    /* Move back the entries that can't be found past the hole any more */
+    for (size_t j = (i + 1) & mask; huge_regions[j] != NULL;
+         j = (j + 1) & mask)
+    {
+        size_t home = huge_region_slot(huge_regions[j]->address);
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            huge_regions[i] = huge_regions[j];
+            huge_regions[j] = NULL;
+            i = j;
+        }
+    }
+}
+
+/* Map HUGE_REGION_SIZE bytes aligned to HUGE_REGION_SIZE. */
+static void *
+huge_region_map(void)
+{
+    void *ptr;
+#ifdef MAP_HUGETLB
+    if (use_hugetlb != 0) {
+        ptr = mmap(NULL, HUGE_REGION_SIZE, PROT_READ|PROT_WRITE,
+                   MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+        use_hugetlb = (ptr != MAP_FAILED);
+        if (ptr != MAP_FAILED) {
+            return ptr;
+        }
+    }
+#endif
+    /* Map twice the size and trim the excess at both ends */
+    ptr = mmap(NULL, 2 * HUGE_REGION_SIZE, PROT_READ|PROT_WRITE,
+               MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t address = _Py_SIZE_ROUND_UP(start, HUGE_REGION_SIZE);
+    if (address != start) {
+        munmap(ptr, address - start);
+    }
+    size_t tail = start + HUGE_REGION_SIZE - address;
+    if (tail != 0) {
+        munmap((void *)(address + HUGE_REGION_SIZE), tail);
+    }
+#ifdef MADV_HUGEPAGE
+    (void)madvise((void *)address, HUGE_REGION_SIZE, MADV_HUGEPAGE);
+#endif
+    return (void *)address;
+}
+
+static void
+partial_huge_regions_remove(struct huge_region *region)
+{
+    if (region->prevregion != NULL) {
+        region->prevregion->nextregion = region->nextregion;
+    }
+    else {
+        partial_huge_regions = region->nextregion;
+    }
+    if (region->nextregion != NULL) {
+        region->nextregion->prevregion = region->prevregion;
+    }
+}
+
+static void
+partial_huge_regions_push(struct huge_region *region)
+{
+    region->prevregion = NULL;
+    region->nextregion = partial_huge_regions;
+    if (partial_huge_regions != NULL) {
+        partial_huge_regions->prevregion = region;
+    }
+    partial_huge_regions = region;
+}
+
+static size_t
+count_partial_huge_regions(void)
+{
+    size_t n = 0;
+    for (struct huge_region *r = partial_huge_regions; r != NULL;
+         r = r->nextregion)
+    {
+        n++;
+    }
+    return n;
+}
+
+static void *
+_PyObject_ArenaHugeAlloc(void *ctx, size_t size)
+{
+    if (size != ARENA_SIZE) {
+        /* _PyObject_VirtualAlloc() */
+        return _PyObject_ArenaMmap(ctx, size);
+    }
+    struct huge_region *region = partial_huge_regions;
+    if (region == NULL) {
+        region = PyMem_RawMalloc(sizeof(struct huge_region));
+        if (region == NULL) {
+            return NULL;
+        }
+        void *address = huge_region_map();
+        if (address == NULL) {
+            PyMem_RawFree(region);
+            return NULL;
+        }
+        region->address = (uintptr_t)address;
+        region->used = 0;
+        region->trimmed = 0;
+        if (huge_region_insert(region) < 0) {
+            munmap(address, HUGE_REGION_SIZE);
+            PyMem_RawFree(region);
+            return NULL;
+        }
+        ntimes_huge_region_allocated++;
+        partial_huge_regions_push(region);
+    }
+    uint i = 0;
+    while (region->used & ((uint32_t)1 << i)) {
+        i++;
+    }
+    region->used |= (uint32_t)1 << i;
+    region->trimmed &= ~((uint32_t)1 << i);
+    if (region->used == REGION_FULL) {
+        partial_huge_regions_remove(region);
+    }
+    return (void *)(region->address + i * ARENA_SIZE);
+}
+
+static void
+_PyObject_ArenaHugeFree(void *ctx, void *ptr, size_t size)
+{
+    struct huge_region *region = NULL;
+    if (size == ARENA_SIZE) {
+        region = huge_region_lookup((uintptr_t)ptr & ~HUGE_REGION_MASK);
+    }
+    if (region == NULL) {
+        /* Not carved out of a region: _PyObject_VirtualAlloc(), or an arena
+         * allocated before PYTHONMALLOC took effect */
+        _PyObject_ArenaMunmap(ctx, ptr, size);
+        return;
+    }
+    uint i = (uint)(((uintptr_t)ptr - region->address) / ARENA_SIZE);
+    assert(region->used & ((uint32_t)1 << i));
+    if (region->used == REGION_FULL) {
+        partial_huge_regions_push(region);
+    }
+    region->used &= ~((uint32_t)1 << i);
+    if (region->used == 0) {
+        partial_huge_regions_remove(region);
+        huge_region_remove(region);
+        munmap((void *)region->address, HUGE_REGION_SIZE);
+        PyMem_RawFree(region);
+    }
+}
+#endif  /* ARENAS_USE_MMAP */
+
+
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
  * allocate a new arena, and return the address of an arena_object
  * describing the new arena.  It's expected that the caller will set
  * `usable_arenas` to the return value.
  */
 static struct arena_object*
-new_arena(void)
+new_arena(struct _obmalloc_state *state)
 {
     struct arena_object* arenaobj;
     uint excess;        /* number of bytes above pool alignment */
@@ -1592,7 +2063,7 @@ new_arena(void)
         _PyObject_DebugMallocStats(stderr);
     }
 
-    if (unused_arena_objects == NULL) {
+    if (state->unused_arena_objects == NULL) {
         uint i;
         uint numarenas;
         size_t nbytes;
@@ -1600,18 +2071,20 @@ new_arena(void)
         /* Double the number of arena objects on each allocation.
          * Note that it's possible for `numarenas` to overflow.
          */
-        numarenas = maxarenas ? maxarenas << 1 : INITIAL_ARENA_OBJECTS;
-        if (numarenas <= maxarenas)
+        numarenas = state->maxarenas ? state->maxarenas << 1
+                                     : INITIAL_ARENA_OBJECTS;
+        if (numarenas <= state->maxarenas)
             return NULL;                /* overflow */
 #if SIZEOF_SIZE_T <= SIZEOF_INT
-        if (numarenas > SIZE_MAX / sizeof(*arenas))
+        if (numarenas > SIZE_MAX / sizeof(*state->arenas))
             return NULL;                /* overflow */
 #endif
-        nbytes = numarenas * sizeof(*arenas);
-        arenaobj = (struct arena_object *)PyMem_RawRealloc(arenas, nbytes);
+        nbytes = numarenas * sizeof(*state->arenas);
+        arenaobj = (struct arena_object *)PyMem_RawRealloc(state->arenas,
+                                                           nbytes);
         if (arenaobj == NULL)
             return NULL;
-        arenas = arenaobj;
+        state->arenas = arenaobj;
 
         /* We might need to fix pointers that were copied.  However,
          * new_arena only gets called when all the pages in the
@@ -1619,25 +2092,25 @@ new_arena(void)
          * into the old array. Thus, we don't have to worry about
          * invalid pointers.  Just to be sure, some asserts:
          */
-        assert(usable_arenas == NULL);
-        assert(unused_arena_objects == NULL);
+        assert(state->usable_arenas == NULL);
+        assert(state->unused_arena_objects == NULL);
 
         /* Put the new arenas on the unused_arena_objects list. */
-        for (i = maxarenas; i < numarenas; ++i) {
-            arenas[i].address = 0;              /* mark as unassociated */
-            arenas[i].nextarena = i < numarenas - 1 ?
-                                   &arenas[i+1] : NULL;
+        for (i = state->maxarenas; i < numarenas; ++i) {
+            state->arenas[i].address = 0;       /* mark as unassociated */
+            state->arenas[i].nextarena = i < numarenas - 1 ?
+                                         &state->arenas[i+1] : NULL;
         }
 
-        /* Update globals. */
-        unused_arena_objects = &arenas[maxarenas];
-        maxarenas = numarenas;
+        /* Update the state. */
+        state->unused_arena_objects = &state->arenas[state->maxarenas];
+        state->maxarenas = numarenas;
     }
 
     /* Take the next available arena object off the head of the list. */
-    assert(unused_arena_objects != NULL);
-    arenaobj = unused_arena_objects;
-    unused_arena_objects = arenaobj->nextarena;
+    assert(state->unused_arena_objects != NULL);
+    arenaobj = state->unused_arena_objects;
+    state->unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
     address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
 #if WITH_PYMALLOC_RADIX_TREE
@@ -1653,16 +2126,16 @@ new_arena(void)
         /* The allocation failed: return NULL after putting the
          * arenaobj back.
          */
-        arenaobj->nextarena = unused_arena_objects;
-        unused_arena_objects = arenaobj;
+        arenaobj->nextarena = state->unused_arena_objects;
+        state->unused_arena_objects = arenaobj;
         return NULL;
     }
     arenaobj->address = (uintptr_t)address;
 
-    ++narenas_currently_allocated;
-    ++ntimes_arena_allocated;
-    if (narenas_currently_allocated > narenas_highwater)
-        narenas_highwater = narenas_currently_allocated;
+    ++state->narenas_currently_allocated;
+    ++state->ntimes_arena_allocated;
+    if (state->narenas_currently_allocated > state->narenas_highwater)
+        state->narenas_highwater = state->narenas_currently_allocated;
     arenaobj->freepools = NULL;
     /* pool_address <- first pool-aligned address in the arena
        nfreepools <- number of whole pools that fit after alignment */
@@ -1685,7 +2158,8 @@ new_arena(void)
    pymalloc.  When the radix tree is used, 'poolp' is unused.
  */
 static bool
-address_in_range(void *p, poolp Py_UNUSED(pool))
+address_in_range(struct _obmalloc_state *Py_UNUSED(state), void *p,
+                 poolp Py_UNUSED(pool))
 {
     return arena_map_is_used(p);
 }
@@ -1768,7 +2242,7 @@ extremely desirable that it be this fast.
 static bool _Py_NO_SANITIZE_ADDRESS
             _Py_NO_SANITIZE_THREAD
             _Py_NO_SANITIZE_MEMORY
-address_in_range(void *p, poolp pool)
+address_in_range(struct _obmalloc_state *state, void *p, poolp pool)
 {
     // Since address_in_range may be reading from memory which was not allocated
     // by Python, it is important that pool->arenaindex is read only once, as
@@ -1776,9 +2250,9 @@ address_in_range(void *p, poolp pool)
     // the GIL. The following dance forces the compiler to read pool->arenaindex
     // only once.
     uint arenaindex = *((volatile uint *)&pool->arenaindex);
-    return arenaindex < maxarenas &&
-        (uintptr_t)p - arenas[arenaindex].address < ARENA_SIZE &&
-        arenas[arenaindex].address != 0;
+    return arenaindex < state->maxarenas &&
+        (uintptr_t)p - state->arenas[arenaindex].address < ARENA_SIZE &&
+        state->arenas[arenaindex].address != 0;
 }
 
 #endif /* !WITH_PYMALLOC_RADIX_TREE */
@@ -1810,60 +2284,63 @@ pymalloc_pool_extend(poolp pool, uint size)
  * This function takes new pool and allocate a block from it.
  */
 static void*
-allocate_from_new_pool(uint size)
+allocate_from_new_pool(struct _obmalloc_state *state, uint size)
 {
     /* There isn't a pool of the right size class immediately
      * available:  use a free pool.
      */
-    if (UNLIKELY(usable_arenas == NULL)) {
+    if (UNLIKELY(state->usable_arenas == NULL)) {
         /* No arena has a free pool:  allocate a new arena. */
 #ifdef WITH_MEMORY_LIMITS
-        if (narenas_currently_allocated >= MAX_ARENAS) {
+        if (state->narenas_currently_allocated >= MAX_ARENAS) {
             return NULL;
         }
 #endif
-        usable_arenas = new_arena();
-        if (usable_arenas == NULL) {
+        state->usable_arenas = new_arena(state);
+        if (state->usable_arenas == NULL) {
             return NULL;
         }
-        usable_arenas->nextarena = usable_arenas->prevarena = NULL;
-        assert(nfp2lasta[usable_arenas->nfreepools] == NULL);
-        nfp2lasta[usable_arenas->nfreepools] = usable_arenas;
+        struct arena_object *ao = state->usable_arenas;
+        ao->nextarena = ao->prevarena = NULL;
+        assert(state->nfp2lasta[ao->nfreepools] == NULL);
+        state->nfp2lasta[ao->nfreepools] = ao;
     }
-    assert(usable_arenas->address != 0);
+    assert(state->usable_arenas->address != 0);
 
     /* This arena already had the smallest nfreepools value, so decreasing
      * nfreepools doesn't change that, and we don't need to rearrange the
      * usable_arenas list.  However, if the arena becomes wholly allocated,
      * we need to remove its arena_object from usable_arenas.
      */
-    assert(usable_arenas->nfreepools > 0);
-    if (nfp2lasta[usable_arenas->nfreepools] == usable_arenas) {
+    assert(state->usable_arenas->nfreepools > 0);
+    if (state->nfp2lasta[state->usable_arenas->nfreepools] ==
+            state->usable_arenas) {
         /* It's the last of this size, so there won't be any. */
-        nfp2lasta[usable_arenas->nfreepools] = NULL;
+        state->nfp2lasta[state->usable_arenas->nfreepools] = NULL;
     }
     /* If any free pools will remain, it will be the new smallest. */
-    if (usable_arenas->nfreepools > 1) {
-        assert(nfp2lasta[usable_arenas->nfreepools - 1] == NULL);
-        nfp2lasta[usable_arenas->nfreepools - 1] = usable_arenas;
+    if (state->usable_arenas->nfreepools > 1) {
+        assert(state->nfp2lasta[state->usable_arenas->nfreepools - 1] == NULL);
+        state->nfp2lasta[state->usable_arenas->nfreepools - 1] =
+            state->usable_arenas;
     }
 
     /* Try to get a cached free pool. */
-    poolp pool = usable_arenas->freepools;
+    poolp pool = state->usable_arenas->freepools;
     if (LIKELY(pool != NULL)) {
         /* Unlink from cached pools. */
-        usable_arenas->freepools = pool->nextpool;
-        usable_arenas->nfreepools--;
-        if (UNLIKELY(usable_arenas->nfreepools == 0)) {
+        state->usable_arenas->freepools = pool->nextpool;
+        state->usable_arenas->nfreepools--;
+        if (UNLIKELY(state->usable_arenas->nfreepools == 0)) {
             /* Wholly allocated:  remove. */
-            assert(usable_arenas->freepools == NULL);
-            assert(usable_arenas->nextarena == NULL ||
-                   usable_arenas->nextarena->prevarena ==
-                   usable_arenas);
-            usable_arenas = usable_arenas->nextarena;
-            if (usable_arenas != NULL) {
-                usable_arenas->prevarena = NULL;
-                assert(usable_arenas->address != 0);
+            assert(state->usable_arenas->freepools == NULL);
+            assert(state->usable_arenas->nextarena == NULL ||
+                   state->usable_arenas->nextarena->prevarena ==
+                   state->usable_arenas);
+            state->usable_arenas = state->usable_arenas->nextarena;
+            if (state->usable_arenas != NULL) {
+                state->usable_arenas->prevarena = NULL;
+                assert(state->usable_arenas->address != 0);
             }
         }
         else {
@@ -1872,41 +2349,41 @@ allocate_from_new_pool(uint size)
              * off all the arena's pools for the first
              * time.
              */
-            assert(usable_arenas->freepools != NULL ||
-                   usable_arenas->pool_address <=
-                   (block*)usable_arenas->address +
+            assert(state->usable_arenas->freepools != NULL ||
+                   state->usable_arenas->pool_address <=
+                   (block*)state->usable_arenas->address +
                        ARENA_SIZE - POOL_SIZE);
         }
     }
     else {
         /* Carve off a new pool. */
-        assert(usable_arenas->nfreepools > 0);
-        assert(usable_arenas->freepools == NULL);
-        pool = (poolp)usable_arenas->pool_address;
-        assert((block*)pool <= (block*)usable_arenas->address +
+        assert(state->usable_arenas->nfreepools > 0);
+        assert(state->usable_arenas->freepools == NULL);
+        pool = (poolp)state->usable_arenas->pool_address;
+        assert((block*)pool <= (block*)state->usable_arenas->address +
                                  ARENA_SIZE - POOL_SIZE);
-        pool->arenaindex = (uint)(usable_arenas - arenas);
-        assert(&arenas[pool->arenaindex] == usable_arenas);
+        pool->arenaindex = (uint)(state->usable_arenas - state->arenas);
+        assert(&state->arenas[pool->arenaindex] == state->usable_arenas);
         pool->szidx = DUMMY_SIZE_IDX;
-        usable_arenas->pool_address += POOL_SIZE;
-        --usable_arenas->nfreepools;
+        state->usable_arenas->pool_address += POOL_SIZE;
+        --state->usable_arenas->nfreepools;
 
-        if (usable_arenas->nfreepools == 0) {
-            assert(usable_arenas->nextarena == NULL ||
-                   usable_arenas->nextarena->prevarena ==
-                   usable_arenas);
+        if (state->usable_arenas->nfreepools == 0) {
+            assert(state->usable_arenas->nextarena == NULL ||
+                   state->usable_arenas->nextarena->prevarena ==
+                   state->usable_arenas);
             /* Unlink the arena:  it is completely allocated. */
-            usable_arenas = usable_arenas->nextarena;
-            if (usable_arenas != NULL) {
-                usable_arenas->prevarena = NULL;
-                assert(usable_arenas->address != 0);
+            state->usable_arenas = state->usable_arenas->nextarena;
+            if (state->usable_arenas != NULL) {
+                state->usable_arenas->prevarena = NULL;
+                assert(state->usable_arenas->address != 0);
             }
         }
     }
 
     /* Frontlink to used pools. */
     block *bp;
-    poolp next = usedpools[size + size]; /* == prev */
+    poolp next = state->usedpools[size + size]; /* == prev */
     pool->nextpool = next;
     pool->prevpool = next;
     next->nextpool = pool;
@@ -1965,9 +2442,20 @@ pymalloc_alloc(void *Py_UNUSED(ctx), size_t nbytes)
     }
 
     uint size = (uint)(nbytes - 1) >> ALIGNMENT_SHIFT;
-    poolp pool = usedpools[size + size];
     block *bp;
 
+#if WITH_PYMALLOC_THREAD_CACHE
+    if (size < THREAD_CACHE_CLASSES) {
+        bp = thread_cache_pop(size);
+        if (bp != NULL) {
+            return (void *)bp;
+        }
+    }
+#endif
+
+    struct _obmalloc_state *state = get_current_state();
+    poolp pool = state->usedpools[size + size];
+
     if (LIKELY(pool != pool->nextpool)) {
         /*
          * There is a used pool for this size class.
@@ -1986,7 +2474,7 @@ pymalloc_alloc(void *Py_UNUSED(ctx), size_t nbytes)
         /* There isn't a pool of the right size class immediately
          * available:  use a free pool.
          */
-        bp = allocate_from_new_pool(size);
+        bp = allocate_from_new_pool(state, size);
     }
 
     return (void *)bp;
@@ -2030,12 +2518,12 @@ _PyObject_Calloc(void *ctx, size_t nelem, size_t elsize)
 
 
 static void
-insert_to_usedpool(poolp pool)
+insert_to_usedpool(struct _obmalloc_state *state, poolp pool)
 {
     assert(pool->ref.count > 0);            /* else the pool is empty */
 
     uint size = pool->szidx;
-    poolp next = usedpools[size + size];
+    poolp next = state->usedpools[size + size];
     poolp prev = next->prevpool;
 
     /* insert pool before next:   prev <-> pool <-> next */
@@ -2045,8 +2533,52 @@ insert_to_usedpool(poolp pool)
     prev->nextpool = pool;
 }
 
+static void release_state(struct _obmalloc_state *state);
+
+/* Return the arena of ao, in which all pools are free, to the system. */
+static void
+free_arena(struct _obmalloc_state *state, struct arena_object *ao)
+{
+    assert(ao->nfreepools == ao->ntotalpools);
+    /* First unlink ao from usable_arenas. */
+    assert(ao->prevarena == NULL ||
+           ao->prevarena->address != 0);
+    assert(ao->nextarena == NULL ||
+           ao->nextarena->address != 0);
+
+    /* Fix the pointer in the prevarena, or the usable_arenas pointer. */
+    if (ao->prevarena == NULL) {
+        state->usable_arenas = ao->nextarena;
+        assert(state->usable_arenas == NULL ||
+               state->usable_arenas->address != 0);
+    }
+    else {
+        assert(ao->prevarena->nextarena == ao);
+        ao->prevarena->nextarena = ao->nextarena;
+    }
+    /* Fix the pointer in the nextarena. */
+    if (ao->nextarena != NULL) {
+        assert(ao->nextarena->prevarena == ao);
+        ao->nextarena->prevarena = ao->prevarena;
+    }
+    /* Record that this arena_object slot is available to be reused. */
+    ao->nextarena = state->unused_arena_objects;
+    state->unused_arena_objects = ao;
+
+#if WITH_PYMALLOC_RADIX_TREE
+    /* mark arena region as not under control of obmalloc */
+    arena_map_mark_used(ao->address, 0);
+#endif
+
+    /* Free the entire arena. */
+    _PyObject_Arena.free(_PyObject_Arena.ctx,
+                         (void *)ao->address, ARENA_SIZE);
+    ao->address = 0;                        /* mark unassociated */
+    --state->narenas_currently_allocated;
+}
+
 static void
-insert_to_freepool(poolp pool)
+insert_to_freepool(struct _obmalloc_state *state, poolp pool)
 {
     poolp next = pool->nextpool;
     poolp prev = pool->prevpool;
@@ -2056,7 +2588,7 @@ insert_to_freepool(poolp pool)
     /* Link the pool to freepools.  This is a singly-linked
      * list, and pool->prevpool isn't used there.
      */
-    struct arena_object *ao = &arenas[pool->arenaindex];
+    struct arena_object *ao = &state->arenas[pool->arenaindex];
     pool->nextpool = ao->freepools;
     ao->freepools = pool;
     uint nf = ao->nfreepools;
@@ -2064,7 +2596,7 @@ insert_to_freepool(poolp pool)
      * nfp2lasta[nf] needs to change.  Caution:  if nf is 0, there
      * are no arenas in usable_arenas with that value.
      */
-    struct arena_object* lastnf = nfp2lasta[nf];
+    struct arena_object* lastnf = state->nfp2lasta[nf];
     assert((nf == 0 && lastnf == NULL) ||
            (nf > 0 &&
             lastnf != NULL &&
@@ -2073,7 +2605,7 @@ insert_to_freepool(poolp pool)
              nf < lastnf->nextarena->nfreepools)));
     if (lastnf == ao) {  /* it is the rightmost */
         struct arena_object* p = ao->prevarena;
-        nfp2lasta[nf] = (p != NULL && p->nfreepools == nf) ? p : NULL;
+        state->nfp2lasta[nf] = (p != NULL && p->nfreepools == nf) ? p : NULL;
     }
     ao->nfreepools = ++nf;
 
@@ -2085,7 +2617,8 @@ insert_to_freepool(poolp pool)
      *    keeping one wholly free arena in the list avoids
      *    pathological cases where a simple loop would
      *    otherwise provoke needing to allocate and free an
-     *    arena on every iteration.  See bpo-37257.
+     *    arena on every iteration.  See bpo-37257.  Nothing
+     *    allocates from an orphaned state, so it keeps none.
      * 2. If this is the only free pool in the arena,
      *    add the arena back to the `usable_arenas` list.
      * 3. If the "next" arena has a smaller count of free
@@ -2094,50 +2627,13 @@ insert_to_freepool(poolp pool)
      *    nfreepools.
      * 4. Else there's nothing more to do.
      */
-    if (nf == ao->ntotalpools && ao->nextarena != NULL) {
-        /* Case 1.  First unlink ao from usable_arenas.
-         */
-        assert(ao->prevarena == NULL ||
-               ao->prevarena->address != 0);
-        assert(ao ->nextarena == NULL ||
-               ao->nextarena->address != 0);
-
-        /* Fix the pointer in the prevarena, or the
-         * usable_arenas pointer.
-         */
-        if (ao->prevarena == NULL) {
-            usable_arenas = ao->nextarena;
-            assert(usable_arenas == NULL ||
-                   usable_arenas->address != 0);
-        }
-        else {
-            assert(ao->prevarena->nextarena == ao);
-            ao->prevarena->nextarena =
-                ao->nextarena;
-        }
-        /* Fix the pointer in the nextarena. */
-        if (ao->nextarena != NULL) {
-            assert(ao->nextarena->prevarena == ao);
-            ao->nextarena->prevarena =
-                ao->prevarena;
+    if (nf == ao->ntotalpools &&
+        (ao->nextarena != NULL || state->orphaned)) {
+        /* Case 1. */
+        free_arena(state, ao);
+        if (state->orphaned && state->narenas_currently_allocated == 0) {
+            release_state(state);
         }
-        /* Record that this arena_object slot is
-         * available to be reused.
-         */
-        ao->nextarena = unused_arena_objects;
-        unused_arena_objects = ao;
-
-#if WITH_PYMALLOC_RADIX_TREE
-        /* mark arena region as not under control of obmalloc */
-        arena_map_mark_used(ao->address, 0);
-#endif
-
-        /* Free the entire arena. */
-        _PyObject_Arena.free(_PyObject_Arena.ctx,
-                             (void *)ao->address, ARENA_SIZE);
-        ao->address = 0;                        /* mark unassociated */
-        --narenas_currently_allocated;
-
         return;
     }
 
@@ -2147,14 +2643,14 @@ insert_to_freepool(poolp pool)
          * ao->nfreepools was 0 before, ao isn't
          * currently on the usable_arenas list.
          */
-        ao->nextarena = usable_arenas;
+        ao->nextarena = state->usable_arenas;
         ao->prevarena = NULL;
-        if (usable_arenas)
-            usable_arenas->prevarena = ao;
-        usable_arenas = ao;
-        assert(usable_arenas->address != 0);
-        if (nfp2lasta[1] == NULL) {
-            nfp2lasta[1] = ao;
+        if (state->usable_arenas)
+            state->usable_arenas->prevarena = ao;
+        state->usable_arenas = ao;
+        assert(state->usable_arenas->address != 0);
+        if (state->nfp2lasta[1] == NULL) {
+            state->nfp2lasta[1] = ao;
         }
 
         return;
@@ -2168,8 +2664,8 @@ insert_to_freepool(poolp pool)
      * approach allowed a lot more memory to be freed.
      */
     /* If this is the only arena with nf, record that. */
-    if (nfp2lasta[nf] == NULL) {
-        nfp2lasta[nf] = ao;
+    if (state->nfp2lasta[nf] == NULL) {
+        state->nfp2lasta[nf] = ao;
     } /* else the rightmost with nf doesn't change */
     /* If this was the rightmost of the old size, it remains in place. */
     if (ao == lastnf) {
@@ -2193,8 +2689,8 @@ insert_to_freepool(poolp pool)
     }
     else {
         /* ao is at the head of the list */
-        assert(usable_arenas == ao);
-        usable_arenas = ao->nextarena;
+        assert(state->usable_arenas == ao);
+        state->usable_arenas = ao->nextarena;
     }
     ao->nextarena->prevarena = ao->prevarena;
     /* And insert after lastnf. */
@@ -2208,30 +2704,14 @@ insert_to_freepool(poolp pool)
     assert(ao->nextarena == NULL || nf <= ao->nextarena->nfreepools);
     assert(ao->prevarena == NULL || nf > ao->prevarena->nfreepools);
     assert(ao->nextarena == NULL || ao->nextarena->prevarena == ao);
-    assert((usable_arenas == ao && ao->prevarena == NULL)
+    assert((state->usable_arenas == ao && ao->prevarena == NULL)
            || ao->prevarena->nextarena == ao);
 }
 
-/* Free a memory block allocated by pymalloc_alloc().
-   Return 1 if it was freed.
-   Return 0 if the block was not allocated by pymalloc_alloc(). */
-static inline int
-pymalloc_free(void *Py_UNUSED(ctx), void *p)
+/* Link block p back into pool, a pool of state. */
+static inline void
+pool_free_block(struct _obmalloc_state *state, poolp pool, void *p)
 {
-    assert(p != NULL);
-
-#ifdef WITH_VALGRIND
-    if (UNLIKELY(running_on_valgrind > 0)) {
-        return 0;
-    }
-#endif
-
-    poolp pool = POOL_ADDR(p);
-    if (UNLIKELY(!address_in_range(p, pool))) {
-        return 0;
-    }
-    /* We allocated this address. */
-
     /* Link p to the start of the pool's freeblock list.  Since
      * the pool had at least the p block outstanding, the pool
      * wasn't empty (so it's already in a usedpools[] list, or
@@ -2251,8 +2731,8 @@ pymalloc_free(void *Py_UNUSED(ctx), void *p)
          * targets optimal filling when several pools contain
          * blocks of the same size class.
          */
-        insert_to_usedpool(pool);
-        return 1;
+        insert_to_usedpool(state, pool);
+        return;
     }
 
     /* freeblock wasn't NULL, so the pool wasn't full,
@@ -2260,7 +2740,7 @@ pymalloc_free(void *Py_UNUSED(ctx), void *p)
      */
     if (LIKELY(pool->ref.count != 0)) {
         /* pool isn't empty:  leave it in usedpools */
-        return 1;
+        return;
     }
 
     /* Pool is now empty:  unlink from usedpools, and
@@ -2268,7 +2748,38 @@ pymalloc_free(void *Py_UNUSED(ctx), void *p)
      * previously freed pools will be allocated later
      * (being not referenced, they are perhaps paged out).
      */
-    insert_to_freepool(pool);
+    insert_to_freepool(state, pool);
+}
+
+/* Free a memory block allocated by pymalloc_alloc().
+   Return 1 if it was freed.
+   Return 0 if the block was not allocated by pymalloc_alloc(). */
+static inline int
+pymalloc_free(void *Py_UNUSED(ctx), void *p)
+{
+    assert(p != NULL);
+
+#ifdef WITH_VALGRIND
+    if (UNLIKELY(running_on_valgrind > 0)) {
+        return 0;
+    }
+#endif
+
+    struct _obmalloc_state *state = get_current_state();
+    poolp pool = POOL_ADDR(p);
+    if (UNLIKELY(!address_in_range(state, p, pool))) {
+        return 0;
+    }
+    /* We allocated this address. */
+
+#if WITH_PYMALLOC_THREAD_CACHE
+    if (pool->szidx < THREAD_CACHE_CLASSES &&
+        thread_cache_push(state, pool, p)) {
+        return 1;
+    }
+#endif
+
+    pool_free_block(get_pool_state(state, pool), pool, p);
     return 1;
 }
 
@@ -2315,7 +2826,7 @@ pymalloc_realloc(void *ctx, void **newptr_p, void *p, size_t nbytes)
 #endif
 
     pool = POOL_ADDR(p);
-    if (!address_in_range(p, pool)) {
+    if (!address_in_range(get_current_state(), p, pool)) {
         /* pymalloc is not managing this block.
 
            If nbytes <= SMALL_REQUEST_THRESHOLD, it's tempting to try to take
@@ -2375,6 +2886,259 @@ _PyObject_Realloc(void *ctx, void *ptr, size_t nbytes)
     return PyMem_RawRealloc(ptr, nbytes);
 }
 
+
+void
+_PyObject_ClearThreadCache(PyThreadState *tstate)
+{
+#if WITH_PYMALLOC_THREAD_CACHE
+    struct _obmalloc_state *state = get_state(tstate);
+    for (uint i = 0; i < THREAD_CACHE_CLASSES; i++) {
+        block *bp;
+        while ((bp = tstate->obmalloc_cache.freeblock[i]) != NULL) {
+            tstate->obmalloc_cache.freeblock[i] = *(block **)bp;
+            state->ncached--;
+            pool_free_block(state, POOL_ADDR(bp), bp);
+        }
+        /* The thread state is going away: don't cache the blocks it frees
+         * until then. */
+        tstate->obmalloc_cache.count[i] = THREAD_CACHE_LIMIT;
+    }
+#endif
+}
+
+int
+_PyObject_InitState(PyInterpreterState *interp)
+{
+#if WITH_PYMALLOC_RADIX_TREE
+    struct _obmalloc_state *state = PyMem_RawCalloc(1, sizeof(*state));
+    if (state == NULL) {
+        return -1;
+    }
+    for (uint i = 0; i < Py_ARRAY_LENGTH(state->usedpools) / 2; i++) {
+        state->usedpools[2*i] = state->usedpools[2*i + 1] = PTA(state, i);
+    }
+    state->next = obmalloc_main_state.next;
+    obmalloc_main_state.next = state;
+    interp->obmalloc = state;
+#endif
+    return 0;
+}
+
+static void
+release_state(struct _obmalloc_state *state)
+{
+    assert(state != &obmalloc_main_state);
+    assert(state->narenas_currently_allocated == 0);
+    struct _obmalloc_state **p = &obmalloc_main_state.next;
+    while (*p != state) {
+        p = &(*p)->next;
+    }
+    *p = state->next;
+    PyMem_RawFree(state->arenas);
+    PyMem_RawFree(state);
+}
+
+void
+_PyObject_FiniState(PyInterpreterState *interp)
+{
+    struct _obmalloc_state *state = interp->obmalloc;
+    if (state == NULL || state == &obmalloc_main_state) {
+        return;
+    }
+    interp->obmalloc = NULL;
+    /* The threads of interp have cleared their caches. */
+    assert(state->ncached == 0);
+
+    /* Nothing allocates from the state any more: return the arenas with no
+     * blocks in use, and the state itself if that was all of them. */
+    state->orphaned = 1;
+    for (uint i = 0; i < state->maxarenas; i++) {
+        struct arena_object *ao = &state->arenas[i];
+        if (ao->address == 0 || ao->nfreepools != ao->ntotalpools) {
+            continue;
+        }
+        uint nf = ao->nfreepools;
+        if (state->nfp2lasta[nf] == ao) {
+            struct arena_object *p = ao->prevarena;
+            state->nfp2lasta[nf] = (p != NULL && p->nfreepools == nf) ? p
+                                                                      : NULL;
+        }
+        free_arena(state, ao);
+    }
+    if (state->narenas_currently_allocated == 0) {
+        release_state(state);
+    }
+}
+
+/*==========================================================================*/
+/* Trimming.
+
+A single block in use keeps its whole arena alive, so after a peak of
+allocations the memory of a process rarely shrinks back.  A trim pass helps
+with that in two ways:
+
+- The pools of each usedpools[] list are sorted so that blocks are taken
+  from the arenas with the fewest free pools first, and in an arena from the
+  fullest pools first.  usable_arenas already hands out new pools from the
+  fullest arenas (see nfp2lasta); this extends it to the pools that are
+  already in use, so that the sparse arenas drain and can be freed.
+
+- The free pools of the arenas still in use are returned to the system with
+  madvise(MADV_DONTNEED), except for the page holding the pool header which
+  links them in freepools.  Their szidx is reset to DUMMY_SIZE_IDX so that
+  allocate_from_new_pool() doesn't trust their free list any more; it also
+  marks them as already trimmed.
+
+Only the mmap()-based arena allocators are trimmed: nothing is known about
+the memory handed out by a custom arena allocator.
+*/
+
+#if defined(ARENAS_USE_MMAP) && defined(MADV_DONTNEED)
+#  define TRIM_WITH_MADVISE 1
+#endif
+
+/* Return 1 if blocks should rather be taken from pool a than from pool b */
+static inline int
+pool_precedes(struct _obmalloc_state *state, poolp a, poolp b)
+{
+    uint afree = state->arenas[a->arenaindex].nfreepools;
+    uint bfree = state->arenas[b->arenaindex].nfreepools;
+    if (afree != bfree) {
+        return afree < bfree;
+    }
+    return a->ref.count > b->ref.count;
+}
+
+/* Stable merge sort of the n pools linked by nextpool from head. */
+static poolp
+sort_pool_list(struct _obmalloc_state *state, poolp head, size_t n)
+{
+    if (n < 2) {
+        return head;
+    }
+    poolp tail = head;
+    for (size_t i = 1; i < n / 2; i++) {
+        tail = tail->nextpool;
+    }
+    poolp second = tail->nextpool;
+    tail->nextpool = NULL;
+    poolp a = sort_pool_list(state, head, n / 2);
+    poolp b = sort_pool_list(state, second, n - n / 2);
+
+    poolp merged = NULL;
+    poolp *link = &merged;
+    while (a != NULL && b != NULL) {
+        if (pool_precedes(state, b, a)) {
+            *link = b;
+            b = b->nextpool;
+        }
+        else {
+            *link = a;
+            a = a->nextpool;
+        }
+        link = &(*link)->nextpool;
+    }
+    *link = (a != NULL) ? a : b;
+    return merged;
+}
+
+static void
+sort_used_pools(struct _obmalloc_state *state)
+{
+    for (uint i = 0; i < NB_SMALL_SIZE_CLASSES; i++) {
+        poolp header = PTA(state, i);
+        size_t n = 0;
+        for (poolp pool = header->nextpool; pool != header;
+             pool = pool->nextpool)
+        {
+            n++;
+        }
+        if (n < 2) {
+            continue;
+        }
+        header->prevpool->nextpool = NULL;
+        poolp pool = sort_pool_list(state, header->nextpool, n);
+        poolp prev = header;
+        for (; pool != NULL; pool = pool->nextpool) {
+            prev->nextpool = pool;
+            pool->prevpool = prev;
+            prev = pool;
+        }
+        prev->nextpool = header;
+        header->prevpool = prev;
+    }
+}
+
+#ifdef TRIM_WITH_MADVISE
+static size_t
+trim_free_pools(struct _obmalloc_state *state)
+{
+    size_t nbytes = 0;
+#if POOL_SIZE > SYSTEM_PAGE_SIZE
+    for (uint i = 0; i < state->maxarenas; i++) {
+        struct arena_object *ao = &state->arenas[i];
+        if (ao->address == 0) {
+            continue;
+        }
+        for (poolp pool = ao->freepools; pool != NULL; pool = pool->nextpool) {
+            if (pool->szidx == DUMMY_SIZE_IDX) {
+                continue;
+            }
+            if (madvise((block *)pool + SYSTEM_PAGE_SIZE,
+                        POOL_SIZE - SYSTEM_PAGE_SIZE, MADV_DONTNEED) == 0)
+            {
+                pool->szidx = DUMMY_SIZE_IDX;
+                nbytes += POOL_SIZE - SYSTEM_PAGE_SIZE;
+            }
+        }
+    }
+#endif
+    return nbytes;
+}
+
+static size_t
+trim_huge_regions(void)
+{
+    size_t nbytes = 0;
+    for (struct huge_region *region = partial_huge_regions; region != NULL;
+         region = region->nextregion)
+    {
+        for (uint i = 0; i < ARENAS_PER_REGION; i++) {
+            uint32_t bit = (uint32_t)1 << i;
+            if ((region->used | region->trimmed) & bit) {
+                continue;
+            }
+            if (madvise((void *)(region->address + i * ARENA_SIZE),
+                        ARENA_SIZE, MADV_DONTNEED) == 0)
+            {
+                region->trimmed |= bit;
+                nbytes += ARENA_SIZE;
+            }
+        }
+    }
+    return nbytes;
+}
+#endif
+
+size_t
+_PyObject_TrimArenas(void)
+{
+    struct _obmalloc_state *state = get_current_state();
+    sort_used_pools(state);
+
+    size_t nbytes = 0;
+#ifdef TRIM_WITH_MADVISE
+    if (_PyObject_Arena.free == _PyObject_ArenaMunmap) {
+        nbytes += trim_free_pools(state);
+    }
+    else if (_PyObject_Arena.free == _PyObject_ArenaHugeFree) {
+        nbytes += trim_free_pools(state);
+        nbytes += trim_huge_regions();
+    }
+#endif
+    return nbytes;
+}
+
 #else   /* ! WITH_PYMALLOC */
 
 /*==========================================================================*/
@@ -2387,6 +3151,28 @@ _Py_GetAllocatedBlocks(void)
     return 0;
 }
 
+void
+_PyObject_ClearThreadCache(PyThreadState *Py_UNUSED(tstate))
+{
+}
+
+int
+_PyObject_InitState(PyInterpreterState *Py_UNUSED(interp))
+{
+    return 0;
+}
+
+void
+_PyObject_FiniState(PyInterpreterState *Py_UNUSED(interp))
+{
+}
+
+size_t
+_PyObject_TrimArenas(void)
+{
+    return 0;
+}
+
 #endif /* WITH_PYMALLOC */
 
 
@@ -2985,6 +3771,13 @@ _PyObject_DebugMallocStats(FILE *out)
     size_t quantization = 0;
     /* # of arenas actually allocated. */
     size_t narenas = 0;
+    /* # of arenas allocated and reclaimed, and highwater marks */
+    size_t ntimes_arena_allocated = 0;
+    size_t narenas_highwater = 0;
+    /* # of allocator states, orphaned states and blocks in thread caches */
+    size_t nstates = 0;
+    size_t norphaned = 0;
+    size_t ncached = 0;
     /* running total -- should equal narenas * ARENA_SIZE */
     size_t total;
     char buf[128];
@@ -2998,51 +3791,62 @@ _PyObject_DebugMallocStats(FILE *out)
     /* Because full pools aren't linked to from anything, it's easiest
      * to march over all the arenas.  If we're lucky, most of the memory
      * will be living in full pools -- would be a shame to miss them.
+     * The arenas of all the allocator states are added up.
      */
-    for (i = 0; i < maxarenas; ++i) {
-        uint j;
-        uintptr_t base = arenas[i].address;
+    for (struct _obmalloc_state *state = &obmalloc_main_state;
+         state != NULL; state = state->next)
+    {
+        size_t narenas_before = narenas;
+        for (i = 0; i < state->maxarenas; ++i) {
+            uint j;
+            uintptr_t base = state->arenas[i].address;
 
-        /* Skip arenas which are not allocated. */
-        if (arenas[i].address == (uintptr_t)NULL)
-            continue;
-        narenas += 1;
+            /* Skip arenas which are not allocated. */
+            if (state->arenas[i].address == (uintptr_t)NULL)
+                continue;
+            narenas += 1;
 
-        numfreepools += arenas[i].nfreepools;
+            numfreepools += state->arenas[i].nfreepools;
 
-        /* round up to pool alignment */
-        if (base & (uintptr_t)POOL_SIZE_MASK) {
-            arena_alignment += POOL_SIZE;
-            base &= ~(uintptr_t)POOL_SIZE_MASK;
-            base += POOL_SIZE;
-        }
+            /* round up to pool alignment */
+            if (base & (uintptr_t)POOL_SIZE_MASK) {
+                arena_alignment += POOL_SIZE;
+                base &= ~(uintptr_t)POOL_SIZE_MASK;
+                base += POOL_SIZE;
+            }
 
-        /* visit every pool in the arena */
-        assert(base <= (uintptr_t) arenas[i].pool_address);
-        for (j = 0; base < (uintptr_t) arenas[i].pool_address;
-             ++j, base += POOL_SIZE) {
-            poolp p = (poolp)base;
-            const uint sz = p->szidx;
-            uint freeblocks;
+            /* visit every pool in the arena */
+            assert(base <= (uintptr_t) state->arenas[i].pool_address);
+            for (j = 0; base < (uintptr_t) state->arenas[i].pool_address;
+                 ++j, base += POOL_SIZE) {
+                poolp p = (poolp)base;
+                const uint sz = p->szidx;
+                uint freeblocks;
 
-            if (p->ref.count == 0) {
-                /* currently unused */
+                if (p->ref.count == 0) {
+                    /* currently unused */
 #ifdef Py_DEBUG
-                assert(pool_is_in_list(p, arenas[i].freepools));
+                    assert(pool_is_in_list(p, state->arenas[i].freepools));
 #endif
-                continue;
-            }
-            ++numpools[sz];
-            numblocks[sz] += p->ref.count;
-            freeblocks = NUMBLOCKS(sz) - p->ref.count;
-            numfreeblocks[sz] += freeblocks;
+                    continue;
+                }
+                ++numpools[sz];
+                numblocks[sz] += p->ref.count;
+                freeblocks = NUMBLOCKS(sz) - p->ref.count;
+                numfreeblocks[sz] += freeblocks;
 #ifdef Py_DEBUG
-            if (freeblocks > 0)
-                assert(pool_is_in_list(p, usedpools[sz + sz]));
+                if (freeblocks > 0)
+                    assert(pool_is_in_list(p, state->usedpools[sz + sz]));
 #endif
+            }
         }
+        nstates++;
+        norphaned += state->orphaned;
+        ncached += state->ncached;
+        ntimes_arena_allocated += state->ntimes_arena_allocated;
+        narenas_highwater += state->narenas_highwater;
+        assert(narenas - narenas_before == state->narenas_currently_allocated);
     }
-    assert(narenas == narenas_currently_allocated);
 
     fputc('\n', out);
     fputs("class   size   num pools   blocks in use  avail blocks\n"
@@ -3097,6 +3901,22 @@ _PyObject_DebugMallocStats(FILE *out)
     (void)printone(out, "Total", total);
     assert(narenas * ARENA_SIZE == total);
 
+#ifdef ARENAS_USE_MMAP
+    if (ntimes_huge_region_allocated) {
+        fputc('\n', out);
+        (void)printone(out, "# huge pages allocated total",
+                       ntimes_huge_region_allocated);
+        (void)printone(out, "# huge pages allocated current", nhuge_regions);
+        (void)printone(out, "# huge pages with free arenas",
+                       count_partial_huge_regions());
+    }
+#endif
+
+    fputc('\n', out);
+    (void)printone(out, "# allocator states", nstates);
+    (void)printone(out, "# orphaned allocator states", norphaned);
+    (void)printone(out, "# blocks in thread caches", ncached);
+
 #if WITH_PYMALLOC_RADIX_TREE
     fputs("\narena map counts\n", out);
 #ifdef USE_INTERIOR_NODES
@@ -10,14 +10,34 @@
    The initial probe index is computed as hash mod the table size.
    Subsequent probe indices are computed as explained in Objects/dictobject.c.
 
+   Each slot of the table has a control byte, stored after the entries:
+   SETC_EMPTY for unused slots, SETC_DUMMY for dummy slots, and for active
+   slots a tag made of 7 bits of the hash with the high bit set.  A probe
+   compares the control bytes of SET_GROUP_SIZE consecutive slots at once
+   (with SSE2 or NEON when available) and only looks at the entries whose tag
+   matches, so most collisions never touch the entries.  Searches stop at the
+   first group containing an unused slot, and new keys go to the first unused
+   or dummy slot in probe order.
+
    To improve cache locality, each probe inspects a series of consecutive
    nearby entries before moving on to probes elsewhere in memory.  This leaves
    us with a hybrid of linear probing and randomized probing.  The linear probing
    reduces the cost of hash collisions because consecutive memory accesses
-   tend to be much cheaper than scattered probes.  After LINEAR_PROBES steps,
-   we then use more of the upper bits from the hash value and apply a simple
-   linear congruential random number generator.  This helps break-up long
-   chains of collisions.
+   tend to be much cheaper than scattered probes.  After each group, we then
+   use more of the upper bits from the hash value and apply a simple linear
+   congruential random number generator.  This helps break-up long chains of
+   collisions.  Groups may start at any slot: the control bytes of the first
+   SET_GROUP_SIZE - 1 slots are repeated after the last one, so that a group
+   wraps around the end of the table.  The smalltable has no control bytes:
+   it is probed one slot at a time, without linear probing.
+
+   Tables larger than the smalltable come in two kinds.  The slots of
+   SET_KEYS_GENERAL tables are setentry records.  SET_KEYS_COMPACT tables
+   only hold exact str and int keys, and their slots are bare key pointers:
+   the hash of these keys is cached in the object or cheap to compute, and
+   computing it has no side effects, so it is not stored.  A table is made
+   compact when it is resized and only holds such keys, and it is turned
+   back into a general one before any other key is inserted.
 
    All arithmetic on hash should ignore overflow.
 
@@ -34,6 +54,7 @@
 #include "Python.h"
 #include "pycore_object.h"        // _PyObject_GC_UNTRACK()
 #include <stddef.h>               // offsetof()
+#include "stringlib/simd.h"       // STRINGLIB_SSE2, stringlib_ctz32()
 
 /* Object used as dummy key to fill deleted entries */
 static PyObject _dummy_struct;
@@ -44,71 +65,333 @@ static PyObject _dummy_struct;
 /* ======================================================================== */
 /* ======= Begin logic for probing the hash table ========================= */
 
-/* Set this to zero to turn-off linear probing */
-#ifndef LINEAR_PROBES
-#define LINEAR_PROBES 9
-#endif
-
 /* This must be >= 1 */
 #define PERTURB_SHIFT 5
 
-static setentry *
+#define SETC_EMPTY 0x00
+#define SETC_DUMMY 0x01
+
+#define SET_GROUP_SIZE 16
+
+/* A group mask has SET_GROUP_STRIDE bits per slot, the lowest of which is
+   set for the slots of the group which match. */
+#ifdef STRINGLIB_NEON
+typedef uint64_t set_groupmask;
+#  define SET_GROUP_STRIDE 4
+#  define SET_GROUP_CTZ stringlib_ctz64
+#else
+typedef uint32_t set_groupmask;
+#  define SET_GROUP_STRIDE 1
+#  define SET_GROUP_CTZ stringlib_ctz32
+#endif
+
+#define SET_KEYS_GENERAL 0
+#define SET_KEYS_COMPACT 1
+
+/* A table larger than the smalltable is allocated as a single block:
+
+     control bytes | copy of the first group | kind | slots
+
+   The control bytes take mask + 1 bytes, followed by a copy of those of
+   the first SET_GROUP_SIZE - 1 slots and by the kind of the table.  The
+   table pointer points to the slots. */
+#define SET_TABLE_CTRL(table, mask) \
+    ((uint8_t *)(table) - ((mask) + 1) - SET_GROUP_SIZE)
+#define SET_TABLE_KIND(table) (((uint8_t *)(table))[-1])
+#define SET_CTRL(so) SET_TABLE_CTRL((so)->table, (so)->mask)
+
+/* Size in bytes of a table with size slots.  Only tables larger than the
+   smalltable have control bytes, and they can be compact. */
+static inline size_t
+set_table_bytes(size_t size, int compact)
+{
+    if (size <= PySet_MINSIZE)
+        return size * sizeof(setentry);
+    return size * ((compact ? sizeof(PyObject *) : sizeof(setentry)) + 1)
+           + SET_GROUP_SIZE;
+}
+
+static inline int
+set_table_compact(const setentry *table, size_t mask)
+{
+    return (mask >= SET_GROUP_SIZE - 1
+            && SET_TABLE_KIND(table) == SET_KEYS_COMPACT);
+}
+
+static void
+set_table_free(setentry *table, size_t mask)
+{
+    PyMem_Free(SET_TABLE_CTRL(table, mask));
+}
+
+/* Can key be stored in a compact table? */
+static inline int
+set_compact_key(PyObject *key)
+{
+    return PyUnicode_CheckExact(key) || PyLong_CheckExact(key);
+}
+
+/* Hash of a key of a compact table. */
+static inline Py_hash_t
+set_compact_hash(PyObject *key)
+{
+    assert(set_compact_key(key));
+    if (PyUnicode_CheckExact(key)) {
+        Py_hash_t hash = _PyASCIIObject_CAST(key)->hash;
+        if (hash != -1)
+            return hash;
+    }
+    return PyObject_Hash(key);
+}
+
+/* Key and hash of slot i of a table.  The hash is only valid for the slots
+   holding a key. */
+static inline PyObject *
+set_slot_key(const setentry *table, int compact, size_t i)
+{
+    if (compact)
+        return ((PyObject * const *)table)[i];
+    return table[i].key;
+}
+
+static inline Py_hash_t
+set_slot_hash(const setentry *table, int compact, size_t i)
+{
+    if (compact)
+        return set_compact_hash(((PyObject * const *)table)[i]);
+    return table[i].hash;
+}
+
+static inline void
+set_slot_store(setentry *table, int compact, size_t i,
+               PyObject *key, Py_hash_t hash)
+{
+    if (compact) {
+        assert(key == dummy || set_compact_hash(key) == hash);
+        ((PyObject **)table)[i] = key;
+    }
+    else {
+        table[i].key = key;
+        table[i].hash = hash;
+    }
+}
+
+static inline uint8_t
+set_hash_tag(Py_hash_t hash)
+{
+#if SIZEOF_SIZE_T > 4
+    return (uint8_t)(0x80 | (((size_t)hash * 0x9e3779b97f4a7c15) >> 57));
+#else
+    return (uint8_t)(0x80 | (((size_t)hash * 0x9e3779b9) >> 25));
+#endif
+}
+
+#ifdef STRINGLIB_NEON
+static inline set_groupmask
+set_neon_match(uint8x16_t eq)
+{
+    uint8x8_t bits = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return (vget_lane_u64(vreinterpret_u64_u8(bits), 0)
+            & 0x1111111111111111u);
+}
+#endif
+
+/* Mask of the slots of the group at ctrl whose control byte is c. */
+static inline set_groupmask
+set_ctrl_match(const uint8_t *ctrl, uint8_t c)
+{
+#if defined(STRINGLIB_SSE2)
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    __m128i eq = _mm_cmpeq_epi8(group, _mm_set1_epi8((char)c));
+    return (uint32_t)_mm_movemask_epi8(eq);
+#elif defined(STRINGLIB_NEON)
+    return set_neon_match(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(c)));
+#else
+    set_groupmask match = 0;
+    for (int i = 0; i < SET_GROUP_SIZE; i++) {
+        match |= (set_groupmask)(ctrl[i] == c) << i;
+    }
+    return match;
+#endif
+}
+
+/* Mask of the unused and dummy slots of the group at ctrl: the slots whose
+   control byte is not a tag. */
+static inline set_groupmask
+set_ctrl_match_free(const uint8_t *ctrl)
+{
+#if defined(STRINGLIB_SSE2)
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return (uint32_t)_mm_movemask_epi8(group) ^ 0xffff;
+#elif defined(STRINGLIB_NEON)
+    return set_neon_match(vcltq_u8(vld1q_u8(ctrl), vdupq_n_u8(0x80)));
+#else
+    set_groupmask match = 0;
+    for (int i = 0; i < SET_GROUP_SIZE; i++) {
+        match |= (set_groupmask)(ctrl[i] < 0x80) << i;
+    }
+    return match;
+#endif
+}
+
+/* The slots matched by set_small_match() */
+#define SET_MATCH_HASH  0           /* active slots with the given hash */
+#define SET_MATCH_EMPTY 1           /* unused slots */
+#define SET_MATCH_FREE  2           /* unused and dummy slots */
+
+/* Group mask of the smalltable, computed from its entries.  Its groups are
+   made of a single slot, as it is small enough for the perturbation to
+   reach every slot quickly, and its keys are too close together for
+   linear probing. */
+static inline set_groupmask
+set_small_match(const setentry *table, size_t i, int kind, Py_hash_t hash)
+{
+    const setentry *entry = &table[i];
+    if (kind == SET_MATCH_HASH)
+        return entry->hash == hash && entry->key != NULL;
+    if (kind == SET_MATCH_EMPTY)
+        return entry->key == NULL;
+    return entry->key == NULL || entry->key == dummy;
+}
+
+/* Mask of the slots of the group starting at slot i which may hold a key
+   with this hash and tag, in probe order: the lowest slot of the mask is
+   slot i. */
+static inline set_groupmask
+set_group_match(const setentry *table, size_t mask, size_t i,
+                uint8_t tag, Py_hash_t hash)
+{
+    if (mask < SET_GROUP_SIZE - 1)
+        return set_small_match(table, i, SET_MATCH_HASH, hash);
+    return set_ctrl_match(SET_TABLE_CTRL(table, mask) + i, tag);
+}
+
+/* Mask of the unused slots of the group starting at slot i, in probe
+   order. */
+static inline set_groupmask
+set_group_match_empty(const setentry *table, size_t mask, size_t i)
+{
+    if (mask < SET_GROUP_SIZE - 1)
+        return set_small_match(table, i, SET_MATCH_EMPTY, 0);
+    return set_ctrl_match(SET_TABLE_CTRL(table, mask) + i, SETC_EMPTY);
+}
+
+/* Mask of the unused and dummy slots of the group starting at slot i, in
+   probe order. */
+static inline set_groupmask
+set_group_match_free(const setentry *table, size_t mask, size_t i)
+{
+    if (mask < SET_GROUP_SIZE - 1)
+        return set_small_match(table, i, SET_MATCH_FREE, 0);
+    return set_ctrl_match_free(SET_TABLE_CTRL(table, mask) + i);
+}
+
+/* Offset in its group of the first slot of a non-empty group mask. */
+static inline size_t
+set_group_first(set_groupmask match)
+{
+    return (size_t)SET_GROUP_CTZ(match) / SET_GROUP_STRIDE;
+}
+
+static inline void
+set_prefetch(const void *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+/* Set the control byte of slot i, and its copy after the last slot.  The
+   second store writes to slot i again unless it has a copy.  The smalltable
+   has no control bytes. */
+static inline void
+set_ctrl_store(setentry *table, size_t mask, size_t i, uint8_t c)
+{
+    if (mask >= SET_GROUP_SIZE - 1) {
+        uint8_t *ctrl = SET_TABLE_CTRL(table, mask);
+        ctrl[i] = c;
+        ctrl[((i - (SET_GROUP_SIZE - 1)) & mask) + SET_GROUP_SIZE - 1] = c;
+    }
+}
+
+/* Return the slot of key, or the unused slot where the search stopped if
+   key is missing, or -1 if a comparison raised an exception. */
+static Py_ssize_t
 set_lookkey(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
-    setentry *table;
-    setentry *entry;
+    setentry *table = so->table;
+    PyObject *startkey;
     size_t perturb = hash;
     size_t mask = so->mask;
     size_t i = (size_t)hash & mask; /* Unsigned for defined overflow behavior */
-    int probes;
+    size_t j;
+    const uint8_t tag = set_hash_tag(hash);
+    const int compact = set_table_compact(table, mask);
+    set_groupmask match;
     int cmp;
 
+    /* The first slot probed is often unused or holds the key itself: check
+       it while the control bytes are loaded, they are another cache miss in
+       large tables. */
+    if (mask >= SET_GROUP_SIZE - 1)
+        set_prefetch(SET_TABLE_CTRL(table, mask) + i);
+    startkey = set_slot_key(table, compact, i);
+    if (startkey == NULL || startkey == key)
+        return i;
+
     while (1) {
-        entry = &so->table[i];
-        probes = (i + LINEAR_PROBES <= mask) ? LINEAR_PROBES: 0;
-        do {
-            if (entry->hash == 0 && entry->key == NULL)
-                return entry;
-            if (entry->hash == hash) {
-                PyObject *startkey = entry->key;
-                assert(startkey != dummy);
-                if (startkey == key)
-                    return entry;
-                if (PyUnicode_CheckExact(startkey)
-                    && PyUnicode_CheckExact(key)
-                    && _PyUnicode_EQ(startkey, key))
-                    return entry;
-                table = so->table;
-                Py_INCREF(startkey);
-                cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
-                Py_DECREF(startkey);
-                if (cmp < 0)
-                    return NULL;
-                if (table != so->table || entry->key != startkey)
-                    return set_lookkey(so, key, hash);
-                if (cmp > 0)
-                    return entry;
-                mask = so->mask;
-            }
-            entry++;
-        } while (probes--);
+        for (match = set_group_match(table, mask, i, tag, hash); match;
+             match &= match - 1) {
+            j = (i + set_group_first(match)) & mask;
+            startkey = set_slot_key(table, compact, j);
+            assert(startkey != NULL && startkey != dummy);
+            if (startkey == key)
+                return j;
+            if (set_slot_hash(table, compact, j) != hash)
+                continue;
+            if (PyUnicode_CheckExact(startkey)
+                && PyUnicode_CheckExact(key)
+                && _PyUnicode_EQ(startkey, key))
+                return j;
+            Py_INCREF(startkey);
+            cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+            Py_DECREF(startkey);
+            if (cmp < 0)
+                return -1;
+            if (table != so->table || mask != (size_t)so->mask
+                || set_slot_key(table, compact, j) != startkey)
+                return set_lookkey(so, key, hash);
+            if (cmp > 0)
+                return j;
+        }
+        match = set_group_match_empty(table, mask, i);
+        if (match)
+            return (i + set_group_first(match)) & mask;
         perturb >>= PERTURB_SHIFT;
         i = (i * 5 + 1 + perturb) & mask;
     }
 }
 
 static int set_table_resize(PySetObject *, Py_ssize_t);
+static int set_table_rebuild(PySetObject *, size_t, int);
+static void set_insert_clean(setentry *, size_t, PyObject *, Py_hash_t);
 
 static int
 set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
     setentry *table;
-    setentry *freeslot;
-    setentry *entry;
+    PyObject *startkey;
+    Py_ssize_t freeslot;
     size_t perturb;
     size_t mask;
     size_t i;                       /* Unsigned for defined overflow behavior */
-    int probes;
+    size_t j;
+    set_groupmask match;
+    set_groupmask empty;
+    const uint8_t tag = set_hash_tag(hash);
+    int compact;
     int cmp;
 
     /* Pre-increment is necessary to prevent arbitrary code in the rich
@@ -117,61 +400,93 @@ set_add_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 
   restart:
 
+    table = so->table;
     mask = so->mask;
+    compact = set_table_compact(table, mask);
     i = (size_t)hash & mask;
-    freeslot = NULL;
+    freeslot = -1;
     perturb = hash;
 
+    if (mask >= SET_GROUP_SIZE - 1)
+        set_prefetch(SET_TABLE_CTRL(table, mask) + i);
+    startkey = set_slot_key(table, compact, i);
+    if (startkey == NULL) {
+        j = i;
+        goto found_unused;
+    }
+    if (startkey == key)
+        goto found_active;
+
     while (1) {
-        entry = &so->table[i];
-        probes = (i + LINEAR_PROBES <= mask) ? LINEAR_PROBES: 0;
-        do {
-            if (entry->hash == 0 && entry->key == NULL)
-                goto found_unused_or_dummy;
-            if (entry->hash == hash) {
-                PyObject *startkey = entry->key;
-                assert(startkey != dummy);
-                if (startkey == key)
-                    goto found_active;
-                if (PyUnicode_CheckExact(startkey)
-                    && PyUnicode_CheckExact(key)
-                    && _PyUnicode_EQ(startkey, key))
-                    goto found_active;
-                table = so->table;
-                Py_INCREF(startkey);
-                cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
-                Py_DECREF(startkey);
-                if (cmp > 0)
-                    goto found_active;
-                if (cmp < 0)
-                    goto comparison_error;
-                if (table != so->table || entry->key != startkey)
-                    goto restart;
-                mask = so->mask;
-            }
-            else if (entry->hash == -1) {
-                assert (entry->key == dummy);
-                freeslot = entry;
-            }
-            entry++;
-        } while (probes--);
+        for (match = set_group_match(table, mask, i, tag, hash); match;
+             match &= match - 1) {
+            j = (i + set_group_first(match)) & mask;
+            startkey = set_slot_key(table, compact, j);
+            assert(startkey != NULL && startkey != dummy);
+            if (startkey == key)
+                goto found_active;
+            if (set_slot_hash(table, compact, j) != hash)
+                continue;
+            if (PyUnicode_CheckExact(startkey)
+                && PyUnicode_CheckExact(key)
+                && _PyUnicode_EQ(startkey, key))
+                goto found_active;
+            Py_INCREF(startkey);
+            cmp = PyObject_RichCompareBool(startkey, key, Py_EQ);
+            Py_DECREF(startkey);
+            if (cmp > 0)
+                goto found_active;
+            if (cmp < 0)
+                goto comparison_error;
+            if (table != so->table || mask != (size_t)so->mask
+                || set_slot_key(table, compact, j) != startkey)
+                goto restart;
+        }
+        /* The key goes to the first unused or dummy slot in probe order,
+           so that an unused first slot means that the key is missing. */
+        if (freeslot < 0) {
+            match = set_group_match_free(table, mask, i);
+            if (match)
+                freeslot = (i + set_group_first(match)) & mask;
+        }
+        empty = set_group_match_empty(table, mask, i);
+        if (empty)
+            goto found_unused_or_dummy;
         perturb >>= PERTURB_SHIFT;
         i = (i * 5 + 1 + perturb) & mask;
     }
 
   found_unused_or_dummy:
-    if (freeslot == NULL)
+    j = freeslot;
+    if (set_slot_key(table, compact, j) == NULL)
         goto found_unused;
+    assert(set_slot_key(table, compact, j) == dummy);
+    if (compact && !set_compact_key(key))
+        goto found_unused_compact;
     so->used++;
-    freeslot->key = key;
-    freeslot->hash = hash;
+    set_slot_store(table, compact, j, key, hash);
+    set_ctrl_store(table, mask, j, tag);
     return 0;
 
   found_unused:
+    if (compact && !set_compact_key(key))
+        goto found_unused_compact;
+    so->fill++;
+    so->used++;
+    set_slot_store(table, compact, j, key, hash);
+    set_ctrl_store(table, mask, j, tag);
+    if ((size_t)so->fill*5 < mask*3)
+        return 0;
+    return set_table_resize(so, so->used>50000 ? so->used*2 : so->used*4);
+
+  found_unused_compact:
+    /* The key is missing, but it can't be stored in the compact table:
+       turn it into a general table first. */
+    if (set_table_rebuild(so, mask + 1, 0) < 0)
+        goto comparison_error;
     so->fill++;
     so->used++;
-    entry->key = key;
-    entry->hash = hash;
+    set_insert_clean(so->table, so->mask, key, hash);
     if ((size_t)so->fill*5 < mask*3)
         return 0;
     return set_table_resize(so, so->used>50000 ? so->used*2 : so->used*4);
@@ -196,47 +511,52 @@ the setobject's fill and used fields.
 static void
 set_insert_clean(setentry *table, size_t mask, PyObject *key, Py_hash_t hash)
 {
-    setentry *entry;
     size_t perturb = hash;
     size_t i = (size_t)hash & mask;
-    size_t j;
+    const int compact = set_table_compact(table, mask);
+    set_groupmask empty;
 
-    while (1) {
-        entry = &table[i];
-        if (entry->key == NULL)
-            goto found_null;
-        if (i + LINEAR_PROBES <= mask) {
-            for (j = 0; j < LINEAR_PROBES; j++) {
-                entry++;
-                if (entry->key == NULL)
-                    goto found_null;
-            }
+    if (set_slot_key(table, compact, i) != NULL) {
+        while (!(empty = set_group_match_empty(table, mask, i))) {
+            perturb >>= PERTURB_SHIFT;
+            i = (i * 5 + 1 + perturb) & mask;
         }
-        perturb >>= PERTURB_SHIFT;
-        i = (i * 5 + 1 + perturb) & mask;
+        i = (i + set_group_first(empty)) & mask;
     }
-  found_null:
-    entry->key = key;
-    entry->hash = hash;
+    set_slot_store(table, compact, i, key, hash);
+    set_ctrl_store(table, mask, i, set_hash_tag(hash));
 }
 
 /* ======== End logic for probing the hash table ========================== */
 /* ======================================================================== */
 
+/* Can all the keys of so be stored in a compact table? */
+static int
+set_all_compact(PySetObject *so)
+{
+    setentry *table = so->table;
+    size_t mask = so->mask;
+    int compact = set_table_compact(table, mask);
+
+    if (compact)
+        return 1;
+    for (size_t i = 0; i <= mask; i++) {
+        PyObject *key = set_slot_key(table, compact, i);
+        if (key != NULL && key != dummy && !set_compact_key(key))
+            return 0;
+    }
+    return 1;
+}
+
 /*
 Restructure the table by allocating a new table and reinserting all
 keys again.  When entries have been deleted, the new table may
-actually be smaller than the old one.
+actually be smaller than the old one.  The new table is compact if all
+the keys allow it.
 */
-static int
-set_table_resize(PySetObject *so, Py_ssize_t minused)
+static size_t
+set_table_size(Py_ssize_t minused)
 {
-    setentry *oldtable, *newtable, *entry;
-    Py_ssize_t oldmask = so->mask;
-    size_t newmask;
-    int is_oldtable_malloced;
-    setentry small_copy[PySet_MINSIZE];
-
     assert(minused >= 0);
 
     /* Find the smallest table size > minused. */
@@ -245,10 +565,31 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
     while (newsize <= (size_t)minused) {
         newsize <<= 1; // The largest possible value is PY_SSIZE_T_MAX + 1.
     }
+    return newsize;
+}
+
+static int
+set_table_resize(PySetObject *so, Py_ssize_t minused)
+{
+    return set_table_rebuild(so, set_table_size(minused), set_all_compact(so));
+}
+
+/* Move the keys of so to a new table of newsize slots, compact or not.  The
+   smalltable is never compact. */
+static int
+set_table_rebuild(PySetObject *so, size_t newsize, int compact)
+{
+    setentry *oldtable, *newtable;
+    size_t oldmask = so->mask;
+    size_t newmask;
+    int oldcompact;
+    int is_oldtable_malloced;
+    setentry small_copy[PySet_MINSIZE];
 
     /* Get space for a new table. */
     oldtable = so->table;
     assert(oldtable != NULL);
+    oldcompact = set_table_compact(oldtable, oldmask);
     is_oldtable_malloced = oldtable != so->smalltable;
 
     if (newsize == PySet_MINSIZE) {
@@ -269,53 +610,58 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
             memcpy(small_copy, oldtable, sizeof(small_copy));
             oldtable = small_copy;
         }
+        memset(newtable, 0, sizeof(so->smalltable));
     }
     else {
-        newtable = PyMem_NEW(setentry, newsize);
-        if (newtable == NULL) {
+        uint8_t *block;
+        if (newsize > ((size_t)PY_SSIZE_T_MAX - SET_GROUP_SIZE)
+                      / (sizeof(setentry) + 1)) {
             PyErr_NoMemory();
             return -1;
         }
+        block = PyMem_Malloc(set_table_bytes(newsize, compact));
+        if (block == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        memset(block, 0, set_table_bytes(newsize, compact));
+        newtable = (setentry *)(block + newsize + SET_GROUP_SIZE);
+        SET_TABLE_KIND(newtable) = compact ? SET_KEYS_COMPACT
+                                           : SET_KEYS_GENERAL;
     }
 
     /* Make the set empty, using the new table. */
     assert(newtable != oldtable);
-    memset(newtable, 0, sizeof(setentry) * newsize);
     so->mask = newsize - 1;
     so->table = newtable;
+    so->fill = so->used;
 
     /* Copy the data over; this is refcount-neutral for active entries;
        dummy entries aren't copied over, of course */
     newmask = (size_t)so->mask;
-    if (so->fill == so->used) {
-        for (entry = oldtable; entry <= oldtable + oldmask; entry++) {
-            if (entry->key != NULL) {
-                set_insert_clean(newtable, newmask, entry->key, entry->hash);
-            }
-        }
-    } else {
-        so->fill = so->used;
-        for (entry = oldtable; entry <= oldtable + oldmask; entry++) {
-            if (entry->key != NULL && entry->key != dummy) {
-                set_insert_clean(newtable, newmask, entry->key, entry->hash);
-            }
+    for (size_t i = 0; i <= oldmask; i++) {
+        PyObject *key = set_slot_key(oldtable, oldcompact, i);
+        if (key != NULL && key != dummy) {
+            set_insert_clean(newtable, newmask, key,
+                             set_slot_hash(oldtable, oldcompact, i));
         }
     }
 
     if (is_oldtable_malloced)
-        PyMem_Free(oldtable);
+        set_table_free(oldtable, oldmask);
     return 0;
 }
 
 static int
 set_contains_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
-    setentry *entry;
+    Py_ssize_t i;
 
-    entry = set_lookkey(so, key, hash);
-    if (entry != NULL)
-        return entry->key != NULL;
-    return -1;
+    i = set_lookkey(so, key, hash);
+    if (i < 0)
+        return -1;
+    return set_slot_key(so->table, set_table_compact(so->table, so->mask),
+                        i) != NULL;
 }
 
 #define DISCARD_NOTFOUND 0
@@ -324,17 +670,19 @@ set_contains_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 static int
 set_discard_entry(PySetObject *so, PyObject *key, Py_hash_t hash)
 {
-    setentry *entry;
+    Py_ssize_t i;
+    int compact;
     PyObject *old_key;
 
-    entry = set_lookkey(so, key, hash);
-    if (entry == NULL)
+    i = set_lookkey(so, key, hash);
+    if (i < 0)
         return -1;
-    if (entry->key == NULL)
+    compact = set_table_compact(so->table, so->mask);
+    old_key = set_slot_key(so->table, compact, i);
+    if (old_key == NULL)
         return DISCARD_NOTFOUND;
-    old_key = entry->key;
-    entry->key = dummy;
-    entry->hash = -1;
+    set_slot_store(so->table, compact, i, dummy, -1);
+    set_ctrl_store(so->table, so->mask, i, SETC_DUMMY);
     so->used--;
     Py_DECREF(old_key);
     return DISCARD_FOUND;
@@ -396,8 +744,10 @@ set_empty_to_minsize(PySetObject *so)
 static int
 set_clear_internal(PySetObject *so)
 {
-    setentry *entry;
+    PyObject *key;
     setentry *table = so->table;
+    size_t mask = so->mask;
+    const int compact = set_table_compact(table, mask);
     Py_ssize_t fill = so->fill;
     Py_ssize_t used = so->used;
     int table_is_malloced = table != so->smalltable;
@@ -430,15 +780,16 @@ set_clear_internal(PySetObject *so)
      * assert that the refcount on table is 1 now, i.e. that this function
      * has unique access to it, so decref side-effects can't alter it.
      */
-    for (entry = table; used > 0; entry++) {
-        if (entry->key && entry->key != dummy) {
+    for (size_t i = 0; used > 0; i++) {
+        key = set_slot_key(table, compact, i);
+        if (key && key != dummy) {
             used--;
-            Py_DECREF(entry->key);
+            Py_DECREF(key);
         }
     }
 
     if (table_is_malloced)
-        PyMem_Free(table);
+        set_table_free(table, mask);
     return 0;
 }
 
@@ -446,43 +797,51 @@ set_clear_internal(PySetObject *so)
  * Iterate over a set table.  Use like so:
  *
  *     Py_ssize_t pos;
- *     setentry *entry;
+ *     PyObject *key;
+ *     Py_hash_t hash;
  *     pos = 0;   # important!  pos should not otherwise be changed by you
- *     while (set_next(yourset, &pos, &entry)) {
- *              Refer to borrowed reference in entry->key.
+ *     while (set_next(yourset, &pos, &key, &hash)) {
+ *              Refer to borrowed reference in key.
  *     }
  *
+ * hash may be NULL if the hashes are not needed.
+ *
  * CAUTION:  In general, it isn't safe to use set_next in a loop that
  * mutates the table.
  */
 static int
-set_next(PySetObject *so, Py_ssize_t *pos_ptr, setentry **entry_ptr)
+set_next(PySetObject *so, Py_ssize_t *pos_ptr, PyObject **key_ptr,
+         Py_hash_t *hash_ptr)
 {
     Py_ssize_t i;
     Py_ssize_t mask;
-    setentry *entry;
+    PyObject *key = NULL;
+    int compact;
 
     assert (PyAnySet_Check(so));
     i = *pos_ptr;
     assert(i >= 0);
     mask = so->mask;
-    entry = &so->table[i];
-    while (i <= mask && (entry->key == NULL || entry->key == dummy)) {
+    compact = set_table_compact(so->table, mask);
+    while (i <= mask && ((key = set_slot_key(so->table, compact, i)) == NULL
+                         || key == dummy)) {
         i++;
-        entry++;
     }
     *pos_ptr = i+1;
     if (i > mask)
         return 0;
-    assert(entry != NULL);
-    *entry_ptr = entry;
+    assert(key != NULL);
+    *key_ptr = key;
+    if (hash_ptr != NULL)
+        *hash_ptr = set_slot_hash(so->table, compact, i);
     return 1;
 }
 
 static void
 set_dealloc(PySetObject *so)
 {
-    setentry *entry;
+    PyObject *key;
+    const int compact = set_table_compact(so->table, so->mask);
     Py_ssize_t used = so->used;
 
     /* bpo-31095: UnTrack is needed before calling any callbacks */
@@ -491,14 +850,15 @@ set_dealloc(PySetObject *so)
     if (so->weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject *) so);
 
-    for (entry = so->table; used > 0; entry++) {
-        if (entry->key && entry->key != dummy) {
+    for (size_t i = 0; used > 0; i++) {
+        key = set_slot_key(so->table, compact, i);
+        if (key && key != dummy) {
                 used--;
-                Py_DECREF(entry->key);
+                Py_DECREF(key);
         }
     }
     if (so->table != so->smalltable)
-        PyMem_Free(so->table);
+        set_table_free(so->table, so->mask);
     Py_TYPE(so)->tp_free(so);
     Py_TRASHCAN_END
 }
@@ -560,8 +920,8 @@ set_merge(PySetObject *so, PyObject *otherset)
     PySetObject *other;
     PyObject *key;
     Py_ssize_t i;
-    setentry *so_entry;
-    setentry *other_entry;
+    int compact;
+    int other_compact;
 
     assert (PyAnySet_Check(so));
     assert (PyAnySet_Check(otherset));
@@ -570,28 +930,36 @@ set_merge(PySetObject *so, PyObject *otherset)
     if (other == so || other->used == 0)
         /* a.update(a) or a.update(set()); nothing to do */
         return 0;
+    other_compact = set_table_compact(other->table, other->mask);
     /* Do one big resize at the start, rather than
      * incrementally resizing as we insert new keys.  Expect
      * that there will be no (or few) overlapping keys.
      */
     if ((so->fill + other->used)*5 >= so->mask*3) {
-        if (set_table_resize(so, (so->used + other->used)*2) != 0)
+        if (set_table_rebuild(so, set_table_size((so->used + other->used)*2),
+                              set_all_compact(so) && set_all_compact(other)))
             return -1;
     }
-    so_entry = so->table;
-    other_entry = other->table;
+    compact = set_table_compact(so->table, so->mask);
+    if (so->fill == 0 && compact && !other_compact && !set_all_compact(other)) {
+        if (set_table_rebuild(so, so->mask + 1, 0) != 0)
+            return -1;
+        compact = 0;
+    }
 
-    /* If our table is empty, and both tables have the same size, and
-       there are no dummies to eliminate, then just copy the pointers. */
-    if (so->fill == 0 && so->mask == other->mask && other->fill == other->used) {
-        for (i = 0; i <= other->mask; i++, so_entry++, other_entry++) {
-            key = other_entry->key;
-            if (key != NULL) {
-                assert(so_entry->key == NULL);
-                Py_INCREF(key);
-                so_entry->key = key;
-                so_entry->hash = other_entry->hash;
-            }
+    /* If our table is empty, and both tables have the same size and kind,
+       and there are no dummies to eliminate, then just copy the table. */
+    if (so->fill == 0 && so->mask == other->mask && other->fill == other->used
+        && compact == other_compact) {
+        for (i = 0; i <= other->mask; i++) {
+            Py_XINCREF(set_slot_key(other->table, compact, i));
+        }
+        if (so->table == so->smalltable) {
+            memcpy(so->table, other->table, sizeof(so->smalltable));
+        }
+        else {
+            memcpy(SET_CTRL(so), SET_CTRL(other),
+                   set_table_bytes(so->mask + 1, compact));
         }
         so->fill = other->fill;
         so->used = other->used;
@@ -604,11 +972,12 @@ set_merge(PySetObject *so, PyObject *otherset)
         size_t newmask = (size_t)so->mask;
         so->fill = other->used;
         so->used = other->used;
-        for (i = other->mask + 1; i > 0 ; i--, other_entry++) {
-            key = other_entry->key;
+        for (i = 0; i <= other->mask; i++) {
+            key = set_slot_key(other->table, other_compact, i);
             if (key != NULL && key != dummy) {
                 Py_INCREF(key);
-                set_insert_clean(newtable, newmask, key, other_entry->hash);
+                set_insert_clean(newtable, newmask, key,
+                                 set_slot_hash(other->table, other_compact, i));
             }
         }
         return 0;
@@ -616,10 +985,11 @@ set_merge(PySetObject *so, PyObject *otherset)
 
     /* We can't assure there are no duplicates, so do normal insertions */
     for (i = 0; i <= other->mask; i++) {
-        other_entry = &other->table[i];
-        key = other_entry->key;
+        other_compact = set_table_compact(other->table, other->mask);
+        key = set_slot_key(other->table, other_compact, i);
         if (key != NULL && key != dummy) {
-            if (set_add_entry(so, key, other_entry->hash))
+            if (set_add_entry(so, key,
+                              set_slot_hash(other->table, other_compact, i)))
                 return -1;
         }
     }
@@ -630,24 +1000,23 @@ static PyObject *
 set_pop(PySetObject *so, PyObject *Py_UNUSED(ignored))
 {
     /* Make sure the search finger is in bounds */
-    setentry *entry = so->table + (so->finger & so->mask);
-    setentry *limit = so->table + so->mask;
+    size_t mask = so->mask;
+    size_t i = so->finger & mask;
+    const int compact = set_table_compact(so->table, mask);
     PyObject *key;
 
     if (so->used == 0) {
         PyErr_SetString(PyExc_KeyError, "pop from an empty set");
         return NULL;
     }
-    while (entry->key == NULL || entry->key==dummy) {
-        entry++;
-        if (entry > limit)
-            entry = so->table;
+    while ((key = set_slot_key(so->table, compact, i)) == NULL
+           || key == dummy) {
+        i = (i + 1) & mask;
     }
-    key = entry->key;
-    entry->key = dummy;
-    entry->hash = -1;
+    set_slot_store(so->table, compact, i, dummy, -1);
+    set_ctrl_store(so->table, mask, i, SETC_DUMMY);
     so->used--;
-    so->finger = entry - so->table + 1;   /* next place to start */
+    so->finger = i + 1;   /* next place to start */
     return key;
 }
 
@@ -658,10 +1027,10 @@ static int
 set_traverse(PySetObject *so, visitproc visit, void *arg)
 {
     Py_ssize_t pos = 0;
-    setentry *entry;
+    PyObject *key;
 
-    while (set_next(so, &pos, &entry))
-        Py_VISIT(entry->key);
+    while (set_next(so, &pos, &key, NULL))
+        Py_VISIT(key);
     return 0;
 }
 
@@ -700,18 +1069,28 @@ frozenset_hash(PyObject *self)
        depends only on active entries.  This allows the code to be
        vectorized by the compiler and it saves the unpredictable
        branches that would arise when trying to exclude null and dummy
-       entries on every iteration. */
+       entries on every iteration.  Compact tables have no hash field:
+       the hashes of their active entries are computed. */
 
-    for (entry = so->table; entry <= &so->table[so->mask]; entry++)
-        hash ^= _shuffle_bits(entry->hash);
+    if (set_table_compact(so->table, so->mask)) {
+        Py_ssize_t pos = 0;
+        PyObject *key;
+        Py_hash_t keyhash;
+        while (set_next(so, &pos, &key, &keyhash))
+            hash ^= _shuffle_bits(keyhash);
+    }
+    else {
+        for (entry = so->table; entry <= &so->table[so->mask]; entry++)
+            hash ^= _shuffle_bits(entry->hash);
 
-    /* Remove the effect of an odd number of NULL entries */
-    if ((so->mask + 1 - so->fill) & 1)
-        hash ^= _shuffle_bits(0);
+        /* Remove the effect of an odd number of NULL entries */
+        if ((so->mask + 1 - so->fill) & 1)
+            hash ^= _shuffle_bits(0);
 
-    /* Remove the effect of an odd number of dummy entries */
-    if ((so->fill - so->used) & 1)
-        hash ^= _shuffle_bits(-1);
+        /* Remove the effect of an odd number of dummy entries */
+        if ((so->fill - so->used) & 1)
+            hash ^= _shuffle_bits(-1);
+    }
 
     /* Factor in the number of active entries */
     hash ^= ((Py_uhash_t)PySet_GET_SIZE(self) + 1) * 1927868237UL;
@@ -793,9 +1172,9 @@ static PyMethodDef setiter_methods[] = {
 
 static PyObject *setiter_iternext(setiterobject *si)
 {
-    PyObject *key;
+    PyObject *key = NULL;
     Py_ssize_t i, mask;
-    setentry *entry;
+    int compact;
     PySetObject *so = si->si_set;
 
     if (so == NULL)
@@ -811,15 +1190,15 @@ static PyObject *setiter_iternext(setiterobject *si)
 
     i = si->si_pos;
     assert(i>=0);
-    entry = so->table;
     mask = so->mask;
-    while (i <= mask && (entry[i].key == NULL || entry[i].key == dummy))
+    compact = set_table_compact(so->table, mask);
+    while (i <= mask && ((key = set_slot_key(so->table, compact, i)) == NULL
+                         || key == dummy))
         i++;
     si->si_pos = i+1;
     if (i > mask)
         goto fail;
     si->len--;
-    key = entry[i].key;
     Py_INCREF(key);
     return key;
 
@@ -1194,7 +1573,6 @@ set_intersection(PySetObject *so, PyObject *other)
 
     if (PyAnySet_Check(other)) {
         Py_ssize_t pos = 0;
-        setentry *entry;
 
         if (PySet_GET_SIZE(other) > PySet_GET_SIZE(so)) {
             tmp = (PyObject *)so;
@@ -1202,9 +1580,7 @@ set_intersection(PySetObject *so, PyObject *other)
             other = tmp;
         }
 
-        while (set_next((PySetObject *)other, &pos, &entry)) {
-            key = entry->key;
-            hash = entry->hash;
+        while (set_next((PySetObject *)other, &pos, &key, &hash)) {
             Py_INCREF(key);
             rv = set_contains_entry(so, key, hash);
             if (rv < 0) {
@@ -1355,17 +1731,16 @@ set_isdisjoint(PySetObject *so, PyObject *other)
 
     if (PyAnySet_CheckExact(other)) {
         Py_ssize_t pos = 0;
-        setentry *entry;
+        Py_hash_t hash;
 
         if (PySet_GET_SIZE(other) > PySet_GET_SIZE(so)) {
             tmp = (PyObject *)so;
             so = (PySetObject *)other;
             other = tmp;
         }
-        while (set_next((PySetObject *)other, &pos, &entry)) {
-            PyObject *key = entry->key;
+        while (set_next((PySetObject *)other, &pos, &key, &hash)) {
             Py_INCREF(key);
-            rv = set_contains_entry(so, key, entry->hash);
+            rv = set_contains_entry(so, key, hash);
             Py_DECREF(key);
             if (rv < 0) {
                 return NULL;
@@ -1409,7 +1784,8 @@ set_difference_update_internal(PySetObject *so, PyObject *other)
         return set_clear_internal(so);
 
     if (PyAnySet_Check(other)) {
-        setentry *entry;
+        PyObject *key;
+        Py_hash_t hash;
         Py_ssize_t pos = 0;
 
         /* Optimization:  When the other set is more than 8 times
@@ -1424,10 +1800,9 @@ set_difference_update_internal(PySetObject *so, PyObject *other)
             Py_INCREF(other);
         }
 
-        while (set_next((PySetObject *)other, &pos, &entry)) {
-            PyObject *key = entry->key;
+        while (set_next((PySetObject *)other, &pos, &key, &hash)) {
             Py_INCREF(key);
-            if (set_discard_entry(so, key, entry->hash) < 0) {
+            if (set_discard_entry(so, key, hash) < 0) {
                 Py_DECREF(other);
                 Py_DECREF(key);
                 return -1;
@@ -1496,7 +1871,6 @@ set_difference(PySetObject *so, PyObject *other)
     PyObject *result;
     PyObject *key;
     Py_hash_t hash;
-    setentry *entry;
     Py_ssize_t pos = 0, other_size;
     int rv;
 
@@ -1521,9 +1895,7 @@ set_difference(PySetObject *so, PyObject *other)
         return NULL;
 
     if (PyDict_CheckExact(other)) {
-        while (set_next(so, &pos, &entry)) {
-            key = entry->key;
-            hash = entry->hash;
+        while (set_next(so, &pos, &key, &hash)) {
             Py_INCREF(key);
             rv = _PyDict_Contains_KnownHash(other, key, hash);
             if (rv < 0) {
@@ -1544,9 +1916,7 @@ set_difference(PySetObject *so, PyObject *other)
     }
 
     /* Iterate over so, checking for common elements in other. */
-    while (set_next(so, &pos, &entry)) {
-        key = entry->key;
-        hash = entry->hash;
+    while (set_next(so, &pos, &key, &hash)) {
         Py_INCREF(key);
         rv = set_contains_entry((PySetObject *)other, key, hash);
         if (rv < 0) {
@@ -1620,7 +1990,6 @@ set_symmetric_difference_update(PySetObject *so, PyObject *other)
     PyObject *key;
     Py_ssize_t pos = 0;
     Py_hash_t hash;
-    setentry *entry;
     int rv;
 
     if ((PyObject *)so == other)
@@ -1655,9 +2024,7 @@ set_symmetric_difference_update(PySetObject *so, PyObject *other)
             return NULL;
     }
 
-    while (set_next(otherset, &pos, &entry)) {
-        key = entry->key;
-        hash = entry->hash;
+    while (set_next(otherset, &pos, &key, &hash)) {
         Py_INCREF(key);
         rv = set_discard_entry(so, key, hash);
         if (rv < 0) {
@@ -1730,7 +2097,8 @@ set_ixor(PySetObject *so, PyObject *other)
 static PyObject *
 set_issubset(PySetObject *so, PyObject *other)
 {
-    setentry *entry;
+    PyObject *key;
+    Py_hash_t hash;
     Py_ssize_t pos = 0;
     int rv;
 
@@ -1746,10 +2114,9 @@ set_issubset(PySetObject *so, PyObject *other)
     if (PySet_GET_SIZE(so) > PySet_GET_SIZE(other))
         Py_RETURN_FALSE;
 
-    while (set_next(so, &pos, &entry)) {
-        PyObject *key = entry->key;
+    while (set_next(so, &pos, &key, &hash)) {
         Py_INCREF(key);
-        rv = set_contains_entry((PySetObject *)other, key, entry->hash);
+        rv = set_contains_entry((PySetObject *)other, key, hash);
         Py_DECREF(key);
         if (rv < 0) {
             return NULL;
@@ -1973,7 +2340,8 @@ set_sizeof(PySetObject *so, PyObject *Py_UNUSED(ignored))
 
     res = _PyObject_SIZE(Py_TYPE(so));
     if (so->table != so->smalltable)
-        res = res + (so->mask + 1) * sizeof(setentry);
+        res = res + set_table_bytes(so->mask + 1,
+                                    set_table_compact(so->table, so->mask));
     return PyLong_FromSsize_t(res);
 }
 
@@ -2340,17 +2708,11 @@ PySet_Add(PyObject *anyset, PyObject *key)
 int
 _PySet_NextEntry(PyObject *set, Py_ssize_t *pos, PyObject **key, Py_hash_t *hash)
 {
-    setentry *entry;
-
     if (!PyAnySet_Check(set)) {
         PyErr_BadInternalCall();
         return -1;
     }
-    if (set_next((PySetObject *)set, pos, &entry) == 0)
-        return 0;
-    *key = entry->key;
-    *hash = entry->hash;
-    return 1;
+    return set_next((PySetObject *)set, pos, key, hash);
 }
 
 PyObject *
@@ -19,6 +19,452 @@
 /* 10xxxxxx */
 #define IS_CONTINUATION_BYTE(ch) ((ch) >= 0x80 && (ch) < 0xC0)
 
+#ifdef STRINGLIB_SIMD
+/* Copy the run of ASCII characters at the start of [start, end) to dest and
+   return its length.  The input is checked and widened 16 bytes at a time,
+   or 32 bytes at a time with AVX2. */
+
+#ifdef STRINGLIB_AVX2
+__attribute__((target("avx2")))
+static Py_ssize_t
+STRINGLIB(ascii_decode_avx2)(const char *start, const char *end,
+                             STRINGLIB_CHAR *dest)
+{
+    const char *p = start;
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)p);
+        if (_mm256_movemask_epi8(v)) {
+            break;
+        }
+#if STRINGLIB_SIZEOF_CHAR == 1
+        _mm256_storeu_si256((__m256i *)dest, v);
+#else
+        __m128i lo = _mm256_castsi256_si128(v);
+        __m128i hi = _mm256_extracti128_si256(v, 1);
+# if STRINGLIB_SIZEOF_CHAR == 2
+        _mm256_storeu_si256((__m256i *)dest, _mm256_cvtepu8_epi16(lo));
+        _mm256_storeu_si256((__m256i *)(dest + 16), _mm256_cvtepu8_epi16(hi));
+# else
+        _mm256_storeu_si256((__m256i *)dest, _mm256_cvtepu8_epi32(lo));
+        _mm256_storeu_si256((__m256i *)(dest + 8),
+                            _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+        _mm256_storeu_si256((__m256i *)(dest + 16), _mm256_cvtepu8_epi32(hi));
+        _mm256_storeu_si256((__m256i *)(dest + 24),
+                            _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+# endif
+#endif
+        p += 32;
+        dest += 32;
+    }
+    return p - start;
+}
+#endif
+
+static Py_ssize_t
+STRINGLIB(ascii_decode)(const char *start, const char *end,
+                        STRINGLIB_CHAR *dest)
+{
+    const char *p = start;
+
+#ifdef STRINGLIB_SSE2
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        if (_mm_movemask_epi8(v)) {
+            break;
+        }
+# if STRINGLIB_SIZEOF_CHAR == 1
+        _mm_storeu_si128((__m128i *)dest, v);
+# else
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+#  if STRINGLIB_SIZEOF_CHAR == 2
+        _mm_storeu_si128((__m128i *)dest, lo);
+        _mm_storeu_si128((__m128i *)(dest + 8), hi);
+#  else
+        _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *)(dest + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i *)(dest + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i *)(dest + 12), _mm_unpackhi_epi16(hi, zero));
+#  endif
+# endif
+        p += 16;
+        dest += 16;
+# ifdef STRINGLIB_AVX2
+        /* Short runs between non-ASCII characters are not worth the
+           dispatch: switch to AVX2 after the first block. */
+        if (p - start == 16 && end - p >= 32
+            && STRINGLIB_HAVE_AVX2())
+        {
+            Py_ssize_t n = STRINGLIB(ascii_decode_avx2)(p, end, dest);
+            p += n;
+            dest += n;
+        }
+# endif
+    }
+#else
+    while (end - p >= 16) {
+        uint8x16_t v = vld1q_u8((const uint8_t *)p);
+        if (vmaxvq_u8(v) & 0x80) {
+            break;
+        }
+# if STRINGLIB_SIZEOF_CHAR == 1
+        vst1q_u8(dest, v);
+# else
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_high_u8(v);
+#  if STRINGLIB_SIZEOF_CHAR == 2
+        vst1q_u16(dest, lo);
+        vst1q_u16(dest + 8, hi);
+#  else
+        vst1q_u32(dest, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(dest + 4, vmovl_high_u16(lo));
+        vst1q_u32(dest + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(dest + 12, vmovl_high_u16(hi));
+#  endif
+# endif
+        p += 16;
+        dest += 16;
+    }
+#endif
+    while (p < end && !((unsigned char)*p & 0x80)) {
+        *dest++ = (unsigned char)*p++;
+    }
+    return p - start;
+}
+#endif  /* STRINGLIB_SIMD */
+
+/* Validation and transcoding of multi-byte UTF-8 sequences, 16 bytes at a
+   time.  This needs a byte shuffle, which SSE2 lacks: on x86 it is compiled
+   for AVX2 and only runs when STRINGLIB_HAVE_AVX2() is true.  It is not
+   used for UCS1 strings: the text decoded as Latin-1 is mostly ASCII with
+   a few accented letters, for which the check for a run would only be an
+   overhead. */
+#if STRINGLIB_MAX_CHAR > 0xFF && PY_LITTLE_ENDIAN \
+    && (defined(STRINGLIB_AVX2) || defined(STRINGLIB_NEON))
+# define STRINGLIB_UTF8_SIMD
+# ifdef STRINGLIB_AVX2
+#  define UTF8_SIMD_TARGET __attribute__((target("avx2")))
+#  define UTF8_SIMD_AVAILABLE() STRINGLIB_HAVE_AVX2()
+# else
+#  define UTF8_SIMD_TARGET
+#  define UTF8_SIMD_AVAILABLE() 1
+# endif
+
+#ifndef STRINGLIB_UTF8_CHECK_BLOCK
+#define STRINGLIB_UTF8_CHECK_BLOCK
+
+/* The "lookup" algorithm of John Keiser and Daniel Lemire, "Validating
+   UTF-8 In Less Than One Instruction Per Byte" (2021).  Every byte is
+   classified together with the byte before it with three 16-entry tables,
+   indexed by the high nibble of the previous byte, its low nibble and the
+   high nibble of the byte itself.  Each bit is one kind of error; a pair
+   of bytes is invalid if the three entries share a bit.  The TWO_CONTS bit
+   marks a continuation byte following another one, which is only valid
+   for the third and fourth bytes of a sequence. */
+#define UTF8_TOO_SHORT      (1 << 0)  /* lead byte not followed by a
+                                         continuation byte */
+#define UTF8_TOO_LONG       (1 << 1)  /* ASCII followed by a continuation
+                                         byte */
+#define UTF8_OVERLONG_3     (1 << 2)  /* \xE0\x80-\xE0\x9F */
+#define UTF8_TOO_LARGE      (1 << 3)  /* \xF4\x90- and \xF5- */
+#define UTF8_SURROGATE      (1 << 4)  /* \xED\xA0-\xED\xBF */
+#define UTF8_OVERLONG_2     (1 << 5)  /* \xC0 and \xC1 */
+#define UTF8_TOO_LARGE_1000 (1 << 6)  /* \xF5\x80- and above */
+#define UTF8_OVERLONG_4     (1 << 6)  /* \xF0\x80-\xF0\x8F */
+#define UTF8_TWO_CONTS      (1 << 7)
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#define UTF8_BYTE_1_HIGH \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, \
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2, \
+    UTF8_TOO_SHORT, \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE, \
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+#define UTF8_BYTE_1_LOW \
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, \
+    UTF8_CARRY | UTF8_OVERLONG_2, \
+    UTF8_CARRY, \
+    UTF8_CARRY, \
+    UTF8_CARRY | UTF8_TOO_LARGE, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000, \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+#define UTF8_BYTE_2_HIGH \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 \
+        | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 \
+        | UTF8_TOO_LARGE, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE \
+        | UTF8_TOO_LARGE, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE \
+        | UTF8_TOO_LARGE, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+/* Check the 16 bytes at p, read as if they followed an ASCII character.
+   Return 0 if they contain an invalid sequence, ignoring a sequence cut
+   short by the end of the block.  Otherwise return the mask of the
+   positions of the bytes which are not continuation bytes, that is where
+   the characters start, with bit 16 set. */
+UTF8_SIMD_TARGET
+static inline uint32_t
+utf8_check_block(const char *p)
+{
+#ifdef STRINGLIB_AVX2
+    const __m128i byte_1_high = _mm_setr_epi8(UTF8_BYTE_1_HIGH);
+    const __m128i byte_1_low = _mm_setr_epi8(UTF8_BYTE_1_LOW);
+    const __m128i byte_2_high = _mm_setr_epi8(UTF8_BYTE_2_HIGH);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i input = _mm_loadu_si128((const __m128i *)p);
+    __m128i prev1 = _mm_slli_si128(input, 1);
+    __m128i sc = _mm_and_si128(
+        _mm_and_si128(
+            _mm_shuffle_epi8(byte_1_high,
+                _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+            _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+        _mm_shuffle_epi8(byte_2_high,
+            _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+    /* The top bit is set for the third byte after a 3- or 4-byte lead byte
+       and the fourth byte after a 4-byte lead byte. */
+    __m128i must23 = _mm_or_si128(
+        _mm_subs_epu8(_mm_slli_si128(input, 2), _mm_set1_epi8(0xE0 - 0x80)),
+        _mm_subs_epu8(_mm_slli_si128(input, 3), _mm_set1_epi8(0xF0 - 0x80)));
+    __m128i error = _mm_xor_si128(
+        _mm_and_si128(must23, _mm_set1_epi8((char)0x80)), sc);
+    if (!_mm_testz_si128(error, error)) {
+        return 0;
+    }
+    /* Continuation bytes are -128 to -65 as signed bytes. */
+    __m128i cont = _mm_cmplt_epi8(input, _mm_set1_epi8(-64));
+    return (uint32_t)(_mm_movemask_epi8(cont) ^ 0x1FFFF);
+#else
+    static const uint8_t tables[3][16] = {
+        {UTF8_BYTE_1_HIGH}, {UTF8_BYTE_1_LOW}, {UTF8_BYTE_2_HIGH}};
+    static const uint8_t bits[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t zero = vdupq_n_u8(0);
+    uint8x16_t input = vld1q_u8((const uint8_t *)p);
+    uint8x16_t prev1 = vextq_u8(zero, input, 15);
+    uint8x16_t sc = vandq_u8(
+        vandq_u8(
+            vqtbl1q_u8(vld1q_u8(tables[0]), vshrq_n_u8(prev1, 4)),
+            vqtbl1q_u8(vld1q_u8(tables[1]),
+                       vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+        vqtbl1q_u8(vld1q_u8(tables[2]), vshrq_n_u8(input, 4)));
+    uint8x16_t must23 = vorrq_u8(
+        vcgeq_u8(vextq_u8(zero, input, 14), vdupq_n_u8(0xE0)),
+        vcgeq_u8(vextq_u8(zero, input, 13), vdupq_n_u8(0xF0)));
+    uint8x16_t error = veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), sc);
+    if (vmaxvq_u8(error)) {
+        return 0;
+    }
+    uint8x16_t lead = vandq_u8(vcgeq_s8(vreinterpretq_s8_u8(input),
+                                        vdupq_n_s8(-64)),
+                               vld1q_u8(bits));
+    return (uint32_t)vaddv_u8(vget_low_u8(lead))
+           | ((uint32_t)vaddv_u8(vget_high_u8(lead)) << 8) | 0x10000;
+#endif
+}
+
+#undef UTF8_TOO_SHORT
+#undef UTF8_TOO_LONG
+#undef UTF8_OVERLONG_3
+#undef UTF8_TOO_LARGE
+#undef UTF8_SURROGATE
+#undef UTF8_OVERLONG_2
+#undef UTF8_TOO_LARGE_1000
+#undef UTF8_OVERLONG_4
+#undef UTF8_TWO_CONTS
+#undef UTF8_CARRY
+#undef UTF8_BYTE_1_HIGH
+#undef UTF8_BYTE_1_LOW
+#undef UTF8_BYTE_2_HIGH
+#endif  /* !STRINGLIB_UTF8_CHECK_BLOCK */
+
+/* Decode the valid UTF-8 at the start of [start, end) to *destptr, 16 bytes
+   at a time, and return the number of bytes decoded.  Blocks made only of
+   2-, 3- or 4-byte sequences are widened with SIMD, the others are decoded
+   without further checks.  Stop before a block with an invalid sequence,
+   before a character out of range and before ASCII text, which
+   ascii_decode() copies faster. */
+UTF8_SIMD_TARGET
+static Py_ssize_t
+STRINGLIB(utf8_decode_simd)(const char *start, const char *end,
+                            STRINGLIB_CHAR **destptr)
+{
+    const unsigned char *p = (const unsigned char *)start;
+    STRINGLIB_CHAR *dest = *destptr;
+
+    while (end - (const char *)p >= 16) {
+        if (p[0] < 0x80 && p[1] < 0x80) {
+            break;
+        }
+        uint32_t leads = utf8_check_block((const char *)p);
+        if (leads == 0) {
+            break;
+        }
+        /* Leave a sequence cut by the end of the block to the next one. */
+        Py_ssize_t n = 16;
+        if (p[15] >= 0xC0) {
+            n = 15;
+        }
+        else if (p[14] >= 0xE0) {
+            n = 14;
+        }
+        else if (p[13] >= 0xF0) {
+            n = 13;
+        }
+
+        Py_ssize_t i = 0;
+        if (leads == 0x15555 && n == 16) {
+            /* 8 2-byte sequences: 110xxxxx 10yyyyyy in each 16-bit lane */
+#ifdef STRINGLIB_AVX2
+            __m128i v = _mm_loadu_si128((const __m128i *)p);
+            __m128i ch = _mm_or_si128(
+                _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x1F)), 6),
+                _mm_and_si128(_mm_srli_epi16(v, 8), _mm_set1_epi16(0x3F)));
+# if STRINGLIB_SIZEOF_CHAR == 2
+            _mm_storeu_si128((__m128i *)dest, ch);
+# else
+            __m128i zero = _mm_setzero_si128();
+            _mm_storeu_si128((__m128i *)dest, _mm_unpacklo_epi16(ch, zero));
+            _mm_storeu_si128((__m128i *)(dest + 4),
+                             _mm_unpackhi_epi16(ch, zero));
+# endif
+#else
+            uint16x8_t v = vreinterpretq_u16_u8(vld1q_u8(p));
+            uint16x8_t ch = vorrq_u16(
+                vshlq_n_u16(vandq_u16(v, vdupq_n_u16(0x1F)), 6),
+                vandq_u16(vshrq_n_u16(v, 8), vdupq_n_u16(0x3F)));
+# if STRINGLIB_SIZEOF_CHAR == 2
+            vst1q_u16(dest, ch);
+# else
+            vst1q_u32(dest, vmovl_u16(vget_low_u16(ch)));
+            vst1q_u32(dest + 4, vmovl_high_u16(ch));
+# endif
+#endif
+            i = 16;
+            dest += 8;
+        }
+        else if ((leads & 0x1FFF) == 0x1249 && !(leads & 0x6000)) {
+            /* 4 3-byte sequences, 1110xxxx 10yyyyyy 10zzzzzz, gathered
+               into 32-bit lanes as 10zzzzzz 10yyyyyy 1110xxxx 0 */
+#ifdef STRINGLIB_AVX2
+            __m128i x = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i *)p),
+                _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1,
+                              8, 7, 6, -1, 11, 10, 9, -1));
+            __m128i ch = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_and_si128(x, _mm_set1_epi32(0x3F)),
+                    _mm_and_si128(_mm_srli_epi32(x, 2),
+                                  _mm_set1_epi32(0x0FC0))),
+                _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi32(0xF000)));
+# if STRINGLIB_SIZEOF_CHAR == 2
+            _mm_storel_epi64((__m128i *)dest, _mm_packus_epi32(ch, ch));
+# else
+            _mm_storeu_si128((__m128i *)dest, ch);
+# endif
+#else
+            static const uint8_t gather[16] = {
+                2, 1, 0, 0xFF, 5, 4, 3, 0xFF, 8, 7, 6, 0xFF, 11, 10, 9, 0xFF};
+            uint32x4_t x = vreinterpretq_u32_u8(
+                vqtbl1q_u8(vld1q_u8(p), vld1q_u8(gather)));
+            uint32x4_t ch = vorrq_u32(
+                vorrq_u32(
+                    vandq_u32(x, vdupq_n_u32(0x3F)),
+                    vandq_u32(vshrq_n_u32(x, 2), vdupq_n_u32(0x0FC0))),
+                vandq_u32(vshrq_n_u32(x, 4), vdupq_n_u32(0xF000)));
+# if STRINGLIB_SIZEOF_CHAR == 2
+            vst1_u16(dest, vmovn_u32(ch));
+# else
+            vst1q_u32(dest, ch);
+# endif
+#endif
+            i = 12;
+            dest += 4;
+        }
+#if STRINGLIB_SIZEOF_CHAR == 4
+        else if (leads == 0x11111) {
+            /* 4 4-byte sequences: 11110www 10xxxxxx 10yyyyyy 10zzzzzz in
+               each 32-bit lane */
+#ifdef STRINGLIB_AVX2
+            __m128i x = _mm_loadu_si128((const __m128i *)p);
+            __m128i ch = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x07)), 18),
+                    _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x3F00)),
+                                   4)),
+                _mm_or_si128(
+                    _mm_srli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x3F0000)),
+                                   10),
+                    _mm_and_si128(_mm_srli_epi32(x, 24),
+                                  _mm_set1_epi32(0x3F))));
+            _mm_storeu_si128((__m128i *)dest, ch);
+#else
+            uint32x4_t x = vreinterpretq_u32_u8(vld1q_u8(p));
+            uint32x4_t ch = vorrq_u32(
+                vorrq_u32(
+                    vshlq_n_u32(vandq_u32(x, vdupq_n_u32(0x07)), 18),
+                    vshlq_n_u32(vandq_u32(x, vdupq_n_u32(0x3F00)), 4)),
+                vorrq_u32(
+                    vshrq_n_u32(vandq_u32(x, vdupq_n_u32(0x3F0000)), 10),
+                    vandq_u32(vshrq_n_u32(x, 24), vdupq_n_u32(0x3F))));
+            vst1q_u32(dest, ch);
+#endif
+            i = 16;
+            dest += 4;
+        }
+#endif
+
+        /* The block is valid: decode the rest without checks. */
+        while (i < n) {
+            Py_UCS4 ch = p[i];
+            Py_ssize_t len;
+            if (ch < 0x80) {
+                len = 1;
+            }
+            else if (ch < 0xE0) {
+                ch = ((ch & 0x1F) << 6) | (p[i + 1] & 0x3F);
+                len = 2;
+            }
+            else if (ch < 0xF0) {
+                ch = ((ch & 0x0F) << 12) | ((p[i + 1] & 0x3F) << 6)
+                     | (p[i + 2] & 0x3F);
+                len = 3;
+            }
+            else {
+                ch = ((ch & 0x07) << 18) | ((p[i + 1] & 0x3F) << 12)
+                     | ((p[i + 2] & 0x3F) << 6) | (p[i + 3] & 0x3F);
+                len = 4;
+            }
+            if (ch > STRINGLIB_MAX_CHAR) {
+                p += i;
+                goto done;
+            }
+            *dest++ = (STRINGLIB_CHAR)ch;
+            i += len;
+        }
+        p += n;
+    }
+done:
+    *destptr = dest;
+    return (const char *)p - start;
+}
+#endif  /* STRINGLIB_MAX_CHAR > 0xFF && ... */
+
 Py_LOCAL_INLINE(Py_UCS4)
 STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                        STRINGLIB_CHAR *dest,
@@ -32,6 +478,21 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
         ch = (unsigned char)*s;
 
         if (ch < 0x80) {
+#ifdef STRINGLIB_SIMD
+            /* Fast path for runs of ASCII characters, which make up the
+               overwhelming majority of common UTF-8 input.  Lone ASCII
+               characters, like spaces between CJK words, are copied
+               directly. */
+            if (end - s >= 2 && (unsigned char)s[1] < 0x80) {
+                Py_ssize_t n = STRINGLIB(ascii_decode)(s, end, p);
+                s += n;
+                p += n;
+                continue;
+            }
+            s++;
+            *p++ = ch;
+            continue;
+#else
             /* Fast path for runs of ASCII characters. Given that common UTF-8
                input will consist of an overwhelming majority of ASCII
                characters, we try to optimize for this case by checking
@@ -92,6 +553,7 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 *p++ = ch;
                 continue;
             }
+#endif
         }
 
         if (ch < 0xE0) {
@@ -121,7 +583,7 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 /* Out-of-range */
                 goto Return;
             *p++ = ch;
-            continue;
+            goto DecodeRun;
         }
 
         if (ch < 0xF0) {
@@ -171,7 +633,7 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 /* Out-of-range */
                 goto Return;
             *p++ = ch;
-            continue;
+            goto DecodeRun;
         }
 
         if (ch < 0xF5) {
@@ -228,9 +690,26 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
                 /* Out-of-range */
                 goto Return;
             *p++ = ch;
-            continue;
+            goto DecodeRun;
         }
         goto InvalidStart;
+
+    DecodeRun:
+#ifdef STRINGLIB_UTF8_SIMD
+        /* Decode the run of multi-byte sequences which may follow 16 bytes
+           at a time.  An isolated character, like an accented letter in
+           Latin text, only costs this check. */
+        if (end - s >= 16 && ((unsigned char)*s & 0x80)
+            && UTF8_SIMD_AVAILABLE())
+        {
+            /* Don't take the address of p, which would keep it out of a
+               register. */
+            STRINGLIB_CHAR *q = p;
+            s += STRINGLIB(utf8_decode_simd)(s, end, &q);
+            p = q;
+        }
+#endif
+        continue;
     }
     ch = 0;
 Return:
@@ -252,6 +731,11 @@ STRINGLIB(utf8_decode)(const char **inptr, const char *end,
 }
 
 #undef ASCII_CHAR_MASK
+#ifdef STRINGLIB_UTF8_SIMD
+# undef STRINGLIB_UTF8_SIMD
+# undef UTF8_SIMD_TARGET
+# undef UTF8_SIMD_AVAILABLE
+#endif
 
 
 /* UTF-8 encoder specialized for a Unicode kind to avoid the slow
@@ -2,6 +2,10 @@
 
 #define STRINGLIB_FASTSEARCH_H
 
+#ifndef STRINGLIB_SIMD_H
+#error must include "stringlib/simd.h" before including this module
+#endif
+
 /* fast search/count implementation, based on a mix between boyer-
    moore and horspool, with a few more bells and whistles on the top.
    for some more background, see:
@@ -728,6 +732,291 @@ STRINGLIB(default_rfind)(const STRINGLIB_CHAR* s, Py_ssize_t n,
 }
 
 
+static Py_ssize_t
+STRINGLIB(_scalar_find)(const STRINGLIB_CHAR* s, Py_ssize_t n,
+                        const STRINGLIB_CHAR* p, Py_ssize_t m,
+                        Py_ssize_t maxcount, int mode)
+{
+    if (n < 2500 || (m < 100 && n < 30000) || m < 6) {
+        return STRINGLIB(default_find)(s, n, p, m, maxcount, mode);
+    }
+    else if ((m >> 2) * 3 < (n >> 2)) {
+        /* 33% threshold, but don't overflow. */
+        /* For larger problems where the needle isn't a huge
+           percentage of the size of the haystack, the relatively
+           expensive O(m) startup cost of the two-way algorithm
+           will surely pay off. */
+        if (mode == FAST_SEARCH) {
+            return STRINGLIB(_two_way_find)(s, n, p, m);
+        }
+        else {
+            return STRINGLIB(_two_way_count)(s, n, p, m, maxcount);
+        }
+    }
+    else {
+        /* To ensure that we have good worst-case behavior,
+           here's an adaptive version of the algorithm, where if
+           we match O(m) characters without any matches of the
+           entire needle, then we predict that the startup cost of
+           the two-way algorithm will probably be worth it. */
+        return STRINGLIB(adaptive_find)(s, n, p, m, maxcount, mode);
+    }
+}
+
+
+#ifdef STRINGLIB_SIMD
+/* SIMD candidate filtering, from Wojciech Mula's "SIMD-friendly algorithms
+   for substring searching": compare a block of the haystack with the first
+   character of the needle, and the block m-1 characters further with its
+   last character.  Only the positions where both match are compared with
+   the whole needle.
+
+   SIMD_MASK() turns the result of the comparisons into an integer with
+   SIMD_STRIDE bits per position, of which only the lowest one is kept. */
+
+#define SIMD_LANES (16 / STRINGLIB_SIZEOF_CHAR)
+/* find_all_any() filters with SIMD up to this number of needles */
+#define SIMD_MAX_NEEDLES 8
+
+#ifdef STRINGLIB_SSE2
+# define SIMD_VEC __m128i
+# define SIMD_MASK_T uint32_t
+# define SIMD_STRIDE STRINGLIB_SIZEOF_CHAR
+# define SIMD_CTZ stringlib_ctz32
+# define SIMD_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+# define SIMD_AND _mm_and_si128
+# define SIMD_OR _mm_or_si128
+# define SIMD_ZERO() _mm_setzero_si128()
+# if STRINGLIB_SIZEOF_CHAR == 1
+#  define SIMD_SPLAT(ch) _mm_set1_epi8((char)(ch))
+#  define SIMD_CMPEQ _mm_cmpeq_epi8
+#  define SIMD_LANE_BITS 0xFFFFu
+# elif STRINGLIB_SIZEOF_CHAR == 2
+#  define SIMD_SPLAT(ch) _mm_set1_epi16((short)(ch))
+#  define SIMD_CMPEQ _mm_cmpeq_epi16
+#  define SIMD_LANE_BITS 0x5555u
+# else
+#  define SIMD_SPLAT(ch) _mm_set1_epi32((int)(ch))
+#  define SIMD_CMPEQ _mm_cmpeq_epi32
+#  define SIMD_LANE_BITS 0x1111u
+# endif
+# define SIMD_MASK(v) ((uint32_t)_mm_movemask_epi8(v) & SIMD_LANE_BITS)
+#else
+# define SIMD_MASK_T uint64_t
+# define SIMD_STRIDE (4 * STRINGLIB_SIZEOF_CHAR)
+# define SIMD_CTZ stringlib_ctz64
+# if STRINGLIB_SIZEOF_CHAR == 1
+#  define SIMD_VEC uint8x16_t
+#  define SIMD_LOAD(p) vld1q_u8((const uint8_t *)(p))
+#  define SIMD_SPLAT(ch) vdupq_n_u8((uint8_t)(ch))
+#  define SIMD_CMPEQ vceqq_u8
+#  define SIMD_AND vandq_u8
+#  define SIMD_OR vorrq_u8
+#  define SIMD_ZERO() vdupq_n_u8(0)
+#  define SIMD_TO_U16 vreinterpretq_u16_u8
+#  define SIMD_LANE_BITS 0x1111111111111111u
+# elif STRINGLIB_SIZEOF_CHAR == 2
+#  define SIMD_VEC uint16x8_t
+#  define SIMD_LOAD(p) vld1q_u16((const uint16_t *)(p))
+#  define SIMD_SPLAT(ch) vdupq_n_u16((uint16_t)(ch))
+#  define SIMD_CMPEQ vceqq_u16
+#  define SIMD_AND vandq_u16
+#  define SIMD_OR vorrq_u16
+#  define SIMD_ZERO() vdupq_n_u16(0)
+#  define SIMD_TO_U16(v) (v)
+#  define SIMD_LANE_BITS 0x0101010101010101u
+# else
+#  define SIMD_VEC uint32x4_t
+#  define SIMD_LOAD(p) vld1q_u32((const uint32_t *)(p))
+#  define SIMD_SPLAT(ch) vdupq_n_u32((uint32_t)(ch))
+#  define SIMD_CMPEQ vceqq_u32
+#  define SIMD_AND vandq_u32
+#  define SIMD_OR vorrq_u32
+#  define SIMD_ZERO() vdupq_n_u32(0)
+#  define SIMD_TO_U16 vreinterpretq_u16_u32
+#  define SIMD_LANE_BITS 0x0001000100010001u
+# endif
+# define SIMD_MASK(v) \
+    (vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(SIMD_TO_U16(v), 4)), 0) \
+     & SIMD_LANE_BITS)
+#endif
+
+static Py_ssize_t
+STRINGLIB(_simd_find)(const STRINGLIB_CHAR* s, Py_ssize_t n,
+                      const STRINGLIB_CHAR* p, Py_ssize_t m,
+                      Py_ssize_t maxcount, int mode)
+{
+    const Py_ssize_t mlast = m - 1;
+    const size_t middle = (size_t)(m - 2) * sizeof(STRINGLIB_CHAR);
+    const SIMD_VEC first = SIMD_SPLAT(p[0]);
+    const SIMD_VEC last = SIMD_SPLAT(p[mlast]);
+    Py_ssize_t i, count = 0, hits = 0, end = 0, res;
+
+    for (i = 0; i + SIMD_LANES + mlast <= n; i += SIMD_LANES) {
+        SIMD_VEC eq = SIMD_AND(SIMD_CMPEQ(SIMD_LOAD(s + i), first),
+                               SIMD_CMPEQ(SIMD_LOAD(s + i + mlast), last));
+        SIMD_MASK_T mask = SIMD_MASK(eq);
+        while (mask) {
+            Py_ssize_t j = i + SIMD_CTZ(mask) / SIMD_STRIDE;
+            mask &= mask - 1;
+            if (middle == 0 || memcmp(s + j + 1, p + 1, middle) == 0) {
+                /* got a match! */
+                if (mode != FAST_COUNT) {
+                    return j;
+                }
+                count++;
+                if (count == maxcount) {
+                    return maxcount;
+                }
+                end = j + m;
+                /* matches don't overlap: skip the candidates inside this
+                   one */
+                Py_ssize_t skip = j + m - i;
+                if (skip >= SIMD_LANES) {
+                    i = j + m - SIMD_LANES;
+                    break;
+                }
+                mask &= ~(SIMD_MASK_T)0 << (skip * SIMD_STRIDE);
+                continue;
+            }
+            /* Many false candidates: the haystack is made of the
+               characters of the needle.  Finish with the algorithms
+               which bound the number of comparisons. */
+            hits += m;
+            if (hits > i + 1024) {
+                /* Don't count again the matches already found in this
+                   block. */
+                i = Py_MAX(i, end);
+                res = STRINGLIB(_scalar_find)(s + i, n - i, p, m,
+                                              maxcount - count, mode);
+                goto done;
+            }
+        }
+    }
+    res = STRINGLIB(default_find)(s + i, n - i, p, m,
+                                  maxcount - count, mode);
+  done:
+    if (mode == FAST_COUNT) {
+        return res + count;
+    }
+    return res == -1 ? -1 : res + i;
+}
+#endif  /* STRINGLIB_SIMD */
+
+/* Find the non-overlapping occurrences in s of any of the k needles, which
+   must not be empty, from left to right.  If several needles match at the
+   same position, the first one wins.  The search starts at *start.  Store
+   at most size matches in the matches array as (position, index of the
+   needle) pairs and return their number; *start is set to the position
+   where the search must resume, which is n if it is complete. */
+static inline Py_ssize_t
+STRINGLIB(find_all_any)(const STRINGLIB_CHAR* s, Py_ssize_t n,
+                        Py_ssize_t *start,
+                        const STRINGLIB_CHAR *const *needles,
+                        const Py_ssize_t *lens, Py_ssize_t k,
+                        Py_ssize_t *matches, Py_ssize_t size)
+{
+    Py_ssize_t i = *start, j, found = 0;
+
+#ifdef STRINGLIB_SIMD
+    if (k <= SIMD_MAX_NEEDLES) {
+        SIMD_VEC firsts[SIMD_MAX_NEEDLES], lasts[SIMD_MAX_NEEDLES];
+        Py_ssize_t maxlen = 0;
+        for (j = 0; j < k; j++) {
+            assert(lens[j] > 0);
+            firsts[j] = SIMD_SPLAT(needles[j][0]);
+            lasts[j] = SIMD_SPLAT(needles[j][lens[j] - 1]);
+            maxlen = Py_MAX(maxlen, lens[j]);
+        }
+        while (i + SIMD_LANES + maxlen - 1 <= n) {
+            SIMD_VEC block = SIMD_LOAD(s + i);
+            SIMD_VEC eq = SIMD_ZERO();
+            for (j = 0; j < k; j++) {
+                eq = SIMD_OR(eq, SIMD_AND(
+                    SIMD_CMPEQ(block, firsts[j]),
+                    SIMD_CMPEQ(SIMD_LOAD(s + i + lens[j] - 1), lasts[j])));
+            }
+            SIMD_MASK_T mask = SIMD_MASK(eq);
+            Py_ssize_t next = i + SIMD_LANES;
+            while (mask) {
+                Py_ssize_t pos = i + SIMD_CTZ(mask) / SIMD_STRIDE;
+                mask &= mask - 1;
+                for (j = 0; j < k; j++) {
+                    const STRINGLIB_CHAR *p = needles[j];
+                    Py_ssize_t m = lens[j];
+                    if (s[pos] == p[0] && s[pos + m - 1] == p[m - 1]
+                        && (m <= 2 || memcmp(s + pos + 1, p + 1,
+                                             (m - 2) * sizeof(*p)) == 0)) {
+                        break;
+                    }
+                }
+                if (j == k) {
+                    continue;
+                }
+                if (found == size) {
+                    *start = pos;
+                    return found;
+                }
+                matches[2 * found] = pos;
+                matches[2 * found + 1] = j;
+                found++;
+                /* matches don't overlap: skip the candidates inside this
+                   one */
+                Py_ssize_t skip = pos + lens[j] - i;
+                if (skip >= SIMD_LANES) {
+                    next = pos + lens[j];
+                    break;
+                }
+                mask &= ~(SIMD_MASK_T)0 << (skip * SIMD_STRIDE);
+            }
+            i = next;
+        }
+    }
+#endif
+    while (i < n) {
+        for (j = 0; j < k; j++) {
+            if (lens[j] <= n - i && s[i] == needles[j][0]
+                && memcmp(s + i, needles[j],
+                          lens[j] * sizeof(STRINGLIB_CHAR)) == 0) {
+                break;
+            }
+        }
+        if (j == k) {
+            i++;
+            continue;
+        }
+        if (found == size) {
+            *start = i;
+            return found;
+        }
+        matches[2 * found] = i;
+        matches[2 * found + 1] = j;
+        found++;
+        i += lens[j];
+    }
+    *start = n;
+    return found;
+}
+
+#ifdef STRINGLIB_SIMD
+#undef SIMD_LANES
+#undef SIMD_MAX_NEEDLES
+#undef SIMD_VEC
+#undef SIMD_MASK_T
+#undef SIMD_STRIDE
+#undef SIMD_CTZ
+#undef SIMD_LOAD
+#undef SIMD_AND
+#undef SIMD_OR
+#undef SIMD_ZERO
+#undef SIMD_SPLAT
+#undef SIMD_CMPEQ
+#undef SIMD_TO_U16
+#undef SIMD_LANE_BITS
+#undef SIMD_MASK
+#endif  /* STRINGLIB_SIMD */
+
+
 static inline Py_ssize_t
 STRINGLIB(count_char)(const STRINGLIB_CHAR *s, Py_ssize_t n,
                       const STRINGLIB_CHAR p0, Py_ssize_t maxcount)
@@ -770,30 +1059,12 @@ FASTSEARCH(const STRINGLIB_CHAR* s, Py_ssize_t n,
     }
 
     if (mode != FAST_RSEARCH) {
-        if (n < 2500 || (m < 100 && n < 30000) || m < 6) {
-            return STRINGLIB(default_find)(s, n, p, m, maxcount, mode);
-        }
-        else if ((m >> 2) * 3 < (n >> 2)) {
-            /* 33% threshold, but don't overflow. */
-            /* For larger problems where the needle isn't a huge
-               percentage of the size of the haystack, the relatively
-               expensive O(m) startup cost of the two-way algorithm
-               will surely pay off. */
-            if (mode == FAST_SEARCH) {
-                return STRINGLIB(_two_way_find)(s, n, p, m);
-            }
-            else {
-                return STRINGLIB(_two_way_count)(s, n, p, m, maxcount);
-            }
-        }
-        else {
-            /* To ensure that we have good worst-case behavior,
-               here's an adaptive version of the algorithm, where if
-               we match O(m) characters without any matches of the
-               entire needle, then we predict that the startup cost of
-               the two-way algorithm will probably be worth it. */
-            return STRINGLIB(adaptive_find)(s, n, p, m, maxcount, mode);
+#ifdef STRINGLIB_SIMD
+        if (m <= 64) {
+            return STRINGLIB(_simd_find)(s, n, p, m, maxcount, mode);
         }
+#endif
+        return STRINGLIB(_scalar_find)(s, n, p, m, maxcount, mode);
     }
     else {
         /* FAST_RSEARCH */
@@ -0,0 +1,73 @@
+/* stringlib: SIMD instructions available to the string algorithms */
+
+#ifndef STRINGLIB_SIMD_H
+#define STRINGLIB_SIMD_H
+
+/* SSE2 and NEON are part of the x86-64 and AArch64 baselines.  SSE2 is
+   used unconditionally.  The NEON code has not been built and tested on
+   AArch64 yet: it is only used when STRINGLIB_USE_NEON is defined, and the
+   portable code is used otherwise.  With GCC and clang, code for AVX2 can
+   be compiled with the target attribute; it must only run when
+   STRINGLIB_HAVE_AVX2() is true. */
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define STRINGLIB_SSE2
+#  if defined(__GNUC__) && !defined(_MSC_VER) && defined(__has_attribute)
+#    if __has_attribute(target)
+#      include <immintrin.h>
+#      define STRINGLIB_AVX2
+#      define STRINGLIB_HAVE_AVX2() __builtin_cpu_supports("avx2")
+#    endif
+#  endif
+#elif (defined(__aarch64__) || defined(_M_ARM64)) \
+    && defined(STRINGLIB_USE_NEON)
+#  include <arm_neon.h>
+#  define STRINGLIB_NEON
+#endif
+
+#if defined(STRINGLIB_SSE2) || defined(STRINGLIB_NEON)
+#  define STRINGLIB_SIMD
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>             // _BitScanForward()
+#endif
+
+/* Index of the least significant bit set in x, which must not be 0. */
+static inline int
+stringlib_ctz32(uint32_t x)
+{
+    assert(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+#else
+    int index = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+#ifdef STRINGLIB_NEON
+static inline int
+stringlib_ctz64(uint64_t x)
+{
+    assert(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+#endif
+}
+#endif
+
+#endif  /* !STRINGLIB_SIMD_H */
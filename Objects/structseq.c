@@ -589,7 +589,8 @@ _PyStructSequence_FiniType(PyTypeObject *type)
     PyMem_Free(type->tp_members);
 
     _PyStaticType_Dealloc(type);
-    assert(Py_REFCNT(type) == 1);
+    // Immortal objects (see gc.freeze()) never release their references
+    assert(Py_REFCNT(type) >= 1);
     // Undo Py_INCREF(type) of _PyStructSequence_InitType().
     // Don't use Py_DECREF(): static type must not be deallocated
     Py_SET_REFCNT(type, 0);
@@ -307,6 +307,21 @@ type_cache_clear(struct type_cache *cache, PyObject *value)
 }
 
 
+static void
+mega_attr_cache_clear(struct mega_attr_cache *cache, PyObject *value)
+{
+    for (Py_ssize_t i = 0; i < (1 << MEGA_ATTR_CACHE_SIZE_EXP); i++) {
+        struct mega_attr_cache_entry *entry = &cache->hashtable[i];
+        entry->version = 0;
+        entry->kind = MEGA_ATTR_GENERIC;
+        entry->index = 0;
+        entry->keys_version = 0;
+        Py_XSETREF(entry->name, _Py_XNewRef(value));
+        entry->descr = NULL;
+    }
+}
+
+
 void
 _PyType_InitCache(PyInterpreterState *interp)
 {
@@ -321,6 +336,7 @@ _PyType_InitCache(PyInterpreterState *interp)
         entry->name = Py_NewRef(Py_None);
         entry->value = NULL;
     }
+    mega_attr_cache_clear(&interp->types.mega_attr_cache, Py_None);
 }
 
 
@@ -343,6 +359,7 @@ _PyType_ClearCache(PyInterpreterState *interp)
     // Set to None, rather than NULL, so _PyType_Lookup() can
     // use Py_SETREF() rather than using slower Py_XSETREF().
     type_cache_clear(cache, Py_None);
+    mega_attr_cache_clear(&interp->types.mega_attr_cache, Py_None);
 
     return next_version_tag - 1;
 }
@@ -361,6 +378,11 @@ _PyTypes_Fini(PyInterpreterState *interp)
 {
     struct type_cache *cache = &interp->types.type_cache;
     type_cache_clear(cache, NULL);
+    mega_attr_cache_clear(&interp->types.mega_attr_cache, NULL);
+    memset(&interp->types.attr_poly_caches, 0,
+           sizeof(interp->types.attr_poly_caches));
+    _PyType_ClearObjectCaches(interp);
+    interp->types.num_object_caches = 0;
 
     assert(interp->types.num_builtins_initialized == 0);
     // All the static builtin types should have been finalized already.
@@ -1258,6 +1280,213 @@ PyType_GenericAlloc(PyTypeObject *type, Py_ssize_t nitems)
     return obj;
 }
 
+/* Object caches.
+
+The instances of the types with the Py_TPFLAGS_OBJECT_CACHE flag are
+allocated by object_cache_alloc() and freed by object_cache_free(): the
+memory of freed instances is kept on a per-interpreter free list, like
+the free lists of floats or tuples, and reused by the next allocations.
+
+Subclasses inherit tp_alloc and tp_free but not the flag: their instances
+are allocated and freed like with PyType_GenericAlloc() and PyObject_Free()
+or PyObject_GC_Del().
+*/
+
+static struct _Py_object_cache *
+object_cache_find(PyInterpreterState *interp, PyTypeObject *type)
+{
+    struct types_state *state = &interp->types;
+    for (int i = 0; i < state->num_object_caches; i++) {
+        if (state->object_caches[i].type == type) {
+            return &state->object_caches[i];
+        }
+    }
+    return NULL;
+}
+
+/* Return NULL if the maximum number of caches is reached. */
+static struct _Py_object_cache *
+object_cache_get(PyInterpreterState *interp, PyTypeObject *type)
+{
+    struct _Py_object_cache *cache = object_cache_find(interp, type);
+    if (cache != NULL) {
+        return cache;
+    }
+    struct types_state *state = &interp->types;
+    if (state->num_object_caches == _Py_MAX_OBJECT_CACHES) {
+        return NULL;
+    }
+    cache = &state->object_caches[state->num_object_caches++];
+    cache->type = type;
+    cache->free_list = NULL;
+    cache->numfree = 0;
+    cache->maxfree = _Py_OBJECT_CACHE_DEFAULT_SIZE;
+    cache->hits = 0;
+    cache->misses = 0;
+    return cache;
+}
+
+static void
+object_cache_trim(struct _Py_object_cache *cache, Py_ssize_t size)
+{
+    while (cache->numfree > size) {
+        void *block = cache->free_list;
+        cache->free_list = *(void **)block;
+        cache->numfree--;
+        PyObject_Free(block);
+    }
+}
+
+static PyObject *
+object_cache_alloc(PyTypeObject *type, Py_ssize_t nitems)
+{
+    if (!_PyType_HasFeature(type, Py_TPFLAGS_OBJECT_CACHE)) {
+        return PyType_GenericAlloc(type, nitems);
+    }
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    struct _Py_object_cache *cache = object_cache_get(interp, type);
+    if (cache == NULL || cache->free_list == NULL) {
+        if (cache != NULL) {
+            cache->misses++;
+        }
+        return PyType_GenericAlloc(type, nitems);
+    }
+    char *alloc = cache->free_list;
+    cache->free_list = *(void **)alloc;
+    cache->numfree--;
+    cache->hits++;
+    OBJECT_STAT_INC(from_freelist);
+
+    const size_t presize = _PyType_PreHeaderSize(type);
+    PyObject *obj = (PyObject *)(alloc + presize);
+    if (presize) {
+        ((PyObject **)alloc)[0] = NULL;
+        ((PyObject **)alloc)[1] = NULL;
+        _PyObject_GC_Link(obj);
+    }
+    memset(obj, '\0', _PyObject_SIZE(type));
+    _PyObject_Init(obj, type);
+    if (_PyType_IS_GC(type)) {
+        _PyObject_GC_TRACK(obj);
+    }
+    return obj;
+}
+
+static void
+object_cache_free(void *self)
+{
+    PyObject *op = (PyObject *)self;
+    PyTypeObject *type = Py_TYPE(op);
+    struct _Py_object_cache *cache = NULL;
+    if (_PyType_HasFeature(type, Py_TPFLAGS_OBJECT_CACHE)) {
+        cache = object_cache_find(_PyInterpreterState_GET(), type);
+    }
+    if (cache == NULL || cache->numfree >= cache->maxfree) {
+        if (_PyType_IS_GC(type)) {
+            PyObject_GC_Del(op);
+        }
+        else {
+            PyObject_Free(op);
+        }
+        return;
+    }
+    if (_PyType_IS_GC(type)) {
+        if (_PyObject_GC_IS_TRACKED(op)) {
+            _PyObject_GC_UNTRACK(op);
+        }
+        // Like PyObject_GC_Del()
+        struct _gc_runtime_state *gcstate = &_PyInterpreterState_GET()->gc;
+        if (gcstate->generations[0].count > 0) {
+            gcstate->generations[0].count--;
+        }
+    }
+    void **block = (void **)((char *)op - _PyType_PreHeaderSize(type));
+    *block = cache->free_list;
+    cache->free_list = block;
+    cache->numfree++;
+    OBJECT_STAT_INC(to_freelist);
+}
+
+int
+_PyType_SetObjectCacheSize(PyTypeObject *type, Py_ssize_t size)
+{
+    if (!_PyType_HasFeature(type, Py_TPFLAGS_OBJECT_CACHE)) {
+        PyErr_Format(PyExc_TypeError,
+                     "type %s doesn't have the Py_TPFLAGS_OBJECT_CACHE flag",
+                     type->tp_name);
+        return -1;
+    }
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError, "size must be non-negative");
+        return -1;
+    }
+    struct _Py_object_cache *cache = object_cache_get(
+        _PyInterpreterState_GET(), type);
+    if (cache == NULL) {
+        PyErr_Format(PyExc_RuntimeError,
+                     "too many object caches (maximum is %d)",
+                     _Py_MAX_OBJECT_CACHES);
+        return -1;
+    }
+    cache->maxfree = size;
+    object_cache_trim(cache, size);
+    return 0;
+}
+
+/* Return a dict mapping the types with a cache to a dict of statistics. */
+PyObject *
+_PyType_GetObjectCacheStats(PyInterpreterState *interp)
+{
+    PyObject *result = PyDict_New();
+    if (result == NULL) {
+        return NULL;
+    }
+    struct types_state *state = &interp->types;
+    for (int i = 0; i < state->num_object_caches; i++) {
+        struct _Py_object_cache *cache = &state->object_caches[i];
+        PyObject *stats = Py_BuildValue("{snsnsnsn}",
+                                        "size", cache->numfree,
+                                        "max_size", cache->maxfree,
+                                        "hits", cache->hits,
+                                        "misses", cache->misses);
+        if (stats == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        int res = PyDict_SetItem(result, (PyObject *)cache->type, stats);
+        Py_DECREF(stats);
+        if (res < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+/* Free the cached memory of all types, keeping their statistics. */
+void
+_PyType_ClearObjectCaches(PyInterpreterState *interp)
+{
+    struct types_state *state = &interp->types;
+    for (int i = 0; i < state->num_object_caches; i++) {
+        object_cache_trim(&state->object_caches[i], 0);
+    }
+}
+
+/* Forget the cache of a type being deallocated. */
+static void
+object_cache_remove(PyTypeObject *type)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    struct _Py_object_cache *cache = object_cache_find(interp, type);
+    if (cache == NULL) {
+        return;
+    }
+    object_cache_trim(cache, 0);
+    struct types_state *state = &interp->types;
+    *cache = state->object_caches[--state->num_object_caches];
+}
+
 PyObject *
 PyType_GenericNew(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
@@ -4401,6 +4630,9 @@ type_dealloc(PyTypeObject *type)
     _PyObject_GC_UNTRACK(type);
 
     type_dealloc_common(type);
+    if (type->tp_flags & Py_TPFLAGS_OBJECT_CACHE) {
+        object_cache_remove(type);
+    }
 
     // PyObject_ClearWeakRefs() raises an exception if Py_REFCNT() != 0
     assert(Py_REFCNT(type) == 0);
@@ -6359,11 +6591,13 @@ inherit_slots(PyTypeObject *type, PyTypeObject *base)
         }
         else if ((type->tp_flags & Py_TPFLAGS_HAVE_GC) &&
                  type->tp_free == NULL &&
-                 base->tp_free == PyObject_Free) {
+                 (base->tp_free == PyObject_Free ||
+                  base->tp_free == object_cache_free)) {
             /* A bit of magic to plug in the correct default
              * tp_free function when a derived class adds gc,
              * didn't define tp_free, and the base uses the
-             * default non-gc tp_free.
+             * default non-gc tp_free, or an object cache, which
+             * subclasses don't share.
              */
             type->tp_free = PyObject_GC_Del;
         }
@@ -6567,6 +6801,37 @@ type_ready_preheader(PyTypeObject *type)
     return 0;
 }
 
+static int
+type_ready_object_cache(PyTypeObject *type)
+{
+    if (!(type->tp_flags & Py_TPFLAGS_OBJECT_CACHE)) {
+        return 0;
+    }
+    if (type->tp_itemsize != 0) {
+        PyErr_Format(PyExc_TypeError,
+                     "type %s has the Py_TPFLAGS_OBJECT_CACHE flag "
+                     "but is variable-size",
+                     type->tp_name);
+        return -1;
+    }
+    if (type->tp_alloc == PyType_GenericAlloc) {
+        type->tp_alloc = object_cache_alloc;
+    }
+    if (type->tp_free == PyObject_Free || type->tp_free == PyObject_GC_Del) {
+        type->tp_free = object_cache_free;
+    }
+    if (type->tp_alloc != object_cache_alloc
+        || type->tp_free != object_cache_free)
+    {
+        PyErr_Format(PyExc_TypeError,
+                     "type %s has the Py_TPFLAGS_OBJECT_CACHE flag "
+                     "but sets tp_alloc or tp_free",
+                     type->tp_name);
+        return -1;
+    }
+    return 0;
+}
+
 static int
 type_ready_mro(PyTypeObject *type)
 {
@@ -6854,6 +7119,9 @@ type_ready(PyTypeObject *type)
     if (type_ready_preheader(type) < 0) {
         return -1;
     }
+    if (type_ready_object_cache(type) < 0) {
+        return -1;
+    }
     if (type_ready_set_hash(type) < 0) {
         return -1;
     }
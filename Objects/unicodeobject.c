@@ -54,8 +54,9 @@ OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
 #include "pycore_runtime_init.h"  // _PyUnicode_InitStaticStrings()
 #include "pycore_ucnhash.h"       // _PyUnicode_Name_CAPI
-#include "pycore_unicodeobject.h" // struct _Py_unicode_state
+#include "pycore_unicodeobject.h" // struct _Py_unicode_state, _PyUnicodeIterObject
 #include "stringlib/eq.h"         // unicode_eq()
+#include "stringlib/simd.h"       // STRINGLIB_SIMD
 
 #ifdef MS_WINDOWS
 #include <windows.h>
@@ -4475,6 +4476,9 @@ PyUnicode_DecodeUTF8(const char *s,
 static Py_ssize_t
 ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
 {
+#ifdef STRINGLIB_SIMD
+    return asciilib_ascii_decode(start, end, dest);
+#else
     const char *p = start;
 
 #if SIZEOF_SIZE_T <= SIZEOF_VOID_P
@@ -4524,6 +4528,7 @@ ascii_decode(const char *start, const char *end, Py_UCS1 *dest)
     }
     memcpy(dest, start, p - start);
     return p - start;
+#endif
 }
 
 static PyObject *
@@ -10220,6 +10225,161 @@ replace(PyObject *self, PyObject *str1,
     return NULL;
 }
 
+static Py_ssize_t
+anylib_find_all_any(int kind, const void *buf, Py_ssize_t len,
+                    Py_ssize_t *start, const void **needles,
+                    const Py_ssize_t *lens, Py_ssize_t k,
+                    Py_ssize_t *matches, Py_ssize_t size)
+{
+    switch (kind) {
+    case PyUnicode_1BYTE_KIND:
+        return ucs1lib_find_all_any(buf, len, start,
+                                    (const Py_UCS1 *const *)needles,
+                                    lens, k, matches, size);
+    case PyUnicode_2BYTE_KIND:
+        return ucs2lib_find_all_any(buf, len, start,
+                                    (const Py_UCS2 *const *)needles,
+                                    lens, k, matches, size);
+    case PyUnicode_4BYTE_KIND:
+        return ucs4lib_find_all_any(buf, len, start,
+                                    (const Py_UCS4 *const *)needles,
+                                    lens, k, matches, size);
+    }
+    Py_UNREACHABLE();
+}
+
+/* Replace the occurrences of the k strings olds[i] with news[i] in a single
+   pass.  At each position, the first of the olds which matches is replaced,
+   and the replacement is not searched again.  The olds must not be empty. */
+static PyObject *
+replace_many(PyObject *self, PyObject *const *olds, PyObject *const *news,
+             Py_ssize_t k)
+{
+    int skind = PyUnicode_KIND(self);
+    const char *sbuf = PyUnicode_DATA(self);
+    Py_ssize_t slen = PyUnicode_GET_LENGTH(self);
+    Py_UCS4 smaxchar = PyUnicode_MAX_CHAR_VALUE(self);
+    Py_UCS4 maxchar = smaxchar;
+    int mayshrink = 0;
+    Py_ssize_t i, n = 0, pos, ipos, upos, new_size = slen;
+    Py_ssize_t nmatches = 0, allocated = 0;
+    Py_ssize_t *matches = NULL;
+    PyObject *u = NULL;
+
+    const void **bufs = PyMem_New(const void *, k);
+    Py_ssize_t *lens = PyMem_New(Py_ssize_t, k);
+    Py_ssize_t *index = PyMem_New(Py_ssize_t, k);
+    if (bufs == NULL || lens == NULL || index == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    /* Keep the olds which may be present, in the kind of self */
+    for (i = 0; i < k; i++) {
+        PyObject *old = olds[i];
+        Py_ssize_t len = PyUnicode_GET_LENGTH(old);
+        assert(len > 0);
+        if (len > slen || PyUnicode_MAX_CHAR_VALUE(old) > smaxchar) {
+            continue;
+        }
+        const void *buf = PyUnicode_DATA(old);
+        if (PyUnicode_KIND(old) < skind) {
+            buf = unicode_askind(PyUnicode_KIND(old), buf, len, skind);
+            if (buf == NULL) {
+                goto done;
+            }
+        }
+        bufs[n] = buf;
+        lens[n] = len;
+        index[n] = i;
+        n++;
+    }
+
+    /* Find the matches, as (position, index in olds) pairs */
+    pos = 0;
+    while (n > 0) {
+        if (nmatches == allocated) {
+            allocated = allocated ? allocated * 2 : 16;
+            if (!PyMem_Resize(matches, Py_ssize_t, 2 * allocated)) {
+                PyErr_NoMemory();
+                goto done;
+            }
+        }
+        Py_ssize_t *found = matches + 2 * nmatches;
+        Py_ssize_t nfound = anylib_find_all_any(skind, sbuf, slen, &pos,
+                                                bufs, lens, n, found,
+                                                allocated - nmatches);
+        for (i = 0; i < nfound; i++) {
+            Py_ssize_t which = found[2 * i + 1];
+            PyObject *old = olds[index[which]];
+            PyObject *new = news[index[which]];
+            Py_ssize_t len1 = lens[which];
+            Py_ssize_t len2 = PyUnicode_GET_LENGTH(new);
+            if (len2 > len1 && len2 - len1 > PY_SSIZE_T_MAX - new_size) {
+                PyErr_SetString(PyExc_OverflowError,
+                                "replace string is too long");
+                goto done;
+            }
+            new_size += len2 - len1;
+            found[2 * i + 1] = index[which];
+            /* Replacing old with new may cause a maxchar reduction in the
+               result string. */
+            Py_UCS4 maxchar_old = PyUnicode_MAX_CHAR_VALUE(old);
+            Py_UCS4 maxchar_new = PyUnicode_MAX_CHAR_VALUE(new);
+            mayshrink |= ((maxchar_new < maxchar_old)
+                          && (smaxchar == maxchar_old));
+            maxchar = Py_MAX(maxchar, maxchar_new);
+        }
+        nmatches += nfound;
+        if (pos == slen) {
+            break;
+        }
+    }
+    if (nmatches == 0) {
+        u = unicode_result_unchanged(self);
+        goto done;
+    }
+
+    u = PyUnicode_New(new_size, maxchar);
+    if (u == NULL) {
+        goto done;
+    }
+    ipos = upos = 0;
+    for (i = 0; i < nmatches; i++) {
+        Py_ssize_t j = matches[2 * i];
+        PyObject *new = news[matches[2 * i + 1]];
+        Py_ssize_t len2 = PyUnicode_GET_LENGTH(new);
+        /* copy unchanged part [ipos:j] */
+        _PyUnicode_FastCopyCharacters(u, upos, self, ipos, j - ipos);
+        upos += j - ipos;
+        _PyUnicode_FastCopyCharacters(u, upos, new, 0, len2);
+        upos += len2;
+        ipos = j + PyUnicode_GET_LENGTH(olds[matches[2 * i + 1]]);
+    }
+    _PyUnicode_FastCopyCharacters(u, upos, self, ipos, slen - ipos);
+    assert(upos + slen - ipos == new_size);
+    if (mayshrink) {
+        unicode_adjust_maxchar(&u);
+    }
+    else {
+        u = unicode_result(u);
+    }
+
+  done:
+    if (bufs != NULL) {
+        for (i = 0; i < n; i++) {
+            if (bufs[i] != PyUnicode_DATA(olds[index[i]])) {
+                PyMem_Free((void *)bufs[i]);
+            }
+        }
+    }
+    PyMem_Free(bufs);
+    PyMem_Free(lens);
+    PyMem_Free(index);
+    PyMem_Free(matches);
+    return u;
+}
+
 /* --- Unicode Object Methods --------------------------------------------- */
 
 /*[clinic input]
@@ -14765,14 +14925,8 @@ _PyUnicode_ClearInterned(PyInterpreterState *interp)
 
 /********************* Unicode Iterator **************************/
 
-typedef struct {
-    PyObject_HEAD
-    Py_ssize_t it_index;
-    PyObject *it_seq;    /* Set to NULL when iterator is exhausted */
-} unicodeiterobject;
-
 static void
-unicodeiter_dealloc(unicodeiterobject *it)
+unicodeiter_dealloc(_PyUnicodeIterObject *it)
 {
     _PyObject_GC_UNTRACK(it);
     Py_XDECREF(it->it_seq);
@@ -14780,14 +14934,14 @@ unicodeiter_dealloc(unicodeiterobject *it)
 }
 
 static int
-unicodeiter_traverse(unicodeiterobject *it, visitproc visit, void *arg)
+unicodeiter_traverse(_PyUnicodeIterObject *it, visitproc visit, void *arg)
 {
     Py_VISIT(it->it_seq);
     return 0;
 }
 
 static PyObject *
-unicodeiter_next(unicodeiterobject *it)
+unicodeiter_next(_PyUnicodeIterObject *it)
 {
     PyObject *seq;
 
@@ -14811,7 +14965,7 @@ unicodeiter_next(unicodeiterobject *it)
 }
 
 static PyObject *
-unicode_ascii_iter_next(unicodeiterobject *it)
+unicode_ascii_iter_next(_PyUnicodeIterObject *it)
 {
     assert(it != NULL);
     PyObject *seq = it->it_seq;
@@ -14834,7 +14988,7 @@ unicode_ascii_iter_next(unicodeiterobject *it)
 }
 
 static PyObject *
-unicodeiter_len(unicodeiterobject *it, PyObject *Py_UNUSED(ignored))
+unicodeiter_len(_PyUnicodeIterObject *it, PyObject *Py_UNUSED(ignored))
 {
     Py_ssize_t len = 0;
     if (it->it_seq)
@@ -14845,7 +14999,7 @@ unicodeiter_len(unicodeiterobject *it, PyObject *Py_UNUSED(ignored))
 PyDoc_STRVAR(length_hint_doc, "Private method returning an estimate of len(list(it)).");
 
 static PyObject *
-unicodeiter_reduce(unicodeiterobject *it, PyObject *Py_UNUSED(ignored))
+unicodeiter_reduce(_PyUnicodeIterObject *it, PyObject *Py_UNUSED(ignored))
 {
     if (it->it_seq != NULL) {
         return Py_BuildValue("N(O)n", _PyEval_GetBuiltin(&_Py_ID(iter)),
@@ -14861,7 +15015,7 @@ unicodeiter_reduce(unicodeiterobject *it, PyObject *Py_UNUSED(ignored))
 PyDoc_STRVAR(reduce_doc, "Return state information for pickling.");
 
 static PyObject *
-unicodeiter_setstate(unicodeiterobject *it, PyObject *state)
+unicodeiter_setstate(_PyUnicodeIterObject *it, PyObject *state)
 {
     Py_ssize_t index = PyLong_AsSsize_t(state);
     if (index == -1 && PyErr_Occurred())
@@ -14891,7 +15045,7 @@ static PyMethodDef unicodeiter_methods[] = {
 PyTypeObject PyUnicodeIter_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     "str_iterator",         /* tp_name */
-    sizeof(unicodeiterobject),      /* tp_basicsize */
+    sizeof(_PyUnicodeIterObject),      /* tp_basicsize */
     0,                  /* tp_itemsize */
     /* methods */
     (destructor)unicodeiter_dealloc,    /* tp_dealloc */
@@ -14924,7 +15078,7 @@ PyTypeObject PyUnicodeIter_Type = {
 PyTypeObject _PyUnicodeASCIIIter_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     .tp_name = "str_ascii_iterator",
-    .tp_basicsize = sizeof(unicodeiterobject),
+    .tp_basicsize = sizeof(_PyUnicodeIterObject),
     .tp_dealloc = (destructor)unicodeiter_dealloc,
     .tp_getattro = PyObject_GenericGetAttr,
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
@@ -14937,17 +15091,17 @@ PyTypeObject _PyUnicodeASCIIIter_Type = {
 static PyObject *
 unicode_iter(PyObject *seq)
 {
-    unicodeiterobject *it;
+    _PyUnicodeIterObject *it;
 
     if (!PyUnicode_Check(seq)) {
         PyErr_BadInternalCall();
         return NULL;
     }
     if (PyUnicode_IS_COMPACT_ASCII(seq)) {
-        it = PyObject_GC_New(unicodeiterobject, &_PyUnicodeASCIIIter_Type);
+        it = PyObject_GC_New(_PyUnicodeIterObject, &_PyUnicodeASCIIIter_Type);
     }
     else {
-        it = PyObject_GC_New(unicodeiterobject, &PyUnicodeIter_Type);
+        it = PyObject_GC_New(_PyUnicodeIterObject, &PyUnicodeIter_Type);
     }
     if (it == NULL)
         return NULL;
@@ -15202,14 +15356,79 @@ _PyUnicode_Fini(PyInterpreterState *interp)
     unicode_clear_identifiers(state);
 }
 
+static PyObject *
+string_replace_many(PyObject *module, PyObject *const *args, Py_ssize_t nargs)
+{
+    if (!_PyArg_CheckPositional("replace_many", nargs, 2, 2)) {
+        return NULL;
+    }
+    PyObject *self = args[0];
+    if (!PyUnicode_Check(self)) {
+        PyErr_Format(PyExc_TypeError, "expected str, got %s",
+                     Py_TYPE(self)->tp_name);
+        return NULL;
+    }
+    PyObject *pairs = PySequence_Fast(args[1],
+                                      "expected a sequence of pairs");
+    if (pairs == NULL) {
+        return NULL;
+    }
+
+    PyObject *result = NULL;
+    Py_ssize_t i, k = PySequence_Fast_GET_SIZE(pairs);
+    PyObject **olds = PyMem_New(PyObject *, k);
+    PyObject **news = PyMem_New(PyObject *, k);
+    if (olds == NULL || news == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < k; i++) {
+        PyObject *pair = PySequence_Fast_GET_ITEM(pairs, i);
+        if (!PyTuple_Check(pair) || PyTuple_GET_SIZE(pair) != 2
+            || !PyUnicode_Check(PyTuple_GET_ITEM(pair, 0))
+            || !PyUnicode_Check(PyTuple_GET_ITEM(pair, 1)))
+        {
+            PyErr_Format(PyExc_TypeError,
+                         "expected a pair of str, got %s",
+                         Py_TYPE(pair)->tp_name);
+            goto done;
+        }
+        olds[i] = PyTuple_GET_ITEM(pair, 0);
+        news[i] = PyTuple_GET_ITEM(pair, 1);
+        if (PyUnicode_GET_LENGTH(olds[i]) == 0) {
+            PyErr_SetString(PyExc_ValueError, "empty substring");
+            goto done;
+        }
+    }
+    result = replace_many(self, olds, news, k);
+
+  done:
+    PyMem_Free(olds);
+    PyMem_Free(news);
+    Py_DECREF(pairs);
+    return result;
+}
+
+PyDoc_STRVAR(string_replace_many__doc__,
+"replace_many($module, string, replacements, /)\n"
+"--\n"
+"\n"
+"Return a copy of string with substrings replaced in a single pass.\n"
+"\n"
+"replacements is a sequence of (old, new) pairs of strings.  At each\n"
+"position, the first old substring which matches is replaced with the\n"
+"corresponding new one; the replacements are not searched again.");
+
 /* A _string module, to export formatter_parser and formatter_field_name_split
-   to the string.Formatter class implemented in Python. */
+   to the string.Formatter class implemented in Python, and replace_many. */
 
 static PyMethodDef _string_methods[] = {
     {"formatter_field_name_split", (PyCFunction) formatter_field_name_split,
      METH_O, PyDoc_STR("split the argument as a field name")},
     {"formatter_parser", (PyCFunction) formatter_parser,
      METH_O, PyDoc_STR("parse the argument as a format string")},
+    {"replace_many", _PyCFunction_CAST(string_replace_many),
+     METH_FASTCALL, string_replace_many__doc__},
     {NULL, NULL}
 };
 
@@ -5,6 +5,7 @@
 #include "pycore_ast.h"           // _PyAST_Validate()
 #include "pycore_call.h"          // _PyObject_CallNoArgs()
 #include "pycore_compile.h"       // _PyAST_Compile()
+#include "pycore_iterators.h"     // _PyZipObject, _PyZip_NextPair()
 #include "pycore_object.h"        // _Py_AddToAllObjects()
 #include "pycore_pyerrors.h"      // _PyErr_NoMemory()
 #include "pycore_pystate.h"       // _PyThreadState_GET()
@@ -2677,18 +2678,10 @@ builtin_issubclass_impl(PyObject *module, PyObject *cls,
     return PyBool_FromLong(retval);
 }
 
-typedef struct {
-    PyObject_HEAD
-    Py_ssize_t tuplesize;
-    PyObject *ittuple;     /* tuple of iterators */
-    PyObject *result;
-    int strict;
-} zipobject;
-
 static PyObject *
 zip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    zipobject *lz;
+    _PyZipObject *lz;
     Py_ssize_t i;
     PyObject *ittuple;  /* tuple of iterators */
     PyObject *result;
@@ -2739,7 +2732,7 @@ zip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     /* create zipobject structure */
-    lz = (zipobject *)type->tp_alloc(type, 0);
+    lz = (_PyZipObject *)type->tp_alloc(type, 0);
     if (lz == NULL) {
         Py_DECREF(ittuple);
         Py_DECREF(result);
@@ -2754,7 +2747,7 @@ zip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 }
 
 static void
-zip_dealloc(zipobject *lz)
+zip_dealloc(_PyZipObject *lz)
 {
     PyObject_GC_UnTrack(lz);
     Py_XDECREF(lz->ittuple);
@@ -2763,15 +2756,63 @@ zip_dealloc(zipobject *lz)
 }
 
 static int
-zip_traverse(zipobject *lz, visitproc visit, void *arg)
+zip_traverse(_PyZipObject *lz, visitproc visit, void *arg)
 {
     Py_VISIT(lz->ittuple);
     Py_VISIT(lz->result);
     return 0;
 }
 
+/* Called when argument i of a strict zip() is exhausted (or raised): raise
+   ValueError if the other arguments are not exhausted as well. Always
+   returns NULL. */
+static PyObject *
+zip_strict_check(_PyZipObject *lz, Py_ssize_t i)
+{
+    Py_ssize_t tuplesize = lz->tuplesize;
+    PyObject *it;
+    PyObject *item;
+
+    if (PyErr_Occurred()) {
+        if (!PyErr_ExceptionMatches(PyExc_StopIteration)) {
+            // next() on argument i raised an exception (not StopIteration)
+            return NULL;
+        }
+        PyErr_Clear();
+    }
+    if (i) {
+        // ValueError: zip() argument 2 is shorter than argument 1
+        // ValueError: zip() argument 3 is shorter than arguments 1-2
+        const char* plural = i == 1 ? " " : "s 1-";
+        return PyErr_Format(PyExc_ValueError,
+                            "zip() argument %d is shorter than argument%s%d",
+                            i + 1, plural, i);
+    }
+    for (i = 1; i < tuplesize; i++) {
+        it = PyTuple_GET_ITEM(lz->ittuple, i);
+        item = (*Py_TYPE(it)->tp_iternext)(it);
+        if (item) {
+            Py_DECREF(item);
+            const char* plural = i == 1 ? " " : "s 1-";
+            return PyErr_Format(PyExc_ValueError,
+                                "zip() argument %d is longer than argument%s%d",
+                                i + 1, plural, i);
+        }
+        if (PyErr_Occurred()) {
+            if (!PyErr_ExceptionMatches(PyExc_StopIteration)) {
+                // next() on argument i raised an exception (not StopIteration)
+                return NULL;
+            }
+            PyErr_Clear();
+        }
+        // Argument i is exhausted. So far so good...
+    }
+    // All arguments are exhausted. Success!
+    return NULL;
+}
+
 static PyObject *
-zip_next(zipobject *lz)
+zip_next(_PyZipObject *lz)
 {
     Py_ssize_t i;
     Py_ssize_t tuplesize = lz->tuplesize;
@@ -2790,7 +2831,7 @@ zip_next(zipobject *lz)
             if (item == NULL) {
                 Py_DECREF(result);
                 if (lz->strict) {
-                    goto check;
+                    return zip_strict_check(lz, i);
                 }
                 return NULL;
             }
@@ -2813,7 +2854,7 @@ zip_next(zipobject *lz)
             if (item == NULL) {
                 Py_DECREF(result);
                 if (lz->strict) {
-                    goto check;
+                    return zip_strict_check(lz, i);
                 }
                 return NULL;
             }
@@ -2821,47 +2862,42 @@ zip_next(zipobject *lz)
         }
     }
     return result;
-check:
-    if (PyErr_Occurred()) {
-        if (!PyErr_ExceptionMatches(PyExc_StopIteration)) {
-            // next() on argument i raised an exception (not StopIteration)
-            return NULL;
+}
+
+/* Used by the specialized FOR_ITER instruction, which pushes both items
+   directly instead of going through the result tuple. The zip must have
+   exactly two arguments. Stores new references and returns 1, or returns 0
+   when exhausted or on error, like tp_iternext returning NULL. */
+int
+_PyZip_NextPair(PyObject *self, PyObject **pfirst, PyObject **psecond)
+{
+    _PyZipObject *lz = (_PyZipObject *)self;
+    assert(Py_IS_TYPE(self, &PyZip_Type));
+    assert(lz->tuplesize == 2);
+    PyObject *it = PyTuple_GET_ITEM(lz->ittuple, 0);
+    PyObject *first = (*Py_TYPE(it)->tp_iternext)(it);
+    if (first == NULL) {
+        if (lz->strict) {
+            zip_strict_check(lz, 0);
         }
-        PyErr_Clear();
-    }
-    if (i) {
-        // ValueError: zip() argument 2 is shorter than argument 1
-        // ValueError: zip() argument 3 is shorter than arguments 1-2
-        const char* plural = i == 1 ? " " : "s 1-";
-        return PyErr_Format(PyExc_ValueError,
-                            "zip() argument %d is shorter than argument%s%d",
-                            i + 1, plural, i);
+        return 0;
     }
-    for (i = 1; i < tuplesize; i++) {
-        it = PyTuple_GET_ITEM(lz->ittuple, i);
-        item = (*Py_TYPE(it)->tp_iternext)(it);
-        if (item) {
-            Py_DECREF(item);
-            const char* plural = i == 1 ? " " : "s 1-";
-            return PyErr_Format(PyExc_ValueError,
-                                "zip() argument %d is longer than argument%s%d",
-                                i + 1, plural, i);
+    it = PyTuple_GET_ITEM(lz->ittuple, 1);
+    PyObject *second = (*Py_TYPE(it)->tp_iternext)(it);
+    if (second == NULL) {
+        Py_DECREF(first);
+        if (lz->strict) {
+            zip_strict_check(lz, 1);
         }
-        if (PyErr_Occurred()) {
-            if (!PyErr_ExceptionMatches(PyExc_StopIteration)) {
-                // next() on argument i raised an exception (not StopIteration)
-                return NULL;
-            }
-            PyErr_Clear();
-        }
-        // Argument i is exhausted. So far so good...
+        return 0;
     }
-    // All arguments are exhausted. Success!
-    return NULL;
+    *pfirst = first;
+    *psecond = second;
+    return 1;
 }
 
 static PyObject *
-zip_reduce(zipobject *lz, PyObject *Py_UNUSED(ignored))
+zip_reduce(_PyZipObject *lz, PyObject *Py_UNUSED(ignored))
 {
     /* Just recreate the zip with the internal iterator tuple */
     if (lz->strict) {
@@ -2873,7 +2909,7 @@ zip_reduce(zipobject *lz, PyObject *Py_UNUSED(ignored))
 PyDoc_STRVAR(setstate_doc, "Set state information for unpickling.");
 
 static PyObject *
-zip_setstate(zipobject *lz, PyObject *state)
+zip_setstate(_PyZipObject *lz, PyObject *state)
 {
     int strict = PyObject_IsTrue(state);
     if (strict < 0) {
@@ -2906,7 +2942,7 @@ raise a ValueError.");
 PyTypeObject PyZip_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     "zip",                              /* tp_name */
-    sizeof(zipobject),                  /* tp_basicsize */
+    sizeof(_PyZipObject),               /* tp_basicsize */
     0,                                  /* tp_itemsize */
     /* methods */
     (destructor)zip_dealloc,            /* tp_dealloc */
@@ -13,6 +13,8 @@
 #include "pycore_ceval.h"         // _PyEval_SignalAsyncExc()
 #include "pycore_code.h"
 #include "pycore_function.h"
+#include "pycore_iterators.h"     // _PyEnum_NextPair(), _PyZip_NextPair()
+#include "pycore_jit.h"           // _PyJIT_Compile()
 #include "pycore_long.h"          // _PyLong_GetZero()
 #include "pycore_object.h"        // _PyObject_GC_TRACK()
 #include "pycore_moduleobject.h"  // PyModuleObject
@@ -24,6 +26,8 @@
 #include "pycore_sliceobject.h"   // _PyBuildSlice_ConsumeRefs
 #include "pycore_sysmodule.h"     // _PySys_Audit()
 #include "pycore_tuple.h"         // _PyTuple_ITEMS()
+#include "pycore_typeobject.h"    // _PyMegaAttrCache_Entry()
+#include "pycore_unicodeobject.h" // _PyUnicodeIterObject
 #include "pycore_emscripten_signal.h"  // _Py_CHECK_EMSCRIPTEN_SIGNALS
 
 #include "pycore_dict.h"
@@ -56,8 +60,11 @@
 #undef Py_DECREF
 #define Py_DECREF(arg) \
     do { \
-        _Py_DECREF_STAT_INC(); \
         PyObject *op = _PyObject_CAST(arg); \
+        if (_Py_IsImmortal(op)) { \
+            break; \
+        } \
+        _Py_DECREF_STAT_INC(); \
         if (--op->ob_refcnt == 0) { \
             destructor dealloc = Py_TYPE(op)->tp_dealloc; \
             (*dealloc)(op); \
@@ -80,8 +87,11 @@
 #undef _Py_DECREF_SPECIALIZED
 #define _Py_DECREF_SPECIALIZED(arg, dealloc) \
     do { \
-        _Py_DECREF_STAT_INC(); \
         PyObject *op = _PyObject_CAST(arg); \
+        if (_Py_IsImmortal(op)) { \
+            break; \
+        } \
+        _Py_DECREF_STAT_INC(); \
         if (--op->ob_refcnt == 0) { \
             destructor d = (destructor)(dealloc); \
             d(op); \
@@ -214,6 +224,10 @@ static _PyInterpreterFrame *
 _PyEvalFramePushAndInit(PyThreadState *tstate, PyFunctionObject *func,
                         PyObject *locals, PyObject* const* args,
                         size_t argcount, PyObject *kwnames);
+static _PyInterpreterFrame *
+_PyEvalFramePushAndInit_Ex(PyThreadState *tstate, PyFunctionObject *func,
+                           PyObject *locals, PyObject *callargs,
+                           PyObject *kwargs);
 static void
 _PyEvalFrameClearAndPop(PyThreadState *tstate, _PyInterpreterFrame *frame);
 
@@ -677,6 +691,8 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
         frame->prev_instr = next_instr++; \
         OPCODE_EXE_INC(op); \
         if (_py_stats) _py_stats->opcode_stats[lastopcode].pair_count[op]++; \
+        OPCODE_TRIPLE_INC(prevopcode, lastopcode, op); \
+        prevopcode = lastopcode; \
         lastopcode = op; \
     } while (0)
 #else
@@ -724,6 +740,40 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
         goto handle_eval_breaker; \
     }
 
+#ifdef _Py_JIT
+/* Run the JIT-compiled code from next_instr on, if there is any for it,
+   compiling the code object first once it is warm (see pycore_jit.h).
+   The compiled code returns where the interpreter has to take over. */
+#define JIT_ENTER() \
+    do { \
+        PyCodeObject *jit_code = frame->f_code; \
+        if (cframe.use_tracing || jit_code->_co_jit_warmup < 0) { \
+            break; \
+        } \
+        if (jit_code->_co_jit == NULL) { \
+            if (!tstate->interp->config.jit || \
+                ++jit_code->_co_jit_warmup < _PyJIT_WARMUP || \
+                _PyJIT_Compile(jit_code) < 0) \
+            { \
+                break; \
+            } \
+        } \
+        _PyJITFunction jit_entry = _PyJIT_Entry(jit_code, INSTR_OFFSET()); \
+        if (jit_entry == NULL) { \
+            break; \
+        } \
+        int jit_err = jit_entry(frame, stack_pointer, tstate); \
+        stack_pointer = _PyFrame_GetStackPointer(frame); \
+        frame->stacktop = -1; \
+        next_instr = frame->prev_instr + 1; \
+        if (jit_err) { \
+            goto error; \
+        } \
+    } while (0)
+#else
+#define JIT_ENTER() ((void)0)
+#endif
+
 
 /* Tuple access macros */
 
@@ -751,6 +801,31 @@ GETITEM(PyObject *v, Py_ssize_t i) {
 #define JUMPTO(x)       (next_instr = first_instr + (x))
 #define JUMPBY(x)       (next_instr += (x))
 
+/* Borrowing loads push values without a new reference, for the next
+   instruction (or the one after it) to consume; see borrow_local_loads()
+   in compile.c.  A trace function called in between could rebind the
+   local through f_locals, so traced code runs the loads and their
+   consumers as their strong counterparts instead. */
+#define IS_BORROWING_LOAD(op) \
+    ((op) == LOAD_FAST_BORROW || (op) == LOAD_CONST_BORROW)
+#define FOLLOWS_BORROWING_LOAD() \
+    (INSTR_OFFSET() > 0 && \
+     IS_BORROWING_LOAD(_PyOpcode_Deopt[_Py_OPCODE(next_instr[-1])]))
+#define UNBORROW_OPCODE() \
+    do { \
+        switch (opcode) { \
+            case LOAD_FAST_BORROW: opcode = LOAD_FAST_CHECK; break; \
+            case LOAD_CONST_BORROW: opcode = LOAD_CONST; break; \
+            case POP_JUMP_IF_FALSE_BORROW: opcode = POP_JUMP_IF_FALSE; break; \
+            case POP_JUMP_IF_TRUE_BORROW: opcode = POP_JUMP_IF_TRUE; break; \
+            case POP_JUMP_IF_NOTNONE_BORROW: \
+                opcode = POP_JUMP_IF_NOT_NONE; \
+                break; \
+            case POP_JUMP_IF_NONE_BORROW: opcode = POP_JUMP_IF_NONE; break; \
+            case COMPARE_OP: oparg &= ~COMPARE_BORROWED; break; \
+        } \
+    } while (0)
+
 /* Get opcode and oparg from original instructions, not quickened form. */
 #define TRACING_NEXTOPARG() do { \
         NEXTOPARG(); \
@@ -863,6 +938,20 @@ GETITEM(PyObject *v, Py_ssize_t i) {
 #define DEOPT_IF(cond, instname) if (cond) { goto miss; }
 
 
+/* True for a memoryview that has not been released and exposes a
+   one-dimensional buffer of unsigned bytes (format "B"). */
+#define MEMORYVIEW_IS_BYTES(mv) \
+    (!(((PyMemoryViewObject *)(mv))->flags & _Py_MEMORYVIEW_RELEASED) && \
+     !(((PyMemoryViewObject *)(mv))->mbuf->flags & _Py_MANAGED_BUFFER_RELEASED) && \
+     PyMemoryView_GET_BUFFER(mv)->ndim == 1 && \
+     PyMemoryView_GET_BUFFER(mv)->itemsize == 1 && \
+     PyMemoryView_GET_BUFFER(mv)->suboffsets == NULL && \
+     PyMemoryView_GET_BUFFER(mv)->format != NULL && \
+     PyMemoryView_GET_BUFFER(mv)->format[0] == 'B' && \
+     PyMemoryView_GET_BUFFER(mv)->format[1] == '\0')
+
+#include "ceval_macros.h"
+
 #define GLOBALS() frame->f_globals
 #define BUILTINS() frame->f_builtins
 #define LOCALS() frame->f_locals
@@ -1009,6 +1098,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
 
 #ifdef Py_STATS
     int lastopcode = 0;
+    int prevopcode = 0;
 #endif
     // opcode is an 8-bit value to improve the code generated by MSVC
     // for the big switch below (in combination with the EXTRA_CASES macro).
@@ -1150,6 +1240,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             if (_Py_atomic_load_relaxed_int32(eval_breaker) && oparg < 2) {
                 goto handle_eval_breaker;
             }
+            JIT_ENTER();
             DISPATCH();
         }
 
@@ -1190,6 +1281,24 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(LOAD_FAST_BORROW) {
+            PyObject *value = GETLOCAL(oparg);
+            /* Only NULL if a trace function deleted the local */
+            if (value == NULL) {
+                goto unbound_borrowed_local_error;
+            }
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            DISPATCH();
+        }
+
+        TARGET(LOAD_CONST_BORROW) {
+            PyObject *value = GETITEM(consts, oparg);
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            DISPATCH();
+        }
+
         TARGET(STORE_FAST) {
             PyObject *value = POP();
             SETLOCAL(oparg, value);
@@ -1258,6 +1367,43 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(LOAD_FAST_BORROW__LOAD_FAST_BORROW) {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_borrowed_local_error;
+            }
+            NEXTOPARG();
+            next_instr++;
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_borrowed_local_error;
+            }
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            DISPATCH();
+        }
+
+        TARGET(LOAD_FAST_BORROW__LOAD_CONST_BORROW) {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_borrowed_local_error;
+            }
+            NEXTOPARG();
+            next_instr++;
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            value = GETITEM(consts, oparg);
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            DISPATCH();
+        }
+
+#define SUPERINSTRUCTION_TARGETS
+#include "superinstructions.h"
+#undef SUPERINSTRUCTION_TARGETS
+
         TARGET(POP_TOP) {
             PyObject *value = POP();
             Py_DECREF(value);
@@ -1325,14 +1471,10 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
             DEOPT_IF(!PyLong_CheckExact(right), BINARY_OP);
             STAT_INC(BINARY_OP, hit);
-            PyObject *prod = _PyLong_Multiply((PyLongObject *)left, (PyLongObject *)right);
-            SET_SECOND(prod);
-            _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
-            _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+            PyObject *prod;
+            INT_RESULT_REUSING_INPUTS(left, right, *, _PyLong_Multiply, prod);
             STACK_SHRINK(1);
-            if (prod == NULL) {
-                goto error;
-            }
+            SET_TOP(prod);
             JUMPBY(INLINE_CACHE_ENTRIES_BINARY_OP);
             DISPATCH();
         }
@@ -1346,14 +1488,10 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             STAT_INC(BINARY_OP, hit);
             double dprod = ((PyFloatObject *)left)->ob_fval *
                 ((PyFloatObject *)right)->ob_fval;
-            PyObject *prod = PyFloat_FromDouble(dprod);
-            SET_SECOND(prod);
-            _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc);
-            _Py_DECREF_SPECIALIZED(left, _PyFloat_ExactDealloc);
+            PyObject *prod;
+            FLOAT_RESULT_REUSING_INPUTS(left, right, dprod, prod);
             STACK_SHRINK(1);
-            if (prod == NULL) {
-                goto error;
-            }
+            SET_TOP(prod);
             JUMPBY(INLINE_CACHE_ENTRIES_BINARY_OP);
             DISPATCH();
         }
@@ -1365,14 +1503,10 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
             DEOPT_IF(!PyLong_CheckExact(right), BINARY_OP);
             STAT_INC(BINARY_OP, hit);
-            PyObject *sub = _PyLong_Subtract((PyLongObject *)left, (PyLongObject *)right);
-            SET_SECOND(sub);
-            _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
-            _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+            PyObject *sub;
+            INT_RESULT_REUSING_INPUTS(left, right, -, _PyLong_Subtract, sub);
             STACK_SHRINK(1);
-            if (sub == NULL) {
-                goto error;
-            }
+            SET_TOP(sub);
             JUMPBY(INLINE_CACHE_ENTRIES_BINARY_OP);
             DISPATCH();
         }
@@ -1385,14 +1519,10 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DEOPT_IF(!PyFloat_CheckExact(right), BINARY_OP);
             STAT_INC(BINARY_OP, hit);
             double dsub = ((PyFloatObject *)left)->ob_fval - ((PyFloatObject *)right)->ob_fval;
-            PyObject *sub = PyFloat_FromDouble(dsub);
-            SET_SECOND(sub);
-            _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc);
-            _Py_DECREF_SPECIALIZED(left, _PyFloat_ExactDealloc);
+            PyObject *sub;
+            FLOAT_RESULT_REUSING_INPUTS(left, right, dsub, sub);
             STACK_SHRINK(1);
-            if (sub == NULL) {
-                goto error;
-            }
+            SET_TOP(sub);
             JUMPBY(INLINE_CACHE_ENTRIES_BINARY_OP);
             DISPATCH();
         }
@@ -1423,8 +1553,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DEOPT_IF(!PyUnicode_CheckExact(left), BINARY_OP);
             DEOPT_IF(Py_TYPE(right) != Py_TYPE(left), BINARY_OP);
             _Py_CODEUNIT true_next = next_instr[INLINE_CACHE_ENTRIES_BINARY_OP];
-            assert(_Py_OPCODE(true_next) == STORE_FAST ||
-                   _Py_OPCODE(true_next) == STORE_FAST__LOAD_FAST);
+            assert(_PyOpcode_Deopt[_Py_OPCODE(true_next)] == STORE_FAST);
             PyObject **target_local = &GETLOCAL(_Py_OPARG(true_next));
             DEOPT_IF(*target_local != left, BINARY_OP);
             STAT_INC(BINARY_OP, hit);
@@ -1461,14 +1590,10 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             STAT_INC(BINARY_OP, hit);
             double dsum = ((PyFloatObject *)left)->ob_fval +
                 ((PyFloatObject *)right)->ob_fval;
-            PyObject *sum = PyFloat_FromDouble(dsum);
-            SET_SECOND(sum);
-            _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc);
-            _Py_DECREF_SPECIALIZED(left, _PyFloat_ExactDealloc);
+            PyObject *sum;
+            FLOAT_RESULT_REUSING_INPUTS(left, right, dsum, sum);
             STACK_SHRINK(1);
-            if (sum == NULL) {
-                goto error;
-            }
+            SET_TOP(sum);
             JUMPBY(INLINE_CACHE_ENTRIES_BINARY_OP);
             DISPATCH();
         }
@@ -1480,14 +1605,10 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DEOPT_IF(!PyLong_CheckExact(left), BINARY_OP);
             DEOPT_IF(Py_TYPE(right) != Py_TYPE(left), BINARY_OP);
             STAT_INC(BINARY_OP, hit);
-            PyObject *sum = _PyLong_Add((PyLongObject *)left, (PyLongObject *)right);
-            SET_SECOND(sum);
-            _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
-            _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
+            PyObject *sum;
+            INT_RESULT_REUSING_INPUTS(left, right, +, _PyLong_Add, sum);
             STACK_SHRINK(1);
-            if (sum == NULL) {
-                goto error;
-            }
+            SET_TOP(sum);
             JUMPBY(INLINE_CACHE_ENTRIES_BINARY_OP);
             DISPATCH();
         }
@@ -1636,6 +1757,84 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(BINARY_SUBSCR_BYTEARRAY_INT) {
+            assert(cframe.use_tracing == 0);
+            PyObject *sub = TOP();
+            PyObject *ba = SECOND();
+            DEOPT_IF(!PyLong_CheckExact(sub), BINARY_SUBSCR);
+            DEOPT_IF(!PyByteArray_CheckExact(ba), BINARY_SUBSCR);
+
+            // Deopt unless 0 <= sub < len(ba)
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1, BINARY_SUBSCR);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            DEOPT_IF(index >= PyByteArray_GET_SIZE(ba), BINARY_SUBSCR);
+            STAT_INC(BINARY_SUBSCR, hit);
+            PyObject *res = _PyLong_FromUnsignedChar(
+                (unsigned char)PyByteArray_AS_STRING(ba)[index]);
+            STACK_SHRINK(1);
+            _Py_DECREF_SPECIALIZED(sub, (destructor)PyObject_Free);
+            SET_TOP(res);
+            Py_DECREF(ba);
+            JUMPBY(INLINE_CACHE_ENTRIES_BINARY_SUBSCR);
+            DISPATCH();
+        }
+
+        TARGET(BINARY_SUBSCR_MEMORYVIEW_INT) {
+            assert(cframe.use_tracing == 0);
+            PyObject *sub = TOP();
+            PyObject *mv = SECOND();
+            DEOPT_IF(!PyLong_CheckExact(sub), BINARY_SUBSCR);
+            DEOPT_IF(!PyMemoryView_Check(mv), BINARY_SUBSCR);
+            // Only live, one-dimensional views of unsigned bytes
+            DEOPT_IF(!MEMORYVIEW_IS_BYTES(mv), BINARY_SUBSCR);
+            Py_buffer *view = PyMemoryView_GET_BUFFER(mv);
+
+            // Deopt unless 0 <= sub < len(mv)
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1, BINARY_SUBSCR);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            DEOPT_IF(index >= view->shape[0], BINARY_SUBSCR);
+            STAT_INC(BINARY_SUBSCR, hit);
+            unsigned char *ptr = (unsigned char *)view->buf +
+                                 view->strides[0] * index;
+            PyObject *res = _PyLong_FromUnsignedChar(*ptr);
+            STACK_SHRINK(1);
+            _Py_DECREF_SPECIALIZED(sub, (destructor)PyObject_Free);
+            SET_TOP(res);
+            Py_DECREF(mv);
+            JUMPBY(INLINE_CACHE_ENTRIES_BINARY_SUBSCR);
+            DISPATCH();
+        }
+
+        TARGET(BINARY_SUBSCR_ARRAY_INT) {
+            assert(cframe.use_tracing == 0);
+            _PyBinarySubscrCache *cache = (_PyBinarySubscrCache *)next_instr;
+            PyObject *sub = TOP();
+            PyObject *array = SECOND();
+            PyTypeObject *tp = Py_TYPE(array);
+            DEOPT_IF(!PyLong_CheckExact(sub), BINARY_SUBSCR);
+            DEOPT_IF(tp->tp_version_tag != read_u32(cache->type_version),
+                     BINARY_SUBSCR);
+            assert(tp->tp_as_sequence->sq_item != NULL);
+
+            // Deopt unless 0 <= sub < len(array)
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1, BINARY_SUBSCR);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            DEOPT_IF(index >= Py_SIZE(array), BINARY_SUBSCR);
+            STAT_INC(BINARY_SUBSCR, hit);
+            // Skips the index conversion and wraparound of the generic path;
+            // the item still has to be boxed by the array module.
+            PyObject *res = tp->tp_as_sequence->sq_item(array, index);
+            if (res == NULL) {
+                goto error;
+            }
+            STACK_SHRINK(1);
+            _Py_DECREF_SPECIALIZED(sub, (destructor)PyObject_Free);
+            SET_TOP(res);
+            Py_DECREF(array);
+            JUMPBY(INLINE_CACHE_ENTRIES_BINARY_SUBSCR);
+            DISPATCH();
+        }
+
         TARGET(BINARY_SUBSCR_GETITEM) {
             PyObject *sub = TOP();
             PyObject *container = SECOND();
@@ -1770,6 +1969,101 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(STORE_SUBSCR_BYTEARRAY_INT) {
+            assert(cframe.use_tracing == 0);
+            PyObject *sub = TOP();
+            PyObject *ba = SECOND();
+            PyObject *value = THIRD();
+            DEOPT_IF(!PyLong_CheckExact(sub), STORE_SUBSCR);
+            DEOPT_IF(!PyByteArray_CheckExact(ba), STORE_SUBSCR);
+
+            // Ensure nonnegative, zero-or-one-digit ints.
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1, STORE_SUBSCR);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            // Ensure index < len(ba)
+            DEOPT_IF(index >= PyByteArray_GET_SIZE(ba), STORE_SUBSCR);
+            // Ensure 0 <= value < 256; anything else raises in the generic path.
+            DEOPT_IF(!PyLong_CheckExact(value), STORE_SUBSCR);
+            DEOPT_IF(((size_t)Py_SIZE(value)) > 1, STORE_SUBSCR);
+            digit byte = ((PyLongObject*)value)->ob_digit[0];
+            DEOPT_IF(byte > 255, STORE_SUBSCR);
+            STAT_INC(STORE_SUBSCR, hit);
+
+            PyByteArray_AS_STRING(ba)[index] = (char)byte;
+            STACK_SHRINK(3);
+            _Py_DECREF_SPECIALIZED(value, (destructor)PyObject_Free);
+            _Py_DECREF_SPECIALIZED(sub, (destructor)PyObject_Free);
+            Py_DECREF(ba);
+            JUMPBY(INLINE_CACHE_ENTRIES_STORE_SUBSCR);
+            DISPATCH();
+        }
+
+        TARGET(STORE_SUBSCR_MEMORYVIEW_INT) {
+            assert(cframe.use_tracing == 0);
+            PyObject *sub = TOP();
+            PyObject *mv = SECOND();
+            PyObject *value = THIRD();
+            DEOPT_IF(!PyLong_CheckExact(sub), STORE_SUBSCR);
+            DEOPT_IF(!PyMemoryView_Check(mv), STORE_SUBSCR);
+            DEOPT_IF(!MEMORYVIEW_IS_BYTES(mv), STORE_SUBSCR);
+            Py_buffer *view = PyMemoryView_GET_BUFFER(mv);
+            DEOPT_IF(view->readonly, STORE_SUBSCR);
+
+            // Ensure nonnegative, zero-or-one-digit ints.
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1, STORE_SUBSCR);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            // Ensure index < len(mv)
+            DEOPT_IF(index >= view->shape[0], STORE_SUBSCR);
+            // Ensure 0 <= value < 256; anything else raises in the generic path.
+            DEOPT_IF(!PyLong_CheckExact(value), STORE_SUBSCR);
+            DEOPT_IF(((size_t)Py_SIZE(value)) > 1, STORE_SUBSCR);
+            digit byte = ((PyLongObject*)value)->ob_digit[0];
+            DEOPT_IF(byte > 255, STORE_SUBSCR);
+            STAT_INC(STORE_SUBSCR, hit);
+
+            unsigned char *ptr = (unsigned char *)view->buf +
+                                 view->strides[0] * index;
+            *ptr = (unsigned char)byte;
+            STACK_SHRINK(3);
+            _Py_DECREF_SPECIALIZED(value, (destructor)PyObject_Free);
+            _Py_DECREF_SPECIALIZED(sub, (destructor)PyObject_Free);
+            Py_DECREF(mv);
+            JUMPBY(INLINE_CACHE_ENTRIES_STORE_SUBSCR);
+            DISPATCH();
+        }
+
+        TARGET(STORE_SUBSCR_ARRAY_INT) {
+            assert(cframe.use_tracing == 0);
+            _PyStoreSubscrCache *cache = (_PyStoreSubscrCache *)next_instr;
+            PyObject *sub = TOP();
+            PyObject *array = SECOND();
+            PyObject *value = THIRD();
+            PyTypeObject *tp = Py_TYPE(array);
+            DEOPT_IF(!PyLong_CheckExact(sub), STORE_SUBSCR);
+            DEOPT_IF(tp->tp_version_tag != read_u32(cache->type_version),
+                     STORE_SUBSCR);
+            assert(tp->tp_as_sequence->sq_ass_item != NULL);
+
+            // Ensure nonnegative, zero-or-one-digit ints.
+            DEOPT_IF(((size_t)Py_SIZE(sub)) > 1, STORE_SUBSCR);
+            Py_ssize_t index = ((PyLongObject*)sub)->ob_digit[0];
+            // Ensure index < len(array)
+            DEOPT_IF(index >= Py_SIZE(array), STORE_SUBSCR);
+            STAT_INC(STORE_SUBSCR, hit);
+
+            // The array module still converts and range-checks the value.
+            int err = tp->tp_as_sequence->sq_ass_item(array, index, value);
+            STACK_SHRINK(3);
+            Py_DECREF(value);
+            _Py_DECREF_SPECIALIZED(sub, (destructor)PyObject_Free);
+            Py_DECREF(array);
+            if (err != 0) {
+                goto error;
+            }
+            JUMPBY(INLINE_CACHE_ENTRIES_STORE_SUBSCR);
+            DISPATCH();
+        }
+
         TARGET(DELETE_SUBSCR) {
             PyObject *sub = TOP();
             PyObject *container = SECOND();
@@ -3042,7 +3336,9 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             _PyAttrCache *cache = (_PyAttrCache *)next_instr;
             uint32_t type_version = read_u32(cache->version);
             assert(type_version != 0);
-            DEOPT_IF(tp->tp_version_tag != type_version, LOAD_ATTR);
+            if (tp->tp_version_tag != type_version) {
+                goto load_attr_slot_poly_miss;
+            }
             char *addr = (char *)owner + cache->index;
             res = *(PyObject **)addr;
             DEOPT_IF(res == NULL, LOAD_ATTR);
@@ -3056,6 +3352,119 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(LOAD_ATTR_SLOT_POLY) {
+            assert(cframe.use_tracing == 0);
+            PyObject *owner = TOP();
+            PyObject *res;
+            uint32_t tp_version = Py_TYPE(owner)->tp_version_tag;
+            _PyAttrCache *cache = (_PyAttrCache *)next_instr;
+            struct attr_poly_cache_entry *entry =
+                &tstate->interp->types.attr_poly_caches.entries[cache->index];
+            Py_ssize_t offset = 0;
+            if (entry->site == next_instr - 1) {
+                for (int i = 0; i < ATTR_POLY_CACHE_SIZE; i++) {
+                    if (entry->versions[i] == tp_version) {
+                        offset = entry->offsets[i];
+                        break;
+                    }
+                }
+            }
+            if (offset == 0) {
+                goto load_attr_slot_poly_miss;
+            }
+            res = *(PyObject **)((char *)owner + offset);
+            DEOPT_IF(res == NULL, LOAD_ATTR);
+            STAT_INC(LOAD_ATTR, hit);
+            Py_INCREF(res);
+            SET_TOP(NULL);
+            STACK_GROW((oparg & 1));
+            SET_TOP(res);
+            Py_DECREF(owner);
+            JUMPBY(INLINE_CACHE_ENTRIES_LOAD_ATTR);
+            DISPATCH();
+        }
+
+        TARGET(LOAD_ATTR_MEGAMORPHIC) {
+            assert(cframe.use_tracing == 0);
+            PyObject *owner = TOP();
+            PyObject *name = GETITEM(names, oparg>>1);
+            PyTypeObject *tp = Py_TYPE(owner);
+            struct mega_attr_cache_entry *entry = _PyMegaAttrCache_Entry(
+                &tstate->interp->types.mega_attr_cache, tp->tp_version_tag, name);
+            if (entry->version != tp->tp_version_tag || entry->name != name) {
+                entry = _PyMegaAttrCache_Fill(tp, name);
+                if (entry == NULL) {
+                    JUMP_TO_INSTRUCTION(LOAD_ATTR);
+                }
+            }
+            PyObject *res;
+            switch (entry->kind) {
+                case MEGA_ATTR_SLOT:
+                    res = *(PyObject **)((char *)owner + entry->index);
+                    break;
+                case MEGA_ATTR_INSTANCE_VALUE:
+                {
+                    PyDictOrValues dorv = *_PyObject_DictOrValuesPointer(owner);
+                    if (!_PyDictOrValues_IsValues(dorv)) {
+                        JUMP_TO_INSTRUCTION(LOAD_ATTR);
+                    }
+                    res = _PyDictOrValues_GetValues(dorv)->values[entry->index];
+                    break;
+                }
+                case MEGA_ATTR_METHOD_WITH_VALUES:
+                {
+                    if ((oparg & 1) == 0) {
+                        JUMP_TO_INSTRUCTION(LOAD_ATTR);
+                    }
+                    PyDictOrValues dorv = *_PyObject_DictOrValuesPointer(owner);
+                    if (!_PyDictOrValues_IsValues(dorv)) {
+                        JUMP_TO_INSTRUCTION(LOAD_ATTR);
+                    }
+                    PyHeapTypeObject *heap_type = (PyHeapTypeObject *)tp;
+                    if (heap_type->ht_cached_keys->dk_version != entry->keys_version) {
+                        /* The keys changed: analyze them again next time */
+                        _PyMegaAttrCache_Fill(tp, name);
+                        JUMP_TO_INSTRUCTION(LOAD_ATTR);
+                    }
+                }
+                /* fall through */
+                case MEGA_ATTR_METHOD:
+                    if ((oparg & 1) == 0) {
+                        JUMP_TO_INSTRUCTION(LOAD_ATTR);
+                    }
+                    STAT_INC(LOAD_ATTR, hit);
+                    res = entry->descr;
+                    assert(res != NULL);
+                    SET_TOP(Py_NewRef(res));
+                    PUSH(owner);
+                    JUMPBY(INLINE_CACHE_ENTRIES_LOAD_ATTR);
+                    DISPATCH();
+                default:
+                    JUMP_TO_INSTRUCTION(LOAD_ATTR);
+            }
+            if (res == NULL) {
+                JUMP_TO_INSTRUCTION(LOAD_ATTR);
+            }
+            STAT_INC(LOAD_ATTR, hit);
+            Py_INCREF(res);
+            SET_TOP(NULL);
+            STACK_GROW((oparg & 1));
+            SET_TOP(res);
+            Py_DECREF(owner);
+            JUMPBY(INLINE_CACHE_ENTRIES_LOAD_ATTR);
+            DISPATCH();
+        }
+
+        load_attr_slot_poly_miss:
+        {
+            PyObject *name = GETITEM(names, oparg>>1);
+            if (_Py_Specialize_LoadAttrPoly(TOP(), next_instr - 1, name)) {
+                next_instr--;
+                DISPATCH_SAME_OPARG();
+            }
+            goto miss;
+        }
+
         TARGET(LOAD_ATTR_CLASS) {
             assert(cframe.use_tracing == 0);
             _PyLoadMethodCache *cache = (_PyLoadMethodCache *)next_instr;
@@ -3259,7 +3668,9 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             _PyAttrCache *cache = (_PyAttrCache *)next_instr;
             uint32_t type_version = read_u32(cache->version);
             assert(type_version != 0);
-            DEOPT_IF(tp->tp_version_tag != type_version, STORE_ATTR);
+            if (tp->tp_version_tag != type_version) {
+                goto store_attr_slot_poly_miss;
+            }
             char *addr = (char *)owner + cache->index;
             STAT_INC(STORE_ATTR, hit);
             STACK_SHRINK(1);
@@ -3272,19 +3683,60 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
-        TARGET(COMPARE_OP) {
-            PREDICTED(COMPARE_OP);
-            assert(oparg <= Py_GE);
-            PyObject *right = POP();
-            PyObject *left = TOP();
-            PyObject *res = PyObject_RichCompare(left, right, oparg);
-            SET_TOP(res);
-            Py_DECREF(left);
-            Py_DECREF(right);
-            if (res == NULL) {
-                goto error;
+        TARGET(STORE_ATTR_SLOT_POLY) {
+            assert(cframe.use_tracing == 0);
+            PyObject *owner = TOP();
+            uint32_t tp_version = Py_TYPE(owner)->tp_version_tag;
+            _PyAttrCache *cache = (_PyAttrCache *)next_instr;
+            struct attr_poly_cache_entry *entry =
+                &tstate->interp->types.attr_poly_caches.entries[cache->index];
+            Py_ssize_t offset = 0;
+            if (entry->site == next_instr - 1) {
+                for (int i = 0; i < ATTR_POLY_CACHE_SIZE; i++) {
+                    if (entry->versions[i] == tp_version) {
+                        offset = entry->offsets[i];
+                        break;
+                    }
+                }
             }
-            JUMPBY(INLINE_CACHE_ENTRIES_COMPARE_OP);
+            if (offset == 0) {
+                goto store_attr_slot_poly_miss;
+            }
+            char *addr = (char *)owner + offset;
+            STAT_INC(STORE_ATTR, hit);
+            STACK_SHRINK(1);
+            PyObject *value = POP();
+            PyObject *old_value = *(PyObject **)addr;
+            *(PyObject **)addr = value;
+            Py_XDECREF(old_value);
+            Py_DECREF(owner);
+            JUMPBY(INLINE_CACHE_ENTRIES_STORE_ATTR);
+            DISPATCH();
+        }
+
+        store_attr_slot_poly_miss:
+        {
+            PyObject *name = GETITEM(names, oparg);
+            if (_Py_Specialize_StoreAttrPoly(TOP(), next_instr - 1, name)) {
+                next_instr--;
+                DISPATCH_SAME_OPARG();
+            }
+            goto miss;
+        }
+
+        TARGET(COMPARE_OP) {
+            PREDICTED(COMPARE_OP);
+            assert((oparg & ~COMPARE_BORROWED) <= Py_GE);
+            PyObject *right = POP();
+            PyObject *left = TOP();
+            PyObject *res = PyObject_RichCompare(left, right,
+                                                 oparg & ~COMPARE_BORROWED);
+            SET_TOP(res);
+            DECREF_COMPARE_OPERANDS(oparg, Py_DECREF(left), Py_DECREF(right));
+            if (res == NULL) {
+                goto error;
+            }
+            JUMPBY(INLINE_CACHE_ENTRIES_COMPARE_OP);
             DISPATCH();
         }
 
@@ -3320,11 +3772,13 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DEOPT_IF(isnan(dleft), COMPARE_OP);
             DEOPT_IF(isnan(dright), COMPARE_OP);
             STAT_INC(COMPARE_OP, hit);
+            int borrowed = oparg & COMPARE_BORROWED;
             JUMPBY(INLINE_CACHE_ENTRIES_COMPARE_OP);
             NEXTOPARG();
             STACK_SHRINK(2);
-            _Py_DECREF_SPECIALIZED(left, _PyFloat_ExactDealloc);
-            _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc);
+            DECREF_COMPARE_OPERANDS(borrowed,
+                _Py_DECREF_SPECIALIZED(left, _PyFloat_ExactDealloc),
+                _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc));
             assert(opcode == POP_JUMP_IF_FALSE || opcode == POP_JUMP_IF_TRUE);
             int jump = (1 << (sign + 1)) & when_to_jump_mask;
             if (!jump) {
@@ -3352,11 +3806,13 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             Py_ssize_t ileft = Py_SIZE(left) * ((PyLongObject *)left)->ob_digit[0];
             Py_ssize_t iright = Py_SIZE(right) * ((PyLongObject *)right)->ob_digit[0];
             int sign = (ileft > iright) - (ileft < iright);
+            int borrowed = oparg & COMPARE_BORROWED;
             JUMPBY(INLINE_CACHE_ENTRIES_COMPARE_OP);
             NEXTOPARG();
             STACK_SHRINK(2);
-            _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free);
-            _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free);
+            DECREF_COMPARE_OPERANDS(borrowed,
+                _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free),
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free));
             assert(opcode == POP_JUMP_IF_FALSE || opcode == POP_JUMP_IF_TRUE);
             int jump = (1 << (sign + 1)) & when_to_jump_mask;
             if (!jump) {
@@ -3382,13 +3838,16 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             if (res < 0) {
                 goto error;
             }
-            assert(oparg == Py_EQ || oparg == Py_NE);
+            int borrowed = oparg & COMPARE_BORROWED;
+            assert((oparg & ~COMPARE_BORROWED) == Py_EQ ||
+                   (oparg & ~COMPARE_BORROWED) == Py_NE);
             JUMPBY(INLINE_CACHE_ENTRIES_COMPARE_OP);
             NEXTOPARG();
             assert(opcode == POP_JUMP_IF_FALSE || opcode == POP_JUMP_IF_TRUE);
             STACK_SHRINK(2);
-            _Py_DECREF_SPECIALIZED(left, _PyUnicode_ExactDealloc);
-            _Py_DECREF_SPECIALIZED(right, _PyUnicode_ExactDealloc);
+            DECREF_COMPARE_OPERANDS(borrowed,
+                _Py_DECREF_SPECIALIZED(left, _PyUnicode_ExactDealloc),
+                _Py_DECREF_SPECIALIZED(right, _PyUnicode_ExactDealloc));
             assert(res == 0 || res == 1);
             assert(invert == 0 || invert == 1);
             int jump = res ^ invert;
@@ -3414,6 +3873,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
         }
 
         TARGET(CONTAINS_OP) {
+            PREDICTED(CONTAINS_OP);
             PyObject *right = POP();
             PyObject *left = POP();
             int res = PySequence_Contains(right, left);
@@ -3425,6 +3885,82 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             PyObject *b = (res^oparg) ? Py_True : Py_False;
             Py_INCREF(b);
             PUSH(b);
+            JUMPBY(INLINE_CACHE_ENTRIES_CONTAINS_OP);
+            DISPATCH();
+        }
+
+        TARGET(CONTAINS_OP_ADAPTIVE) {
+            assert(cframe.use_tracing == 0);
+            _PyContainsOpCache *cache = (_PyContainsOpCache *)next_instr;
+            if (ADAPTIVE_COUNTER_IS_ZERO(cache)) {
+                PyObject *right = TOP();
+                PyObject *left = SECOND();
+                next_instr--;
+                _Py_Specialize_ContainsOp(left, right, next_instr);
+                DISPATCH_SAME_OPARG();
+            }
+            else {
+                STAT_INC(CONTAINS_OP, deferred);
+                DECREMENT_ADAPTIVE_COUNTER(cache);
+                JUMP_TO_INSTRUCTION(CONTAINS_OP);
+            }
+        }
+
+        /* The dict and set lookups use the hash cached in exact str keys,
+           so "name in d" hashes nothing once "name" has been hashed. */
+        TARGET(CONTAINS_OP_DICT) {
+            assert(cframe.use_tracing == 0);
+            PyObject *dict = TOP();
+            PyObject *key = SECOND();
+            DEOPT_IF(!PyDict_CheckExact(dict), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyDict_Contains(dict, key);
+            if (res < 0) {
+                goto error;
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(dict);
+            Py_DECREF(key);
+            SET_TOP(Py_NewRef((res^oparg) ? Py_True : Py_False));
+            JUMPBY(INLINE_CACHE_ENTRIES_CONTAINS_OP);
+            DISPATCH();
+        }
+
+        TARGET(CONTAINS_OP_SET) {
+            assert(cframe.use_tracing == 0);
+            PyObject *set = TOP();
+            PyObject *key = SECOND();
+            DEOPT_IF(!PyAnySet_CheckExact(set), CONTAINS_OP);
+            DEOPT_IF(PySet_Check(key), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PySet_Contains(set, key);
+            if (res < 0) {
+                goto error;
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(set);
+            Py_DECREF(key);
+            SET_TOP(Py_NewRef((res^oparg) ? Py_True : Py_False));
+            JUMPBY(INLINE_CACHE_ENTRIES_CONTAINS_OP);
+            DISPATCH();
+        }
+
+        TARGET(CONTAINS_OP_STR) {
+            assert(cframe.use_tracing == 0);
+            PyObject *str = TOP();
+            PyObject *sub = SECOND();
+            DEOPT_IF(!PyUnicode_CheckExact(str), CONTAINS_OP);
+            DEOPT_IF(!PyUnicode_CheckExact(sub), CONTAINS_OP);
+            STAT_INC(CONTAINS_OP, hit);
+            int res = PyUnicode_Contains(str, sub);
+            if (res < 0) {
+                goto error;
+            }
+            STACK_SHRINK(1);
+            _Py_DECREF_SPECIALIZED(str, _PyUnicode_ExactDealloc);
+            _Py_DECREF_SPECIALIZED(sub, _PyUnicode_ExactDealloc);
+            SET_TOP(Py_NewRef((res^oparg) ? Py_True : Py_False));
+            JUMPBY(INLINE_CACHE_ENTRIES_CONTAINS_OP);
             DISPATCH();
         }
 
@@ -3610,6 +4146,60 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(POP_JUMP_IF_FALSE_BORROW) {
+            PyObject *cond = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (Py_IsFalse(cond)) {
+                JUMPBY(oparg);
+            }
+            else if (!Py_IsTrue(cond)) {
+                int err = PyObject_IsTrue(cond);
+                if (err == 0) {
+                    JUMPBY(oparg);
+                }
+                else if (err < 0) {
+                    goto error;
+                }
+            }
+            DISPATCH();
+        }
+
+        TARGET(POP_JUMP_IF_TRUE_BORROW) {
+            PyObject *cond = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (Py_IsTrue(cond)) {
+                JUMPBY(oparg);
+            }
+            else if (!Py_IsFalse(cond)) {
+                int err = PyObject_IsTrue(cond);
+                if (err > 0) {
+                    JUMPBY(oparg);
+                }
+                else if (err < 0) {
+                    goto error;
+                }
+            }
+            DISPATCH();
+        }
+
+        TARGET(POP_JUMP_IF_NOTNONE_BORROW) {
+            PyObject *value = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (!Py_IsNone(value)) {
+                JUMPBY(oparg);
+            }
+            DISPATCH();
+        }
+
+        TARGET(POP_JUMP_IF_NONE_BORROW) {
+            PyObject *value = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (Py_IsNone(value)) {
+                JUMPBY(oparg);
+            }
+            DISPATCH();
+        }
+
         TARGET(JUMP_IF_FALSE_OR_POP) {
             PyObject *cond = TOP();
             int err;
@@ -3674,6 +4264,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             assert(oparg < INSTR_OFFSET());
             JUMPBY(-oparg);
             CHECK_EVAL_BREAKER();
+            JIT_ENTER();
             DISPATCH();
         }
 
@@ -3801,6 +4392,9 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
                 JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER);
                 DISPATCH();
             }
+        /* Specialized forms that call into the iterator jump here when it
+           returns nothing, with the iterator still on top of the stack. */
+        for_iter_end:
             if (_PyErr_Occurred(tstate)) {
                 if (!_PyErr_ExceptionMatches(tstate, PyExc_StopIteration)) {
                     goto error;
@@ -3811,7 +4405,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
                 _PyErr_Clear(tstate);
             }
             /* iterator ended normally */
-            STACK_SHRINK(1);
+            iter = POP();
             Py_DECREF(iter);
             JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER + oparg);
             DISPATCH();
@@ -3855,6 +4449,144 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             DISPATCH();
         }
 
+        TARGET(FOR_ITER_TUPLE) {
+            assert(cframe.use_tracing == 0);
+            _PyTupleIterObject *it = (_PyTupleIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyTupleIter_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            PyTupleObject *seq = it->it_seq;
+            if (seq) {
+                if (it->it_index < PyTuple_GET_SIZE(seq)) {
+                    PyObject *next = PyTuple_GET_ITEM(seq, it->it_index++);
+                    Py_INCREF(next);
+                    PUSH(next);
+                    JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER);
+                    DISPATCH();
+                }
+                it->it_seq = NULL;
+                Py_DECREF(seq);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(it);
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER + oparg);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_STR) {
+            assert(cframe.use_tracing == 0);
+            _PyUnicodeIterObject *it = (_PyUnicodeIterObject *)TOP();
+            DEOPT_IF(Py_TYPE(it) != &_PyUnicodeASCIIIter_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            PyObject *seq = it->it_seq;
+            if (seq) {
+                assert(PyUnicode_IS_COMPACT_ASCII(seq));
+                if (it->it_index < PyUnicode_GET_LENGTH(seq)) {
+                    Py_UCS1 chr = PyUnicode_1BYTE_DATA(seq)[it->it_index++];
+                    PyObject *next = (PyObject *)&_Py_SINGLETON(strings).ascii[chr];
+                    Py_INCREF(next);
+                    PUSH(next);
+                    JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER);
+                    DISPATCH();
+                }
+                it->it_seq = NULL;
+                Py_DECREF(seq);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(it);
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER + oparg);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_DICT_KEYS) {
+            assert(cframe.use_tracing == 0);
+            PyObject *it = TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyDictIterKey_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            PyObject *key, *value;
+            if (!_PyDictIter_NextEntry(it, &key, &value)) {
+                goto for_iter_end;
+            }
+            Py_INCREF(key);
+            PUSH(key);
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_DICT_VALUES) {
+            assert(cframe.use_tracing == 0);
+            PyObject *it = TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyDictIterValue_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            PyObject *key, *value;
+            if (!_PyDictIter_NextEntry(it, &key, &value)) {
+                goto for_iter_end;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER);
+            DISPATCH();
+        }
+
+        /* The following specializations also perform the UNPACK_SEQUENCE 2
+           that follows them, pushing both items without creating a tuple. */
+
+        TARGET(FOR_ITER_DICT_ITEMS) {
+            assert(cframe.use_tracing == 0);
+            PyObject *it = TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyDictIterItem_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            assert(_PyOpcode_Deopt[_Py_OPCODE(next_instr[INLINE_CACHE_ENTRIES_FOR_ITER])] == UNPACK_SEQUENCE);
+            PyObject *key, *value;
+            if (!_PyDictIter_NextEntry(it, &key, &value)) {
+                goto for_iter_end;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            Py_INCREF(key);
+            PUSH(key);
+            // The UNPACK_SEQUENCE is already done.
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER + 1 +
+                   INLINE_CACHE_ENTRIES_UNPACK_SEQUENCE);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_ENUMERATE) {
+            assert(cframe.use_tracing == 0);
+            PyObject *it = TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyEnum_Type, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            assert(_PyOpcode_Deopt[_Py_OPCODE(next_instr[INLINE_CACHE_ENTRIES_FOR_ITER])] == UNPACK_SEQUENCE);
+            PyObject *index, *item;
+            if (!_PyEnum_NextPair(it, &index, &item)) {
+                goto for_iter_end;
+            }
+            PUSH(item);
+            PUSH(index);
+            // The UNPACK_SEQUENCE is already done.
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER + 1 +
+                   INLINE_CACHE_ENTRIES_UNPACK_SEQUENCE);
+            DISPATCH();
+        }
+
+        TARGET(FOR_ITER_ZIP) {
+            assert(cframe.use_tracing == 0);
+            PyObject *it = TOP();
+            DEOPT_IF(Py_TYPE(it) != &PyZip_Type, FOR_ITER);
+            DEOPT_IF(((_PyZipObject *)it)->tuplesize != 2, FOR_ITER);
+            STAT_INC(FOR_ITER, hit);
+            assert(_PyOpcode_Deopt[_Py_OPCODE(next_instr[INLINE_CACHE_ENTRIES_FOR_ITER])] == UNPACK_SEQUENCE);
+            PyObject *first, *second;
+            if (!_PyZip_NextPair(it, &first, &second)) {
+                goto for_iter_end;
+            }
+            PUSH(second);
+            PUSH(first);
+            // The UNPACK_SEQUENCE is already done.
+            JUMPBY(INLINE_CACHE_ENTRIES_FOR_ITER + 1 +
+                   INLINE_CACHE_ENTRIES_UNPACK_SEQUENCE);
+            DISPATCH();
+        }
+
         TARGET(FOR_ITER_RANGE) {
             assert(cframe.use_tracing == 0);
             _PyRangeIterObject *r = (_PyRangeIterObject *)TOP();
@@ -4284,6 +5016,64 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             goto start_frame;
         }
 
+        TARGET(CALL_PY_WITH_KWARGS) {
+            assert(call_shape.kwnames != NULL);
+            DEOPT_IF(tstate->interp->eval_frame, CALL);
+            _PyCallCache *cache = (_PyCallCache *)next_instr;
+            uint16_t layout = cache->min_args;
+            int is_meth = is_method(stack_pointer, oparg);
+            DEOPT_IF(is_meth != ((layout & CALL_KW_IS_METH) != 0), CALL);
+            int argcount = oparg + is_meth;
+            PyObject *callable = PEEK(argcount + 1);
+            DEOPT_IF(!PyFunction_Check(callable), CALL);
+            PyFunctionObject *func = (PyFunctionObject *)callable;
+            DEOPT_IF(func->func_version != read_u32(cache->func_version), CALL);
+            PyCodeObject *code = (PyCodeObject *)func->func_code;
+            DEOPT_IF(!_PyThreadState_HasStackSpace(tstate, code->co_framesize), CALL);
+            STAT_INC(CALL, hit);
+            // The keyword names are a constant of the call site, so the
+            // layout checked by the specializer still applies.
+            int kwcount = (int)PyTuple_GET_SIZE(call_shape.kwnames);
+            int positional = argcount - kwcount;
+            call_shape.kwnames = NULL;
+            _PyInterpreterFrame *new_frame = _PyFrame_PushUnchecked(tstate, func);
+            CALL_STAT_INC(inlined_py_calls);
+            STACK_SHRINK(argcount);
+            PyObject **localsplus = new_frame->localsplus;
+            for (int i = 0; i < code->co_nlocalsplus; i++) {
+                localsplus[i] = NULL;
+            }
+            for (int i = 0; i < positional; i++) {
+                localsplus[i] = stack_pointer[i];
+            }
+            for (int i = 0; i < kwcount; i++) {
+                int index = _PyCallCache_KwIndex(layout, i);
+                assert(localsplus[index] == NULL);
+                localsplus[index] = stack_pointer[positional + i];
+            }
+            // Whatever is left has a positional default
+            int mindefault = code->co_argcount;
+            if (func->func_defaults != NULL) {
+                mindefault -= (int)PyTuple_GET_SIZE(func->func_defaults);
+            }
+            for (int i = positional; i < code->co_argcount; i++) {
+                if (localsplus[i] == NULL) {
+                    assert(i >= mindefault);
+                    PyObject *def = PyTuple_GET_ITEM(func->func_defaults,
+                                                     i - mindefault);
+                    Py_INCREF(def);
+                    localsplus[i] = def;
+                }
+            }
+            STACK_SHRINK(2-is_meth);
+            _PyFrame_SetStackPointer(frame, stack_pointer);
+            JUMPBY(INLINE_CACHE_ENTRIES_CALL);
+            frame->prev_instr = next_instr - 1;
+            new_frame->previous = frame;
+            frame = cframe.current_frame = new_frame;
+            goto start_frame;
+        }
+
         TARGET(CALL_NO_KW_TYPE_1) {
             assert(call_shape.kwnames == NULL);
             assert(cframe.use_tracing == 0);
@@ -4732,7 +5522,21 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
                     Py_DECREF(kwargs);
                     kwargs = d;
                 }
-                assert(PyDict_CheckExact(kwargs));
+                else if (oparg & 0x02) {
+                    /* kwargs is the caller's own dict (f(*args, **kw)): it
+                       is only unpacked by Python functions and vectorcall,
+                       other callables get a copy as with DICT_MERGE. */
+                    if (PyDict_GET_SIZE(kwargs) == 0) {
+                        Py_CLEAR(kwargs);
+                    }
+                    else if (_PyVectorcall_Function(TOP()) == NULL) {
+                        Py_SETREF(kwargs, PyDict_Copy(kwargs));
+                        if (kwargs == NULL) {
+                            goto error;
+                        }
+                    }
+                }
+                assert(kwargs == NULL || PyDict_CheckExact(kwargs));
             }
             callargs = POP();
             func = TOP();
@@ -4748,6 +5552,28 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             }
             assert(PyTuple_CheckExact(callargs));
 
+            // Push Python functions as a new frame, like CALL does
+            if (Py_IS_TYPE(func, &PyFunction_Type) &&
+                tstate->interp->eval_frame == NULL &&
+                ((PyFunctionObject *)func)->vectorcall == _PyFunction_Vectorcall)
+            {
+                int code_flags = ((PyCodeObject*)PyFunction_GET_CODE(func))->co_flags;
+                PyObject *locals = code_flags & CO_OPTIMIZED ? NULL : Py_NewRef(PyFunction_GET_GLOBALS(func));
+                // The frame steals func, so pop it and the NULL below it
+                STACK_SHRINK(2);
+                _PyInterpreterFrame *new_frame = _PyEvalFramePushAndInit_Ex(
+                    tstate, (PyFunctionObject *)func, locals, callargs, kwargs);
+                if (new_frame == NULL) {
+                    goto error;
+                }
+                _PyFrame_SetStackPointer(frame, stack_pointer);
+                frame->prev_instr = next_instr - 1;
+                new_frame->previous = frame;
+                cframe.current_frame = frame = new_frame;
+                CALL_STAT_INC(inlined_py_calls);
+                goto start_frame;
+            }
+
             result = do_call_core(tstate, func, callargs, kwargs, cframe.use_tracing);
             Py_DECREF(func);
             Py_DECREF(callargs);
@@ -4965,6 +5791,9 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             // We might be tracing. To avoid breaking tracing guarantees in
             // quickened instructions, always deoptimize the next opcode:
             opcode = _PyOpcode_Deopt[_Py_OPCODE(*next_instr)];
+            if (cframe.use_tracing) {
+                UNBORROW_OPCODE();
+            }
             PRE_DISPATCH_GOTO();
             // CPython hasn't traced the following instruction historically
             // (DO_TRACING would clobber our extended oparg anyways), so just
@@ -4996,6 +5825,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
     {
         assert(cframe.use_tracing);
         assert(tstate->tracing == 0);
+        int was_tracing = cframe.use_tracing;
         if (INSTR_OFFSET() >= frame->f_code->_co_firsttraceable) {
             int instr_prev = _PyInterpreterFrame_LASTI(frame);
             frame->prev_instr = next_instr;
@@ -5047,6 +5877,33 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
             }
         }
         TRACING_NEXTOPARG();
+        if (cframe.use_tracing) {
+            UNBORROW_OPCODE();
+        }
+        else if (was_tracing && FOLLOWS_BORROWING_LOAD()) {
+            /* The trace function turned tracing off after the previous
+               load took a strong reference.  The rest of its window won't
+               come through here, so finish it with strong references. */
+            if (IS_BORROWING_LOAD(opcode)) {
+                /* The second operand of a COMPARE_OP */
+                PyObject *value = opcode == LOAD_FAST_BORROW ?
+                    GETLOCAL(oparg) : GETITEM(consts, oparg);
+                frame->prev_instr = next_instr++;
+                if (value == NULL) {
+                    goto unbound_local_error;
+                }
+                Py_INCREF(value);
+                PUSH(value);
+                TRACING_NEXTOPARG();
+            }
+            while (opcode == EXTENDED_ARG) {
+                int oldoparg = oparg;
+                next_instr++;
+                TRACING_NEXTOPARG();
+                oparg |= oldoparg << 8;
+            }
+            UNBORROW_OPCODE();
+        }
         PRE_DISPATCH_GOTO();
         DISPATCH_GOTO();
     }
@@ -5080,17 +5937,31 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, _PyInterpreterFrame *frame, int
         /* The counter is always the first cache entry: */
         _Py_CODEUNIT *counter = (_Py_CODEUNIT *)next_instr;
         *counter -= 1;
-        if (*counter == 0) {
+        if ((*counter & ((1 << MISS_COUNTER_BITS) - 1)) == 0) {
             int adaptive_opcode = _PyOpcode_Adaptive[opcode];
             assert(adaptive_opcode);
+            ATTR_SITE_STAT(_Py_OPCODE(next_instr[-1]), adaptive_opcode);
             _Py_SET_OPCODE(next_instr[-1], adaptive_opcode);
             STAT_INC(opcode, deopt);
-            *counter = adaptive_counter_start();
+            *counter = miss_counter_deopt(*counter);
         }
         next_instr--;
         DISPATCH_GOTO();
     }
 
+unbound_borrowed_local_error:
+        {
+            /* If this is the second operand of a COMPARE_OP, the first one
+               is borrowed as well: drop it from the stack without a decref.
+               The compiler doesn't give such loads an EXTENDED_ARG. */
+            if (INSTR_OFFSET() >= 2 &&
+                IS_BORROWING_LOAD(_PyOpcode_Deopt[_Py_OPCODE(next_instr[-2])]))
+            {
+                STACK_SHRINK(1);
+            }
+            goto unbound_local_error;
+        }
+
 unbound_local_error:
         {
             format_exc_check_arg(tstate, PyExc_UnboundLocalError,
@@ -5752,6 +6623,124 @@ _PyEvalFramePushAndInit(PyThreadState *tstate, PyFunctionObject *func,
     return NULL;
 }
 
+/* Push a frame for a function whose only parameters are *args and maybe
+   **kwargs.  The callargs tuple becomes *args, and the kwargs dict becomes
+   **kwargs if no one else refers to it, otherwise a copy of it does.
+   Steals the reference to func and consumes the references to locals,
+   callargs and kwargs (which is NULL for no keyword arguments). */
+static _PyInterpreterFrame *
+push_and_init_forwarding(PyThreadState *tstate, PyFunctionObject *func,
+                         PyObject *locals, PyObject *callargs,
+                         PyObject *kwargs)
+{
+    PyCodeObject *code = (PyCodeObject *)func->func_code;
+    PyObject *kwdict = NULL;
+    if (code->co_flags & CO_VARKEYWORDS) {
+        if (kwargs == NULL) {
+            kwdict = PyDict_New();
+        }
+        else if (Py_REFCNT(kwargs) == 1) {
+            kwdict = kwargs;
+            kwargs = NULL;
+        }
+        else {
+            kwdict = PyDict_Copy(kwargs);
+        }
+        if (kwdict == NULL) {
+            goto error;
+        }
+        if (PyDict_GET_SIZE(kwdict) && !_PyDict_HasOnlyStringKeys(kwdict)) {
+            /* Same error as _PyStack_UnpackDict() */
+            _PyErr_SetString(tstate, PyExc_TypeError,
+                             "keywords must be strings");
+            goto error;
+        }
+    }
+    assert(kwargs == NULL || kwdict != NULL);
+    CALL_STAT_INC(frames_pushed);
+    _PyInterpreterFrame *frame = _PyThreadState_PushFrame(tstate, code->co_framesize);
+    if (frame == NULL) {
+        PyErr_NoMemory();
+        goto error;
+    }
+    _PyFrame_InitializeSpecials(frame, func, locals, code);
+    PyObject **localsarray = &frame->localsplus[0];
+    for (int i = 0; i < code->co_nlocalsplus; i++) {
+        localsarray[i] = NULL;
+    }
+    localsarray[0] = callargs;
+    if (kwdict != NULL) {
+        localsarray[1] = kwdict;
+    }
+    Py_XDECREF(kwargs);
+    return frame;
+
+error:
+    Py_XDECREF(kwdict);
+    Py_DECREF(func);
+    Py_XDECREF(locals);
+    Py_DECREF(callargs);
+    Py_XDECREF(kwargs);
+    return NULL;
+}
+
+/* Same as _PyEvalFramePushAndInit but takes the arguments as a tuple and an
+   optional dict, as used by CALL_FUNCTION_EX. Steals the reference to func
+   and consumes the references to callargs and kwargs. */
+static _PyInterpreterFrame *
+_PyEvalFramePushAndInit_Ex(PyThreadState *tstate, PyFunctionObject *func,
+                           PyObject *locals, PyObject *callargs,
+                           PyObject *kwargs)
+{
+    assert(PyTuple_CheckExact(callargs));
+    assert(kwargs == NULL || PyDict_CheckExact(kwargs));
+    Py_ssize_t nargs = PyTuple_GET_SIZE(callargs);
+    bool has_dict = (kwargs != NULL && PyDict_GET_SIZE(kwargs) > 0);
+    PyCodeObject *code = (PyCodeObject *)func->func_code;
+    if (code->co_argcount == 0 && code->co_kwonlyargcount == 0
+        && (code->co_flags & CO_VARARGS)
+        && (!has_dict || (code->co_flags & CO_VARKEYWORDS)))
+    {
+        /* A forwarding function: callargs is *args, kwargs is **kwargs */
+        if (!has_dict) {
+            Py_XDECREF(kwargs);
+            kwargs = NULL;
+        }
+        return push_and_init_forwarding(tstate, func, locals, callargs,
+                                        kwargs);
+    }
+    PyObject *kwnames = NULL;
+    PyObject *const *newargs;
+    if (has_dict) {
+        newargs = _PyStack_UnpackDict(tstate, _PyTuple_ITEMS(callargs),
+                                      nargs, kwargs, &kwnames);
+        if (newargs == NULL) {
+            Py_DECREF(func);
+            Py_XDECREF(locals);
+            goto error;
+        }
+    }
+    else {
+        newargs = _PyTuple_ITEMS(callargs);
+        /* The new frame steals the references to the arguments */
+        for (Py_ssize_t i = 0; i < nargs; i++) {
+            Py_INCREF(newargs[i]);
+        }
+    }
+    _PyInterpreterFrame *new_frame = _PyEvalFramePushAndInit(
+        tstate, func, locals, newargs, nargs, kwnames);
+    if (has_dict) {
+        _PyStack_UnpackDict_FreeNoDecRef(newargs, kwnames);
+    }
+    Py_DECREF(callargs);
+    Py_XDECREF(kwargs);
+    return new_frame;
+error:
+    Py_DECREF(callargs);
+    Py_XDECREF(kwargs);
+    return NULL;
+}
+
 static void
 _PyEvalFrameClearAndPop(PyThreadState *tstate, _PyInterpreterFrame * frame)
 {
@@ -5801,6 +6790,33 @@ _PyEval_Vector(PyThreadState *tstate, PyFunctionObject *func,
     return retval;
 }
 
+/* Same as _PyEval_Vector but takes the arguments as a tuple and an optional
+   dict, which can become the *args and **kwargs of a forwarding function. */
+PyObject *
+_PyEval_Vector_Ex(PyThreadState *tstate, PyFunctionObject *func,
+                  PyObject *locals, PyObject *callargs, PyObject *kwargs)
+{
+    /* _PyEvalFramePushAndInit_Ex consumes the references
+     * to func, locals, callargs and kwargs */
+    Py_INCREF(func);
+    Py_XINCREF(locals);
+    Py_INCREF(callargs);
+    Py_XINCREF(kwargs);
+    _PyInterpreterFrame *frame = _PyEvalFramePushAndInit_Ex(
+        tstate, func, locals, callargs, kwargs);
+    if (frame == NULL) {
+        return NULL;
+    }
+    EVAL_CALL_STAT_INC(EVAL_CALL_VECTOR);
+    PyObject *retval = _PyEval_EvalFrame(tstate, frame, 0);
+    assert(
+        _PyFrame_GetStackPointer(frame) == _PyFrame_Stackbase(frame) ||
+        _PyFrame_GetStackPointer(frame) == frame->localsplus
+    );
+    _PyEvalFrameClearAndPop(tstate, frame);
+    return retval;
+}
+
 /* Legacy API */
 PyObject *
 PyEval_EvalCodeEx(PyObject *_co, PyObject *globals, PyObject *locals,
@@ -0,0 +1,87 @@
+/* Macros shared by the interpreter loop in ceval.c and the stencils of
+   the JIT compiler (Tools/jit/template.c).  They expect "frame",
+   "next_instr" and GETLOCAL() to be defined as in ceval.c, and an "error"
+   label to jump to when an exception has been raised. */
+
+#ifndef Py_CEVAL_MACROS_H
+#define Py_CEVAL_MACROS_H
+
+/* Specialized float and int arithmetic stores its result in an operand
+   that no other code can see, instead of allocating a new object.  That
+   is the case for the intermediate results of an expression such as
+   "a * b + c", so a chain of specialized operations only allocates where
+   the chain ends.  The left operand may also be held by the local that
+   the next instruction overwrites with the result, as in "t = t + x". */
+#define BINARY_OP_LEFT_IS_TEMPORARY(left) \
+    (Py_REFCNT(left) == 1 || \
+     (Py_REFCNT(left) == 2 && \
+      _PyOpcode_Deopt[_Py_OPCODE(next_instr[INLINE_CACHE_ENTRIES_BINARY_OP])] == STORE_FAST && \
+      GETLOCAL(_Py_OPARG(next_instr[INLINE_CACHE_ENTRIES_BINARY_OP])) == (left)))
+
+#define FLOAT_RESULT_REUSING_INPUTS(left, right, dval, result) \
+    do { \
+        if (BINARY_OP_LEFT_IS_TEMPORARY(left)) { \
+            ((PyFloatObject *)(left))->ob_fval = (dval); \
+            _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc); \
+            (result) = (left); \
+        } \
+        else if (Py_REFCNT(right) == 1) { \
+            ((PyFloatObject *)(right))->ob_fval = (dval); \
+            _Py_DECREF_NO_DEALLOC(left); \
+            (result) = (right); \
+        } \
+        else { \
+            (result) = PyFloat_FromDouble(dval); \
+            if ((result) == NULL) { \
+                goto error; \
+            } \
+            _Py_DECREF_NO_DEALLOC(left); \
+            _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc); \
+        } \
+    } while (0)
+
+/* The same for ints of at most one digit, where "op" is the C operator
+   and "slow" the function for all other operands and results. */
+#define INT_RESULT_REUSING_INPUTS(left, right, op, slow, result) \
+    do { \
+        PyLongObject *left_ = (PyLongObject *)(left); \
+        PyLongObject *right_ = (PyLongObject *)(right); \
+        if (_PyLong_IsMedium(left_) && _PyLong_IsMedium(right_)) { \
+            stwodigits value_ = _PyLong_MediumValue(left_) op \
+                                _PyLong_MediumValue(right_); \
+            if (BINARY_OP_LEFT_IS_TEMPORARY(left) && \
+                _PyLong_ReuseMedium(left_, value_)) \
+            { \
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free); \
+                (result) = (left); \
+                break; \
+            } \
+            if (Py_REFCNT(right) == 1 && _PyLong_ReuseMedium(right_, value_)) { \
+                _Py_DECREF_NO_DEALLOC(left); \
+                (result) = (right); \
+                break; \
+            } \
+        } \
+        (result) = slow(left_, right_); \
+        if ((result) == NULL) { \
+            goto error; \
+        } \
+        _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free); \
+        _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free); \
+    } while (0)
+
+/* COMPARE_OP and its specializations release their operands with
+   DECREF_LEFT and DECREF_RIGHT, unless "flags" has COMPARE_BORROWED set. */
+#define DECREF_COMPARE_OPERANDS(flags, DECREF_LEFT, DECREF_RIGHT) \
+    do { \
+        if ((flags) & COMPARE_BORROWED) { \
+            OBJECT_STAT_INC(interpreter_decrefs_avoided); \
+            OBJECT_STAT_INC(interpreter_decrefs_avoided); \
+        } \
+        else { \
+            DECREF_LEFT; \
+            DECREF_RIGHT; \
+        } \
+    } while (0)
+
+#endif  /* !Py_CEVAL_MACROS_H */
@@ -1081,6 +1081,38 @@ sys__debugmallocstats(PyObject *module, PyObject *Py_UNUSED(ignored))
     return sys__debugmallocstats_impl(module);
 }
 
+PyDoc_STRVAR(sys__trim_allocator__doc__,
+"_trim_allocator($module, /)\n"
+"--\n"
+"\n"
+"Return the free memory of pymalloc\'s arenas to the system.\n"
+"\n"
+"Future allocations are also steered away from the sparsest arenas, so\n"
+"that they can be released once their remaining blocks are freed.\n"
+"Return the number of bytes given back.");
+
+#define SYS__TRIM_ALLOCATOR_METHODDEF    \
+    {"_trim_allocator", (PyCFunction)sys__trim_allocator, METH_NOARGS, sys__trim_allocator__doc__},
+
+static size_t
+sys__trim_allocator_impl(PyObject *module);
+
+static PyObject *
+sys__trim_allocator(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    size_t _return_value;
+
+    _return_value = sys__trim_allocator_impl(module);
+    if ((_return_value == (size_t)-1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromSize_t(_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(sys__clear_type_cache__doc__,
 "_clear_type_cache($module, /)\n"
 "--\n"
@@ -1343,4 +1375,4 @@ sys_is_stack_trampoline_active(PyObject *module, PyObject *Py_UNUSED(ignored))
 #ifndef SYS_GETANDROIDAPILEVEL_METHODDEF
     #define SYS_GETANDROIDAPILEVEL_METHODDEF
 #endif /* !defined(SYS_GETANDROIDAPILEVEL_METHODDEF) */
-/*[clinic end generated code: output=15318cdd96b62b06 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=ae75d081a04280ba input=a9049054013a1b77]*/
@@ -1138,6 +1138,10 @@ stack_effect(int opcode, int oparg, int jump)
         case POP_JUMP_IF_NOT_NONE:
         case POP_JUMP_IF_FALSE:
         case POP_JUMP_IF_TRUE:
+        case POP_JUMP_IF_NONE_BORROW:
+        case POP_JUMP_IF_NOTNONE_BORROW:
+        case POP_JUMP_IF_FALSE_BORROW:
+        case POP_JUMP_IF_TRUE_BORROW:
             return -1;
 
         case LOAD_GLOBAL:
@@ -1171,6 +1175,8 @@ stack_effect(int opcode, int oparg, int jump)
 
         case LOAD_FAST:
         case LOAD_FAST_CHECK:
+        case LOAD_FAST_BORROW:
+        case LOAD_CONST_BORROW:
             return 1;
         case STORE_FAST:
             return -1;
@@ -5027,6 +5033,13 @@ compiler_call_helper(struct compiler *c,
         return 0;
     }
     /* Then keyword arguments */
+    if (nkwelts == 1 && ((keyword_ty)asdl_seq_GET(keywords, 0))->arg == NULL) {
+        /* A single **mapping is passed as is, CALL_FUNCTION_EX copies it
+           if needed */
+        VISIT(c, expr, ((keyword_ty)asdl_seq_GET(keywords, 0))->value);
+        ADDOP_I(c, CALL_FUNCTION_EX, 3);
+        return 1;
+    }
     if (nkwelts) {
         /* Has a new dict been pushed */
         int have_dict = 0;
@@ -7982,6 +7995,76 @@ add_checks_for_loads_of_unknown_variables(basicblock *entryblock,
     return 0;
 }
 
+static bool
+can_borrow(struct instr *load, struct instr *consumer)
+{
+    return (load->i_opcode == LOAD_FAST || load->i_opcode == LOAD_CONST) &&
+           load->i_loc.lineno == consumer->i_loc.lineno;
+}
+
+static void
+borrow(struct instr *load)
+{
+    load->i_opcode = load->i_opcode == LOAD_FAST ? LOAD_FAST_BORROW
+                                                 : LOAD_CONST_BORROW;
+}
+
+/* Make loads of locals and constants whose values are consumed right away
+ * push them without a new reference, and their consumers not release it:
+ *
+ *   LOAD_FAST x; POP_JUMP_IF_FALSE
+ *       -> LOAD_FAST_BORROW x; POP_JUMP_IF_FALSE_BORROW
+ *   LOAD_FAST x; LOAD_CONST c; COMPARE_OP <
+ *       -> LOAD_FAST_BORROW x; LOAD_CONST_BORROW c; COMPARE_OP <|COMPARE_BORROWED
+ *
+ * The local keeps the value alive: only LOAD_FAST is borrowed, not
+ * LOAD_FAST_CHECK, and nothing can rebind the local before the consumer
+ * runs, as traced code runs the strong forms instead.  All the
+ * instructions must be on the same line, so that no line event (the only
+ * one that can jump) falls in between.  The consumers
+ * don't keep their operands either, unlike BINARY_OP which may reuse one
+ * for its result.  A second operand can't have an EXTENDED_ARG, so that
+ * the interpreter can tell from the previous instruction whether the
+ * first one is borrowed, if it has to raise UnboundLocalError.
+ */
+static void
+borrow_local_loads(basicblock *entryblock)
+{
+    for (basicblock *b = entryblock; b != NULL; b = b->b_next) {
+        for (int i = 1; i < b->b_iused; i++) {
+            struct instr *instr = &b->b_instr[i];
+            switch (instr->i_opcode) {
+                case POP_JUMP_IF_FALSE:
+                case POP_JUMP_IF_TRUE:
+                case POP_JUMP_IF_NOT_NONE:
+                case POP_JUMP_IF_NONE:
+                    if (!can_borrow(&instr[-1], instr)) {
+                        break;
+                    }
+                    borrow(&instr[-1]);
+                    instr->i_opcode =
+                        instr->i_opcode == POP_JUMP_IF_FALSE ? POP_JUMP_IF_FALSE_BORROW :
+                        instr->i_opcode == POP_JUMP_IF_TRUE ? POP_JUMP_IF_TRUE_BORROW :
+                        instr->i_opcode == POP_JUMP_IF_NOT_NONE ? POP_JUMP_IF_NOTNONE_BORROW :
+                        POP_JUMP_IF_NONE_BORROW;
+                    break;
+                case COMPARE_OP:
+                    if (i < 2 ||
+                        !can_borrow(&instr[-2], instr) ||
+                        !can_borrow(&instr[-1], instr) ||
+                        instr[-1].i_oparg > 0xFF)
+                    {
+                        break;
+                    }
+                    borrow(&instr[-2]);
+                    borrow(&instr[-1]);
+                    instr->i_oparg |= COMPARE_BORROWED;
+                    break;
+            }
+        }
+    }
+}
+
 static PyObject *
 dict_keys_inorder(PyObject *dict, Py_ssize_t offset)
 {
@@ -8654,6 +8737,7 @@ assemble(struct compiler *c, int addNone)
     if (add_checks_for_loads_of_unknown_variables(g->g_entryblock, c) < 0) {
         goto error;
     }
+    borrow_local_loads(g->g_entryblock);
 
     assert(no_redundant_jumps(g));
 
@@ -124,6 +124,10 @@ The following implementation-specific options are available:\n\
     able to report Python calls. This option is only available on some platforms and will \n\
     do nothing if is not supported on the current system. The default value is \"off\".\n\
 \n\
+-X jit=[on|off]: compile hot functions to machine code with the experimental JIT\n\
+    compiler. \"-X jit\" alone means \"on\". This option does nothing unless Python\n\
+    was configured with --enable-experimental-jit. The default value is \"off\".\n\
+\n\
 -X frozen_modules=[on|off]: whether or not frozen modules should be used.\n\
    The default is \"on\" (or \"off\" if you are running a local build).\n\
 \n\
@@ -760,6 +764,7 @@ _PyConfig_InitCompatConfig(PyConfig *config)
     config->faulthandler = -1;
     config->tracemalloc = -1;
     config->perf_profiling = -1;
+    config->jit = -1;
     config->module_search_paths_set = 0;
     config->parse_argv = 0;
     config->site_import = -1;
@@ -849,6 +854,7 @@ PyConfig_InitIsolatedConfig(PyConfig *config)
     config->faulthandler = 0;
     config->tracemalloc = 0;
     config->perf_profiling = 0;
+    config->jit = 0;
     config->safe_path = 1;
     config->pathconfig_warnings = 0;
 #ifdef MS_WINDOWS
@@ -961,6 +967,7 @@ _PyConfig_Copy(PyConfig *config, const PyConfig *config2)
     COPY_ATTR(faulthandler);
     COPY_ATTR(tracemalloc);
     COPY_ATTR(perf_profiling);
+    COPY_ATTR(jit);
     COPY_ATTR(import_time);
     COPY_ATTR(code_debug_ranges);
     COPY_ATTR(show_ref_count);
@@ -1072,6 +1079,7 @@ _PyConfig_AsDict(const PyConfig *config)
     SET_ITEM_INT(faulthandler);
     SET_ITEM_INT(tracemalloc);
     SET_ITEM_INT(perf_profiling);
+    SET_ITEM_INT(jit);
     SET_ITEM_INT(import_time);
     SET_ITEM_INT(code_debug_ranges);
     SET_ITEM_INT(show_ref_count);
@@ -1354,6 +1362,7 @@ _PyConfig_FromDict(PyConfig *config, PyObject *dict)
     GET_UINT(faulthandler);
     GET_UINT(tracemalloc);
     GET_UINT(perf_profiling);
+    GET_UINT(jit);
     GET_UINT(import_time);
     GET_UINT(code_debug_ranges);
     GET_UINT(show_ref_count);
@@ -1731,6 +1740,40 @@ config_init_perf_profiling(PyConfig *config)
 
 }
 
+static PyStatus
+config_init_jit(PyConfig *config)
+{
+    const char *env = config_get_env(config, "PYTHONJIT");
+    if (env) {
+        int active;
+        if (_Py_str_to_int(env, &active) != 0) {
+            return _PyStatus_ERR("PYTHONJIT: invalid value, "
+                                 "expected an integer");
+        }
+        config->jit = (active != 0);
+    }
+
+    /* -X jit=[on|off] */
+    const wchar_t *xoption = config_get_xoption_value(config, L"jit");
+    if (xoption == NULL) {
+    }
+    else if (wcslen(xoption) == 0
+             || wcscmp(xoption, L"on") == 0
+             || wcscmp(xoption, L"1") == 0)
+    {
+        // "-X jit" and "-X jit=" both imply "on".
+        config->jit = 1;
+    }
+    else if (wcscmp(xoption, L"off") == 0 || wcscmp(xoption, L"0") == 0) {
+        config->jit = 0;
+    }
+    else {
+        return _PyStatus_ERR("bad value for option -X jit "
+                             "(expected \"on\" or \"off\")");
+    }
+    return _PyStatus_OK();
+}
+
 static PyStatus
 config_init_tracemalloc(PyConfig *config)
 {
@@ -1881,6 +1924,13 @@ config_read_complex_options(PyConfig *config)
         }
     }
 
+    if (config->jit < 0) {
+        status = config_init_jit(config);
+        if (_PyStatus_EXCEPTION(status)) {
+            return status;
+        }
+    }
+
     if (_Py_global_config_int_max_str_digits < 0) {
         status = config_init_int_max_str_digits(config);
         if (_PyStatus_EXCEPTION(status)) {
@@ -2206,6 +2256,9 @@ config_read(PyConfig *config, int compute_path_config)
     if (config->perf_profiling < 0) {
         config->perf_profiling = 0;
     }
+    if (config->jit < 0) {
+        config->jit = 0;
+    }
     if (config->use_hash_seed < 0) {
         config->use_hash_seed = 0;
         config->hash_seed = 0;
@@ -0,0 +1,283 @@
+/* Copy-and-patch JIT compiler.
+ *
+ * A code object is compiled by copying the stencil for each of its
+ * instructions into executable memory and filling in the holes in the
+ * copies: the addresses of the code for the next instruction and the jump
+ * target, the instruction itself, its argument, and so on.  The stencils
+ * are generated by Tools/jit/build.py from Tools/jit/template.c; see there
+ * and Include/internal/pycore_jit.h for how they work.
+ */
+
+#include "Python.h"
+
+#ifdef _Py_JIT
+
+/* The headers of Tools/jit/template.c, which declare the symbols that the
+   stencils refer to */
+#include "pycore_atomic.h"        // _Py_atomic_load_relaxed()
+#include "pycore_code.h"          // _PyCode_CODE()
+#include "pycore_floatobject.h"   // _PyFloat_ExactDealloc()
+#include "pycore_frame.h"         // _PyInterpreterFrame
+#include "pycore_jit.h"
+#include "pycore_list.h"          // _PyListIterObject
+#include "pycore_long.h"          // _PyLong_Add()
+#include "pycore_object.h"        // _Py_DECREF_SPECIALIZED()
+#include "pycore_opcode.h"        // _PyOpcode_Deopt
+#include "pycore_pystate.h"       // _PyThreadState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
+#include "opcode.h"
+
+#include <sys/mman.h>             // mmap()
+
+typedef enum {
+    HOLE_BASE,      // the address of the copied stencil
+    HOLE_CONTINUE,  // the code for the next instruction
+    HOLE_TARGET,    // the code for the jump target
+    HOLE_INSTR,     // the instruction
+    HOLE_OPARG,     // its argument
+    HOLE_OPERAND,   // the operand computed by compile_instruction()
+    HOLE_SYMBOL,    // symbol_addresses[symbol]
+} HoleKind;
+
+typedef struct {
+    size_t offset;
+    HoleKind kind;
+    int symbol;
+    int64_t addend;
+} Hole;
+
+typedef struct {
+    size_t size;
+    const unsigned char *body;
+    size_t entry;
+    size_t nholes;
+    const Hole *holes;
+} Stencil;
+
+#include "Python/jit_stencils.h"
+
+#define STENCIL_ALIGNMENT 16
+
+typedef struct {
+    const Stencil *stencil;
+    int oparg;
+    int next;           // index of the instruction to continue with
+    int target;         // index of the jump target
+    uintptr_t operand;
+    size_t offset;      // of the copy of the stencil
+} Instruction;
+
+/* Choose the stencil for the instruction at index i and compute its holes,
+   leaving the generic stencil for anything that isn't supported. */
+static void
+compile_instruction(PyCodeObject *code, int i, Instruction *instruction)
+{
+    _Py_CODEUNIT *instructions = _PyCode_CODE(code);
+    Py_ssize_t size = Py_SIZE(code);
+    int opcode = _Py_OPCODE(instructions[i]);
+    int base = _PyOpcode_Deopt[opcode];
+    int oparg = instruction->oparg;
+    int next = i + 1 + _PyOpcode_Caches[base];
+    int target = -1;
+    uintptr_t operand = 0;
+
+    /* Superinstructions and quickened forms share the stencil of the
+       instruction they start with or are specialized from. */
+    const Stencil *stencil = &stencils[opcode];
+    if (stencil->size == 0) {
+        stencil = &stencils[base];
+        opcode = base;
+    }
+    switch (opcode) {
+        case LOAD_CONST:
+        case LOAD_CONST_BORROW:
+            operand = (uintptr_t)PyTuple_GET_ITEM(code->co_consts, oparg);
+            break;
+        case POP_JUMP_IF_FALSE:
+        case POP_JUMP_IF_TRUE:
+        case POP_JUMP_IF_NOT_NONE:
+        case POP_JUMP_IF_NONE:
+        case POP_JUMP_IF_FALSE_BORROW:
+        case POP_JUMP_IF_TRUE_BORROW:
+        case POP_JUMP_IF_NOTNONE_BORROW:
+        case POP_JUMP_IF_NONE_BORROW:
+        case JUMP_FORWARD:
+        case FOR_ITER_LIST:
+            target = next + oparg;
+            break;
+        case JUMP_BACKWARD:
+            target = next - oparg;
+            break;
+        case FOR_ITER_RANGE:
+            target = next + oparg;
+            if (next >= size ||
+                _PyOpcode_Deopt[_Py_OPCODE(instructions[next])] != STORE_FAST)
+            {
+                stencil = NULL;
+                break;
+            }
+            /* The STORE_FAST after it is done by the stencil */
+            operand = _Py_OPARG(instructions[next]);
+            next++;
+            break;
+        case COMPARE_OP_FLOAT_JUMP:
+        case COMPARE_OP_INT_JUMP:
+            /* So is the POP_JUMP_IF_FALSE or POP_JUMP_IF_TRUE */
+            operand = ((_PyCompareOpCache *)&instructions[i + 1])->mask;
+            if (next >= size) {
+                stencil = NULL;
+                break;
+            }
+            target = next + 1 + _Py_OPARG(instructions[next]);
+            next++;
+            break;
+    }
+    int jumps_only = (opcode == JUMP_FORWARD || opcode == JUMP_BACKWARD);
+    if (stencil == NULL || stencil->size == 0 ||
+        (next >= size && !jumps_only) ||
+        (target != -1 && (target < 0 || target >= size)))
+    {
+        stencil = &generic_stencil;
+    }
+    instruction->stencil = stencil;
+    instruction->next = next < size ? next : -1;
+    instruction->target = target;
+    instruction->operand = operand;
+}
+
+static void
+patch(unsigned char *memory, const Instruction *instructions, int i,
+      _Py_CODEUNIT *code)
+{
+    const Instruction *instruction = &instructions[i];
+    const Stencil *stencil = instruction->stencil;
+    unsigned char *location = memory + instruction->offset;
+    memcpy(location, stencil->body, stencil->size);
+    for (size_t h = 0; h < stencil->nholes; h++) {
+        const Hole *hole = &stencil->holes[h];
+        uintptr_t value;
+        switch (hole->kind) {
+            case HOLE_BASE:
+                value = (uintptr_t)location;
+                break;
+            case HOLE_CONTINUE: {
+                assert(instruction->next >= 0);
+                const Instruction *next = &instructions[instruction->next];
+                value = (uintptr_t)(memory + next->offset + next->stencil->entry);
+                break;
+            }
+            case HOLE_TARGET: {
+                assert(instruction->target >= 0);
+                const Instruction *target = &instructions[instruction->target];
+                value = (uintptr_t)(memory + target->offset + target->stencil->entry);
+                break;
+            }
+            case HOLE_INSTR:
+                value = (uintptr_t)&code[i];
+                break;
+            case HOLE_OPARG:
+                value = (uintptr_t)instruction->oparg;
+                break;
+            case HOLE_OPERAND:
+                value = instruction->operand;
+                break;
+            case HOLE_SYMBOL:
+                value = symbol_addresses[hole->symbol];
+                break;
+            default:
+                Py_UNREACHABLE();
+        }
+        value += hole->addend;
+        memcpy(location + hole->offset, &value, sizeof(value));
+    }
+}
+
+int
+_PyJIT_Compile(PyCodeObject *code)
+{
+    assert(code->_co_jit == NULL);
+    _Py_CODEUNIT *instructions = _PyCode_CODE(code);
+    Py_ssize_t size = Py_SIZE(code);
+    _PyJITCode *jit = NULL;
+    unsigned char *memory = MAP_FAILED;
+    size_t total = 0;
+
+    Instruction *compiled = PyMem_Calloc(size, sizeof(Instruction));
+    if (compiled == NULL) {
+        goto fail;
+    }
+    int oparg = 0;
+    for (int i = 0; i < size;) {
+        int opcode = _Py_OPCODE(instructions[i]);
+        int base = _PyOpcode_Deopt[opcode];
+        oparg |= _Py_OPARG(instructions[i]);
+        compiled[i].oparg = oparg;
+        compile_instruction(code, i, &compiled[i]);
+        compiled[i].offset = total;
+        total += _Py_SIZE_ROUND_UP(compiled[i].stencil->size, STENCIL_ALIGNMENT);
+        /* EXTENDED_ARG has no stencil, so the interpreter runs the whole
+           instruction: exits from the instruction itself would skip the
+           prefix. */
+        oparg = (base == EXTENDED_ARG) ? oparg << 8 : 0;
+        i += 1 + _PyOpcode_Caches[base];
+    }
+    /* Don't trust jumps into inline caches in hand-made code objects */
+    for (int i = 0; i < size; i++) {
+        if ((compiled[i].next >= 0 &&
+             compiled[compiled[i].next].stencil == NULL) ||
+            (compiled[i].target >= 0 &&
+             compiled[compiled[i].target].stencil == NULL))
+        {
+            goto fail;
+        }
+    }
+
+    jit = PyMem_Calloc(1, sizeof(_PyJITCode) +
+                          (size - 1) * sizeof(_PyJITFunction));
+    if (jit == NULL) {
+        goto fail;
+    }
+    memory = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        goto fail;
+    }
+    for (int i = 0; i < size; i++) {
+        if (compiled[i].stencil == NULL) {
+            continue;  // an inline cache entry
+        }
+        patch(memory, compiled, i, instructions);
+        if (compiled[i].stencil != &generic_stencil) {
+            jit->entries[i] = (_PyJITFunction)(
+                memory + compiled[i].offset + compiled[i].stencil->entry);
+        }
+    }
+    if (mprotect(memory, total, PROT_READ | PROT_EXEC) < 0) {
+        goto fail;
+    }
+    PyMem_Free(compiled);
+    jit->memory = memory;
+    jit->size = total;
+    code->_co_jit = jit;
+    return 0;
+
+fail:
+    if (memory != MAP_FAILED) {
+        munmap(memory, total);
+    }
+    PyMem_Free(jit);
+    PyMem_Free(compiled);
+    code->_co_jit_warmup = -1;
+    return -1;
+}
+
+void
+_PyJIT_Free(PyCodeObject *code)
+{
+    _PyJITCode *jit = (_PyJITCode *)code->_co_jit;
+    code->_co_jit = NULL;
+    munmap(jit->memory, jit->size);
+    PyMem_Free(jit);
+}
+
+#endif  /* _Py_JIT */
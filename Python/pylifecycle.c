@@ -1983,6 +1983,12 @@ new_interpreter(PyThreadState **tstate_p, int isolated_subinterpreter)
         return _PyStatus_OK();
     }
 
+    if (isolated_subinterpreter && _PyObject_InitState(interp) < 0) {
+        PyInterpreterState_Delete(interp);
+        *tstate_p = NULL;
+        return _PyStatus_NO_MEMORY();
+    }
+
     PyThreadState *tstate = PyThreadState_New(interp);
     if (tstate == NULL) {
         PyInterpreterState_Delete(interp);
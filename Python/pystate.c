@@ -526,6 +526,7 @@ PyInterpreterState_Delete(PyInterpreterState *interp)
     if (interp->id_mutex != NULL) {
         PyThread_free_lock(interp->id_mutex);
     }
+    _PyObject_FiniState(interp);
     free_interpreter(interp);
 }
 
@@ -562,6 +563,7 @@ _PyInterpreterState_DeleteExceptMain(_PyRuntimeState *runtime)
         if (interp->id_mutex != NULL) {
             PyThread_free_lock(interp->id_mutex);
         }
+        _PyObject_FiniState(interp);
         PyInterpreterState *prev_interp = interp;
         interp = interp->next;
         free_interpreter(prev_interp);
@@ -1061,6 +1063,8 @@ PyThreadState_Clear(PyThreadState *tstate)
     if (tstate->on_delete != NULL) {
         tstate->on_delete(tstate->on_delete_data);
     }
+
+    _PyObject_ClearThreadCache(tstate);
 }
 
 
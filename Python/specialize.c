@@ -3,6 +3,7 @@
 #include "pycore_dict.h"
 #include "pycore_function.h"      // _PyFunction_GetVersionForCurrentState()
 #include "pycore_global_strings.h"  // _Py_ID()
+#include "pycore_iterators.h"     // _PyZipObject
 #include "pycore_long.h"
 #include "pycore_moduleobject.h"
 #include "pycore_object.h"
@@ -12,6 +13,8 @@
 
 #include <stdlib.h> // rand()
 
+#include "superinstructions.h"    // profiled_superinstruction()
+
 /* For guidance on adding or extending families of instructions see
  * ./adaptive.md
  */
@@ -27,6 +30,7 @@ uint8_t _PyOpcode_Adaptive[256] = {
     [STORE_ATTR] = STORE_ATTR_ADAPTIVE,
     [BINARY_OP] = BINARY_OP_ADAPTIVE,
     [COMPARE_OP] = COMPARE_OP_ADAPTIVE,
+    [CONTAINS_OP] = CONTAINS_OP_ADAPTIVE,
     [UNPACK_SEQUENCE] = UNPACK_SEQUENCE_ADAPTIVE,
     [FOR_ITER] = FOR_ITER_ADAPTIVE,
 };
@@ -64,6 +68,9 @@ stats_to_dict(SpecializationStats *stats)
     ADD_STAT_TO_DICT(res, deferred);
     ADD_STAT_TO_DICT(res, miss);
     ADD_STAT_TO_DICT(res, deopt);
+    ADD_STAT_TO_DICT(res, monomorphic);
+    ADD_STAT_TO_DICT(res, polymorphic);
+    ADD_STAT_TO_DICT(res, megamorphic);
     PyObject *failure_kinds = PyTuple_New(SPECIALIZATION_FAILURE_KINDS);
     if (failure_kinds == NULL) {
         Py_DECREF(res);
@@ -120,6 +127,7 @@ _Py_GetSpecializationStats(void) {
     err += add_stat_dict(stats, CALL, "call");
     err += add_stat_dict(stats, BINARY_OP, "binary_op");
     err += add_stat_dict(stats, COMPARE_OP, "compare_op");
+    err += add_stat_dict(stats, CONTAINS_OP, "contains_op");
     err += add_stat_dict(stats, UNPACK_SEQUENCE, "unpack_sequence");
     err += add_stat_dict(stats, FOR_ITER, "for_iter");
     if (err < 0) {
@@ -131,6 +139,69 @@ _Py_GetSpecializationStats(void) {
 #endif
 
 
+void
+_Py_OpcodeTripleInc(int first, int second, int third)
+{
+    OpcodeTripleStats *stats = &_py_stats->triple_stats;
+    uint32_t key = (((uint32_t)first << 16) | (second << 8) | third) + 1;
+    uint32_t i = (key * 2654435761u) >> (32 - OPCODE_TRIPLE_TABLE_BITS);
+    for (int probe = 0; probe < 8; probe++) {
+        uint32_t slot = (i + probe) & (OPCODE_TRIPLE_TABLE_SIZE - 1);
+        if (stats->key[slot] == key) {
+            stats->count[slot]++;
+            return;
+        }
+        if (stats->key[slot] == 0) {
+            stats->key[slot] = key;
+            stats->count[slot] = 1;
+            return;
+        }
+    }
+    stats->dropped++;
+}
+
+/* The monomorphic, polymorphic and megamorphic counters of LOAD_ATTR and
+ * STORE_ATTR count the sites currently specialized in each way: a site
+ * moving from one to another leaves the first one, and a site going back
+ * to the adaptive instruction leaves all of them. */
+static uint64_t *
+attr_site_counter(int opcode)
+{
+    int base = _PyOpcode_Deopt[opcode];
+    if ((base != LOAD_ATTR && base != STORE_ATTR) ||
+        opcode == base || opcode == _PyOpcode_Adaptive[base])
+    {
+        return NULL;
+    }
+    SpecializationStats *stats = &_py_stats->opcode_stats[base].specialization;
+    switch (opcode) {
+        case LOAD_ATTR_SLOT_POLY:
+        case STORE_ATTR_SLOT_POLY:
+            return &stats->polymorphic;
+        case LOAD_ATTR_MEGAMORPHIC:
+            return &stats->megamorphic;
+        default:
+            return &stats->monomorphic;
+    }
+}
+
+void
+_Py_AttrSiteStat(int old_opcode, int new_opcode)
+{
+    uint64_t *old_counter = attr_site_counter(old_opcode);
+    uint64_t *new_counter = attr_site_counter(new_opcode);
+    if (old_counter == new_counter) {
+        return;
+    }
+    /* Sites specialized while the stats were off were never counted */
+    if (old_counter != NULL && *old_counter > 0) {
+        (*old_counter)--;
+    }
+    if (new_counter != NULL) {
+        (*new_counter)++;
+    }
+}
+
 #define PRINT_STAT(i, field) \
     if (stats[i].field) { \
         fprintf(out, "    opcode[%d]." #field " : %" PRIu64 "\n", i, stats[i].field); \
@@ -153,6 +224,9 @@ print_spec_stats(FILE *out, OpcodeStats *stats)
         PRINT_STAT(i, specialization.deferred);
         PRINT_STAT(i, specialization.miss);
         PRINT_STAT(i, specialization.deopt);
+        PRINT_STAT(i, specialization.monomorphic);
+        PRINT_STAT(i, specialization.polymorphic);
+        PRINT_STAT(i, specialization.megamorphic);
         PRINT_STAT(i, execution_count);
         for (int j = 0; j < SPECIALIZATION_FAILURE_KINDS; j++) {
             uint64_t val = stats[i].specialization.failure_kinds[j];
@@ -172,6 +246,19 @@ print_spec_stats(FILE *out, OpcodeStats *stats)
 #undef PRINT_STAT
 
 
+static void
+print_triple_stats(FILE *out, OpcodeTripleStats *stats)
+{
+    for (int i = 0; i < OPCODE_TRIPLE_TABLE_SIZE; i++) {
+        if (stats->key[i]) {
+            uint32_t key = stats->key[i] - 1;
+            fprintf(out, "opcode[%d].triple_count[%d][%d] : %" PRIu64 "\n",
+                    key >> 16, (key >> 8) & 255, key & 255, stats->count[i]);
+        }
+    }
+    fprintf(out, "Opcode triples dropped: %" PRIu64 "\n", stats->dropped);
+}
+
 static void
 print_call_stats(FILE *out, CallStats *stats)
 {
@@ -197,6 +284,8 @@ print_object_stats(FILE *out, ObjectStats *stats)
     fprintf(out, "Object new values: %" PRIu64 "\n", stats->new_values);
     fprintf(out, "Object interpreter increfs: %" PRIu64 "\n", stats->interpreter_increfs);
     fprintf(out, "Object interpreter decrefs: %" PRIu64 "\n", stats->interpreter_decrefs);
+    fprintf(out, "Object interpreter increfs avoided: %" PRIu64 "\n", stats->interpreter_increfs_avoided);
+    fprintf(out, "Object interpreter decrefs avoided: %" PRIu64 "\n", stats->interpreter_decrefs_avoided);
     fprintf(out, "Object increfs: %" PRIu64 "\n", stats->increfs);
     fprintf(out, "Object decrefs: %" PRIu64 "\n", stats->decrefs);
     fprintf(out, "Object materialize dict (on request): %" PRIu64 "\n", stats->dict_materialized_on_request);
@@ -208,6 +297,7 @@ print_object_stats(FILE *out, ObjectStats *stats)
 static void
 print_stats(FILE *out, PyStats *stats) {
     print_spec_stats(out, stats->opcode_stats);
+    print_triple_stats(out, &stats->triple_stats);
     print_call_stats(out, &stats->call_stats);
     print_object_stats(out, &stats->object_stats);
 }
@@ -282,6 +372,7 @@ _PyCode_Quicken(PyCodeObject *code)
 {
     _Py_QuickenedCount++;
     int previous_opcode = -1;
+    int previous_opcode2 = -1;
     _Py_CODEUNIT *instructions = _PyCode_CODE(code);
     for (int i = 0; i < Py_SIZE(code); i++) {
         int opcode = _Py_OPCODE(instructions[i]);
@@ -291,10 +382,31 @@ _PyCode_Quicken(PyCodeObject *code)
             // Make sure the adaptive counter is zero:
             assert(instructions[i + 1] == 0);
             previous_opcode = -1;
+            previous_opcode2 = -1;
             i += _PyOpcode_Caches[opcode];
         }
         else {
             assert(!_PyOpcode_Caches[opcode]);
+            // Superinstructions overlap: each one only replaces the opcode
+            // of its first instruction, so that jumps into the middle of
+            // it still work.  Longer ones replace shorter ones.
+            int previous = previous_opcode;
+            if (previous_opcode > 0) {
+                if (previous_opcode2 > 0) {
+                    int fused = profiled_superinstruction(
+                        previous_opcode2, previous_opcode, opcode);
+                    if (fused) {
+                        _Py_SET_OPCODE(instructions[i - 2], fused);
+                    }
+                }
+                int fused = profiled_superinstruction(previous_opcode,
+                                                      opcode, 0);
+                if (fused) {
+                    _Py_SET_OPCODE(instructions[i - 1], fused);
+                    // Keep the hand-written pairs below from replacing it
+                    previous = -1;
+                }
+            }
             switch (opcode) {
                 case EXTENDED_ARG:
                     _Py_SET_OPCODE(instructions[i], EXTENDED_ARG_QUICK);
@@ -306,7 +418,7 @@ _PyCode_Quicken(PyCodeObject *code)
                     _Py_SET_OPCODE(instructions[i], RESUME_QUICK);
                     break;
                 case LOAD_FAST:
-                    switch(previous_opcode) {
+                    switch(previous) {
                         case LOAD_FAST:
                             _Py_SET_OPCODE(instructions[i - 1],
                                            LOAD_FAST__LOAD_FAST);
@@ -322,18 +434,31 @@ _PyCode_Quicken(PyCodeObject *code)
                     }
                     break;
                 case STORE_FAST:
-                    if (previous_opcode == STORE_FAST) {
+                    if (previous == STORE_FAST) {
                         _Py_SET_OPCODE(instructions[i - 1],
                                        STORE_FAST__STORE_FAST);
                     }
                     break;
                 case LOAD_CONST:
-                    if (previous_opcode == LOAD_FAST) {
+                    if (previous == LOAD_FAST) {
                         _Py_SET_OPCODE(instructions[i - 1],
                                        LOAD_FAST__LOAD_CONST);
                     }
                     break;
+                case LOAD_FAST_BORROW:
+                    if (previous == LOAD_FAST_BORROW) {
+                        _Py_SET_OPCODE(instructions[i - 1],
+                                       LOAD_FAST_BORROW__LOAD_FAST_BORROW);
+                    }
+                    break;
+                case LOAD_CONST_BORROW:
+                    if (previous == LOAD_FAST_BORROW) {
+                        _Py_SET_OPCODE(instructions[i - 1],
+                                       LOAD_FAST_BORROW__LOAD_CONST_BORROW);
+                    }
+                    break;
             }
+            previous_opcode2 = previous_opcode;
             previous_opcode = opcode;
         }
     }
@@ -411,6 +536,9 @@ miss_counter_start(void) {
 #define SPEC_FAIL_SUBSCR_PY_OTHER 21
 #define SPEC_FAIL_SUBSCR_DICT_SUBCLASS_NO_OVERRIDE 22
 #define SPEC_FAIL_SUBSCR_NOT_HEAP_TYPE 23
+#define SPEC_FAIL_SUBSCR_MEMORYVIEW_LAYOUT 24
+#define SPEC_FAIL_SUBSCR_MEMORYVIEW_SLICE 25
+#define SPEC_FAIL_SUBSCR_MEMORYVIEW_READONLY 26
 
 /* Binary op */
 
@@ -459,6 +587,7 @@ miss_counter_start(void) {
 #define SPEC_FAIL_CALL_OPERATOR_WRAPPER 27
 #define SPEC_FAIL_CALL_PYFUNCTION 28
 #define SPEC_FAIL_CALL_PEP_523 29
+#define SPEC_FAIL_CALL_KWNAMES_LAYOUT 30
 
 /* COMPARE_OP */
 #define SPEC_FAIL_COMPARE_OP_DIFFERENT_TYPES 12
@@ -497,6 +626,15 @@ miss_counter_start(void) {
 #define SPEC_FAIL_FOR_ITER_CALLABLE 28
 #define SPEC_FAIL_FOR_ITER_ASCII_STRING 29
 
+/* CONTAINS_OP */
+#define SPEC_FAIL_CONTAINS_OP_LIST 8
+#define SPEC_FAIL_CONTAINS_OP_TUPLE 9
+#define SPEC_FAIL_CONTAINS_OP_BYTES 10
+#define SPEC_FAIL_CONTAINS_OP_RANGE 11
+#define SPEC_FAIL_CONTAINS_OP_DICT_VIEW 12
+#define SPEC_FAIL_CONTAINS_OP_SUBCLASS 13
+#define SPEC_FAIL_CONTAINS_OP_SET_IN_SET 14
+
 // UNPACK_SEQUENCE
 
 #define SPEC_FAIL_UNPACK_SEQUENCE_ITERATOR 8
@@ -715,6 +853,219 @@ specialize_dict_access(
     return 1;
 }
 
+/* Polymorphic slot access.
+ *
+ * LOAD_ATTR_SLOT and STORE_ATTR_SLOT cache a single (type version, offset)
+ * pair inline. When they see an instance of another type, the new type is
+ * analyzed and, if the attribute is also a plain object slot there, the
+ * site takes an entry of the interpreter's attr_poly_caches holding both
+ * pairs and is converted to the _POLY form. Further types are added to
+ * that entry. Once it is full, a further type makes the site megamorphic:
+ * loads switch to LOAD_ATTR_MEGAMORPHIC, stores fall back to the adaptive
+ * instruction. A site whose entry was taken over by another one goes back
+ * to the adaptive instruction, backing off further each time, and takes
+ * a new entry once it is specialized again.
+ */
+
+static Py_ssize_t
+slot_offset_for_poly(PyTypeObject *type, PyObject *name, int store)
+{
+    if (type->tp_version_tag == 0) {
+        return -1;
+    }
+    PyObject *descr;
+    DescriptorClassification kind = analyze_descriptor(type, name, &descr, store);
+    if (kind == DUNDER_CLASS && !store) {
+        return offsetof(PyObject, ob_type);
+    }
+    if (kind != OBJECT_SLOT) {
+        return -1;
+    }
+    struct PyMemberDef *dmem = ((PyMemberDescrObject *)descr)->d_member;
+    if (dmem->flags & (store ? READONLY : PY_AUDIT_READ)) {
+        return -1;
+    }
+    if (dmem->offset != (uint16_t)dmem->offset) {
+        return -1;
+    }
+    return dmem->offset;
+}
+
+static int
+specialize_slot_poly(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name,
+                     int opcode, int mono_opcode, int poly_opcode)
+{
+    _PyAttrCache *cache = (_PyAttrCache *)(instr + 1);
+    PyTypeObject *type = Py_TYPE(owner);
+    int current = _Py_OPCODE(*instr);
+    assert(current == mono_opcode || current == poly_opcode);
+    struct attr_poly_caches *caches =
+        &_PyInterpreterState_GET()->types.attr_poly_caches;
+    struct attr_poly_cache_entry *entry = NULL;
+    int free_entry = 0;
+    if (current == poly_opcode && caches->entries[cache->index].site != instr) {
+        /* Back off instead of taking another site's entry in turn, so that
+         * more polymorphic sites than entries don't keep evicting each
+         * other */
+        ATTR_SITE_STAT(current, _PyOpcode_Adaptive[opcode]);
+        _Py_SET_OPCODE(*instr, _PyOpcode_Adaptive[opcode]);
+        cache->counter = miss_counter_deopt(cache->counter);
+        return 1;
+    }
+    if (current == poly_opcode) {
+        entry = &caches->entries[cache->index];
+        while (free_entry < ATTR_POLY_CACHE_SIZE &&
+               entry->versions[free_entry] != 0)
+        {
+            free_entry++;
+        }
+        if (free_entry == ATTR_POLY_CACHE_SIZE) {
+            if (opcode == LOAD_ATTR) {
+                /* Megamorphic loads share the per-interpreter cache */
+                ATTR_SITE_STAT(current, LOAD_ATTR_MEGAMORPHIC);
+                _Py_SET_OPCODE(*instr, LOAD_ATTR_MEGAMORPHIC);
+                return 1;
+            }
+            ATTR_SITE_STAT(current, _PyOpcode_Adaptive[opcode]);
+            _Py_SET_OPCODE(*instr, _PyOpcode_Adaptive[opcode]);
+            cache->counter = adaptive_counter_backoff(adaptive_counter_start());
+            return 1;
+        }
+    }
+    Py_ssize_t offset = slot_offset_for_poly(type, name, opcode == STORE_ATTR);
+    assert(!PyErr_Occurred());
+    if (offset < 0) {
+        return 0;
+    }
+    if (entry == NULL) {
+        unsigned int index = caches->next;
+        caches->next = (index + 1) & ((1 << ATTR_POLY_CACHES_SIZE_EXP) - 1);
+        caches->handed_out++;
+        entry = &caches->entries[index];
+        memset(entry, 0, sizeof(*entry));
+        entry->site = instr;
+        if (current == mono_opcode) {
+            entry->versions[0] = read_u32(cache->version);
+            entry->offsets[0] = cache->index;
+            free_entry = 1;
+        }
+        cache->index = (uint16_t)index;
+    }
+    entry->versions[free_entry] = type->tp_version_tag;
+    entry->offsets[free_entry] = (uint16_t)offset;
+    if (current == mono_opcode) {
+        ATTR_SITE_STAT(current, poly_opcode);
+        _Py_SET_OPCODE(*instr, poly_opcode);
+    }
+    return 1;
+}
+
+/* Called when LOAD_ATTR_SLOT or LOAD_ATTR_SLOT_POLY misses on the type
+ * version. Returns 1 if the instruction was updated and should be
+ * re-dispatched, 0 if the miss should be handled as a normal deopt. */
+int
+_Py_Specialize_LoadAttrPoly(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
+{
+    return specialize_slot_poly(owner, instr, name, LOAD_ATTR,
+                                LOAD_ATTR_SLOT, LOAD_ATTR_SLOT_POLY);
+}
+
+int
+_Py_Specialize_StoreAttrPoly(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
+{
+    return specialize_slot_poly(owner, instr, name, STORE_ATTR,
+                                STORE_ATTR_SLOT, STORE_ATTR_SLOT_POLY);
+}
+
+/* Megamorphic attribute loads.
+ *
+ * LOAD_ATTR_MEGAMORPHIC looks up (type version, name) in the interpreter's
+ * mega_attr_cache. On a miss this function analyzes the type, as the
+ * specializer would, and records how the attribute can be read. Returns
+ * the filled entry, or NULL if the type or name cannot be cached.
+ */
+struct mega_attr_cache_entry *
+_PyMegaAttrCache_Fill(PyTypeObject *type, PyObject *name)
+{
+    if (type->tp_version_tag == 0 || !PyUnicode_CheckExact(name)) {
+        return NULL;
+    }
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    PyObject *descr;
+    DescriptorClassification kind = analyze_descriptor(type, name, &descr, 0);
+    assert(!PyErr_Occurred());
+    /* analyze_descriptor() may have assigned a new version tag */
+    unsigned int version = type->tp_version_tag;
+    if (version == 0) {
+        return NULL;
+    }
+    struct mega_attr_cache_entry *entry =
+        _PyMegaAttrCache_Entry(&interp->types.mega_attr_cache, version, name);
+    entry->kind = MEGA_ATTR_GENERIC;
+    entry->index = 0;
+    entry->keys_version = 0;
+    entry->descr = NULL;
+    switch (kind) {
+        case OBJECT_SLOT:
+        {
+            struct PyMemberDef *dmem = ((PyMemberDescrObject *)descr)->d_member;
+            if ((dmem->flags & PY_AUDIT_READ) == 0 &&
+                dmem->offset == (uint16_t)dmem->offset)
+            {
+                entry->kind = MEGA_ATTR_SLOT;
+                entry->index = (uint16_t)dmem->offset;
+            }
+            break;
+        }
+        case DUNDER_CLASS:
+            entry->kind = MEGA_ATTR_SLOT;
+            entry->index = offsetof(PyObject, ob_type);
+            break;
+        case METHOD:
+            if ((type->tp_flags & Py_TPFLAGS_MANAGED_DICT) == 0 &&
+                type->tp_dictoffset == 0)
+            {
+                entry->kind = MEGA_ATTR_METHOD;
+                entry->descr = descr;  /* borrowed */
+            }
+            else if (type->tp_flags & Py_TPFLAGS_MANAGED_DICT) {
+                PyDictKeysObject *keys = ((PyHeapTypeObject *)type)->ht_cached_keys;
+                if (_PyDictKeys_StringLookup(keys, name) == DKIX_EMPTY) {
+                    uint32_t keys_version =
+                        _PyDictKeys_GetVersionForCurrentState(keys);
+                    if (keys_version != 0) {
+                        entry->kind = MEGA_ATTR_METHOD_WITH_VALUES;
+                        entry->keys_version = keys_version;
+                        entry->descr = descr;  /* borrowed */
+                    }
+                }
+            }
+            break;
+        case BUILTIN_CLASSMETHOD:
+        case PYTHON_CLASSMETHOD:
+        case NON_OVERRIDING:
+        case NON_DESCRIPTOR:
+        case ABSENT:
+            if (type->tp_flags & Py_TPFLAGS_MANAGED_DICT) {
+                PyDictKeysObject *keys = ((PyHeapTypeObject *)type)->ht_cached_keys;
+                Py_ssize_t index = _PyDictKeys_StringLookup(keys, name);
+                if (index >= 0 && index == (uint16_t)index) {
+                    entry->kind = MEGA_ATTR_INSTANCE_VALUE;
+                    entry->index = (uint16_t)index;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    entry->version = version;
+    Py_SETREF(entry->name, Py_NewRef(name));
+    return entry;
+}
+
+/* Two failures or deoptimizations make a site megamorphic */
+#define LOAD_ATTR_MEGAMORPHIC_BACKOFF (ADAPTIVE_BACKOFF_START + 2)
+
 static int specialize_attr_loadmethod(PyObject* owner, _Py_CODEUNIT* instr, PyObject* name,
     PyObject* descr, DescriptorClassification kind);
 static int specialize_class_load_attr(PyObject* owner, _Py_CODEUNIT* instr, PyObject* name);
@@ -724,6 +1075,7 @@ _Py_Specialize_LoadAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
 {
     assert(_PyOpcode_Caches[LOAD_ATTR] == INLINE_CACHE_ENTRIES_LOAD_ATTR);
     _PyAttrCache *cache = (_PyAttrCache *)(instr + 1);
+    int backoff = cache->counter & ((1 << ADAPTIVE_BACKOFF_BITS) - 1);
     if (PyModule_CheckExact(owner)) {
         int err = specialize_module_load_attr(owner, instr, name, LOAD_ATTR,
                                               LOAD_ATTR_MODULE);
@@ -745,6 +1097,12 @@ _Py_Specialize_LoadAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
             return -1;
         }
     }
+    if (backoff >= LOAD_ATTR_MEGAMORPHIC_BACKOFF) {
+        /* The site keeps failing to specialize or being deoptimized:
+           share the per-interpreter cache instead. */
+        _Py_SET_OPCODE(*instr, LOAD_ATTR_MEGAMORPHIC);
+        goto success;
+    }
     PyObject *descr = NULL;
     DescriptorClassification kind = analyze_descriptor(type, name, &descr, 0);
     assert(descr != NULL || kind == ABSENT || kind == GETSET_OVERRIDDEN);
@@ -867,8 +1225,9 @@ _Py_Specialize_LoadAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
     return 0;
 success:
     STAT_INC(LOAD_ATTR, success);
+    ATTR_SITE_STAT(LOAD_ATTR_ADAPTIVE, _Py_OPCODE(*instr));
     assert(!PyErr_Occurred());
-    cache->counter = miss_counter_start();
+    cache->counter = miss_counter_start() | (backoff << MISS_COUNTER_BITS);
     return 0;
 }
 
@@ -877,6 +1236,7 @@ _Py_Specialize_StoreAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
 {
     assert(_PyOpcode_Caches[STORE_ATTR] == INLINE_CACHE_ENTRIES_STORE_ATTR);
     _PyAttrCache *cache = (_PyAttrCache *)(instr + 1);
+    int backoff = cache->counter & ((1 << ADAPTIVE_BACKOFF_BITS) - 1);
     PyTypeObject *type = Py_TYPE(owner);
     if (PyModule_CheckExact(owner)) {
         SPECIALIZATION_FAIL(STORE_ATTR, SPEC_FAIL_OVERRIDDEN);
@@ -950,8 +1310,9 @@ _Py_Specialize_StoreAttr(PyObject *owner, _Py_CODEUNIT *instr, PyObject *name)
     return 0;
 success:
     STAT_INC(STORE_ATTR, success);
+    ATTR_SITE_STAT(STORE_ATTR_ADAPTIVE, _Py_OPCODE(*instr));
     assert(!PyErr_Occurred());
-    cache->counter = miss_counter_start();
+    cache->counter = miss_counter_start() | (backoff << MISS_COUNTER_BITS);
     return 0;
 }
 
@@ -1213,6 +1574,34 @@ _Py_Specialize_LoadGlobal(
     return 0;
 }
 
+/* array.array lives in an extension module, which marks it with
+ * _Py_TPFLAGS_ARRAY.  The flag is not inherited, so subclasses are not
+ * specialized. */
+static int
+is_array_array(PyTypeObject *tp)
+{
+    return (tp->tp_flags & _Py_TPFLAGS_ARRAY) &&
+           tp->tp_as_sequence != NULL &&
+           tp->tp_as_sequence->sq_item != NULL &&
+           tp->tp_as_sequence->sq_ass_item != NULL;
+}
+
+/* Must agree with MEMORYVIEW_IS_BYTES() in Python/ceval.c */
+static int
+is_byte_memoryview(PyObject *obj)
+{
+    PyMemoryViewObject *mv = (PyMemoryViewObject *)obj;
+    Py_buffer *view = &mv->view;
+    if ((mv->flags & _Py_MEMORYVIEW_RELEASED) ||
+        (mv->mbuf->flags & _Py_MANAGED_BUFFER_RELEASED))
+    {
+        return 0;
+    }
+    return view->ndim == 1 && view->itemsize == 1 &&
+           view->suboffsets == NULL && view->format != NULL &&
+           view->format[0] == 'B' && view->format[1] == '\0';
+}
+
 #ifdef Py_STATS
 static int
 binary_subscr_fail_kind(PyTypeObject *container_type, PyObject *sub)
@@ -1235,6 +1624,21 @@ binary_subscr_fail_kind(PyTypeObject *container_type, PyObject *sub)
         }
         return SPEC_FAIL_OTHER;
     }
+    else if (container_type == &PyByteArray_Type) {
+        if (PySlice_Check(sub)) {
+            return SPEC_FAIL_SUBSCR_BYTEARRAY_SLICE;
+        }
+        return SPEC_FAIL_OTHER;
+    }
+    else if (container_type == &PyMemoryView_Type) {
+        if (PyLong_CheckExact(sub)) {
+            return SPEC_FAIL_SUBSCR_MEMORYVIEW_LAYOUT;
+        }
+        if (PySlice_Check(sub)) {
+            return SPEC_FAIL_SUBSCR_MEMORYVIEW_SLICE;
+        }
+        return SPEC_FAIL_OTHER;
+    }
     else if (container_type->tp_as_buffer) {
         if (PyLong_CheckExact(sub)) {
             return SPEC_FAIL_SUBSCR_BUFFER_INT;
@@ -1328,6 +1732,29 @@ _Py_Specialize_BinarySubscr(
         _Py_SET_OPCODE(*instr, BINARY_SUBSCR_DICT);
         goto success;
     }
+    if (PyLong_CheckExact(sub)) {
+        if (container_type == &PyByteArray_Type) {
+            _Py_SET_OPCODE(*instr, BINARY_SUBSCR_BYTEARRAY_INT);
+            goto success;
+        }
+        if (container_type == &PyMemoryView_Type &&
+            is_byte_memoryview(container))
+        {
+            _Py_SET_OPCODE(*instr, BINARY_SUBSCR_MEMORYVIEW_INT);
+            goto success;
+        }
+        if (is_array_array(container_type)) {
+            if (_PyType_Lookup(container_type, &_Py_ID(__getitem__)) == NULL ||
+                container_type->tp_version_tag == 0)
+            {
+                SPECIALIZATION_FAIL(BINARY_SUBSCR, SPEC_FAIL_OUT_OF_VERSIONS);
+                goto fail;
+            }
+            write_u32(cache->type_version, container_type->tp_version_tag);
+            _Py_SET_OPCODE(*instr, BINARY_SUBSCR_ARRAY_INT);
+            goto success;
+        }
+    }
     PyTypeObject *cls = Py_TYPE(container);
     PyObject *descriptor = _PyType_Lookup(cls, &_Py_ID(__getitem__));
     if (descriptor && Py_TYPE(descriptor) == &PyFunction_Type) {
@@ -1404,6 +1831,33 @@ _Py_Specialize_StoreSubscr(PyObject *container, PyObject *sub, _Py_CODEUNIT *ins
         _Py_SET_OPCODE(*instr, STORE_SUBSCR_DICT);
          goto success;
     }
+    if (PyLong_CheckExact(sub)) {
+        if (container_type == &PyByteArray_Type) {
+            _Py_SET_OPCODE(*instr, STORE_SUBSCR_BYTEARRAY_INT);
+            goto success;
+        }
+        if (container_type == &PyMemoryView_Type &&
+            is_byte_memoryview(container))
+        {
+            if (((PyMemoryViewObject *)container)->view.readonly) {
+                SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_SUBSCR_MEMORYVIEW_READONLY);
+                goto fail;
+            }
+            _Py_SET_OPCODE(*instr, STORE_SUBSCR_MEMORYVIEW_INT);
+            goto success;
+        }
+        if (is_array_array(container_type)) {
+            if (_PyType_Lookup(container_type, &_Py_ID(__setitem__)) == NULL ||
+                container_type->tp_version_tag == 0)
+            {
+                SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_OUT_OF_VERSIONS);
+                goto fail;
+            }
+            write_u32(cache->type_version, container_type->tp_version_tag);
+            _Py_SET_OPCODE(*instr, STORE_SUBSCR_ARRAY_INT);
+            goto success;
+        }
+    }
 #ifdef Py_STATS
     PyMappingMethods *as_mapping = container_type->tp_as_mapping;
     if (as_mapping && (as_mapping->mp_ass_subscript
@@ -1426,6 +1880,17 @@ _Py_Specialize_StoreSubscr(PyObject *container, PyObject *sub, _Py_CODEUNIT *ins
                 SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_OTHER);
             }
         }
+        else if (PyMemoryView_Check(container)) {
+            if (PyLong_CheckExact(sub)) {
+                SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_SUBSCR_MEMORYVIEW_LAYOUT);
+            }
+            else if (PySlice_Check(sub)) {
+                SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_SUBSCR_MEMORYVIEW_SLICE);
+            }
+            else {
+                SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_OTHER);
+            }
+        }
         else if (PyByteArray_CheckExact(container)) {
             if (PyLong_CheckExact(sub)) {
                 SPECIALIZATION_FAIL(STORE_SUBSCR, SPEC_FAIL_SUBSCR_BYTEARRAY_INT);
@@ -1590,6 +2055,84 @@ specialize_method_descriptor(PyMethodDescrObject *descr, _Py_CODEUNIT *instr,
     return -1;
 }
 
+/* Keyword arguments are matched to parameters here, once. The call must
+ * fill every parameter without a positional default, so that
+ * CALL_PY_WITH_KWARGS never needs __kwdefaults__ (which can be changed
+ * without changing the function version) and never has to raise. */
+static int
+specialize_py_call_kw(PyFunctionObject *func, _Py_CODEUNIT *instr, int nargs,
+                      PyObject *kwnames, bool bound_method)
+{
+    _PyCallCache *cache = (_PyCallCache *)(instr + 1);
+    PyCodeObject *code = (PyCodeObject *)func->func_code;
+    if (bound_method) {
+        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_CALL_BOUND_METHOD);
+        return -1;
+    }
+    if (code->co_flags & (CO_VARKEYWORDS | CO_VARARGS)) {
+        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_CALL_COMPLEX_PARAMETERS);
+        return -1;
+    }
+    if ((code->co_flags & CO_OPTIMIZED) == 0) {
+        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_CALL_CO_NOT_OPTIMIZED);
+        return -1;
+    }
+    int nkwargs = (int)PyTuple_GET_SIZE(kwnames);
+    int positional = nargs - nkwargs;
+    int argcount = code->co_argcount;
+    int total = argcount + code->co_kwonlyargcount;
+    if (nkwargs > CALL_KW_MAX_KWARGS || total > CALL_KW_MAX_INDEX + 1) {
+        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_OUT_OF_RANGE);
+        return -1;
+    }
+    if (positional > argcount) {
+        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_WRONG_NUMBER_ARGUMENTS);
+        return -1;
+    }
+    int is_meth = nargs - _Py_OPARG(*instr);
+    assert(is_meth == 0 || is_meth == 1);
+    uint16_t layout = is_meth ? CALL_KW_IS_METH : 0;
+    uint32_t filled = 0;
+    for (int i = 0; i < positional; i++) {
+        filled |= 1u << i;
+    }
+    for (int i = 0; i < nkwargs; i++) {
+        PyObject *name = PyTuple_GET_ITEM(kwnames, i);
+        int index = -1;
+        for (int j = code->co_posonlyargcount; j < total; j++) {
+            PyObject *param = PyTuple_GET_ITEM(code->co_localsplusnames, j);
+            if (param == name || _PyUnicode_Equal(param, name)) {
+                index = j;
+                break;
+            }
+        }
+        /* Unknown or repeated names raise TypeError in the generic path */
+        if (index < 0 || (filled & (1u << index))) {
+            SPECIALIZATION_FAIL(CALL, SPEC_FAIL_CALL_KWNAMES_LAYOUT);
+            return -1;
+        }
+        filled |= 1u << index;
+        layout |= index << (CALL_KW_INDEX_BITS * i);
+    }
+    int defcount = func->func_defaults == NULL ? 0 : (int)PyTuple_GET_SIZE(func->func_defaults);
+    for (int j = positional; j < total; j++) {
+        if ((filled & (1u << j)) == 0 && (j >= argcount || j < argcount - defcount)) {
+            SPECIALIZATION_FAIL(CALL, j < argcount ?
+                SPEC_FAIL_WRONG_NUMBER_ARGUMENTS : SPEC_FAIL_CALL_KWNAMES_LAYOUT);
+            return -1;
+        }
+    }
+    int version = _PyFunction_GetVersionForCurrentState(func);
+    if (version == 0) {
+        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_OUT_OF_VERSIONS);
+        return -1;
+    }
+    write_u32(cache->func_version, version);
+    cache->min_args = layout;
+    _Py_SET_OPCODE(*instr, CALL_PY_WITH_KWARGS);
+    return 0;
+}
+
 static int
 specialize_py_call(PyFunctionObject *func, _Py_CODEUNIT *instr, int nargs,
                    PyObject *kwnames, bool bound_method)
@@ -1604,8 +2147,7 @@ specialize_py_call(PyFunctionObject *func, _Py_CODEUNIT *instr, int nargs,
         return -1;
     }
     if (kwnames) {
-        SPECIALIZATION_FAIL(CALL, SPEC_FAIL_CALL_KWNAMES);
-        return -1;
+        return specialize_py_call_kw(func, instr, nargs, kwnames, bound_method);
     }
     if (kind != SIMPLE_FUNCTION) {
         SPECIALIZATION_FAIL(CALL, kind);
@@ -1879,8 +2421,7 @@ _Py_Specialize_BinaryOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
             }
             if (PyUnicode_CheckExact(lhs)) {
                 _Py_CODEUNIT next = instr[INLINE_CACHE_ENTRIES_BINARY_OP + 1];
-                bool to_store = (_Py_OPCODE(next) == STORE_FAST ||
-                                 _Py_OPCODE(next) == STORE_FAST__LOAD_FAST);
+                bool to_store = _PyOpcode_Deopt[_Py_OPCODE(next)] == STORE_FAST;
                 if (to_store && locals[_Py_OPARG(next)] == lhs) {
                     _Py_SET_OPCODE(*instr, BINARY_OP_INPLACE_ADD_UNICODE);
                     goto success;
@@ -2019,6 +2560,7 @@ _Py_Specialize_CompareOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
         goto failure;
 #endif
     }
+    oparg &= ~COMPARE_BORROWED;
     assert(oparg <= Py_GE);
     int when_to_jump_mask = compare_masks[oparg];
     if (next_opcode == POP_JUMP_IF_FALSE) {
@@ -2065,6 +2607,71 @@ _Py_Specialize_CompareOp(PyObject *lhs, PyObject *rhs, _Py_CODEUNIT *instr,
     cache->counter = miss_counter_start();
 }
 
+#ifdef Py_STATS
+static int
+contains_op_fail_kind(PyObject *value, PyObject *container)
+{
+    if (PyList_CheckExact(container)) {
+        return SPEC_FAIL_CONTAINS_OP_LIST;
+    }
+    if (PyTuple_CheckExact(container)) {
+        return SPEC_FAIL_CONTAINS_OP_TUPLE;
+    }
+    if (PyBytes_CheckExact(container) || PyByteArray_CheckExact(container)) {
+        return SPEC_FAIL_CONTAINS_OP_BYTES;
+    }
+    if (PyRange_Check(container)) {
+        return SPEC_FAIL_CONTAINS_OP_RANGE;
+    }
+    if (PyDictKeys_Check(container) || PyDictItems_Check(container) ||
+        PyDictValues_Check(container))
+    {
+        return SPEC_FAIL_CONTAINS_OP_DICT_VIEW;
+    }
+    if (PyAnySet_CheckExact(container) && PySet_Check(value)) {
+        return SPEC_FAIL_CONTAINS_OP_SET_IN_SET;
+    }
+    if (PyUnicode_CheckExact(container)) {
+        return SPEC_FAIL_EXPECTED_ERROR;
+    }
+    if (PyDict_Check(container) || PyAnySet_Check(container) ||
+        PyUnicode_Check(container))
+    {
+        return SPEC_FAIL_CONTAINS_OP_SUBCLASS;
+    }
+    return SPEC_FAIL_OTHER;
+}
+#endif
+
+void
+_Py_Specialize_ContainsOp(PyObject *value, PyObject *container,
+                          _Py_CODEUNIT *instr)
+{
+    assert(_PyOpcode_Caches[CONTAINS_OP] == INLINE_CACHE_ENTRIES_CONTAINS_OP);
+    _PyContainsOpCache *cache = (_PyContainsOpCache *)(instr + 1);
+    if (PyDict_CheckExact(container)) {
+        _Py_SET_OPCODE(*instr, CONTAINS_OP_DICT);
+        goto success;
+    }
+    /* A set can only be looked up in a set as a frozenset, which
+       CONTAINS_OP_SET leaves to CONTAINS_OP. */
+    if (PyAnySet_CheckExact(container) && !PySet_Check(value)) {
+        _Py_SET_OPCODE(*instr, CONTAINS_OP_SET);
+        goto success;
+    }
+    if (PyUnicode_CheckExact(container) && PyUnicode_CheckExact(value)) {
+        _Py_SET_OPCODE(*instr, CONTAINS_OP_STR);
+        goto success;
+    }
+    SPECIALIZATION_FAIL(CONTAINS_OP, contains_op_fail_kind(value, container));
+    STAT_INC(CONTAINS_OP, failure);
+    cache->counter = adaptive_counter_backoff(cache->counter);
+    return;
+success:
+    STAT_INC(CONTAINS_OP, success);
+    cache->counter = miss_counter_start();
+}
+
 #ifdef Py_STATS
 static int
 unpack_sequence_fail_kind(PyObject *seq)
@@ -2199,10 +2806,47 @@ _Py_Specialize_ForIter(PyObject *iter, _Py_CODEUNIT *instr)
         _Py_SET_OPCODE(*instr, FOR_ITER_LIST);
         goto success;
     }
+    else if (tp == &PyTupleIter_Type) {
+        _Py_SET_OPCODE(*instr, FOR_ITER_TUPLE);
+        goto success;
+    }
+    else if (tp == &_PyUnicodeASCIIIter_Type) {
+        _Py_SET_OPCODE(*instr, FOR_ITER_STR);
+        goto success;
+    }
     else if (tp == &PyRangeIter_Type && next_op == STORE_FAST) {
         _Py_SET_OPCODE(*instr, FOR_ITER_RANGE);
         goto success;
     }
+    else if (tp == &PyDictIterKey_Type) {
+        _Py_SET_OPCODE(*instr, FOR_ITER_DICT_KEYS);
+        goto success;
+    }
+    else if (tp == &PyDictIterValue_Type) {
+        _Py_SET_OPCODE(*instr, FOR_ITER_DICT_VALUES);
+        goto success;
+    }
+    /* Iterators of pairs are only specialized when the pair is unpacked
+     * immediately, so that the UNPACK_SEQUENCE can be folded in and no
+     * tuple is created. */
+    else if (next_op == UNPACK_SEQUENCE && _Py_OPARG(next) == 2 &&
+             tp == &PyDictIterItem_Type)
+    {
+        _Py_SET_OPCODE(*instr, FOR_ITER_DICT_ITEMS);
+        goto success;
+    }
+    else if (next_op == UNPACK_SEQUENCE && _Py_OPARG(next) == 2 &&
+             tp == &PyEnum_Type)
+    {
+        _Py_SET_OPCODE(*instr, FOR_ITER_ENUMERATE);
+        goto success;
+    }
+    else if (next_op == UNPACK_SEQUENCE && _Py_OPARG(next) == 2 &&
+             tp == &PyZip_Type && ((_PyZipObject *)iter)->tuplesize == 2)
+    {
+        _Py_SET_OPCODE(*instr, FOR_ITER_ZIP);
+        goto success;
+    }
     else {
         SPECIALIZATION_FAIL(FOR_ITER,
                             _PySpecialization_ClassifyIterator(iter));
@@ -0,0 +1,19 @@
+// Auto-generated by Tools/scripts/generate_superinstructions.py from an execution profile.
+// Use "make regen-superinstructions" to regenerate it.
+
+#ifdef SUPERINSTRUCTION_TARGETS
+
+#else
+
+/* Return the profiled superinstruction for first followed by second
+ * (and third, if it is not 0), or 0 if there is none. */
+static int
+profiled_superinstruction(int first, int second, int third)
+{
+    switch ((first << 16) | (second << 8) | third) {
+        default:
+            return 0;
+    }
+}
+
+#endif
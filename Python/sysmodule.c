@@ -2009,6 +2009,23 @@ sys__debugmallocstats_impl(PyObject *module)
     Py_RETURN_NONE;
 }
 
+/*[clinic input]
+sys._trim_allocator -> size_t
+
+Return the free memory of pymalloc's arenas to the system.
+
+Future allocations are also steered away from the sparsest arenas, so
+that they can be released once their remaining blocks are freed.
+Return the number of bytes given back.
+[clinic start generated code]*/
+
+static size_t
+sys__trim_allocator_impl(PyObject *module)
+/*[clinic end generated code: output=245624f95e937a28 input=d97a5091a114cd8c]*/
+{
+    return _PyObject_TrimArenas();
+}
+
 #ifdef Py_TRACE_REFS
 /* Defined in objects.c because it uses static globals in that file */
 extern PyObject *_Py_GetObjects(PyObject *, PyObject *);
@@ -2249,6 +2266,7 @@ static PyMethodDef sys_methods[] = {
     SYS_GETTRACE_METHODDEF
     SYS_CALL_TRACING_METHODDEF
     SYS__DEBUGMALLOCSTATS_METHODDEF
+    SYS__TRIM_ALLOCATOR_METHODDEF
     SYS_SET_COROUTINE_ORIGIN_TRACKING_DEPTH_METHODDEF
     SYS_GET_COROUTINE_ORIGIN_TRACKING_DEPTH_METHODDEF
     {"set_asyncgen_hooks", _PyCFunction_CAST(sys_set_asyncgen_hooks),
@@ -0,0 +1,80 @@
+"""Benchmark dict or set lookups of present and missing keys.
+
+Builds dicts (or sets with --type set) of several sizes with str or int
+keys, then times the lookup of a shuffled list of probes, of which a
+given share is present in the dict: 100% for a hit-heavy workload such
+as attribute or keyword lookups, 0% or 10% for a miss-heavy one such as
+a cache, a routing table in front of a slower path or deduplication.
+The best time of a few runs is reported in nanoseconds per lookup.
+
+Compare the numbers printed by two builds to evaluate a change of the
+dict or set implementation.
+"""
+
+import argparse
+import collections
+import random
+import time
+
+
+def make_keys(kind, n, start):
+    if kind == 'str':
+        return [f"key:{i}" for i in range(start, start + n)]
+    # Spread the ints so that their low bits collide sometimes
+    return [i * 7919 for i in range(start, start + n)]
+
+
+def time_lookups(d, probes, repeat):
+    contains = d.__contains__
+    consume = collections.deque(maxlen=0).extend
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        consume(map(contains, probes))
+        elapsed = time.perf_counter() - start
+        if best is None or elapsed < best:
+            best = elapsed
+    return best / len(probes)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--sizes', type=int, nargs='+',
+                        default=[5, 1_000, 100_000, 1_000_000],
+                        help="numbers of keys of the dicts")
+    parser.add_argument('--hits', type=float, nargs='+',
+                        default=[1.0, 0.1, 0.0],
+                        help="shares of the probes present in the dict")
+    parser.add_argument('--kinds', nargs='+', choices=('str', 'int'),
+                        default=['str', 'int'])
+    parser.add_argument('--type', choices=('dict', 'set'), default='dict',
+                        help="container to benchmark")
+    parser.add_argument('--probes', type=int, default=1_000_000)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    print(f"{'keys':>5}{'size':>10}"
+          + "".join(f"{f'{hits:.0%} hits':>12}" for hits in args.hits))
+    for kind in args.kinds:
+        for size in args.sizes:
+            keys = make_keys(kind, size, 0)
+            missing = make_keys(kind, size, size)
+            if args.type == 'set':
+                d = set(keys)
+            else:
+                d = dict.fromkeys(keys)
+            line = f"{kind:>5}{size:>10}"
+            for hits in args.hits:
+                nhits = int(args.probes * hits)
+                probes = (rng.choices(keys, k=nhits)
+                          + rng.choices(missing, k=args.probes - nhits))
+                rng.shuffle(probes)
+                elapsed = time_lookups(d, probes, args.repeat)
+                line += f"{elapsed * 1e9:9.1f} ns"
+            print(line)
+
+
+if __name__ == '__main__':
+    main()
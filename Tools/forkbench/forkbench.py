@@ -0,0 +1,153 @@
+"""Benchmark the memory shared with the parent by forked worker processes.
+
+Mimics a prefork server: the parent imports a few modules and builds a
+heap of request routing tables and cached records, then forks workers
+which serve "requests" reading that heap.  Each worker reports the memory
+it no longer shares with the parent (Private_Dirty in
+/proc/self/smaps_rollup), which grows as reference counting and the
+garbage collector write to the inherited pages.
+
+The parent prepares the heap in three ways before forking:
+
+  none         nothing is done
+  freeze       gc.freeze(), the objects are ignored by the collector
+  immortalize  gc.freeze(immortalize=True), the objects are immortal
+
+Linux only.
+"""
+
+import argparse
+import gc
+import os
+import random
+import sys
+import time
+
+
+MODES = ('none', 'freeze', 'immortalize')
+
+
+def private_dirty():
+    """Return the private dirty memory of this process, in kiB."""
+    with open('/proc/self/smaps_rollup') as f:
+        for line in f:
+            if line.startswith('Private_Dirty:'):
+                return int(line.split()[1])
+    raise RuntimeError("Private_Dirty not found in smaps_rollup")
+
+
+class Record:
+    def __init__(self, key, fields, tags):
+        self.key = key
+        self.fields = fields
+        self.tags = tags
+
+
+def build(records, seed):
+    rng = random.Random(seed)
+    words = [f"word{i}" for i in range(5000)]
+    cache = {}
+    for i in range(records):
+        fields = {name: rng.choice(words)
+                  for name in ('user', 'path', 'method', 'status')}
+        fields['size'] = rng.randrange(1 << 20)
+        fields['ratio'] = rng.random()
+        tags = tuple(rng.sample(words, 3))
+        cache[f"key{i}"] = Record(i, fields, tags)
+    routes = {f"/{w}/{v}": (w, v, len(w)) for w in words[:200]
+              for v in words[200:260]}
+    return cache, routes
+
+
+def serve(heap, requests, seed):
+    import json
+    cache, routes = heap
+    rng = random.Random(seed)
+    keys = list(cache)
+    route_keys = list(routes)
+    total = 0
+    for _ in range(requests):
+        record = cache[rng.choice(keys)]
+        route = routes[rng.choice(route_keys)]
+        body = {'key': record.key, 'route': route, 'tags': record.tags}
+        body.update(record.fields)
+        total += len(json.dumps(body))
+    return total
+
+
+def worker(heap, args, seed, wfd):
+    gc.enable()
+    before = private_dirty()
+    serve(heap, args.requests, seed)
+    gc.collect()
+    after = private_dirty()
+    os.write(wfd, f"{before} {after}\n".encode())
+
+
+def run(mode, args):
+    import json, decimal, email.message, http.client, urllib.parse
+    heap = build(args.records, args.seed)
+    gc.disable()
+    gc.collect()
+    if mode == 'freeze':
+        gc.freeze()
+    elif mode == 'immortalize':
+        gc.freeze(immortalize=True)
+    start = time.perf_counter()
+    rfd, wfd = os.pipe()
+    pids = []
+    for i in range(args.workers):
+        pid = os.fork()
+        if pid == 0:
+            os.close(rfd)
+            try:
+                worker(heap, args, args.seed + i, wfd)
+            finally:
+                os._exit(0)
+        pids.append(pid)
+    os.close(wfd)
+    with os.fdopen(rfd) as f:
+        results = [tuple(map(int, line.split())) for line in f]
+    for pid in pids:
+        os.waitpid(pid, 0)
+    elapsed = time.perf_counter() - start
+    if len(results) != args.workers:
+        raise SystemExit(f"{mode}: a worker failed")
+    dirty = sum(after for before, after in results) / len(results)
+    growth = sum(after - before for before, after in results) / len(results)
+    print(f"{mode:12} {dirty / 1024:9.1f} MiB private dirty "
+          f"(+{growth / 1024:.1f} MiB while serving)  {elapsed:7.3f} s")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--records', type=int, default=200_000,
+                        help="number of cached records in the heap")
+    parser.add_argument('--requests', type=int, default=200_000,
+                        help="number of requests served by each worker")
+    parser.add_argument('--workers', type=int, default=4)
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--mode', choices=MODES, action='append',
+                        help="preparation of the heap (default: all)")
+    parser.add_argument('--child', choices=MODES, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if not os.path.exists('/proc/self/smaps_rollup'):
+        raise SystemExit("this benchmark needs /proc/self/smaps_rollup")
+    if args.child:
+        run(args.child, args)
+        return
+
+    # Each mode runs in a fresh interpreter: immortal objects can't be
+    # made mortal again.
+    import subprocess
+    for mode in args.mode or MODES:
+        cmd = [sys.executable, __file__, '--child', mode,
+               '--records', str(args.records),
+               '--requests', str(args.requests),
+               '--workers', str(args.workers), '--seed', str(args.seed)]
+        subprocess.run(cmd, check=True)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,95 @@
+"""Benchmark the latency of full collections as the heap grows.
+
+Builds heaps of increasingly many objects: records linked to their
+neighbours, with a share of them in garbage cycles, and times
+gc.collect() on each heap for several numbers of mark threads (see
+gc.set_mark_threads()).  The best time of a few collections is reported,
+along with the speedup over marking in a single thread.
+"""
+
+import argparse
+import gc
+import os
+import random
+import time
+
+
+class Record:
+    def __init__(self, key):
+        self.key = key
+        self.links = []
+        self.meta = {'key': key}
+
+
+def build(size, garbage, seed):
+    rng = random.Random(seed)
+    heap = [Record(i) for i in range(size)]
+    for record in heap:
+        for _ in range(2):
+            record.links.append(heap[rng.randrange(size)])
+    # Cycles which become garbage before each collection
+    cycles = int(size * garbage)
+    return heap, cycles
+
+
+def make_garbage(cycles):
+    for i in range(cycles // 2):
+        a = Record(-i)
+        b = Record(i)
+        a.links.append(b)
+        b.links.append(a)
+
+
+def time_collect(cycles, repeat):
+    best = None
+    for _ in range(repeat):
+        make_garbage(cycles)
+        start = time.perf_counter()
+        gc.collect()
+        elapsed = time.perf_counter() - start
+        if best is None or elapsed < best:
+            best = elapsed
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--sizes', type=int, nargs='+',
+                        default=[100_000, 300_000, 1_000_000, 3_000_000],
+                        help="number of records of each heap")
+    parser.add_argument('--threads', type=int, nargs='+',
+                        help="numbers of mark threads "
+                             "(default: 1, 2, 4 and the number of CPUs)")
+    parser.add_argument('--garbage', type=float, default=0.05,
+                        help="records in garbage cycles per record "
+                             "of the heap (default: %(default)s)")
+    parser.add_argument('--repeat', type=int, default=3)
+    parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+
+    threads = args.threads
+    if threads is None:
+        threads = sorted({1, 2, 4, os.cpu_count() or 1})
+    print(f"{'objects':>10}" + "".join(f"{f'{n} thr':>18}" for n in threads))
+
+    gc.disable()
+    for size in args.sizes:
+        heap, cycles = build(size, args.garbage, args.seed)
+        gc.collect()
+        objects = len(gc.get_objects())
+        times = []
+        for n in threads:
+            gc.set_mark_threads(n)
+            times.append(time_collect(cycles, args.repeat))
+        gc.set_mark_threads(1)
+        line = f"{objects:>10}"
+        for elapsed in times:
+            speedup = times[0] / elapsed
+            line += f"{elapsed * 1e3:9.1f} ms {speedup:4.1f}x"
+        print(line)
+        del heap
+        gc.collect()
+
+
+if __name__ == '__main__':
+    main()
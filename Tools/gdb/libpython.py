@@ -829,6 +829,8 @@ def _get_entries(keys):
             offset = 4 * dk_size
         else:
             offset = 8 * dk_size
+        # Skip the control bytes
+        offset += dk_size
 
         ent_addr = keys['dk_indices'].address
         ent_addr = ent_addr.cast(_type_unsigned_char_ptr()) + offset
@@ -1234,9 +1236,17 @@ def _dummy_key(self):
     def __iter__(self):
         dummy_ptr = self._dummy_key()
         table = self.field('table')
-        for i in safe_range(self.field('mask') + 1):
-            setentry = table[i]
-            key = setentry['key']
+        mask = int(self.field('mask'))
+        # The slots of compact tables are bare key pointers, and their kind
+        # is stored in the byte before the slots (see Objects/setobject.c)
+        keys = None
+        if mask >= 15 and int(table.cast(_type_unsigned_char_ptr())[-1]) == 1:
+            keys = table.cast(PyObjectPtr.get_gdb_type().pointer())
+        for i in safe_range(mask + 1):
+            if keys is not None:
+                key = keys[i]
+            else:
+                key = table[i]['key']
             if key != 0 and key != dummy_ptr:
                 yield PyObjectPtr.from_pyobject_ptr(key)
 
@@ -0,0 +1,343 @@
+"""Build the stencils of the JIT compiler in Python/jit.c.
+
+Tools/jit/template.c is compiled once for every opcode in STENCILS (and
+once more for the stencil of all other instructions), with the flags of
+the interpreter plus those in STENCIL_CFLAGS.  The code and read-only data
+of each object file become a stencil, and its relocations the holes that
+Python/jit.c fills in.  All of it is written to Python/jit_stencils.h.
+
+Only x86-64 ELF object files are supported.  The stencils are compiled for
+the large code model, so that every reference to a symbol is an absolute
+64-bit address (an R_X86_64_64 relocation) that can be patched wherever
+the code ends up in memory.
+"""
+
+import argparse
+import concurrent.futures
+import os
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+
+SCRIPT_NAME = "Tools/jit/build.py"
+TEMPLATE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "template.c")
+PYTHON_DIR = os.path.join(os.path.dirname(TEMPLATE), os.pardir, os.pardir, "Python")
+
+# The instructions with their own stencil.  Other specializations of the
+# same instruction and superinstructions use the stencil of the
+# instruction they are specialized from (or start with), if any.
+STENCILS = [
+    "NOP",
+    "LOAD_FAST",
+    "LOAD_CONST",
+    "LOAD_FAST_BORROW",
+    "LOAD_CONST_BORROW",
+    "STORE_FAST",
+    "POP_TOP",
+    "PUSH_NULL",
+    "COPY",
+    "SWAP",
+    "BINARY_OP_ADD_INT",
+    "BINARY_OP_SUBTRACT_INT",
+    "BINARY_OP_MULTIPLY_INT",
+    "BINARY_OP_ADD_FLOAT",
+    "BINARY_OP_SUBTRACT_FLOAT",
+    "BINARY_OP_MULTIPLY_FLOAT",
+    "COMPARE_OP_FLOAT_JUMP",
+    "COMPARE_OP_INT_JUMP",
+    "POP_JUMP_IF_FALSE",
+    "POP_JUMP_IF_TRUE",
+    "POP_JUMP_IF_NOT_NONE",
+    "POP_JUMP_IF_NONE",
+    "POP_JUMP_IF_FALSE_BORROW",
+    "POP_JUMP_IF_TRUE_BORROW",
+    "POP_JUMP_IF_NOTNONE_BORROW",
+    "POP_JUMP_IF_NONE_BORROW",
+    "JUMP_FORWARD",
+    "JUMP_BACKWARD",
+    "FOR_ITER_LIST",
+    "FOR_ITER_RANGE",
+]
+
+STENCIL_CFLAGS = [
+    "-O2",
+    # The stencils chain into each other with tail calls...
+    "-foptimize-sibling-calls",
+    "-fomit-frame-pointer",
+    # ...and must be position independent without a GOT or PLT, nor any
+    # code or data that jit.c doesn't copy.
+    "-fno-pic",
+    "-mcmodel=large",
+    "-fno-plt",
+    "-fno-jump-tables",
+    "-fno-asynchronous-unwind-tables",
+    "-fno-stack-protector",
+    "-fno-reorder-blocks-and-partition",
+    "-fcf-protection=none",
+    # The holes are symbols whose addresses aren't those of real objects.
+    "-Wno-array-bounds",
+]
+
+# Flags of the interpreter that add code or data the stencils can't have.
+UNSUPPORTED_CFLAG_PREFIXES = (
+    "-flto",
+    "-fprofile-",
+    "-fsanitize",
+    "-fcoverage",
+    "--coverage",
+)
+
+HOLES = {
+    "_JIT_CONTINUE": "HOLE_CONTINUE",
+    "_JIT_TARGET": "HOLE_TARGET",
+    "_JIT_INSTR": "HOLE_INSTR",
+    "_JIT_OPARG": "HOLE_OPARG",
+    "_JIT_OPERAND": "HOLE_OPERAND",
+}
+
+# Only these holes are called, and only ever tail called.
+TAIL_CALLED = {"_JIT_CONTINUE", "_JIT_TARGET"}
+
+ENTRY = "_JIT_ENTRY"
+ALIGNMENT = 16
+
+SHT_SYMTAB = 2
+SHT_RELA = 4
+SHT_NOBITS = 8
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+SHN_UNDEF = 0
+EM_X86_64 = 62
+R_X86_64_64 = 1
+
+ELF_HEADER = struct.Struct("<16sHHIQQQIHHHHHH")
+SECTION_HEADER = struct.Struct("<IIQQQQIIQQ")
+SYMBOL = struct.Struct("<IBBHQQ")
+RELA = struct.Struct("<QQq")
+
+
+class StencilError(Exception):
+    pass
+
+
+class Hole:
+    def __init__(self, offset, kind, symbol, addend):
+        self.offset = offset
+        self.kind = kind
+        self.symbol = symbol
+        self.addend = addend
+
+
+class Stencil:
+    def __init__(self, body, entry, holes):
+        self.body = body
+        self.entry = entry
+        self.holes = holes
+
+
+def c_string(data, offset):
+    return data[offset:data.index(b"\0", offset)].decode()
+
+
+def parse_object(data):
+    """Turn the contents of an object file into a Stencil."""
+    header = ELF_HEADER.unpack_from(data)
+    ident, machine, shoff, shentsize, shnum, shstrndx = (
+        header[0], header[2], header[6], header[11], header[12], header[13])
+    if ident[:4] != b"\x7fELF" or ident[4] != 2 or ident[5] != 1:
+        raise StencilError("not a little-endian ELF64 object file")
+    if machine != EM_X86_64:
+        raise StencilError("not an x86-64 object file")
+    sections = [SECTION_HEADER.unpack_from(data, shoff + i * shentsize)
+                for i in range(shnum)]
+    names = sections[shstrndx][4]
+
+    def name_of(section):
+        return c_string(data, names + section[0])
+
+    # Lay out the code first, then the read-only data.
+    body = bytearray()
+    bases = {}
+    for executable in (True, False):
+        for index, section in enumerate(sections):
+            _, sh_type, flags, _, offset, size, _, _, align, _ = section
+            if not flags & SHF_ALLOC or bool(flags & SHF_EXECINSTR) != executable:
+                continue
+            if size == 0:
+                continue
+            if flags & SHF_WRITE or sh_type == SHT_NOBITS:
+                raise StencilError(f"writable section {name_of(section)}")
+            if align > ALIGNMENT:
+                raise StencilError(f"section {name_of(section)} is aligned "
+                                   f"to more than {ALIGNMENT} bytes")
+            body.extend(bytes(-len(body) % max(align, 1)))
+            bases[index] = len(body)
+            body.extend(data[offset:offset + size])
+
+    symtab = next(s for s in sections if s[1] == SHT_SYMTAB)
+    strtab = sections[symtab[6]][4]
+    symbols = []
+    for offset in range(symtab[4], symtab[4] + symtab[5], symtab[9]):
+        st_name, _, _, shndx, value, _ = SYMBOL.unpack_from(data, offset)
+        symbols.append((c_string(data, strtab + st_name), shndx, value))
+
+    entry = None
+    for name, shndx, value in symbols:
+        if name == ENTRY and shndx in bases:
+            entry = bases[shndx] + value
+    if entry is None:
+        raise StencilError(f"no {ENTRY} function")
+
+    holes = []
+    for section in sections:
+        if section[1] != SHT_RELA or section[7] not in bases:
+            continue
+        base = bases[section[7]]
+        for offset in range(section[4], section[4] + section[5], section[9]):
+            r_offset, r_info, addend = RELA.unpack_from(data, offset)
+            kind = r_info & 0xFFFFFFFF
+            name, shndx, value = symbols[r_info >> 32]
+            if kind != R_X86_64_64:
+                raise StencilError(f"unsupported relocation type {kind} "
+                                   f"for {name or 'a local symbol'}")
+            location = base + r_offset
+            if shndx != SHN_UNDEF:
+                if shndx not in bases:
+                    raise StencilError(f"reference to {name or 'a section'} "
+                                       "that isn't copied")
+                hole = Hole(location, "HOLE_BASE", None,
+                            bases[shndx] + value + addend)
+            elif name in HOLES:
+                if name in TAIL_CALLED:
+                    check_tail_call(body, location, name)
+                hole = Hole(location, HOLES[name], None, addend)
+            else:
+                hole = Hole(location, "HOLE_SYMBOL", name, addend)
+            holes.append(hole)
+    holes.sort(key=lambda hole: hole.offset)
+    return Stencil(bytes(body), entry, holes)
+
+
+def check_tail_call(body, location, name):
+    """Check that the address patched in at location is only jumped to.
+
+    It must be loaded into a register with "movabs $name, %reg", and the
+    next indirect call or jump through that register must be a jump.  The
+    compiler may share the epilogue between tail calls, so follow a direct
+    jump right after the load.
+    """
+    rex, opcode = body[location - 2:location]
+    if rex not in (0x48, 0x49) or not 0xB8 <= opcode <= 0xBF:
+        raise StencilError(f"{name} is not loaded into a register")
+    register = opcode - 0xB8
+    prefix = b"\x41" if rex == 0x49 else b""
+    jump = prefix + bytes([0xFF, 0xE0 | register])
+    call = prefix + bytes([0xFF, 0xD0 | register])
+    start = location + 8
+    if body[start] == 0xEB:
+        start += 2 + struct.unpack_from("<b", body, start + 1)[0]
+    elif body[start] == 0xE9:
+        start += 5 + struct.unpack_from("<i", body, start + 1)[0]
+    jump_at = body.find(jump, start)
+    call_at = body.find(call, start)
+    if jump_at < 0 or 0 <= call_at < jump_at:
+        raise StencilError(f"{name} is called instead of tail called; "
+                           "is the compiler doing sibling call optimization?")
+
+
+def compile_stencil(cc, cflags, opcode, tempdir):
+    output = os.path.join(tempdir, f"{opcode}.o")
+    args = [*cc, *cflags, f"-I{PYTHON_DIR}", *STENCIL_CFLAGS,
+            f"-D_JIT_OPCODE={opcode}", "-c", TEMPLATE, "-o", output]
+    subprocess.run(args, check=True)
+    with open(output, "rb") as f:
+        try:
+            return parse_object(f.read())
+        except StencilError as exc:
+            raise StencilError(f"stencil for {opcode}: {exc}") from None
+
+
+def format_bytes(data):
+    lines = []
+    for start in range(0, len(data), 12):
+        chunk = data[start:start + 12]
+        lines.append("    " + ", ".join(f"0x{byte:02x}" for byte in chunk) + ",")
+    return lines
+
+
+def write_header(outfile, stencils, command):
+    symbols = sorted({hole.symbol for stencil in stencils.values()
+                      for hole in stencil.holes if hole.symbol})
+    lines = [
+        f"// Auto-generated by {SCRIPT_NAME} from Tools/jit/template.c with",
+        f"// {command}",
+        "",
+    ]
+    for name, stencil in stencils.items():
+        lines.append(f"static const unsigned char {name}_body[{len(stencil.body)}] = {{")
+        lines.extend(format_bytes(stencil.body))
+        lines.append("};")
+        if stencil.holes:
+            lines.append(f"static const Hole {name}_holes[{len(stencil.holes)}] = {{")
+            for hole in stencil.holes:
+                symbol = symbols.index(hole.symbol) if hole.symbol else 0
+                comment = f"  // {hole.symbol}" if hole.symbol else ""
+                lines.append(f"    {{0x{hole.offset:x}, {hole.kind}, {symbol}, "
+                             f"{hole.addend}}},{comment}")
+            lines.append("};")
+        lines.append("")
+
+    def initializer(name, stencil):
+        holes = f"{name}_holes" if stencil.holes else "NULL"
+        return (f"{{{len(stencil.body)}, {name}_body, {stencil.entry}, "
+                f"{len(stencil.holes)}, {holes}}}")
+
+    lines.append("static const Stencil generic_stencil = "
+                 f"{initializer('generic', stencils['generic'])};")
+    lines.append("")
+    lines.append("static const Stencil stencils[256] = {")
+    for name, stencil in stencils.items():
+        if name != "generic":
+            lines.append(f"    [{name}] = {initializer(name, stencil)},")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static const uintptr_t symbol_addresses[{max(len(symbols), 1)}] = {{")
+    for symbol in symbols:
+        lines.append(f"    (uintptr_t)&{symbol},")
+    lines.append("};")
+    with open(outfile, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.partition("\n")[0])
+    parser.add_argument("--cc", default="cc", help="the C compiler")
+    parser.add_argument("--output", required=True,
+                        help="the header to write (Python/jit_stencils.h)")
+    parser.add_argument("cflags", nargs="*",
+                        help="the flags the interpreter is compiled with")
+    args = parser.parse_args()
+    cc = shlex.split(args.cc)
+    cflags = [flag for flag in args.cflags
+              if not flag.startswith(UNSUPPORTED_CFLAG_PREFIXES)]
+    opcodes = {"generic": "0", **{name: name for name in STENCILS}}
+    with tempfile.TemporaryDirectory() as tempdir:
+        with concurrent.futures.ThreadPoolExecutor() as executor:
+            futures = {
+                name: executor.submit(compile_stencil, cc, cflags, opcode, tempdir)
+                for name, opcode in opcodes.items()
+            }
+            try:
+                stencils = {name: future.result()
+                            for name, future in futures.items()}
+            except StencilError as exc:
+                sys.exit(f"{SCRIPT_NAME}: {exc}")
+    command = shlex.join([*cc, *cflags, *STENCIL_CFLAGS])
+    write_header(args.output, stencils, command)
+
+
+if __name__ == "__main__":
+    main()
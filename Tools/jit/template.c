@@ -0,0 +1,471 @@
+/* Template for the stencils of the JIT compiler in Python/jit.c.
+ *
+ * Tools/jit/build.py compiles this file once for every opcode in its
+ * STENCILS list, with _JIT_OPCODE defined to that opcode, and once with
+ * _JIT_OPCODE defined to 0 for the stencil of all other instructions,
+ * which just returns to the interpreter.  The machine code of each
+ * _JIT_ENTRY function is a stencil, with holes where it refers to the
+ * following symbols.  Python/jit.c copies a stencil for every instruction
+ * of a code object and fills the holes in with:
+ *
+ *   _JIT_CONTINUE  the code for the instruction to run next
+ *   _JIT_TARGET    the code for the instruction's jump target
+ *   _JIT_INSTR     the instruction's address
+ *   _JIT_OPARG     the instruction's argument
+ *   _JIT_OPERAND   an opcode specific value, see compile_instruction()
+ *
+ * _JIT_CONTINUE and _JIT_TARGET must only be tail called, which build.py
+ * checks: the stencils chain into each other without using stack space,
+ * and only return (to the interpreter loop) when leaving the compiled
+ * code.  The instructions behave exactly like their implementations in
+ * Python/ceval.c, except that where those deoptimize, these leave the
+ * compiled code before the instruction for the interpreter to run it.
+ */
+
+#include "Python.h"
+#include "pycore_atomic.h"        // _Py_atomic_load_relaxed()
+#include "pycore_code.h"          // COMPARE_BORROWED
+#include "pycore_floatobject.h"   // _PyFloat_ExactDealloc()
+#include "pycore_frame.h"         // _PyInterpreterFrame
+#include "pycore_list.h"          // _PyListIterObject
+#include "pycore_long.h"          // _PyLong_Add()
+#include "pycore_object.h"        // _Py_DECREF_SPECIALIZED()
+#include "pycore_opcode.h"        // _PyOpcode_Deopt
+#include "pycore_pystate.h"       // _PyThreadState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
+#include "opcode.h"
+
+#include "ceval_macros.h"
+
+extern _Py_CODEUNIT _JIT_INSTR;
+extern char _JIT_OPARG;
+extern char _JIT_OPERAND;
+extern int _JIT_CONTINUE(_PyInterpreterFrame *frame, PyObject **stack_pointer,
+                         PyThreadState *tstate);
+extern int _JIT_TARGET(_PyInterpreterFrame *frame, PyObject **stack_pointer,
+                       PyThreadState *tstate);
+
+#define INSTR ((_Py_CODEUNIT *)(uintptr_t)&_JIT_INSTR)
+#define OPERAND ((uintptr_t)&_JIT_OPERAND)
+
+/* The interpreter's view of the instruction, for ceval_macros.h */
+#define next_instr (INSTR + 1)
+
+#define GETLOCAL(i)     (frame->localsplus[i])
+#define SETLOCAL(i, value)      do { PyObject *tmp = GETLOCAL(i); \
+                                     GETLOCAL(i) = value; \
+                                     Py_XDECREF(tmp); } while (0)
+
+#define TOP()             (stack_pointer[-1])
+#define SECOND()          (stack_pointer[-2])
+#define PEEK(n)           (stack_pointer[-(n)])
+#define SET_TOP(v)        (stack_pointer[-1] = (v))
+#define STACK_SHRINK(n)   (stack_pointer -= (n))
+#define PUSH(v)           (*stack_pointer++ = (v))
+#define POP()             (*--stack_pointer)
+
+#define CONTINUE() return _JIT_CONTINUE(frame, stack_pointer, tstate)
+#define JUMP_TO_TARGET() return _JIT_TARGET(frame, stack_pointer, tstate)
+
+/* Leave the compiled code, for the interpreter to run this instruction. */
+#define EXIT() \
+    do { \
+        frame->prev_instr = INSTR - 1; \
+        _PyFrame_SetStackPointer(frame, stack_pointer); \
+        return 0; \
+    } while (0)
+
+int
+_JIT_ENTRY(_PyInterpreterFrame *frame, PyObject **stack_pointer,
+           PyThreadState *tstate)
+{
+    int oparg = (int)(uintptr_t)&_JIT_OPARG;
+    frame->prev_instr = INSTR;
+
+    switch (_JIT_OPCODE) {
+
+        case NOP: {
+            CONTINUE();
+        }
+
+        case LOAD_FAST: {
+            PyObject *value = GETLOCAL(oparg);
+            assert(value != NULL);
+            Py_INCREF(value);
+            PUSH(value);
+            CONTINUE();
+        }
+
+        case LOAD_CONST: {
+            /* The operand is the constant */
+            PyObject *value = (PyObject *)OPERAND;
+            Py_INCREF(value);
+            PUSH(value);
+            CONTINUE();
+        }
+
+        case LOAD_FAST_BORROW: {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                EXIT();
+            }
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            CONTINUE();
+        }
+
+        case LOAD_CONST_BORROW: {
+            PyObject *value = (PyObject *)OPERAND;
+            OBJECT_STAT_INC(interpreter_increfs_avoided);
+            PUSH(value);
+            CONTINUE();
+        }
+
+        case STORE_FAST: {
+            PyObject *value = POP();
+            SETLOCAL(oparg, value);
+            CONTINUE();
+        }
+
+        case POP_TOP: {
+            PyObject *value = POP();
+            Py_DECREF(value);
+            CONTINUE();
+        }
+
+        case PUSH_NULL: {
+            PUSH(NULL);
+            CONTINUE();
+        }
+
+        case COPY: {
+            assert(oparg != 0);
+            PyObject *peek = PEEK(oparg);
+            Py_INCREF(peek);
+            PUSH(peek);
+            CONTINUE();
+        }
+
+        case SWAP: {
+            assert(oparg != 0);
+            PyObject *top = TOP();
+            SET_TOP(PEEK(oparg));
+            PEEK(oparg) = top;
+            CONTINUE();
+        }
+
+        case BINARY_OP_ADD_INT: {
+            PyObject *left = SECOND();
+            PyObject *right = TOP();
+            if (!PyLong_CheckExact(left) || Py_TYPE(right) != Py_TYPE(left)) {
+                EXIT();
+            }
+            PyObject *sum;
+            INT_RESULT_REUSING_INPUTS(left, right, +, _PyLong_Add, sum);
+            STACK_SHRINK(1);
+            SET_TOP(sum);
+            CONTINUE();
+        }
+
+        case BINARY_OP_SUBTRACT_INT: {
+            PyObject *left = SECOND();
+            PyObject *right = TOP();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                EXIT();
+            }
+            PyObject *sub;
+            INT_RESULT_REUSING_INPUTS(left, right, -, _PyLong_Subtract, sub);
+            STACK_SHRINK(1);
+            SET_TOP(sub);
+            CONTINUE();
+        }
+
+        case BINARY_OP_MULTIPLY_INT: {
+            PyObject *left = SECOND();
+            PyObject *right = TOP();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right)) {
+                EXIT();
+            }
+            PyObject *prod;
+            INT_RESULT_REUSING_INPUTS(left, right, *, _PyLong_Multiply, prod);
+            STACK_SHRINK(1);
+            SET_TOP(prod);
+            CONTINUE();
+        }
+
+        case BINARY_OP_ADD_FLOAT: {
+            PyObject *left = SECOND();
+            PyObject *right = TOP();
+            if (!PyFloat_CheckExact(left) || Py_TYPE(right) != Py_TYPE(left)) {
+                EXIT();
+            }
+            double dsum = ((PyFloatObject *)left)->ob_fval +
+                ((PyFloatObject *)right)->ob_fval;
+            PyObject *sum;
+            FLOAT_RESULT_REUSING_INPUTS(left, right, dsum, sum);
+            STACK_SHRINK(1);
+            SET_TOP(sum);
+            CONTINUE();
+        }
+
+        case BINARY_OP_SUBTRACT_FLOAT: {
+            PyObject *left = SECOND();
+            PyObject *right = TOP();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                EXIT();
+            }
+            double dsub = ((PyFloatObject *)left)->ob_fval -
+                ((PyFloatObject *)right)->ob_fval;
+            PyObject *sub;
+            FLOAT_RESULT_REUSING_INPUTS(left, right, dsub, sub);
+            STACK_SHRINK(1);
+            SET_TOP(sub);
+            CONTINUE();
+        }
+
+        case BINARY_OP_MULTIPLY_FLOAT: {
+            PyObject *left = SECOND();
+            PyObject *right = TOP();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                EXIT();
+            }
+            double dprod = ((PyFloatObject *)left)->ob_fval *
+                ((PyFloatObject *)right)->ob_fval;
+            PyObject *prod;
+            FLOAT_RESULT_REUSING_INPUTS(left, right, dprod, prod);
+            STACK_SHRINK(1);
+            SET_TOP(prod);
+            CONTINUE();
+        }
+
+        case COMPARE_OP_FLOAT_JUMP: {
+            /* Together with the following POP_JUMP_IF_FALSE or
+               POP_JUMP_IF_TRUE.  The operand is the cached jump mask. */
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyFloat_CheckExact(left) || !PyFloat_CheckExact(right)) {
+                EXIT();
+            }
+            double dleft = PyFloat_AS_DOUBLE(left);
+            double dright = PyFloat_AS_DOUBLE(right);
+            if (isnan(dleft) || isnan(dright)) {
+                EXIT();
+            }
+            int sign = (dleft > dright) - (dleft < dright);
+            STACK_SHRINK(2);
+            DECREF_COMPARE_OPERANDS(oparg,
+                _Py_DECREF_SPECIALIZED(left, _PyFloat_ExactDealloc),
+                _Py_DECREF_SPECIALIZED(right, _PyFloat_ExactDealloc));
+            if ((1 << (sign + 1)) & (int)OPERAND) {
+                JUMP_TO_TARGET();
+            }
+            CONTINUE();
+        }
+
+        case COMPARE_OP_INT_JUMP: {
+            /* Like COMPARE_OP_FLOAT_JUMP */
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            if (!PyLong_CheckExact(left) || !PyLong_CheckExact(right) ||
+                (size_t)(Py_SIZE(left) + 1) > 2 ||
+                (size_t)(Py_SIZE(right) + 1) > 2)
+            {
+                EXIT();
+            }
+            Py_ssize_t ileft = Py_SIZE(left) * ((PyLongObject *)left)->ob_digit[0];
+            Py_ssize_t iright = Py_SIZE(right) * ((PyLongObject *)right)->ob_digit[0];
+            int sign = (ileft > iright) - (ileft < iright);
+            STACK_SHRINK(2);
+            DECREF_COMPARE_OPERANDS(oparg,
+                _Py_DECREF_SPECIALIZED(left, (destructor)PyObject_Free),
+                _Py_DECREF_SPECIALIZED(right, (destructor)PyObject_Free));
+            if ((1 << (sign + 1)) & (int)OPERAND) {
+                JUMP_TO_TARGET();
+            }
+            CONTINUE();
+        }
+
+        case POP_JUMP_IF_FALSE: {
+            PyObject *cond = POP();
+            if (Py_IsTrue(cond)) {
+                _Py_DECREF_NO_DEALLOC(cond);
+                CONTINUE();
+            }
+            if (Py_IsFalse(cond)) {
+                _Py_DECREF_NO_DEALLOC(cond);
+                JUMP_TO_TARGET();
+            }
+            int err = PyObject_IsTrue(cond);
+            Py_DECREF(cond);
+            if (err > 0) {
+                CONTINUE();
+            }
+            if (err == 0) {
+                JUMP_TO_TARGET();
+            }
+            goto error;
+        }
+
+        case POP_JUMP_IF_TRUE: {
+            PyObject *cond = POP();
+            if (Py_IsFalse(cond)) {
+                _Py_DECREF_NO_DEALLOC(cond);
+                CONTINUE();
+            }
+            if (Py_IsTrue(cond)) {
+                _Py_DECREF_NO_DEALLOC(cond);
+                JUMP_TO_TARGET();
+            }
+            int err = PyObject_IsTrue(cond);
+            Py_DECREF(cond);
+            if (err > 0) {
+                JUMP_TO_TARGET();
+            }
+            if (err == 0) {
+                CONTINUE();
+            }
+            goto error;
+        }
+
+        case POP_JUMP_IF_NOT_NONE: {
+            PyObject *value = POP();
+            int jump = !Py_IsNone(value);
+            Py_DECREF(value);
+            if (jump) {
+                JUMP_TO_TARGET();
+            }
+            CONTINUE();
+        }
+
+        case POP_JUMP_IF_NONE: {
+            PyObject *value = POP();
+            if (Py_IsNone(value)) {
+                _Py_DECREF_NO_DEALLOC(value);
+                JUMP_TO_TARGET();
+            }
+            Py_DECREF(value);
+            CONTINUE();
+        }
+
+        case POP_JUMP_IF_FALSE_BORROW: {
+            PyObject *cond = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (Py_IsTrue(cond)) {
+                CONTINUE();
+            }
+            if (Py_IsFalse(cond)) {
+                JUMP_TO_TARGET();
+            }
+            int err = PyObject_IsTrue(cond);
+            if (err > 0) {
+                CONTINUE();
+            }
+            if (err == 0) {
+                JUMP_TO_TARGET();
+            }
+            goto error;
+        }
+
+        case POP_JUMP_IF_TRUE_BORROW: {
+            PyObject *cond = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (Py_IsFalse(cond)) {
+                CONTINUE();
+            }
+            if (Py_IsTrue(cond)) {
+                JUMP_TO_TARGET();
+            }
+            int err = PyObject_IsTrue(cond);
+            if (err > 0) {
+                JUMP_TO_TARGET();
+            }
+            if (err == 0) {
+                CONTINUE();
+            }
+            goto error;
+        }
+
+        case POP_JUMP_IF_NOTNONE_BORROW: {
+            PyObject *value = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (!Py_IsNone(value)) {
+                JUMP_TO_TARGET();
+            }
+            CONTINUE();
+        }
+
+        case POP_JUMP_IF_NONE_BORROW: {
+            PyObject *value = POP();
+            OBJECT_STAT_INC(interpreter_decrefs_avoided);
+            if (Py_IsNone(value)) {
+                JUMP_TO_TARGET();
+            }
+            CONTINUE();
+        }
+
+        case JUMP_FORWARD: {
+            JUMP_TO_TARGET();
+        }
+
+        case JUMP_BACKWARD: {
+            /* Leave the loop for the interpreter to handle the eval breaker
+               (signals, GIL drop requests, ...) or to start tracing. */
+            if (_Py_atomic_load_relaxed(&tstate->interp->ceval.eval_breaker) ||
+                tstate->cframe->use_tracing)
+            {
+                EXIT();
+            }
+            JUMP_TO_TARGET();
+        }
+
+        case FOR_ITER_LIST: {
+            _PyListIterObject *it = (_PyListIterObject *)TOP();
+            if (Py_TYPE(it) != &PyListIter_Type) {
+                EXIT();
+            }
+            PyListObject *seq = it->it_seq;
+            if (seq) {
+                if (it->it_index < PyList_GET_SIZE(seq)) {
+                    PyObject *next = PyList_GET_ITEM(seq, it->it_index++);
+                    Py_INCREF(next);
+                    PUSH(next);
+                    CONTINUE();
+                }
+                it->it_seq = NULL;
+                Py_DECREF(seq);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(it);
+            JUMP_TO_TARGET();
+        }
+
+        case FOR_ITER_RANGE: {
+            /* Together with the following STORE_FAST, whose argument is
+               the operand. */
+            _PyRangeIterObject *r = (_PyRangeIterObject *)TOP();
+            if (Py_TYPE(r) != &PyRangeIter_Type) {
+                EXIT();
+            }
+            if (r->index >= r->len) {
+                STACK_SHRINK(1);
+                Py_DECREF(r);
+                JUMP_TO_TARGET();
+            }
+            long value = (long)(r->start +
+                                (unsigned long)(r->index++) * r->step);
+            if (_PyLong_AssignValue(&GETLOCAL(OPERAND), value) < 0) {
+                goto error;
+            }
+            CONTINUE();
+        }
+
+        default: {
+            EXIT();
+        }
+    }
+
+error:
+    frame->prev_instr = INSTR;
+    _PyFrame_SetStackPointer(frame, stack_pointer);
+    return -1;
+}
@@ -0,0 +1,270 @@
+"""Generate superinstructions from an execution profile.
+
+Python built with --enable-pystats records how often each pair and triple
+of instructions is executed.  This script reads those counts (by default
+from the files left in /tmp/py_stats/ by running with -X pystats), picks
+the hottest sequences of simple instructions that are not fused yet, and
+writes
+
+  * the list of profiled superinstructions in Lib/opcode.py, and
+  * their implementations and quickening table to
+    Python/superinstructions.h.
+
+Afterwards, run "make regen-opcode regen-opcode-targets" (or just
+"make regen-superinstructions", which does all of it) and rebuild.
+Use "--count 0" to go back to the hand-written superinstructions only.
+"""
+
+import argparse
+import collections
+import os
+import re
+import sys
+import tokenize
+
+SCRIPT_NAME = "Tools/scripts/generate_superinstructions.py"
+
+if os.name == "nt":
+    DEFAULT_DIR = "c:\\temp\\py_stats\\"
+else:
+    DEFAULT_DIR = "/tmp/py_stats/"
+
+BEGIN_MARKER = "# BEGIN PROFILED SUPERINSTRUCTIONS\n"
+END_MARKER = "# END PROFILED SUPERINSTRUCTIONS\n"
+
+# Instructions that can be part of a generated superinstruction: they
+# have no inline cache, never jump and cannot fail.  The C code runs with
+# "oparg" set to the instruction's argument.
+COMPONENTS = {
+    "LOAD_FAST": [
+        "PyObject *value = GETLOCAL(oparg);",
+        "assert(value != NULL);",
+        "Py_INCREF(value);",
+        "PUSH(value);",
+    ],
+    "LOAD_CONST": [
+        "PyObject *value = GETITEM(consts, oparg);",
+        "Py_INCREF(value);",
+        "PUSH(value);",
+    ],
+    "STORE_FAST": [
+        "PyObject *value = POP();",
+        "SETLOCAL(oparg, value);",
+    ],
+    "POP_TOP": [
+        "PyObject *value = POP();",
+        "Py_DECREF(value);",
+    ],
+    "PUSH_NULL": [
+        "BASIC_PUSH(NULL);",
+    ],
+    "COPY": [
+        "assert(oparg != 0);",
+        "PyObject *peek = PEEK(oparg);",
+        "Py_INCREF(peek);",
+        "PUSH(peek);",
+    ],
+    "SWAP": [
+        "assert(oparg != 0);",
+        "PyObject *top = TOP();",
+        "SET_TOP(PEEK(oparg));",
+        "PEEK(oparg) = top;",
+    ],
+}
+
+
+def load_opcode_module(opcode_py):
+    module = {}
+    with tokenize.open(opcode_py) as fp:
+        code = fp.read()
+    exec(code, module)
+    return module
+
+
+def instruction_names(module):
+    """Map every opcode number to its name, as in Include/opcode.h."""
+    specialized = iter(module["_specialized_instructions"])
+    names = []
+    for name in module["opname"]:
+        if name.startswith("<"):
+            name = next(specialized, name)
+        names.append(name)
+    return names
+
+
+def base_sequences(module):
+    """Map every opcode number to the unspecialized instructions it runs."""
+    deopt = {
+        specialized: base
+        for base, family in module["_specializations"].items()
+        for specialized in family
+    }
+    return [tuple(deopt.get(part, part) for part in name.split("__"))
+            if "__" in name else (deopt.get(name, name),)
+            for name in instruction_names(module)]
+
+
+def read_stats(stats_dir):
+    stats = collections.Counter()
+    for filename in os.listdir(stats_dir):
+        with open(os.path.join(stats_dir, filename)) as fd:
+            for line in fd:
+                key, sep, value = line.rpartition(":")
+                if sep:
+                    stats[key.strip()] += int(value)
+    return stats
+
+
+PAIR_RE = re.compile(r"opcode\[(\d+)\]\.pair_count\[(\d+)\]$")
+TRIPLE_RE = re.compile(r"opcode\[(\d+)\]\.triple_count\[(\d+)\]\[(\d+)\]$")
+EXECUTION_RE = re.compile(r"opcode\[(\d+)\]\.execution_count$")
+
+
+def sequence_counts(stats, module):
+    """Count the executed pairs and triples of unspecialized instructions.
+
+    The counts in the profile are for instructions as they were executed,
+    so a superinstruction that already exists stands for several
+    instructions: count the sequences inside it by its execution count,
+    and only those that cross into the next executed instruction (or,
+    for triples, span three of them) by the pair and triple counts.
+    """
+    seq = base_sequences(module)
+    counts = collections.Counter()
+    total = 0
+    for key, value in stats.items():
+        if m := EXECUTION_RE.match(key):
+            total += value
+            ops = seq[int(m.group(1))]
+            for size in (2, 3):
+                for start in range(len(ops) - size + 1):
+                    counts[ops[start:start + size]] += value
+        elif m := PAIR_RE.match(key):
+            first, second = (seq[int(op)] for op in m.groups())
+            ops = first + second
+            for size in (2, 3):
+                for start in range(len(ops) - size + 1):
+                    end = start + size
+                    if start < len(first) < end:
+                        counts[ops[start:end]] += value
+        elif m := TRIPLE_RE.match(key):
+            first, second, third = (seq[int(op)] for op in m.groups())
+            if len(second) == 1:
+                counts[(first[-1], second[0], third[0])] += value
+    return counts, total
+
+
+def choose(counts, total, module, count, min_share):
+    """Pick the sequences that save the most instruction dispatches."""
+    profiled = {
+        name
+        for family in module.get("_profiled_superinstructions", {}).values()
+        for name in family
+    }
+    seq = base_sequences(module)
+    existing = {
+        seq[op]
+        for op, name in enumerate(instruction_names(module))
+        if "__" in name and name not in profiled
+    }
+    candidates = []
+    for ops, n in counts.items():
+        if ops in existing or not all(op in COMPONENTS for op in ops):
+            continue
+        saved = n * (len(ops) - 1)
+        if total and saved < total * min_share:
+            continue
+        candidates.append((saved, ops))
+    candidates.sort(key=lambda c: (-c[0], c[1]))
+    return [ops for saved, ops in candidates[:count]]
+
+
+def write_opcode_py(opcode_py, chosen):
+    with open(opcode_py, encoding="utf-8") as fp:
+        source = fp.read()
+    start = source.index(BEGIN_MARKER) + len(BEGIN_MARKER)
+    end = source.index(END_MARKER)
+    families = collections.defaultdict(list)
+    for ops in chosen:
+        families[ops[0]].append("__".join(ops))
+    lines = ["_profiled_superinstructions = {\n"]
+    for family in sorted(families):
+        lines.append(f'    "{family}": [\n')
+        for name in sorted(families[family]):
+            lines.append(f'        "{name}",\n')
+        lines.append("    ],\n")
+    lines.append("}\n")
+    new_source = source[:start] + "".join(lines) + source[end:]
+    if new_source != source:
+        with open(opcode_py, "w", encoding="utf-8") as fp:
+            fp.write(new_source)
+
+
+def write_header(outfile, chosen):
+    with open(outfile, "w") as out:
+        out.write(f"// Auto-generated by {SCRIPT_NAME} from an execution profile.\n")
+        out.write("// Use \"make regen-superinstructions\" to regenerate it.\n")
+        out.write("\n#ifdef SUPERINSTRUCTION_TARGETS\n")
+        for ops in chosen:
+            out.write(f"\n        TARGET({'__'.join(ops)}) {{\n")
+            for i, op in enumerate(ops):
+                if i:
+                    out.write("            NEXTOPARG();\n")
+                    out.write("            next_instr++;\n")
+                out.write("            {\n")
+                for line in COMPONENTS[op]:
+                    out.write(f"                {line}\n")
+                out.write("            }\n")
+            out.write("            DISPATCH();\n")
+            out.write("        }\n")
+        out.write("\n#else\n\n")
+        out.write("/* Return the profiled superinstruction for first followed by second\n")
+        out.write(" * (and third, if it is not 0), or 0 if there is none. */\n")
+        out.write("static int\n")
+        out.write("profiled_superinstruction(int first, int second, int third)\n")
+        out.write("{\n")
+        out.write("    switch ((first << 16) | (second << 8) | third) {\n")
+        for ops in chosen:
+            key = " | ".join(f"({op} << {16 - 8*i})" if i < 2 else op
+                             for i, op in enumerate(ops))
+            out.write(f"        case {key}:\n")
+            out.write(f"            return {'__'.join(ops)};\n")
+        out.write("        default:\n")
+        out.write("            return 0;\n")
+        out.write("    }\n")
+        out.write("}\n")
+        out.write("\n#endif\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.partition("\n")[0])
+    parser.add_argument("opcode_py", help="path to Lib/opcode.py")
+    parser.add_argument("header", help="path to Python/superinstructions.h")
+    parser.add_argument("--stats-dir", default=DEFAULT_DIR,
+                        help="directory of Py_STATS output (default: %(default)s)")
+    parser.add_argument("--count", type=int, default=8,
+                        help="maximum number of superinstructions (default: %(default)s)")
+    parser.add_argument("--min-share", type=float, default=0.005,
+                        help="minimum share of all executed instructions a "
+                             "superinstruction must save (default: %(default)s)")
+    parser.add_argument("--dry-run", action="store_true",
+                        help="print the selection without writing any files")
+    args = parser.parse_args()
+
+    module = load_opcode_module(args.opcode_py)
+    chosen = []
+    if args.count > 0:
+        counts, total = sequence_counts(read_stats(args.stats_dir), module)
+        chosen = choose(counts, total, module, args.count, args.min_share)
+        for ops in chosen:
+            print(f"{'__'.join(ops)}: {counts[ops]}")
+    if args.dry_run:
+        return
+    write_opcode_py(args.opcode_py, chosen)
+    write_header(args.header, chosen)
+    print(f"{args.header} and {args.opcode_py} regenerated "
+          f"with {len(chosen)} profiled superinstructions")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
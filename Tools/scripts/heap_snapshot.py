@@ -0,0 +1,263 @@
+"""Analyze a heap snapshot written by gc.dump_heap().
+
+The snapshot is a graph whose nodes are the objects tracked by the garbage
+collector, plus the untracked objects they refer to (ints, strings, ...).
+This script computes the dominator tree of that graph and prints
+
+  * the types with the most instances, with their total shallow size, and
+  * the objects which retain the most memory: the retained size of an
+    object is the size of all objects that would be freed along with it.
+
+The roots of the graph are the objects with more references than the
+snapshot knows about: they are referred to from C code, from the stack of
+a frame or from untracked objects.  A super-root refers to all of them.
+"""
+
+import argparse
+import collections
+import mmap
+import sys
+
+MAGIC = b"PYHEAP\0\1"
+
+
+class SnapshotError(Exception):
+    pass
+
+
+class Snapshot:
+    """The object graph of a heap snapshot.
+
+    Objects are numbered in the order they appear in the file; the
+    attributes are lists indexed by those numbers.
+    """
+
+    def __init__(self):
+        self.types = {}         # type address -> type name
+        self.index = {}         # object address -> object number
+        self.addresses = []
+        self.type_addresses = []
+        self.sizes = []
+        self.refcounts = []
+        self.edges = []         # object number -> list of object addresses
+        self.nnodes = 0
+
+    def type_name(self, i):
+        return self.types.get(self.type_addresses[i], "?")
+
+    def _add(self, address, type_address, size, refcount, edges):
+        i = self.index.get(address)
+        if i is not None:
+            # A leaf seen again
+            return
+        self.index[address] = len(self.addresses)
+        self.addresses.append(address)
+        self.type_addresses.append(type_address)
+        self.sizes.append(size)
+        self.refcounts.append(refcount)
+        self.edges.append(edges)
+
+    def successors(self, i):
+        index = self.index
+        for address in self.edges[i]:
+            j = index.get(address)
+            if j is not None:
+                yield j
+
+
+def read_snapshot(path):
+    """Read the snapshot written by gc.dump_heap(path)."""
+    with open(path, "rb") as f:
+        with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as data:
+            return _parse(data)
+
+
+def _parse(data):
+    if data[:len(MAGIC)] != MAGIC:
+        raise SnapshotError("not a heap snapshot")
+    pos = len(MAGIC)
+    end = len(data)
+
+    def varint():
+        nonlocal pos
+        result = shift = 0
+        while True:
+            if pos >= end:
+                raise SnapshotError("truncated heap snapshot")
+            byte = data[pos]
+            pos += 1
+            result |= (byte & 0x7f) << shift
+            if byte < 0x80:
+                return result
+            shift += 7
+
+    snapshot = Snapshot()
+    while True:
+        if pos >= end:
+            raise SnapshotError("truncated heap snapshot")
+        tag = data[pos:pos+1]
+        pos += 1
+        if tag == b"N" or tag == b"L":
+            address = varint()
+            type_address = varint()
+            size = varint()
+            refcount = varint()
+            edges = []
+            if tag == b"N":
+                edges = [varint() for i in range(varint())]
+                snapshot.nnodes += 1
+            snapshot._add(address, type_address, size, refcount, edges)
+        elif tag == b"T":
+            address = varint()
+            length = varint()
+            name = bytes(data[pos:pos+length]).decode("utf-8", "replace")
+            pos += length
+            snapshot.types[address] = name
+        elif tag == b"E":
+            if varint() != snapshot.nnodes:
+                raise SnapshotError("corrupted heap snapshot")
+            return snapshot
+        else:
+            raise SnapshotError(f"unknown record {tag!r} at offset {pos-1}")
+
+
+def find_roots(snapshot):
+    """Return the objects referred to from outside of the snapshot."""
+    indegree = [0] * len(snapshot.addresses)
+    for i in range(len(snapshot.addresses)):
+        for j in snapshot.successors(i):
+            indegree[j] += 1
+    return [i for i, refcount in enumerate(snapshot.refcounts)
+            if refcount > indegree[i]]
+
+
+def dominators(snapshot, roots):
+    """Return the immediate dominator of each object.
+
+    The super-root is numbered len(snapshot.addresses), and is its own
+    dominator; unreachable objects have None.  This uses the iterative
+    algorithm of Cooper, Harvey and Kennedy.
+    """
+    n = len(snapshot.addresses)
+    root = n
+
+    def successors(i):
+        return iter(roots) if i == root else snapshot.successors(i)
+
+    # Depth-first search to number the objects in postorder
+    postorder = []
+    order = [None] * (n + 1)
+    visited = bytearray(n + 1)
+    visited[root] = 1
+    stack = [(root, successors(root))]
+    while stack:
+        i, children = stack[-1]
+        for j in children:
+            if not visited[j]:
+                visited[j] = 1
+                stack.append((j, successors(j)))
+                break
+        else:
+            stack.pop()
+            order[i] = len(postorder)
+            postorder.append(i)
+
+    predecessors = [[] for i in range(n + 1)]
+    for i in postorder:
+        for j in successors(i):
+            predecessors[j].append(i)
+
+    idom = [None] * (n + 1)
+    idom[root] = root
+
+    def intersect(a, b):
+        while a != b:
+            while order[a] < order[b]:
+                a = idom[a]
+            while order[b] < order[a]:
+                b = idom[b]
+        return a
+
+    changed = True
+    while changed:
+        changed = False
+        for i in reversed(postorder):
+            if i == root:
+                continue
+            new = None
+            for p in predecessors[i]:
+                if idom[p] is not None:
+                    new = p if new is None else intersect(p, new)
+            if idom[i] != new:
+                idom[i] = new
+                changed = True
+    return idom, postorder
+
+
+def retained_sizes(snapshot, idom, postorder):
+    """Return the retained size of each object (and of the super-root)."""
+    retained = snapshot.sizes + [0]
+    root = len(snapshot.addresses)
+    # Children come before their dominator in postorder
+    for i in postorder:
+        if i != root:
+            retained[idom[i]] += retained[i]
+    return retained
+
+
+def format_size(size):
+    for unit in ("B", "KiB", "MiB"):
+        if size < 1024:
+            return f"{size:.0f} {unit}" if unit == "B" else f"{size:.1f} {unit}"
+        size /= 1024
+    return f"{size:.1f} GiB"
+
+
+def summarize(snapshot, top, out=sys.stdout):
+    counts = collections.Counter()
+    sizes = collections.Counter()
+    for i in range(len(snapshot.addresses)):
+        name = snapshot.type_name(i)
+        counts[name] += 1
+        sizes[name] += snapshot.sizes[i]
+
+    print(f"{snapshot.nnodes} tracked objects, "
+          f"{len(snapshot.addresses)} objects in total, "
+          f"{format_size(sum(snapshot.sizes))}", file=out)
+    print(file=out)
+    print(f"{'count':>10} {'size':>12}  type", file=out)
+    for name, size in sizes.most_common(top):
+        print(f"{counts[name]:>10} {format_size(size):>12}  {name}", file=out)
+
+    roots = find_roots(snapshot)
+    idom, postorder = dominators(snapshot, roots)
+    retained = retained_sizes(snapshot, idom, postorder)
+    root = len(snapshot.addresses)
+    largest = sorted((i for i in postorder if i != root),
+                     key=retained.__getitem__, reverse=True)
+    print(file=out)
+    print(f"{'retained':>12} {'size':>12}  object", file=out)
+    for i in largest[:top]:
+        print(f"{format_size(retained[i]):>12} "
+              f"{format_size(snapshot.sizes[i]):>12}  "
+              f"<{snapshot.type_name(i)} at {snapshot.addresses[i]:#x}>",
+              file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("snapshot", help="file written by gc.dump_heap()")
+    parser.add_argument("--top", type=int, default=20,
+                        help="number of types and objects to print "
+                             "(default: %(default)s)")
+    args = parser.parse_args()
+    try:
+        snapshot = read_snapshot(args.snapshot)
+    except SnapshotError as exc:
+        sys.exit(f"{args.snapshot}: {exc}")
+    summarize(snapshot, args.top)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
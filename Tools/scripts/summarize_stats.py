@@ -31,6 +31,7 @@
 opmap = dict(sorted(opmap.items()))
 
 TOTAL = "specialization.deferred", "specialization.hit", "specialization.miss", "execution_count"
+POLYMORPHISM = "specialization.monomorphic", "specialization.polymorphic", "specialization.megamorphic"
 
 def print_specialization_stats(name, family_stats, defines):
     if "specializable" not in family_stats:
@@ -49,6 +50,8 @@ def print_specialization_stats(name, family_stats, defines):
                 label = "unquickened"
             elif key in ("specialization.success",  "specialization.failure", "specializable"):
                 continue
+            elif key in POLYMORPHISM:
+                continue
             elif key.startswith("pair"):
                 continue
             else:
@@ -67,8 +70,18 @@ def print_specialization_stats(name, family_stats, defines):
                 val = family_stats.get(key, 0)
                 rows.append((label, val, f"{100*val/total_attempts:0.1f}%"))
             emit_table(("", "Count:", "Ratio:"), rows)
+        total_sites = sum(family_stats.get(key, 0) for key in POLYMORPHISM)
+        if total_sites:
+            print_title("Site polymorphism", 4)
+            rows = []
+            for key in POLYMORPHISM:
+                label = key[len("specialization."):]
+                label = label[0].upper() + label[1:]
+                val = family_stats.get(key, 0)
+                rows.append((label, val, f"{100*val/total_sites:0.1f}%"))
+            emit_table(("", "Count:", "Ratio:"), rows)
         total_failures = family_stats.get("specialization.failure", 0)
-        failure_kinds = [ 0 ] * 30
+        failure_kinds = [ 0 ] * 32
         for key in family_stats:
             if not key.startswith("specialization.failure_kind"):
                 continue
@@ -377,12 +390,38 @@ def emit_pair_counts(opcode_stats, total):
                     succ_rows
                 )
 
+def emit_triple_counts(opcode_stats, stats, total):
+    triple_counts = []
+    for i, opcode_stat in enumerate(opcode_stats):
+        for key, value in opcode_stat.items():
+            if key.startswith("triple_count"):
+                x, y = key[13:-1].split("][")
+                if value:
+                    triple_counts.append((value, (i, int(x), int(y))))
+    with Section("Triple counts", summary="Triple counts for top 100 triples"):
+        triple_counts.sort(reverse=True)
+        cumulative = 0
+        rows = []
+        for (count, triple) in itertools.islice(triple_counts, 100):
+            cumulative += count
+            rows.append((" ".join(opname[op] for op in triple), count,
+                         f"{100*count/total:0.1f}%",
+                         f"{100*cumulative/total:0.1f}%"))
+        emit_table(("Triple", "Count:", "Self:", "Cumulative:"),
+            rows
+        )
+        dropped = stats.get("Opcode triples dropped", 0)
+        if dropped:
+            print(f"{dropped} triples ({100*dropped/total:0.1f}%) did not fit in the table.")
+            print()
+
 def main():
     stats = gather_stats()
     opcode_stats = extract_opcode_stats(stats)
     total = get_total(opcode_stats)
     emit_execution_counts(opcode_stats, total)
     emit_pair_counts(opcode_stats, total)
+    emit_triple_counts(opcode_stats, stats, total)
     emit_specialization_stats(opcode_stats)
     emit_specialization_overview(opcode_stats, total)
     emit_call_stats(stats)
@@ -1390,6 +1390,65 @@ def upper_conversion_dense(STR):
         s_upper()
 
 
+#### Decoding UTF-8
+
+_utf8_texts = {
+    "ascii": "GET /index.html HTTP/1.1, {\"key\": \"value\", \"n\": 42}\n",
+    "latin-1": "Voil\xe0 un caf\xe9 cr\xe8me, s'il vous pla\xeet, gar\xe7on.\n",
+    "cjk": "\u4eca\u65e5\u306f\u3044\u3044\u5929\u6c17\u3067\u3059\u306d\u3002"
+           "\uc548\ub155\ud558\uc138\uc694 \u4f60\u597d\u4e16\u754c\n",
+    "emoji": "Launch day \U0001f680\U0001f389 thanks all \U0001f44d\U0001f600"
+             " \u2764\ufe0f\U0001f525\n",
+}
+_utf8_data = dict((name, (text*1000).encode("utf-8"))
+                  for (name, text) in _utf8_texts.items())
+
+def _get_utf8_data(STR, name):
+    if STR is UNICODE:
+        return _utf8_data[name]
+    raise UnsupportedType
+
+@bench('(ascii_text*1000).encode("utf-8").decode("utf-8")',
+       "decode UTF-8", 100)
+def decode_utf8_ascii(STR):
+    data = _get_utf8_data(STR, "ascii")
+    data_decode = data.decode
+    for x in _RANGE_100:
+        data_decode("utf-8")
+
+@bench('(latin1_text*1000).encode("utf-8").decode("utf-8")',
+       "decode UTF-8", 100)
+def decode_utf8_latin1(STR):
+    data = _get_utf8_data(STR, "latin-1")
+    data_decode = data.decode
+    for x in _RANGE_100:
+        data_decode("utf-8")
+
+@bench('(cjk_text*1000).encode("utf-8").decode("utf-8")',
+       "decode UTF-8", 100)
+def decode_utf8_cjk(STR):
+    data = _get_utf8_data(STR, "cjk")
+    data_decode = data.decode
+    for x in _RANGE_100:
+        data_decode("utf-8")
+
+@bench('(emoji_text*1000).encode("utf-8").decode("utf-8")',
+       "decode UTF-8", 100)
+def decode_utf8_emoji(STR):
+    data = _get_utf8_data(STR, "emoji")
+    data_decode = data.decode
+    for x in _RANGE_100:
+        data_decode("utf-8")
+
+@bench('(ascii_text*1000).encode("ascii").decode("ascii")',
+       "decode ASCII", 100)
+def decode_ascii(STR):
+    data = _get_utf8_data(STR, "ascii")
+    data_decode = data.decode
+    for x in _RANGE_100:
+        data_decode("ascii")
+
+
 # end of benchmarks
 
 #################
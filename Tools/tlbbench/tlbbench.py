@@ -0,0 +1,104 @@
+"""Benchmark pointer chasing over a large heap of small objects.
+
+Builds a graph of small objects spread over many pymalloc arenas and walks
+it in random order, which is dominated by TLB misses on large heaps.  The
+walk is run once per allocator in a child process, so that PYTHONMALLOC
+can select between the regular arenas and the huge page arenas.
+
+If the Linux perf tool is available, dTLB load misses are reported as well.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import time
+
+
+ALLOCATORS = ('pymalloc', 'pymalloc_hugepage')
+
+
+class Node:
+    __slots__ = ('next', 'value')
+
+
+def build(nodes, seed):
+    rng = random.Random(seed)
+    heap = [Node() for _ in range(nodes)]
+    order = list(range(nodes))
+    rng.shuffle(order)
+    for i, j in zip(order, order[1:] + order[:1]):
+        heap[i].next = heap[j]
+        heap[i].value = i
+    return heap[order[0]]
+
+
+def walk(start, steps):
+    node = start
+    total = 0
+    for _ in range(steps):
+        total += node.value
+        node = node.next
+    return total
+
+
+def child(args):
+    start = build(args.nodes, args.seed)
+    t0 = time.perf_counter()
+    walk(start, args.steps)
+    print(time.perf_counter() - t0)
+
+
+def run(allocator, args):
+    cmd = [sys.executable, __file__, '--child',
+           '--nodes', str(args.nodes), '--steps', str(args.steps),
+           '--seed', str(args.seed)]
+    env = dict(os.environ, PYTHONMALLOC=allocator)
+    perf = shutil.which('perf') if not args.no_perf else None
+    if perf:
+        cmd = [perf, 'stat', '-x', ',', '-e', 'dTLB-load-misses'] + cmd
+    proc = subprocess.run(cmd, env=env, capture_output=True, text=True)
+    if proc.returncode:
+        sys.stderr.write(proc.stderr)
+        raise SystemExit(f"{allocator}: child process failed")
+    elapsed = float(proc.stdout.split()[-1])
+    misses = None
+    for line in proc.stderr.splitlines():
+        fields = line.split(',')
+        if len(fields) > 2 and fields[2].startswith('dTLB-load-misses'):
+            if fields[0].isdigit():
+                misses = int(fields[0])
+    return elapsed, misses
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--nodes', type=int, default=2_000_000,
+                        help="number of objects in the graph")
+    parser.add_argument('--steps', type=int, default=10_000_000,
+                        help="number of pointers to follow")
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('-n', '--repeat', type=int, default=3)
+    parser.add_argument('--no-perf', action='store_true',
+                        help="do not use perf to count TLB misses")
+    parser.add_argument('--child', action='store_true',
+                        help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        child(args)
+        return
+
+    for allocator in ALLOCATORS:
+        results = [run(allocator, args) for _ in range(args.repeat)]
+        best, misses = min(results, key=lambda r: r[0])
+        line = f"{allocator:20} {best:8.3f} s"
+        if misses is not None:
+            line += f"  {misses:15,} dTLB-load-misses"
+        print(line)
+
+
+if __name__ == '__main__':
+    main()